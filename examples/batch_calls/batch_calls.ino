@@ -0,0 +1,152 @@
+/*
+ * WAMR Batch Call Example for ESP32
+ *
+ * This example demonstrates:
+ * - Calling one export over many argument rows with callBatch()
+ * - Resolving a function once with getFunction()
+ * - Handling a trap in the middle of a batch
+ * - Calls/sec comparison: looped callFunction() vs. handle vs. batch
+ *
+ * The WASM module is tools/wasm_examples/math.c (add, subtract,
+ * multiply, divide, fibonacci).
+ */
+
+#include <WAMR.h>
+
+// math.wasm (see tools/wasm_examples/math.c)
+const unsigned char math_wasm[] = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x0c, 0x02,
+    0x60, 0x02, 0x7f, 0x7f, 0x01, 0x7f, 0x60, 0x01, 0x7f, 0x01, 0x7f,
+    0x03, 0x06, 0x05, 0x00, 0x00, 0x00, 0x00, 0x01, 0x07, 0x32, 0x05,
+    0x03, 0x61, 0x64, 0x64, 0x00, 0x00, 0x08, 0x73, 0x75, 0x62, 0x74,
+    0x72, 0x61, 0x63, 0x74, 0x00, 0x01, 0x08, 0x6d, 0x75, 0x6c, 0x74,
+    0x69, 0x70, 0x6c, 0x79, 0x00, 0x02, 0x06, 0x64, 0x69, 0x76, 0x69,
+    0x64, 0x65, 0x00, 0x03, 0x09, 0x66, 0x69, 0x62, 0x6f, 0x6e, 0x61,
+    0x63, 0x63, 0x69, 0x00, 0x04, 0x0a, 0x47, 0x05, 0x07, 0x00, 0x20,
+    0x00, 0x20, 0x01, 0x6a, 0x0b, 0x07, 0x00, 0x20, 0x00, 0x20, 0x01,
+    0x6b, 0x0b, 0x07, 0x00, 0x20, 0x00, 0x20, 0x01, 0x6c, 0x0b, 0x10,
+    0x00, 0x20, 0x01, 0x45, 0x04, 0x7f, 0x41, 0x00, 0x05, 0x20, 0x00,
+    0x20, 0x01, 0x6d, 0x0b, 0x0b, 0x1c, 0x00, 0x20, 0x00, 0x41, 0x01,
+    0x4c, 0x04, 0x7f, 0x20, 0x00, 0x05, 0x20, 0x00, 0x41, 0x01, 0x6b,
+    0x10, 0x04, 0x20, 0x00, 0x41, 0x02, 0x6b, 0x10, 0x04, 0x6a, 0x0b,
+    0x0b};
+const unsigned int math_wasm_len = 155;
+
+#define BATCH_SIZE 256
+#define ROUNDS 20
+
+WamrModule wasmModule;
+
+// One row per call: {a, b}; the result overwrites a
+static uint32_t rows[BATCH_SIZE][2];
+
+static void fill_rows() {
+  for (int i = 0; i < BATCH_SIZE; i++) {
+    rows[i][0] = i;
+    rows[i][1] = 3;
+  }
+}
+
+static void report(const char *label, unsigned long elapsed_us) {
+  uint32_t calls = BATCH_SIZE * ROUNDS;
+  Serial.printf("  %-24s %8lu µs  %10.0f calls/sec\n", label, elapsed_us,
+                calls * 1e6 / (elapsed_us ? elapsed_us : 1));
+}
+
+void setup() {
+  Serial.begin(115200);
+  delay(1000);
+
+  Serial.println("\n========================================");
+  Serial.println("  WAMR Batch Call Example");
+  Serial.println("========================================\n");
+
+  if (!WamrRuntime::begin(128 * 1024)) {
+    Serial.println("FATAL: Failed to initialize WAMR!");
+    while (1) delay(1000);
+  }
+
+  if (!wasmModule.load(math_wasm, math_wasm_len)) {
+    Serial.println("FATAL: Failed to load module!");
+    Serial.println(wasmModule.getError());
+    while (1) delay(1000);
+  }
+
+  // ============================================================================
+  // EXAMPLE 1: Batch call
+  // ============================================================================
+
+  Serial.println("Example 1: multiply() over 256 rows in one callBatch()");
+  fill_rows();
+  if (wasmModule.callBatch("multiply", 2, &rows[0][0], BATCH_SIZE)) {
+    Serial.printf("  rows[10] = %u (expected 30)\n", rows[10][0]);
+    Serial.printf("  rows[255] = %u (expected 765)\n\n", rows[255][0]);
+  } else {
+    Serial.println(wasmModule.getError());
+  }
+
+  // ============================================================================
+  // EXAMPLE 2: Trap in the middle of a batch
+  // ============================================================================
+
+  Serial.println("Example 2: divide() with a trapping row 5");
+  uint32_t div_rows[8][2];
+  for (int i = 0; i < 8; i++) {
+    div_rows[i][0] = 100;
+    div_rows[i][1] = 10;
+  }
+  // math.c returns 0 for b == 0, so force a trap with INT_MIN / -1 instead
+  div_rows[5][0] = 0x80000000;
+  div_rows[5][1] = 0xFFFFFFFF;
+
+  uint32_t failed = 0;
+  if (!wasmModule.callBatch("divide", 2, &div_rows[0][0], 8, &failed)) {
+    Serial.printf("  Stopped at row %u: %s\n", failed, wasmModule.getError());
+    Serial.printf("  Rows before it completed: div_rows[4] = %u\n\n",
+                  div_rows[4][0]);
+  }
+
+  // A trap leaves the exception set on the instance until it is cleared.
+  // Clearing it is much cheaper than reloading the module to recover.
+  wasm_runtime_clear_exception(wasmModule.getInstance());
+
+  // ============================================================================
+  // EXAMPLE 3: Performance Comparison
+  // ============================================================================
+
+  Serial.printf("Example 3: add() x %d calls\n", BATCH_SIZE * ROUNDS);
+
+  unsigned long start = micros();
+  for (int r = 0; r < ROUNDS; r++) {
+    for (int i = 0; i < BATCH_SIZE; i++) {
+      uint32_t args[2] = {(uint32_t)i, 3};
+      wasmModule.callFunction("add", 2, args);
+    }
+  }
+  report("callFunction() loop", micros() - start);
+
+  WamrFunction add = wasmModule.getFunction("add");
+  start = micros();
+  for (int r = 0; r < ROUNDS; r++) {
+    for (int i = 0; i < BATCH_SIZE; i++) {
+      uint32_t args[2] = {(uint32_t)i, 3};
+      add.call(2, args);
+    }
+  }
+  report("WamrFunction::call() loop", micros() - start);
+
+  start = micros();
+  for (int r = 0; r < ROUNDS; r++) {
+    fill_rows();
+    add.callBatch(2, &rows[0][0], BATCH_SIZE);
+  }
+  report("callBatch()", micros() - start);
+
+  Serial.println("\n========================================");
+  Serial.println("  Example Complete!");
+  Serial.println("========================================\n");
+}
+
+void loop() {
+  delay(10000);
+}
@@ -0,0 +1,158 @@
+/*
+ * WAMR Fast Native Functions Example for ESP32
+ *
+ * This example demonstrates:
+ * - Registering "fast" natives with wasm_runtime_register_natives_fast()
+ * - Reading params from and writing the result to the wasm cells
+ * - Leaf natives, called without an interpreter frame
+ * - Import-call latency: regular native vs. fast leaf native
+ *
+ * A fast native is declared as
+ *   void foo(wasm_exec_env_t exec_env, uint32_t *cells);
+ * It gets its params in the cells the interpreter already holds them in
+ * (one per i32, two per i64) and writes its result over cells[0]. Natives
+ * registered as leaves must never call back into wasm.
+ */
+
+#include <WAMR.h>
+
+#define LED_PIN 2  // Built-in LED on most ESP32 boards
+#define CALLS 10000
+
+// Regular native: the runtime converts the params for a C call
+static int32_t native_scaleReading(wasm_exec_env_t exec_env, int32_t raw) {
+  return raw * 3 / 2;
+}
+
+// The same as a fast native: param and result in cells[0]
+static void fast_scaleReading(wasm_exec_env_t exec_env, uint32_t *cells) {
+  int32_t raw = (int32_t)cells[0];
+  cells[0] = (uint32_t)(raw * 3 / 2);
+}
+
+// Fast native with two params and no result
+static void fast_digitalWrite(wasm_exec_env_t exec_env, uint32_t *cells) {
+  digitalWrite((int32_t)cells[0], (int32_t)cells[1]);
+}
+
+static NativeSymbol native_symbols[] = {
+  {"scale_reading", (void*)native_scaleReading, "(i)i", nullptr},
+};
+
+// None of these calls back into wasm, so they can be leaves
+static NativeSymbol fast_native_symbols[] = {
+  {"fast_scale_reading", (void*)fast_scaleReading, "(i)i", nullptr},
+  {"fast_digitalWrite", (void*)fast_digitalWrite, "(ii)", nullptr},
+};
+
+// This is compiled from:
+//
+// extern int scale_reading(int raw);
+// extern int fast_scale_reading(int raw);
+// extern void fast_digitalWrite(int pin, int value);
+//
+// int sum_plain(unsigned n) {
+//     int acc = 0;
+//     for (unsigned i = 0; i < n; i++) acc += scale_reading(i);
+//     return acc;
+// }
+//
+// int sum_fast(unsigned n) {
+//     int acc = 0;
+//     for (unsigned i = 0; i < n; i++) acc += fast_scale_reading(i);
+//     return acc;
+// }
+//
+// void set_led(int pin, int value) {
+//     fast_digitalWrite(pin, value);
+// }
+
+const unsigned char fast_natives_wasm[] = {
+  0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x0b, 0x02, 0x60,
+  0x01, 0x7f, 0x01, 0x7f, 0x60, 0x02, 0x7f, 0x7f, 0x00, 0x02, 0x46, 0x03,
+  0x03, 0x65, 0x6e, 0x76, 0x0d, 0x73, 0x63, 0x61, 0x6c, 0x65, 0x5f, 0x72,
+  0x65, 0x61, 0x64, 0x69, 0x6e, 0x67, 0x00, 0x00, 0x03, 0x65, 0x6e, 0x76,
+  0x12, 0x66, 0x61, 0x73, 0x74, 0x5f, 0x73, 0x63, 0x61, 0x6c, 0x65, 0x5f,
+  0x72, 0x65, 0x61, 0x64, 0x69, 0x6e, 0x67, 0x00, 0x00, 0x03, 0x65, 0x6e,
+  0x76, 0x11, 0x66, 0x61, 0x73, 0x74, 0x5f, 0x64, 0x69, 0x67, 0x69, 0x74,
+  0x61, 0x6c, 0x57, 0x72, 0x69, 0x74, 0x65, 0x00, 0x01, 0x03, 0x04, 0x03,
+  0x00, 0x00, 0x01, 0x07, 0x22, 0x03, 0x09, 0x73, 0x75, 0x6d, 0x5f, 0x70,
+  0x6c, 0x61, 0x69, 0x6e, 0x00, 0x03, 0x08, 0x73, 0x75, 0x6d, 0x5f, 0x66,
+  0x61, 0x73, 0x74, 0x00, 0x04, 0x07, 0x73, 0x65, 0x74, 0x5f, 0x6c, 0x65,
+  0x64, 0x00, 0x05, 0x0a, 0x48, 0x03, 0x1e, 0x01, 0x02, 0x7f, 0x03, 0x40,
+  0x20, 0x01, 0x10, 0x00, 0x20, 0x02, 0x6a, 0x21, 0x02, 0x20, 0x01, 0x41,
+  0x01, 0x6a, 0x22, 0x01, 0x20, 0x00, 0x49, 0x0d, 0x00, 0x0b, 0x20, 0x02,
+  0x0b, 0x1e, 0x01, 0x02, 0x7f, 0x03, 0x40, 0x20, 0x01, 0x10, 0x01, 0x20,
+  0x02, 0x6a, 0x21, 0x02, 0x20, 0x01, 0x41, 0x01, 0x6a, 0x22, 0x01, 0x20,
+  0x00, 0x49, 0x0d, 0x00, 0x0b, 0x20, 0x02, 0x0b, 0x08, 0x00, 0x20, 0x00,
+  0x20, 0x01, 0x10, 0x02, 0x0b
+};
+const unsigned int fast_natives_wasm_len = 209;
+
+WamrModule wasmModule;
+
+// Calls `func_name` once, for CALLS import calls, and prints the latency
+static void timeCalls(const char *label, const char *func_name) {
+  uint32_t args[1] = {CALLS};
+  unsigned long start = micros();
+
+  if (!wasmModule.callFunction(func_name, 1, args)) {
+    Serial.printf("ERROR: %s() failed: %s\n", func_name,
+                  wasmModule.getError());
+    return;
+  }
+  unsigned long elapsed_us = micros() - start;
+  Serial.printf("  %-22s sum=%d  %8lu µs  %6.2f µs/call\n", label,
+                (int32_t)args[0], elapsed_us, (float)elapsed_us / CALLS);
+}
+
+void setup() {
+  Serial.begin(115200);
+  delay(1000);
+
+  Serial.println("\n========================================");
+  Serial.println("  WAMR Fast Native Functions Example");
+  Serial.println("========================================\n");
+
+  if (!WamrRuntime::begin(128 * 1024)) {
+    Serial.println("FATAL: Failed to initialize WAMR!");
+    while (1) delay(1000);
+  }
+
+  // Register both kinds BEFORE loading the module
+  if (!wasm_runtime_register_natives("env", native_symbols,
+                                     sizeof(native_symbols) / sizeof(NativeSymbol)) ||
+      !wasm_runtime_register_natives_fast("env", fast_native_symbols,
+                                          sizeof(fast_native_symbols) / sizeof(NativeSymbol),
+                                          true)) {
+    Serial.println("FATAL: Failed to register native functions!");
+    while (1) delay(1000);
+  }
+  Serial.println("✓ Natives registered (1 regular, 2 fast leaves)\n");
+
+  if (!wasmModule.load(fast_natives_wasm, fast_natives_wasm_len)) {
+    Serial.println("FATAL: Failed to load WASM module!");
+    Serial.println(wasmModule.getError());
+    while (1) delay(1000);
+  }
+
+  // Both loops compute the same sum; only the import call differs
+  Serial.printf("Import-call latency over %d calls:\n", CALLS);
+  timeCalls("regular native", "sum_plain");
+  timeCalls("fast leaf native", "sum_fast");
+
+  pinMode(LED_PIN, OUTPUT);
+  Serial.println("\nBlinking the LED through a fast native...");
+}
+
+void loop() {
+  static uint32_t value = 0;
+  uint32_t args[2] = {LED_PIN, value};
+
+  if (!wasmModule.callFunction("set_led", 2, args)) {
+    Serial.println("ERROR: set_led() failed!");
+    Serial.println(wasmModule.getError());
+  }
+  value = !value;
+  delay(500);
+}
@@ -115,7 +115,7 @@ void setup() {
   unsigned long elapsed = micros() - start;
   Serial.printf("\nCompleted %d calls in %lu µs\n", iterations, elapsed);
   Serial.printf("Average: %.2f µs per call\n", (float)elapsed / iterations);
-  Serial.println("(includes pthread creation overhead)\n");
+  Serial.println("(includes handoff to the pooled worker thread)\n");
 
   delay(1000);
 
@@ -183,7 +183,7 @@ void setup() {
   Serial.println("Example 4: Performance Comparison");
   Serial.println("========================================\n");
 
-  // Measure Safe API with new thread per call
+  // Measure Safe API with pooled worker dispatch
   iterations = 10;
   start = micros();
   for (int i = 0; i < iterations; i++) {
@@ -195,12 +195,12 @@ void setup() {
   Serial.printf("Safe API (callFunction):\n");
   Serial.printf("  %d calls: %lu µs\n", iterations, safe_time);
   Serial.printf("  Average: %.2f µs/call\n", (float)safe_time / iterations);
-  Serial.printf("  Overhead: ~%.2f ms for pthread creation\n\n",
+  Serial.printf("  Total: ~%.2f ms including worker handoff\n\n",
                 (float)safe_time / 1000.0);
 
   Serial.println("Raw API comparison:");
   Serial.println("  See Example 3 results above");
-  Serial.println("  Raw API avoids pthread creation overhead");
+  Serial.println("  Raw API avoids the worker thread handoff");
   Serial.println("  Use when calling WASM 100+ times per second\n");
 
   // ============================================================================
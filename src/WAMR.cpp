@@ -6,39 +6,110 @@
  */
 
 #include "WAMR.h"
+#include "WamrWorkerPool.h"
 #include <esp_heap_caps.h>
 #include <pthread.h>
 
+#ifdef WAMR_HOST_BUILD
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <esp_partition.h>
+#endif
+
 // Static member initialization
+uint32_t WamrRuntime::worker_count = WAMR_DEFAULT_WORKER_COUNT;
 bool WamrRuntime::initialized = false;
 char *WamrRuntime::global_heap_buf = nullptr;
+char *WamrRuntime::fast_heap_buf = nullptr;
+uint32_t WamrRuntime::fast_pool_size = 0;
+uint32_t WamrRuntime::fast_classes = WAMR_DEFAULT_FAST_CLASSES;
 const char *WamrRuntime::error_msg = nullptr;
 
 // WamrModule static members
 size_t WamrModule::thread_stack_size = WAMR_DEFAULT_THREAD_STACK;
+uint32_t WamrModule::next_instance_id = 0;
+
+// Worker pool that runs safe callFunction() calls in pthread context
+static WamrWorkerPool worker_pool;
+static pthread_mutex_t worker_pool_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// exec_env owned by a WamrModule for one calling thread
+struct WamrExecEnvEntry {
+  pthread_t owner;
+  wasm_exec_env_t exec_env;
+  WamrExecEnvEntry *next;
+};
+
+// Per-thread cache of exec_envs, keyed by WamrModule instance id.
+// Entries of unloaded modules are never matched again because instance
+// ids are not reused; the exec_envs themselves are owned by the module.
+struct ExecEnvSlot {
+  uint32_t instance_id;
+  wasm_exec_env_t exec_env;
+};
+static __thread ExecEnvSlot exec_env_slots[WAMR_EXEC_ENV_TLS_SLOTS];
+static __thread uint32_t exec_env_slot_next;
 
-// Context structure for passing data to pthread wrapper
+// Every WamrModule, so that the exec_envs of an exiting thread can be found.
+// Lock order: all_modules_lock, then a module's cache_lock.
+static WamrModule *all_modules = nullptr;
+static pthread_mutex_t all_modules_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// Set on a thread once it owns an exec_env, its destructor frees them when
+// the thread exits
+static pthread_key_t exec_env_key;
+static pthread_once_t exec_env_key_once = PTHREAD_ONCE_INIT;
+static bool exec_env_key_created = false;
+
+static void exec_env_key_destructor(void *value) {
+  WamrRuntime::releaseThreadExecEnvs();
+}
+
+static void create_exec_env_key() {
+  exec_env_key_created =
+      pthread_key_create(&exec_env_key, exec_env_key_destructor) == 0;
+}
+
+// Context structure for passing data to a pool worker
 struct WasmCallContext {
   WamrModule *module;
+  wasm_function_inst_t func;  // Resolved handle, or nullptr to look up
   const char *func_name;
   uint32_t argc;
   uint32_t *argv;
+  uint32_t batch_count;       // 0 for a single call, else rows in argv
+  uint32_t *failed_index;
   bool success;
 };
 
-// Pthread wrapper function
-void *wasm_thread_wrapper(void *arg) {
+// Worker pool job function
+void wasm_call_job(void *arg) {
   WasmCallContext *ctx = (WasmCallContext *)arg;
-  ctx->success =
-      ctx->module->callFunctionInternal(ctx->func_name, ctx->argc, ctx->argv);
-  return nullptr;
+  WamrModule *module = ctx->module;
+
+  if (ctx->batch_count > 0) {
+    ctx->success = module->invokeBatchInternal(ctx->func, ctx->func_name,
+                                               ctx->argc, ctx->argv,
+                                               ctx->batch_count,
+                                               ctx->failed_index);
+  } else if (ctx->func) {
+    ctx->success =
+        module->invokeInternal(ctx->func, ctx->func_name, ctx->argc, ctx->argv);
+  } else {
+    ctx->success =
+        module->callFunctionInternal(ctx->func_name, ctx->argc, ctx->argv);
+  }
 }
 
 // ============================================================================
 // WamrRuntime Implementation
 // ============================================================================
 
-bool WamrRuntime::begin(uint32_t heap_pool_size) {
+bool WamrRuntime::begin(uint32_t heap_pool_size,
+                        pool_allocator_type_t allocator) {
   if (initialized) {
     WAMR_LOG_E("Runtime already initialized");
     return true;
@@ -71,6 +142,20 @@ bool WamrRuntime::begin(uint32_t heap_pool_size) {
     return false;
   }
 
+  if (fast_pool_size > 0) {
+    fast_heap_buf = (char *)heap_caps_malloc(
+        fast_pool_size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (!fast_heap_buf) {
+      error_msg = "Failed to allocate fast heap";
+      WAMR_LOG_E("%s (%u bytes)", error_msg, fast_pool_size);
+      free(global_heap_buf);
+      global_heap_buf = nullptr;
+      return false;
+    }
+    WAMR_LOG_D("Using %u bytes of internal RAM for classes 0x%x",
+               fast_pool_size, fast_classes);
+  }
+
   // Initialize WAMR runtime
   RuntimeInitArgs init_args;
   memset(&init_args, 0, sizeof(RuntimeInitArgs));
@@ -78,12 +163,19 @@ bool WamrRuntime::begin(uint32_t heap_pool_size) {
   init_args.mem_alloc_type = Alloc_With_Pool;
   init_args.mem_alloc_option.pool.heap_buf = global_heap_buf;
   init_args.mem_alloc_option.pool.heap_size = heap_pool_size;
+  init_args.mem_alloc_option.pool.allocator_type = allocator;
+  init_args.mem_alloc_option.pool.fast_heap_buf = fast_heap_buf;
+  init_args.mem_alloc_option.pool.fast_heap_size =
+      fast_heap_buf ? fast_pool_size : 0;
+  init_args.mem_alloc_option.pool.fast_mem_classes = fast_classes;
 
   if (!wasm_runtime_full_init(&init_args)) {
     error_msg = "Failed to initialize WAMR runtime";
     WAMR_LOG_E("%s", error_msg);
     free(global_heap_buf);
     global_heap_buf = nullptr;
+    free(fast_heap_buf);
+    fast_heap_buf = nullptr;
     return false;
   }
 
@@ -101,12 +193,16 @@ void WamrRuntime::end() {
 
   WAMR_LOG_D("Shutting down runtime...");
 
+  restartWorkers();
+
   wasm_runtime_destroy();
 
   if (global_heap_buf) {
     free(global_heap_buf);
     global_heap_buf = nullptr;
   }
+  free(fast_heap_buf);
+  fast_heap_buf = nullptr;
 
   initialized = false;
   WAMR_LOG_D("Runtime shutdown complete");
@@ -114,12 +210,12 @@ void WamrRuntime::end() {
 
 void WamrRuntime::printMemoryUsage() {
   Serial.println("=== ESP32 Memory Status ===");
-  Serial.printf("Free heap: %u bytes\n", ESP.getFreeHeap());
+  Serial.printf("Free heap: %u bytes\n", (unsigned)ESP.getFreeHeap());
   Serial.printf("Largest free block: %u bytes\n",
-                heap_caps_get_largest_free_block(MALLOC_CAP_8BIT));
+                (unsigned)heap_caps_get_largest_free_block(MALLOC_CAP_8BIT));
 
 #if CONFIG_SPIRAM_SUPPORT || CONFIG_ESP32_SPIRAM_SUPPORT
-  Serial.printf("Free PSRAM: %u bytes\n", ESP.getFreePsram());
+  Serial.printf("Free PSRAM: %u bytes\n", (unsigned)ESP.getFreePsram());
 #else
   Serial.println("PSRAM: Not available");
 #endif
@@ -127,20 +223,296 @@ void WamrRuntime::printMemoryUsage() {
   Serial.println("===========================");
 }
 
+void WamrRuntime::setWorkerCount(uint32_t count) {
+  if (count == 0 || count > WAMR_POOL_MAX_WORKERS) {
+    WAMR_LOG_E("Worker count must be 1-%u", WAMR_POOL_MAX_WORKERS);
+    return;
+  }
+  if (WamrWorkerPool::isWorkerThread()) {
+    WAMR_LOG_E("Worker count can't be changed from a callFunction() worker");
+    return;
+  }
+  worker_count = count;
+  restartWorkers();
+  WAMR_LOG_D("Worker count set to %u", count);
+}
+
+void WamrRuntime::setMemoryPlacement(uint32_t pool_size, uint32_t classes) {
+#if WASM_ENABLE_MEM_PLACEMENT == 0
+  if (pool_size > 0) {
+    WAMR_LOG_E("Fast pool ignored, WASM_ENABLE_MEM_PLACEMENT=0");
+    return;
+  }
+#endif
+  fast_pool_size = pool_size;
+  fast_classes = classes;
+}
+
+bool WamrRuntime::getPoolInfo(mem_alloc_info_t *main_info,
+                              mem_alloc_info_t *fast_info) {
+  memset(main_info, 0, sizeof(*main_info));
+  memset(fast_info, 0, sizeof(*fast_info));
+  if (!initialized || !wasm_runtime_get_mem_alloc_info(main_info)) {
+    return false;
+  }
+  wasm_runtime_get_fast_mem_alloc_info(fast_info);
+  return true;
+}
+
+bool WamrRuntime::getAllocCacheStats(uint64_t *hits, uint64_t *misses,
+                                     uint32_t *bytes_held) {
+  mem_alloc_cache_stats_t stats;
+  bool enabled = initialized && wasm_runtime_get_alloc_cache_stats(&stats);
+
+  *hits = enabled ? stats.hit_count : 0;
+  *misses = enabled ? stats.miss_count : 0;
+  *bytes_held = enabled ? stats.bytes_held : 0;
+  return enabled;
+}
+
+void WamrRuntime::releaseThreadCache() {
+  if (initialized) {
+    wasm_runtime_flush_thread_alloc_cache();
+  }
+}
+
+void WamrRuntime::releaseThreadExecEnvs() {
+  pthread_t self = pthread_self();
+
+  pthread_mutex_lock(&all_modules_lock);
+  for (WamrModule *module = all_modules; module; module = module->next_module) {
+    module->releaseExecEnvOf(self);
+  }
+  pthread_mutex_unlock(&all_modules_lock);
+
+  memset(exec_env_slots, 0, sizeof(exec_env_slots));
+  if (exec_env_key_created) {
+    pthread_setspecific(exec_env_key, nullptr);
+  }
+  // The freed stacks would otherwise stay in this thread's cache
+  releaseThreadCache();
+}
+
+void WamrRuntime::restartWorkers() {
+  // Workers are started again lazily by the next runOnWorker()
+  pthread_mutex_lock(&worker_pool_lock);
+  worker_pool.stop();
+  pthread_mutex_unlock(&worker_pool_lock);
+}
+
+bool WamrRuntime::runOnWorker(void (*fn)(void *arg), void *arg) {
+  pthread_mutex_lock(&worker_pool_lock);
+  if (!worker_pool.isRunning()) {
+    worker_pool.setExitHook(releaseThreadExecEnvs);
+    if (!worker_pool.start(worker_count, WamrModule::thread_stack_size)) {
+      pthread_mutex_unlock(&worker_pool_lock);
+      return false;
+    }
+    WAMR_LOG_D("Started %u worker thread(s) (stack: %u bytes)", worker_count,
+               WamrModule::thread_stack_size);
+  }
+  pthread_mutex_unlock(&worker_pool_lock);
+
+  return worker_pool.run(fn, arg);
+}
+
 // ============================================================================
 // WamrModule Implementation
 // ============================================================================
 
+// Advance past one unsigned LEB128 value
+static bool skip_leb(const uint8_t **p, const uint8_t *end) {
+  while (*p < end) {
+    if ((*(*p)++ & 0x80) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static bool read_leb_u32(const uint8_t **p, const uint8_t *end,
+                         uint32_t *value) {
+  uint32_t result = 0;
+  for (uint32_t shift = 0; shift < 35 && *p < end; shift += 7) {
+    uint8_t byte = *(*p)++;
+    result |= (uint32_t)(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0) {
+      *value = result;
+      return true;
+    }
+  }
+  return false;
+}
+
+// Advance past the offset expression of an active data segment
+static bool skip_const_expr(const uint8_t **p, const uint8_t *end) {
+  while (*p < end) {
+    switch (*(*p)++) {
+      case 0x0b:  // end
+        return true;
+      case 0x41:  // i32.const
+      case 0x42:  // i64.const
+      case 0x23:  // global.get
+        if (!skip_leb(p, end)) {
+          return false;
+        }
+        break;
+      case 0x43:  // f32.const
+        *p += 4;
+        break;
+      case 0x44:  // f64.const
+        *p += 8;
+        break;
+      default:    // extended-const arithmetic has no immediates
+        break;
+    }
+  }
+  return false;
+}
+
+// Payload bytes of all data segments in a wasm binary, i.e. what a
+// read-only load references in place instead of copying
+static uint32_t wasm_data_bytes(const uint8_t *bytes, uint32_t size) {
+  const uint8_t *p = bytes + 8, *end = bytes + size;  // magic + version
+  uint32_t total = 0;
+
+  while (p < end) {
+    uint8_t id = *p++;
+    uint32_t section_size;
+    if (!read_leb_u32(&p, end, &section_size) ||
+        section_size > (uint32_t)(end - p)) {
+      break;
+    }
+    const uint8_t *section_end = p + section_size;
+    if (id == 11) {  // data section
+      uint32_t count, flags, len;
+      if (!read_leb_u32(&p, section_end, &count)) {
+        break;
+      }
+      for (uint32_t i = 0; i < count; i++) {
+        // flags: 0 = active (memory 0), 1 = passive, 2 = active (memidx)
+        if (!read_leb_u32(&p, section_end, &flags) ||
+            (flags == 2 && !skip_leb(&p, section_end)) ||
+            (flags != 1 && !skip_const_expr(&p, section_end)) ||
+            !read_leb_u32(&p, section_end, &len) ||
+            len > (uint32_t)(section_end - p)) {
+          break;
+        }
+        total += len;
+        p += len;
+      }
+    }
+    p = section_end;
+  }
+  return total;
+}
+
 WamrModule::WamrModule()
     : module(nullptr), module_inst(nullptr), stack_size_for_exec_env(0),
-      last_result(0), loaded(false) {
+      instance_id(0), last_result(0), bytes_saved(0), loaded(false),
+      xip(false), code_cache_used(false), snapshot(nullptr),
+      share_refs(nullptr), xip_map(nullptr), xip_map_size(0),
+      xip_map_handle(0),
+      exec_envs(nullptr), func_cache_next(0), export_hashes(nullptr),
+      export_hash_count(0) {
   memset(error_buf, 0, sizeof(error_buf));
+  memset(func_cache, 0, sizeof(func_cache));
+  pthread_mutex_init(&cache_lock, nullptr);
+
+  pthread_mutex_lock(&all_modules_lock);
+  next_module = all_modules;
+  all_modules = this;
+  pthread_mutex_unlock(&all_modules_lock);
 }
 
-WamrModule::~WamrModule() { unload(); }
+WamrModule::~WamrModule() {
+  pthread_mutex_lock(&all_modules_lock);
+  WamrModule **link = &all_modules;
+  while (*link != this) {
+    link = &(*link)->next_module;
+  }
+  *link = next_module;
+  pthread_mutex_unlock(&all_modules_lock);
+
+  unload();
+  pthread_mutex_destroy(&cache_lock);
+}
 
 bool WamrModule::load(const uint8_t *wasm_bytes, uint32_t size,
                       uint32_t stack_size, uint32_t heap_size) {
+  return loadModule(wasm_bytes, size, stack_size, heap_size, nullptr, 0);
+}
+
+bool WamrModule::loadCached(const uint8_t *wasm_bytes, uint32_t size,
+                            const uint8_t *code_cache, uint32_t cache_size,
+                            uint32_t stack_size, uint32_t heap_size) {
+  return loadModule(wasm_bytes, size, stack_size, heap_size, code_cache,
+                    cache_size);
+}
+
+bool WamrModule::loadLazy(const uint8_t *wasm_bytes, uint32_t size,
+                          uint32_t stack_size, uint32_t heap_size) {
+  return loadModule(wasm_bytes, size, stack_size, heap_size, nullptr, 0,
+                    true);
+}
+
+bool WamrModule::getLazyLoweringStats(uint32_t *lowered_count,
+                                      uint64_t *lowering_time_us) const {
+  if (!loaded) {
+    *lowered_count = 0;
+    *lowering_time_us = 0;
+    return false;
+  }
+  return wasm_runtime_get_lazy_lowering_stats(module, lowered_count,
+                                              lowering_time_us);
+}
+
+uint8_t *WamrModule::buildCodeCache(const uint8_t *wasm_bytes, uint32_t size,
+                                    uint32_t *cache_size) {
+  char error[128];
+
+  if (!WamrRuntime::isInitialized()) {
+    WAMR_LOG_E("WAMR runtime not initialized");
+    return nullptr;
+  }
+  if (isAotBinary(wasm_bytes, size)) {
+    WAMR_LOG_E("AOT modules have no code cache");
+    return nullptr;
+  }
+
+  LoadArgs load_args;
+  memset(&load_args, 0, sizeof(load_args));
+  load_args.name = const_cast<char *>("");
+  load_args.wasm_binary_readonly = true;
+  load_args.code_cache_record = true;
+  wasm_module_t cache_module =
+      wasm_runtime_load_ex(const_cast<uint8_t *>(wasm_bytes), size,
+                           &load_args, error, sizeof(error));
+  if (!cache_module) {
+    WAMR_LOG_E("Failed to load module: %s", error);
+    return nullptr;
+  }
+
+  uint32_t needed = wasm_runtime_save_code_cache(cache_module, nullptr, 0);
+  uint8_t *cache = needed ? (uint8_t *)malloc(needed) : nullptr;
+  if (!cache ||
+      wasm_runtime_save_code_cache(cache_module, cache, needed) != needed) {
+    WAMR_LOG_E("Failed to build code cache (%u bytes)", needed);
+    free(cache);
+    cache = nullptr;
+  } else {
+    *cache_size = needed;
+    WAMR_LOG_D("Code cache built (%u bytes)", needed);
+  }
+
+  wasm_runtime_unload(cache_module);
+  return cache;
+}
+
+bool WamrModule::loadModule(const uint8_t *wasm_bytes, uint32_t size,
+                            uint32_t stack_size, uint32_t heap_size,
+                            const uint8_t *code_cache, uint32_t cache_size,
+                            bool lazy_lowering) {
   if (!WamrRuntime::isInitialized()) {
     snprintf(error_buf, sizeof(error_buf), "WAMR runtime not initialized");
     WAMR_LOG_E("%s", error_buf);
@@ -150,17 +522,56 @@ bool WamrModule::load(const uint8_t *wasm_bytes, uint32_t size,
   // Unload any existing module
   unload();
 
-  WAMR_LOG_D("Loading module (%u bytes)...", size);
+#if WASM_ENABLE_AOT == 0
+  if (isAotBinary(wasm_bytes, size)) {
+    snprintf(error_buf, sizeof(error_buf),
+             "AOT module but AOT support is disabled (WASM_ENABLE_AOT=0)");
+    WAMR_LOG_E("%s", error_buf);
+    return false;
+  }
+#endif
+
+  // The AOT loader reads sections as aligned words; a misaligned word load
+  // faults on Xtensa. Bytecode may be at any address.
+  if (isAotBinary(wasm_bytes, size) && ((uintptr_t)wasm_bytes & 3) != 0) {
+    snprintf(error_buf, sizeof(error_buf),
+             "AOT module buffer must be 4-byte aligned");
+    WAMR_LOG_E("%s", error_buf);
+    return false;
+  }
+
+  WAMR_LOG_D("Loading %s module (%u bytes)...",
+             isAotBinary(wasm_bytes, size) ? "AOT" : "WASM", size);
 
-  // Load WASM module
-  module = wasm_runtime_load(const_cast<uint8_t *>(wasm_bytes), size, error_buf,
-                             sizeof(error_buf));
+  // Load WASM module. The loader never writes to a read-only binary, so the
+  // const_cast is safe and the buffer may be in flash; const strings are
+  // copied and data segments are referenced in place.
+  LoadArgs load_args;
+  memset(&load_args, 0, sizeof(load_args));
+  load_args.name = const_cast<char *>("");
+  load_args.wasm_binary_readonly = true;
+  load_args.code_cache = code_cache;
+  load_args.code_cache_size = cache_size;
+  load_args.lazy_lowering = lazy_lowering;
+#if WASM_ENABLE_LOAD_ARENA != 0
+  // Module data in a few chunks instead of hundreds of heap blocks
+  load_args.load_arena = true;
+#endif
+  module = wasm_runtime_load_ex(const_cast<uint8_t *>(wasm_bytes), size,
+                                &load_args, error_buf, sizeof(error_buf));
   if (!module) {
     WAMR_LOG_E("Failed to load module: %s", error_buf);
     return false;
   }
 
-  WAMR_LOG_D("Module loaded successfully");
+  bytes_saved =
+      isAotBinary(wasm_bytes, size) ? 0 : wasm_data_bytes(wasm_bytes, size);
+  code_cache_used = wasm_runtime_is_code_cache_used(module);
+  if (code_cache && !code_cache_used) {
+    WAMR_LOG_D("Code cache doesn't match the module, functions lowered");
+  }
+  WAMR_LOG_D("Module loaded successfully (%u data bytes used in place)",
+             bytes_saved);
 
   // Instantiate module
   WAMR_LOG_D("Instantiating module (stack: %u, heap: %u)...", stack_size, heap_size);
@@ -177,62 +588,194 @@ bool WamrModule::load(const uint8_t *wasm_bytes, uint32_t size,
   WAMR_LOG_D("Module instantiated successfully");
 
   // Store stack size for later exec_env creation
-  // Note: exec_env must be created per-thread, not stored
-  // globally
+  // Note: exec_env is created lazily per calling thread, see getExecEnv()
   stack_size_for_exec_env = stack_size;
 
+  // New id so exec_envs cached by threads for a previous load never match
+  instance_id = __atomic_add_fetch(&next_instance_id, 1, __ATOMIC_RELAXED);
+  if (instance_id == 0) {
+    instance_id = __atomic_add_fetch(&next_instance_id, 1, __ATOMIC_RELAXED);
+  }
+
+  buildExportHashes();
   loaded = true;
+  xip = isXipBinary(wasm_bytes, size);
   WAMR_LOG_D("Module ready for execution");
 
   return true;
 }
 
-bool WamrModule::callFunction(const char *func_name, uint32_t argc,
-                              uint32_t *argv) {
-  // Safe API: Wrap call in pthread context
-  WasmCallContext ctx;
-  ctx.module = this;
-  ctx.func_name = func_name;
-  ctx.argc = argc;
-  ctx.argv = argv;
-  ctx.success = false;
+bool WamrModule::loadAot(const uint8_t *aot_bytes, uint32_t size,
+                         uint32_t stack_size, uint32_t heap_size) {
+  if (!isAotBinary(aot_bytes, size)) {
+    unload();
+    snprintf(error_buf, sizeof(error_buf),
+             "Not an AOT module (compile it with wamrc)");
+    WAMR_LOG_E("%s", error_buf);
+    return false;
+  }
+  return load(aot_bytes, size, stack_size, heap_size);
+}
 
-  pthread_t thread;
-  pthread_attr_t attr;
+bool WamrModule::loadXip(const uint8_t *image, uint32_t size,
+                         uint32_t stack_size, uint32_t heap_size) {
+  if (!isXipBinary(image, size)) {
+    unload();
+    snprintf(error_buf, sizeof(error_buf), "%s",
+             ((uintptr_t)image & 3) != 0
+                 ? "XIP image must be 4-byte aligned"
+                 : "Not an XIP AOT module (compile it with wamrc --xip)");
+    WAMR_LOG_E("%s", error_buf);
+    return false;
+  }
+  // The AOT loader keeps XIP text in place and never writes to the image
+  return load(image, size, stack_size, heap_size);
+}
 
-  // Initialize thread attributes
-  if (pthread_attr_init(&attr) != 0) {
-    snprintf(error_buf, sizeof(error_buf),
-             "Failed to initialize pthread attributes");
+#ifdef WAMR_HOST_BUILD
+bool WamrModule::loadXipFile(const char *path, uint32_t stack_size,
+                             uint32_t heap_size) {
+  unload();
+
+  int fd = open(path, O_RDONLY);
+  struct stat st;
+  if (fd < 0 || fstat(fd, &st) != 0 || st.st_size <= 0 ||
+      st.st_size > (off_t)UINT32_MAX) {
+    if (fd >= 0) {
+      close(fd);
+    }
+    snprintf(error_buf, sizeof(error_buf), "Cannot open XIP file %s", path);
     WAMR_LOG_E("%s", error_buf);
     return false;
   }
 
-  // Set stack size
-  if (pthread_attr_setstacksize(&attr, thread_stack_size) != 0) {
-    snprintf(error_buf, sizeof(error_buf), "Failed to set pthread stack size");
+  uint32_t size = (uint32_t)st.st_size;
+  void *image = mmap(nullptr, size, PROT_READ | PROT_EXEC, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (image == MAP_FAILED) {
+    snprintf(error_buf, sizeof(error_buf), "Cannot map XIP file %s", path);
     WAMR_LOG_E("%s", error_buf);
-    pthread_attr_destroy(&attr);
     return false;
   }
 
-  // Set joinable (we need to wait for completion)
-  pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_JOINABLE);
+  if (!loadXip((const uint8_t *)image, size, stack_size, heap_size)) {
+    munmap(image, size);
+    return false;
+  }
+
+  xip_map = image;
+  xip_map_size = size;
+  return true;
+}
+#else
+// Length of an AOT file at the start of a larger mapping (e.g. a flash
+// partition padded with 0xFF): walk the section headers until one is not
+// a valid section id. Only aligned 32-bit reads, which instruction-bus
+// mappings require.
+static uint32_t aot_image_size(const uint8_t *image, uint32_t max_size) {
+  uint32_t offset = 8;  // magic + version
+  while (offset + 8 <= max_size) {
+    uint32_t type = *(const uint32_t *)(image + offset);
+    uint32_t size = *(const uint32_t *)(image + offset + 4);
+    // Section types 0..6 and 100 (custom), see AOTSectionType
+    if ((type > 6 && type != 100) || size > max_size - offset - 8) {
+      break;
+    }
+    offset = (offset + 8 + size + 3) & ~3u;
+  }
+  return offset < max_size ? offset : max_size;
+}
+
+bool WamrModule::loadXipPartition(const char *partition_label,
+                                  uint32_t stack_size, uint32_t heap_size) {
+  unload();
+
+  const esp_partition_t *part = esp_partition_find_first(
+      ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, partition_label);
+  if (!part) {
+    snprintf(error_buf, sizeof(error_buf), "XIP partition '%s' not found",
+             partition_label);
+    WAMR_LOG_E("%s", error_buf);
+    return false;
+  }
 
-  // Create thread
-  if (pthread_create(&thread, &attr, wasm_thread_wrapper, &ctx) != 0) {
+  // Map through the instruction bus so the code can run from flash; the
+  // loader reads the headers with aligned 32-bit loads
+  // (WASM_ENABLE_WORD_ALIGN_READ), which this mapping supports
+  const void *image = nullptr;
+  spi_flash_mmap_handle_t handle = 0;
+  esp_err_t err = esp_partition_mmap(part, 0, part->size,
+                                     ESP_PARTITION_MMAP_INST, &image, &handle);
+  if (err != ESP_OK) {
     snprintf(error_buf, sizeof(error_buf),
-             "Failed to create pthread for WASM execution");
+             "Cannot map XIP partition '%s' (error %d)", partition_label,
+             (int)err);
     WAMR_LOG_E("%s", error_buf);
-    pthread_attr_destroy(&attr);
     return false;
   }
 
-  // Wait for thread to complete
-  pthread_join(thread, nullptr);
-  pthread_attr_destroy(&attr);
+  uint32_t size = aot_image_size((const uint8_t *)image, part->size);
+  WAMR_LOG_D("XIP partition '%s': %u of %u bytes used", partition_label, size,
+             (unsigned)part->size);
 
-  return ctx.success;
+  if (!loadXip((const uint8_t *)image, size, stack_size, heap_size)) {
+    spi_flash_munmap(handle);
+    return false;
+  }
+
+  xip_map = image;
+  xip_map_size = size;
+  xip_map_handle = handle;
+  return true;
+}
+#endif
+
+bool WamrModule::isXipBinary(const uint8_t *bytes, uint32_t size) {
+#if WASM_ENABLE_AOT != 0
+  if (!isAotBinary(bytes, size)) {
+    return false;
+  }
+  if (((uintptr_t)bytes & 3) == 0 && size >= 24) {
+    // Target info is always the first section; e_type is the low half of
+    // its second word. Read as words so flash mappings work.
+    const uint32_t *words = (const uint32_t *)bytes;
+    return words[2] == 0 && (words[5] & 0xffff) == 4;  // E_TYPE_XIP
+  }
+  // The AOT loader reads words at aligned addresses, so an unaligned image
+  // can't be loaded anyway
+  return false;
+#else
+  return false;
+#endif
+}
+
+bool WamrModule::isAotBinary(const uint8_t *bytes, uint32_t size) {
+  // AOT_MAGIC_NUMBER is "\0aot" read as a little-endian uint32. Aligned
+  // images are checked with one word load, which also works on flash
+  // mapped through the instruction bus (XIP).
+  if (!bytes || size < 4) {
+    return false;
+  }
+  if (((uintptr_t)bytes & 3) == 0) {
+    return *(const uint32_t *)bytes == 0x746f6100;
+  }
+  return bytes[0] == 0x00 && bytes[1] == 'a' && bytes[2] == 'o' &&
+         bytes[3] == 't';
+}
+
+bool WamrModule::isAot() const {
+#if WASM_ENABLE_AOT != 0
+  return module && wasm_runtime_get_module_package_type(module) ==
+                       Wasm_Module_AoT;
+#else
+  return false;
+#endif
+}
+
+bool WamrModule::callFunction(const char *func_name, uint32_t argc,
+                              uint32_t *argv) {
+  // Safe API: Run call on a pool worker (pthread context)
+  return dispatch(nullptr, func_name, argc, argv, 0, nullptr);
 }
 
 bool WamrModule::callFunctionRaw(const char *func_name, uint32_t argc,
@@ -242,34 +785,147 @@ bool WamrModule::callFunctionRaw(const char *func_name, uint32_t argc,
   return callFunctionInternal(func_name, argc, argv);
 }
 
-bool WamrModule::callFunctionInternal(const char *func_name, uint32_t argc,
-                                      uint32_t *argv) {
-  // Internal implementation - actual WASM call
+bool WamrModule::callFunction(const WamrExportName &func, uint32_t argc,
+                              uint32_t *argv) {
   if (!loaded || !module_inst) {
     snprintf(error_buf, sizeof(error_buf), "Module not loaded");
     WAMR_LOG_E("%s", error_buf);
     return false;
   }
 
-  // Create execution environment for this thread
-  // IMPORTANT: exec_env is thread-specific and must be created in each pthread
-  wasm_exec_env_t exec_env =
-      wasm_runtime_create_exec_env(module_inst, stack_size_for_exec_env);
-  if (!exec_env) {
+  // Resolve on the caller, the worker only runs the call
+  wasm_function_inst_t resolved = lookupExport(func);
+  if (!resolved) {
+    snprintf(error_buf, sizeof(error_buf), "Function '%s' not found",
+             func.name);
+    WAMR_LOG_E("%s", error_buf);
+    return false;
+  }
+
+  return dispatch(resolved, func.name, argc, argv, 0, nullptr);
+}
+
+bool WamrModule::callFunctionRaw(const WamrExportName &func, uint32_t argc,
+                                 uint32_t *argv) {
+  if (!loaded || !module_inst) {
+    snprintf(error_buf, sizeof(error_buf), "Module not loaded");
+    WAMR_LOG_E("%s", error_buf);
+    return false;
+  }
+
+  wasm_function_inst_t resolved = lookupExport(func);
+  if (!resolved) {
+    snprintf(error_buf, sizeof(error_buf), "Function '%s' not found",
+             func.name);
+    WAMR_LOG_E("%s", error_buf);
+    return false;
+  }
+
+  return invokeInternal(resolved, func.name, argc, argv);
+}
+
+WamrFunction WamrModule::getFunction(const char *func_name) {
+  WamrFunction handle;
+
+  if (!loaded || !module_inst) {
+    snprintf(error_buf, sizeof(error_buf), "Module not loaded");
+    WAMR_LOG_E("%s", error_buf);
+    return handle;
+  }
+
+  wasm_function_inst_t func = lookupFunction(func_name);
+  if (!func) {
+    snprintf(error_buf, sizeof(error_buf), "Function '%s' not found",
+             func_name);
+    WAMR_LOG_E("%s", error_buf);
+    return handle;
+  }
+
+  handle.module = this;
+  handle.func = func;
+  handle.instance_id = instance_id;
+  return handle;
+}
+
+bool WamrModule::callBatch(const char *func_name, uint32_t argc,
+                           uint32_t *argv_matrix, uint32_t count,
+                           uint32_t *failed_index) {
+  if (!loaded || !module_inst) {
+    snprintf(error_buf, sizeof(error_buf), "Module not loaded");
+    WAMR_LOG_E("%s", error_buf);
+    return false;
+  }
+
+  // Resolve on the caller so the worker only runs the batch
+  wasm_function_inst_t func = lookupFunction(func_name);
+  if (!func) {
+    snprintf(error_buf, sizeof(error_buf), "Function '%s' not found",
+             func_name);
+    WAMR_LOG_E("%s", error_buf);
+    return false;
+  }
+
+  if (count == 0) {
+    return true;
+  }
+
+  return dispatch(func, func_name, argc, argv_matrix, count, failed_index);
+}
+
+bool WamrModule::dispatch(wasm_function_inst_t func, const char *func_name,
+                          uint32_t argc, uint32_t *argv, uint32_t batch_count,
+                          uint32_t *failed_index) {
+  WasmCallContext ctx;
+  ctx.module = this;
+  ctx.func = func;
+  ctx.func_name = func_name;
+  ctx.argc = argc;
+  ctx.argv = argv;
+  ctx.batch_count = batch_count;
+  ctx.failed_index = failed_index;
+  ctx.success = false;
+
+  if (!WamrRuntime::runOnWorker(wasm_call_job, &ctx)) {
     snprintf(error_buf, sizeof(error_buf),
-             "Failed to create execution environment");
+             "Failed to start worker threads for WASM execution");
+    WAMR_LOG_E("%s", error_buf);
+    return false;
+  }
+
+  return ctx.success;
+}
+
+bool WamrModule::callFunctionInternal(const char *func_name, uint32_t argc,
+                                      uint32_t *argv) {
+  // Internal implementation - resolve name, then call
+  if (!loaded || !module_inst) {
+    snprintf(error_buf, sizeof(error_buf), "Module not loaded");
     WAMR_LOG_E("%s", error_buf);
     return false;
   }
 
   // Look up function
-  wasm_function_inst_t func =
-      wasm_runtime_lookup_function(module_inst, func_name);
+  wasm_function_inst_t func = lookupFunction(func_name);
   if (!func) {
     snprintf(error_buf, sizeof(error_buf), "Function '%s' not found",
              func_name);
     WAMR_LOG_E("%s", error_buf);
-    wasm_runtime_destroy_exec_env(exec_env);
+    return false;
+  }
+
+  return invokeInternal(func, func_name, argc, argv);
+}
+
+bool WamrModule::invokeInternal(wasm_function_inst_t func,
+                                const char *func_name, uint32_t argc,
+                                uint32_t *argv) {
+  // Get execution environment for this thread
+  // IMPORTANT: exec_env is thread-specific, each thread gets its own
+  wasm_exec_env_t exec_env = getExecEnv();
+  if (!exec_env) {
+    snprintf(error_buf, sizeof(error_buf),
+             "Failed to create execution environment");
+    WAMR_LOG_E("%s", error_buf);
     return false;
   }
 
@@ -278,9 +934,6 @@ bool WamrModule::callFunctionInternal(const char *func_name, uint32_t argc,
   // Call function
   bool success = wasm_runtime_call_wasm(exec_env, func, argc, argv);
 
-  // Clean up execution environment
-  wasm_runtime_destroy_exec_env(exec_env);
-
   if (!success) {
     const char *exception = wasm_runtime_get_exception(module_inst);
     if (exception) {
@@ -302,8 +955,302 @@ bool WamrModule::callFunctionInternal(const char *func_name, uint32_t argc,
   return true;
 }
 
+bool WamrModule::invokeBatchInternal(wasm_function_inst_t func,
+                                     const char *func_name, uint32_t argc,
+                                     uint32_t *argv_matrix, uint32_t count,
+                                     uint32_t *failed_index) {
+  wasm_exec_env_t exec_env = getExecEnv();
+  if (!exec_env) {
+    snprintf(error_buf, sizeof(error_buf),
+             "Failed to create execution environment");
+    WAMR_LOG_E("%s", error_buf);
+    return false;
+  }
+
+  WAMR_LOG_D("Calling function '%s' x%u...", func_name, count);
+
+  uint32_t failed = 0;
+  if (!wasm_runtime_call_wasm_batch(exec_env, func, argc, argv_matrix, count,
+                                    &failed)) {
+    const char *exception = wasm_runtime_get_exception(module_inst);
+    snprintf(error_buf, sizeof(error_buf), "Exception at batch index %u: %s",
+             failed, exception ? exception : "call failed");
+    WAMR_LOG_E("%s", error_buf);
+    if (failed_index) {
+      *failed_index = failed;
+    }
+    return false;
+  }
+
+  // Rows of a () -> () export may have no cells, or only params
+  if (argc > 0 && argv_matrix &&
+      wasm_func_get_result_count(func, module_inst) > 0) {
+    last_result = argv_matrix[(count - 1) * argc];
+  }
+  WAMR_LOG_D("Batch '%s' completed successfully", func_name);
+  return true;
+}
+
+wasm_function_inst_t WamrModule::lookupFunction(const char *func_name) {
+  size_t len = strlen(func_name);
+  bool cacheable = len < WAMR_FUNC_CACHE_NAME_LEN;
+
+  if (cacheable) {
+    pthread_mutex_lock(&cache_lock);
+    for (uint32_t i = 0; i < WAMR_FUNC_CACHE_SIZE; i++) {
+      if (func_cache[i].func && strcmp(func_cache[i].name, func_name) == 0) {
+        wasm_function_inst_t func = func_cache[i].func;
+        pthread_mutex_unlock(&cache_lock);
+        return func;
+      }
+    }
+    pthread_mutex_unlock(&cache_lock);
+  }
+
+  wasm_function_inst_t func =
+      wasm_runtime_lookup_function(module_inst, func_name);
+
+  if (func && cacheable) {
+    pthread_mutex_lock(&cache_lock);
+    FuncCacheEntry *entry = &func_cache[func_cache_next];
+    func_cache_next = (func_cache_next + 1) % WAMR_FUNC_CACHE_SIZE;
+    memcpy(entry->name, func_name, len + 1);
+    entry->func = func;
+    pthread_mutex_unlock(&cache_lock);
+  }
+
+  return func;
+}
+
+wasm_function_inst_t WamrModule::lookupExport(const WamrExportName &func) {
+  // First entry with the hash
+  uint32_t low = 0, high = export_hash_count;
+  while (low < high) {
+    uint32_t mid = (low + high) / 2;
+    if (export_hashes[mid].hash < func.hash) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+
+  const ExportHashEntry *match = nullptr;
+  for (uint32_t i = low;
+       i < export_hash_count && export_hashes[i].hash == func.hash; i++) {
+    if (export_hashes[i].length != func.length) {
+      continue;
+    }
+    if (match) {
+      // Two exports with the same hash and length, only names tell them apart
+      return lookupFunction(func.name);
+    }
+    match = &export_hashes[i];
+  }
+
+  if (!match) {
+    // Not in the table, or there is no table: the name lookup finds it if
+    // it is exported at all
+    return lookupFunction(func.name);
+  }
+
+  // A name with the hash and length of an export is that export or isn't
+  // exported at all
+  wasm_export_t export_type;
+  wasm_runtime_get_export_type(module, match->export_index, &export_type);
+  if (memcmp(export_type.name, func.name, func.length) != 0) {
+    WAMR_LOG_D("'%s' has the hash of export '%s'", func.name,
+               export_type.name);
+    return nullptr;
+  }
+
+  return wasm_runtime_get_export_function_by_index(module_inst,
+                                                   match->export_index);
+}
+
+void WamrModule::buildExportHashes() {
+  int32_t export_count = wasm_runtime_get_export_count(module);
+
+  // Indices are kept in 16 bits, larger modules use the name lookup
+  if (export_count <= 0 || export_count > UINT16_MAX) {
+    return;
+  }
+
+  export_hashes =
+      (ExportHashEntry *)malloc(sizeof(ExportHashEntry) * export_count);
+  if (!export_hashes) {
+    WAMR_LOG_D("No memory for the export hashes, using name lookups");
+    return;
+  }
+
+  for (int32_t i = 0; i < export_count; i++) {
+    wasm_export_t export_type;
+    wasm_runtime_get_export_type(module, i, &export_type);
+    size_t length = strlen(export_type.name);
+    if (export_type.kind != WASM_IMPORT_EXPORT_KIND_FUNC ||
+        length > UINT16_MAX) {
+      continue;
+    }
+
+    // Insertion sort by hash, modules export a few functions
+    ExportHashEntry entry = {wamrHashName(export_type.name),
+                             (uint16_t)length, (uint16_t)i};
+    uint32_t j = export_hash_count++;
+    while (j > 0 && export_hashes[j - 1].hash > entry.hash) {
+      export_hashes[j] = export_hashes[j - 1];
+      j--;
+    }
+    export_hashes[j] = entry;
+  }
+}
+
+wasm_exec_env_t WamrModule::getExecEnv() {
+  // Fast path: thread-local cache, no locking
+  for (uint32_t i = 0; i < WAMR_EXEC_ENV_TLS_SLOTS; i++) {
+    if (exec_env_slots[i].instance_id == instance_id) {
+      return exec_env_slots[i].exec_env;
+    }
+  }
+
+  // Slow path: find this thread's exec_env (it may have been evicted from
+  // the thread-local cache) or create it
+  pthread_t self = pthread_self();
+  wasm_exec_env_t exec_env = nullptr;
+  bool created = false;
+
+  pthread_mutex_lock(&cache_lock);
+  for (WamrExecEnvEntry *entry = exec_envs; entry; entry = entry->next) {
+    if (pthread_equal(entry->owner, self)) {
+      exec_env = entry->exec_env;
+      break;
+    }
+  }
+
+  if (!exec_env) {
+    WamrExecEnvEntry *entry = (WamrExecEnvEntry *)malloc(sizeof(*entry));
+    if (entry) {
+      exec_env =
+          wasm_runtime_create_exec_env(module_inst, stack_size_for_exec_env);
+      if (exec_env) {
+        entry->owner = self;
+        entry->exec_env = exec_env;
+        entry->next = exec_envs;
+        exec_envs = entry;
+        WAMR_LOG_D("Created exec_env for new thread (stack: %u bytes)",
+                   stack_size_for_exec_env);
+      } else {
+        free(entry);
+      }
+    }
+    created = exec_env != nullptr;
+  }
+  pthread_mutex_unlock(&cache_lock);
+
+  // Free this thread's exec_envs when it exits
+  if (created) {
+    pthread_once(&exec_env_key_once, create_exec_env_key);
+    if (exec_env_key_created) {
+      pthread_setspecific(exec_env_key, this);
+    }
+  }
+
+  if (exec_env) {
+    ExecEnvSlot *slot = &exec_env_slots[exec_env_slot_next];
+    exec_env_slot_next = (exec_env_slot_next + 1) % WAMR_EXEC_ENV_TLS_SLOTS;
+    slot->instance_id = instance_id;
+    slot->exec_env = exec_env;
+  }
+
+  return exec_env;
+}
+
+bool WamrModule::checkSignature(wasm_function_inst_t func,
+                                const char *func_name,
+                                const wasm_valkind_t *param_kinds,
+                                uint32_t param_count,
+                                const wasm_valkind_t *result_kinds,
+                                uint32_t result_count) {
+  uint32_t actual_params = wasm_func_get_param_count(func, module_inst);
+  uint32_t actual_results = wasm_func_get_result_count(func, module_inst);
+
+  if (actual_params != param_count || actual_results != result_count) {
+    snprintf(error_buf, sizeof(error_buf),
+             "Function '%s' signature mismatch: has %u params/%u results, "
+             "expected %u/%u",
+             func_name, actual_params, actual_results, param_count,
+             result_count);
+    WAMR_LOG_E("%s", error_buf);
+    return false;
+  }
+
+  // Signatures are small; bound the scratch arrays instead of allocating
+  wasm_valkind_t kinds[16];
+  if (actual_params > sizeof(kinds) || actual_results > sizeof(kinds)) {
+    snprintf(error_buf, sizeof(error_buf),
+             "Function '%s' has too many params for a typed handle",
+             func_name);
+    WAMR_LOG_E("%s", error_buf);
+    return false;
+  }
+
+  wasm_func_get_param_types(func, module_inst, kinds);
+  for (uint32_t i = 0; i < param_count; i++) {
+    if (kinds[i] != param_kinds[i]) {
+      snprintf(error_buf, sizeof(error_buf),
+               "Function '%s' signature mismatch at param %u", func_name, i);
+      WAMR_LOG_E("%s", error_buf);
+      return false;
+    }
+  }
+
+  wasm_func_get_result_types(func, module_inst, kinds);
+  for (uint32_t i = 0; i < result_count; i++) {
+    if (kinds[i] != result_kinds[i]) {
+      snprintf(error_buf, sizeof(error_buf),
+               "Function '%s' signature mismatch at result %u", func_name, i);
+      WAMR_LOG_E("%s", error_buf);
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void WamrModule::releaseCaches() {
+  pthread_mutex_lock(&cache_lock);
+  while (exec_envs) {
+    WamrExecEnvEntry *entry = exec_envs;
+    exec_envs = entry->next;
+    wasm_runtime_destroy_exec_env(entry->exec_env);
+    free(entry);
+  }
+  memset(func_cache, 0, sizeof(func_cache));
+  func_cache_next = 0;
+  pthread_mutex_unlock(&cache_lock);
+}
+
+void WamrModule::releaseExecEnvOf(pthread_t owner) {
+  pthread_mutex_lock(&cache_lock);
+  WamrExecEnvEntry **link = &exec_envs;
+  while (*link) {
+    WamrExecEnvEntry *entry = *link;
+    if (pthread_equal(entry->owner, owner)) {
+      *link = entry->next;
+      wasm_runtime_destroy_exec_env(entry->exec_env);
+      free(entry);
+    } else {
+      link = &entry->next;
+    }
+  }
+  pthread_mutex_unlock(&cache_lock);
+}
+
 void WamrModule::setThreadStackSize(size_t stack_size) {
+  if (WamrWorkerPool::isWorkerThread()) {
+    WAMR_LOG_E("Stack size can't be changed from a callFunction() worker");
+    return;
+  }
   thread_stack_size = stack_size;
+  WamrRuntime::restartWorkers();
   WAMR_LOG_D("Thread stack size set to %u bytes", stack_size);
 }
 
@@ -313,20 +1260,252 @@ const char *WamrModule::getError() {
   return error_buf[0] != '\0' ? error_buf : nullptr;
 }
 
+bool WamrModule::reset() {
+  if (!loaded) {
+    snprintf(error_buf, sizeof(error_buf), "Module not loaded");
+    WAMR_LOG_E("%s", error_buf);
+    return false;
+  }
+  if (isAot()) {
+    snprintf(error_buf, sizeof(error_buf), "AOT modules can't be reset");
+    WAMR_LOG_E("%s", error_buf);
+    return false;
+  }
+
+  if (!wasm_runtime_reset_instance(module_inst, error_buf,
+                                   sizeof(error_buf))) {
+    unloadAfterError("Failed to reset instance");
+    return false;
+  }
+
+  memset(error_buf, 0, sizeof(error_buf));
+  last_result = 0;
+  return true;
+}
+
+void WamrModule::unloadAfterError(const char *what) {
+  // The instance may be half initialized, don't let it run again
+  char error[sizeof(error_buf)];
+  memcpy(error, error_buf, sizeof(error));
+  WAMR_LOG_E("%s: %s", what, error);
+  unload();
+  memcpy(error_buf, error, sizeof(error_buf));
+}
+
+bool WamrModule::takeSnapshot() {
+  if (!loaded) {
+    snprintf(error_buf, sizeof(error_buf), "Module not loaded");
+    WAMR_LOG_E("%s", error_buf);
+    return false;
+  }
+  // Clones restore to the snapshot they were made from
+  if (share_refs && __atomic_load_n(share_refs, __ATOMIC_ACQUIRE) > 1) {
+    snprintf(error_buf, sizeof(error_buf),
+             "Snapshot is shared with clones of this module");
+    WAMR_LOG_E("%s", error_buf);
+    return false;
+  }
+
+  wasm_instance_snapshot_t new_snapshot = wasm_runtime_snapshot_instance(
+      module_inst, error_buf, sizeof(error_buf));
+  if (!new_snapshot) {
+    WAMR_LOG_E("Failed to snapshot instance: %s", error_buf);
+    return false;
+  }
+
+  if (snapshot) {
+    wasm_runtime_destroy_snapshot(snapshot);
+  }
+  snapshot = new_snapshot;
+  WAMR_LOG_D("Snapshot taken (%u bytes)", getSnapshotSize());
+  return true;
+}
+
+uint32_t WamrModule::getSnapshotSize() const {
+  return snapshot ? (uint32_t)wasm_runtime_get_snapshot_size(snapshot) : 0;
+}
+
+bool WamrModule::restoreSnapshot() {
+  if (!loaded || !snapshot) {
+    snprintf(error_buf, sizeof(error_buf), "No snapshot to restore");
+    WAMR_LOG_E("%s", error_buf);
+    return false;
+  }
+
+  if (!wasm_runtime_restore_instance(module_inst, snapshot, error_buf,
+                                     sizeof(error_buf))) {
+    unloadAfterError("Failed to restore snapshot");
+    return false;
+  }
+
+  memset(error_buf, 0, sizeof(error_buf));
+  last_result = 0;
+  return true;
+}
+
+bool WamrModule::cloneFrom(WamrModule &source, uint32_t stack_size) {
+  if (&source == this) {
+    snprintf(error_buf, sizeof(error_buf), "Module can't clone itself");
+    WAMR_LOG_E("%s", error_buf);
+    return false;
+  }
+  if (!source.loaded || !source.snapshot) {
+    snprintf(error_buf, sizeof(error_buf), "Source module has no snapshot");
+    WAMR_LOG_E("%s", error_buf);
+    return false;
+  }
+
+  unload();
+
+  if (stack_size == 0) {
+    stack_size = source.stack_size_for_exec_env;
+  }
+
+  module_inst = wasm_runtime_instantiate_from_snapshot(
+      source.module, source.snapshot, stack_size, error_buf,
+      sizeof(error_buf));
+  if (!module_inst) {
+    WAMR_LOG_E("Failed to instantiate from snapshot: %s", error_buf);
+    return false;
+  }
+
+  if (!source.share_refs) {
+    source.share_refs = (uint32_t *)malloc(sizeof(uint32_t));
+    if (!source.share_refs) {
+      snprintf(error_buf, sizeof(error_buf), "Out of memory");
+      WAMR_LOG_E("%s", error_buf);
+      wasm_runtime_deinstantiate(module_inst);
+      module_inst = nullptr;
+      return false;
+    }
+    *source.share_refs = 1;
+  }
+  __atomic_add_fetch(source.share_refs, 1, __ATOMIC_RELAXED);
+  share_refs = source.share_refs;
+  module = source.module;
+  snapshot = source.snapshot;
+
+  stack_size_for_exec_env = stack_size;
+  instance_id = __atomic_add_fetch(&next_instance_id, 1, __ATOMIC_RELAXED);
+  if (instance_id == 0) {
+    instance_id = __atomic_add_fetch(&next_instance_id, 1, __ATOMIC_RELAXED);
+  }
+
+  bytes_saved = source.bytes_saved;
+  code_cache_used = source.code_cache_used;
+  buildExportHashes();
+  loaded = true;
+  WAMR_LOG_D("Module cloned from snapshot");
+  return true;
+}
+
 void WamrModule::unload() {
-  // Note: exec_env is now created/destroyed per call, not stored
+  // exec_envs of all threads belong to the instance, free them first
+  releaseCaches();
+  instance_id = 0;
+  free(export_hashes);
+  export_hashes = nullptr;
+  export_hash_count = 0;
 
   if (module_inst) {
     wasm_runtime_deinstantiate(module_inst);
     module_inst = nullptr;
   }
 
+  // A shared module and snapshot are freed by their last user
+  bool last_user = true;
+  if (share_refs) {
+    last_user = __atomic_sub_fetch(share_refs, 1, __ATOMIC_ACQ_REL) == 0;
+    if (last_user) {
+      free(share_refs);
+    }
+    share_refs = nullptr;
+  }
+
+  if (snapshot) {
+    if (last_user) {
+      wasm_runtime_destroy_snapshot(snapshot);
+    }
+    snapshot = nullptr;
+  }
+
   if (module) {
-    wasm_runtime_unload(module);
+    if (last_user) {
+      wasm_runtime_unload(module);
+    }
     module = nullptr;
   }
 
+  // The image is unmapped only after the module that executes from it
+  if (xip_map) {
+#ifdef WAMR_HOST_BUILD
+    munmap(const_cast<void *>(xip_map), xip_map_size);
+#else
+    spi_flash_munmap(xip_map_handle);
+#endif
+    xip_map = nullptr;
+    xip_map_size = 0;
+    xip_map_handle = 0;
+  }
+
   loaded = false;
+  xip = false;
+  code_cache_used = false;
+  bytes_saved = 0;
   stack_size_for_exec_env = 0;
   memset(error_buf, 0, sizeof(error_buf));
 }
+
+// ============================================================================
+// WamrFunction Implementation
+// ============================================================================
+
+bool WamrFunction::isValid() const {
+  return module && func && module->loaded &&
+         module->instance_id == instance_id;
+}
+
+bool WamrFunction::call(uint32_t argc, uint32_t *argv) {
+  if (!isValid()) {
+    if (module) {
+      snprintf(module->error_buf, sizeof(module->error_buf),
+               "Function handle is not valid");
+      WAMR_LOG_E("%s", module->error_buf);
+    }
+    return false;
+  }
+
+  return module->dispatch(func, "<handle>", argc, argv, 0, nullptr);
+}
+
+bool WamrFunction::callBatch(uint32_t argc, uint32_t *argv_matrix,
+                             uint32_t count, uint32_t *failed_index) {
+  if (!isValid()) {
+    if (module) {
+      snprintf(module->error_buf, sizeof(module->error_buf),
+               "Function handle is not valid");
+      WAMR_LOG_E("%s", module->error_buf);
+    }
+    return false;
+  }
+
+  if (count == 0) {
+    return true;
+  }
+
+  return module->dispatch(func, "<handle>", argc, argv_matrix, count,
+                          failed_index);
+}
+
+bool WamrFunction::callRaw(uint32_t argc, uint32_t *argv) {
+  if (!isValid()) {
+    if (module) {
+      snprintf(module->error_buf, sizeof(module->error_buf),
+               "Function handle is not valid");
+      WAMR_LOG_E("%s", module->error_buf);
+    }
+    return false;
+  }
+
+  return module->invokeInternal(func, "<handle>", argc, argv);
+}
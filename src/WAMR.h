@@ -11,8 +11,11 @@
 #define _WAMR_ARDUINO_H
 
 #include <Arduino.h>
+#include <pthread.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <string.h>
+#include <type_traits>
 
 // Include WAMR build configuration
 #include "wamr/build_config.h"
@@ -60,6 +63,98 @@
 #define WAMR_DEFAULT_STACK_SIZE (16 * 1024)     // 16KB stack
 #define WAMR_DEFAULT_HEAP_POOL (128 * 1024)     // 128KB pool for runtime
 #define WAMR_DEFAULT_THREAD_STACK (32 * 1024)   // 32KB pthread stack for safe calls
+#define WAMR_DEFAULT_WORKER_COUNT 1             // Worker threads for safe calls
+#define WAMR_FUNC_CACHE_SIZE 4                  // Memoized name lookups per module
+#define WAMR_FUNC_CACHE_NAME_LEN 32             // Longest cached function name
+#define WAMR_EXEC_ENV_TLS_SLOTS 4               // Cached exec_envs per thread
+#define WAMR_DEFAULT_FAST_CLASSES                                             \
+  (MEM_CLASS_BIT(Mem_Class_Stack) | MEM_CLASS_BIT(Mem_Class_Code) |           \
+   MEM_CLASS_BIT(Mem_Class_Consts) | MEM_CLASS_BIT(Mem_Class_Instance))
+
+class WamrModule;
+struct WamrExecEnvEntry;
+template <typename Signature> class WamrTypedFunction;
+
+/**
+ * FNV-1a hash of an export name, usable in constant expressions
+ */
+constexpr uint32_t wamrHashName(const char *name,
+                                uint32_t hash = 2166136261u) {
+  return *name ? wamrHashName(name + 1, (hash ^ (uint8_t)*name) * 16777619u)
+               : hash;
+}
+
+/**
+ * Export name hashed at compile time, made with WAMR_EXPORT()
+ */
+struct WamrExportName {
+  const char *name;  // Compared with the export the hash finds
+  uint32_t hash;     // wamrHashName(name)
+  uint32_t length;   // strlen(name)
+};
+
+/**
+ * Name of an exported function, hashed at compile time
+ *
+ * WamrModule::callFunction(WAMR_EXPORT("update"), ...) finds the export by
+ * the hash and length of its name, then compares the name with that one
+ * export only. name must be a string literal.
+ */
+#define WAMR_EXPORT(name)                                                     \
+  (WamrExportName{                                                            \
+      (name), std::integral_constant<uint32_t, wamrHashName(name)>::value,    \
+      (uint32_t)(sizeof(name) - 1)})
+
+/**
+ * Resolved WASM function handle
+ *
+ * Obtained from WamrModule::getFunction(). The export is looked up once;
+ * calls through the handle skip the name lookup entirely. A handle becomes
+ * invalid when its module is unloaded or reloaded.
+ */
+class WamrFunction {
+public:
+  WamrFunction() : module(nullptr), func(nullptr), instance_id(0) {}
+
+  /**
+   * Check if the handle refers to a function of a currently loaded module
+   */
+  bool isValid() const;
+
+  /**
+   * Call the function (SAFE - runs on a worker thread)
+   *
+   * Same semantics as WamrModule::callFunction().
+   */
+  bool call(uint32_t argc = 0, uint32_t *argv = nullptr);
+
+  /**
+   * Call the function directly (RAW - must be in pthread context)
+   *
+   * Same semantics as WamrModule::callFunctionRaw().
+   */
+  bool callRaw(uint32_t argc = 0, uint32_t *argv = nullptr);
+
+  /**
+   * Call the function once per argument row (SAFE - runs on a worker thread)
+   *
+   * Same semantics as WamrModule::callBatch().
+   */
+  bool callBatch(uint32_t argc, uint32_t *argv_matrix, uint32_t count,
+                 uint32_t *failed_index = nullptr);
+
+  /**
+   * Get the underlying WAMR function instance (for advanced usage)
+   */
+  wasm_function_inst_t getHandle() const { return func; }
+
+private:
+  friend class WamrModule;
+
+  WamrModule *module;
+  wasm_function_inst_t func;
+  uint32_t instance_id;
+};
 
 /**
  * WAMR Module wrapper class
@@ -79,16 +174,185 @@ public:
    * @param stack_size Stack size for WASM execution (default: 16KB)
    * @param heap_size Heap size for WASM module (default: 64KB)
    * @return true if successful, false otherwise
+   *
+   * Note: AOT modules are detected by their magic number and loaded as
+   *       precompiled code, see loadAot(). An AOT buffer must be 4-byte
+   *       aligned; bytecode may be at any address.
+   * Note: The buffer is never written and data segments are used in place,
+   *       so it can live in flash (a const array) but must stay valid until
+   *       unload(). See getBytesSaved()
    */
   bool load(const uint8_t *wasm_bytes, uint32_t size,
             uint32_t stack_size = WAMR_DEFAULT_STACK_SIZE,
             uint32_t heap_size = WAMR_DEFAULT_HEAP_SIZE);
 
+  /**
+   * Load a WASM module, restoring its compiled code from a code cache
+   *
+   * Same as load(), but the interpreter code of every function is copied
+   * from a cache made by buildCodeCache() instead of being validated and
+   * lowered again, which is most of the load time. A cache that doesn't
+   * match the binary or this build of the runtime is ignored and the module
+   * is loaded as usual, see isCodeCacheUsed().
+   *
+   * @param wasm_bytes Pointer to WASM binary data
+   * @param size Size of WASM binary in bytes
+   * @param code_cache Cache from buildCodeCache(), only read while loading
+   * @param cache_size Size of the cache in bytes
+   * @param stack_size Stack size for WASM execution (default: 16KB)
+   * @param heap_size Heap size for WASM module (default: 64KB)
+   * @return true if successful, false otherwise
+   *
+   * Note: The cache is trusted like an AOT file, only use caches built on
+   *       the device or by the same firmware
+   */
+  bool loadCached(const uint8_t *wasm_bytes, uint32_t size,
+                  const uint8_t *code_cache, uint32_t cache_size,
+                  uint32_t stack_size = WAMR_DEFAULT_STACK_SIZE,
+                  uint32_t heap_size = WAMR_DEFAULT_HEAP_SIZE);
+
+  /**
+   * Build the code cache of a WASM module for loadCached()
+   *
+   * Store the cache (e.g. in a file or flash partition) once and pass it
+   * to loadCached() on later boots.
+   *
+   * @param wasm_bytes Pointer to WASM binary data
+   * @param size Size of WASM binary in bytes
+   * @param cache_size Receives the size of the cache in bytes
+   * @return Cache allocated with malloc(), release it with free(); nullptr
+   *         on error or for AOT modules
+   */
+  static uint8_t *buildCodeCache(const uint8_t *wasm_bytes, uint32_t size,
+                                 uint32_t *cache_size);
+
+  /**
+   * Check if the loaded module's code was restored from a code cache
+   */
+  bool isCodeCacheUsed() const { return loaded && code_cache_used; }
+
+  /**
+   * Load a WASM module, lowering each function on its first call
+   *
+   * Same as load(), but only the module structure is validated while
+   * loading. Each function body is validated and lowered to interpreter
+   * code the first time it is called, so functions that are never called
+   * cost nothing. A function that fails validation makes its first call
+   * fail with the validation error instead of failing the load.
+   *
+   * @param wasm_bytes Pointer to WASM binary data
+   * @param size Size of WASM binary in bytes
+   * @param stack_size Stack size for WASM execution (default: 16KB)
+   * @param heap_size Heap size for WASM module (default: 64KB)
+   * @return true if successful, false otherwise
+   *
+   * Note: The memory stays growable even if no function uses memory.grow,
+   *       since that is only known once every function is lowered
+   */
+  bool loadLazy(const uint8_t *wasm_bytes, uint32_t size,
+                uint32_t stack_size = WAMR_DEFAULT_STACK_SIZE,
+                uint32_t heap_size = WAMR_DEFAULT_HEAP_SIZE);
+
+  /**
+   * Get the cost of lazy lowering so far, see loadLazy()
+   *
+   * @param lowered_count Receives the number of functions lowered on call
+   * @param lowering_time_us Receives the time spent lowering them, which
+   *        is not part of the load time
+   * @return true if the module was loaded with loadLazy()
+   */
+  bool getLazyLoweringStats(uint32_t *lowered_count,
+                            uint64_t *lowering_time_us) const;
+
+  /**
+   * Load a precompiled AOT module produced by wamrc
+   *
+   * Same as load(), but fails unless the buffer is an AOT module. The AOT
+   * file must be compiled for this chip (e.g. wamrc --target=xtensa
+   * --cpu=esp32s3), otherwise loading fails with a target mismatch error.
+   *
+   * @param aot_bytes Pointer to AOT file data
+   * @param size Size of AOT file in bytes
+   * @param stack_size Stack size for execution (default: 16KB)
+   * @param heap_size Heap size for the module (default: 64KB)
+   * @return true if successful, false otherwise
+   *
+   * Note: Function code is copied to executable RAM (IRAM on ESP32)
+   * Note: The buffer must be 4-byte aligned, e.g. a const array declared
+   *       with __attribute__((aligned(4)))
+   */
+  bool loadAot(const uint8_t *aot_bytes, uint32_t size,
+               uint32_t stack_size = WAMR_DEFAULT_STACK_SIZE,
+               uint32_t heap_size = WAMR_DEFAULT_HEAP_SIZE);
+
+  /**
+   * Check if a buffer holds an AOT module (starts with AOT_MAGIC_NUMBER)
+   */
+  static bool isAotBinary(const uint8_t *bytes, uint32_t size);
+
+  /**
+   * Check if the loaded module runs precompiled AOT code
+   */
+  bool isAot() const;
+
+  /**
+   * Load an XIP (execute-in-place) AOT module without copying its code
+   *
+   * The image must be an AOT file compiled with wamrc --xip and must stay
+   * mapped, readable and executable until unload(). Only data, globals and
+   * the function pointer table are allocated in RAM. The image must be
+   * 4-byte aligned; flash mappings and mmap() always are.
+   *
+   * @param image Pointer to the mapped XIP AOT file
+   * @param size Size of the AOT file in bytes
+   * @param stack_size Stack size for execution (default: 16KB)
+   * @param heap_size Heap size for the module (default: 64KB)
+   * @return true if successful, false otherwise
+   */
+  bool loadXip(const uint8_t *image, uint32_t size,
+               uint32_t stack_size = WAMR_DEFAULT_STACK_SIZE,
+               uint32_t heap_size = WAMR_DEFAULT_HEAP_SIZE);
+
+#ifdef WAMR_HOST_BUILD
+  /**
+   * Map an XIP AOT file read-only and executable, then loadXip() it
+   *
+   * The mapping is released by unload().
+   */
+  bool loadXipFile(const char *path,
+                   uint32_t stack_size = WAMR_DEFAULT_STACK_SIZE,
+                   uint32_t heap_size = WAMR_DEFAULT_HEAP_SIZE);
+#else
+  /**
+   * Map a flash data partition holding an XIP AOT file, then loadXip() it
+   *
+   * The partition is mapped through the instruction bus, so the code runs
+   * straight from flash. Flash it with e.g.
+   * `esptool.py write_flash <offset> module.aot`. The mapping is released
+   * by unload().
+   *
+   * @param partition_label Label of the data partition in partitions.csv
+   */
+  bool loadXipPartition(const char *partition_label,
+                        uint32_t stack_size = WAMR_DEFAULT_STACK_SIZE,
+                        uint32_t heap_size = WAMR_DEFAULT_HEAP_SIZE);
+#endif
+
+  /**
+   * Check if a buffer holds an XIP AOT module (wamrc --xip)
+   */
+  static bool isXipBinary(const uint8_t *bytes, uint32_t size);
+
+  /**
+   * Check if the loaded module executes in place from its image
+   */
+  bool isXip() const { return loaded && xip; }
+
   /**
    * Call a WASM function by name (SAFE - pthread wrapped)
    *
    * This is the recommended method for calling WASM functions from Arduino code.
-   * It automatically wraps the call in a pthread context, which is required by WAMR.
+   * It runs the call on a runtime-owned pthread worker, which is required by WAMR.
    * Safe to call from setup(), loop(), or any Arduino task.
    *
    * @param func_name Name of the exported function
@@ -97,7 +361,8 @@ public:
    * @return true if call succeeded, false otherwise
    *
    * Note: Check getError() for error details if call fails
-   * Note: Adds ~1-2ms overhead for pthread creation per call
+   * Note: Workers are started on the first call and reused afterwards, so
+   *       only a queue handoff is added compared to callFunctionRaw()
    */
   bool callFunction(const char *func_name, uint32_t argc = 0,
                     uint32_t *argv = nullptr);
@@ -120,13 +385,178 @@ public:
   bool callFunctionRaw(const char *func_name, uint32_t argc = 0,
                        uint32_t *argv = nullptr);
 
+  /**
+   * Call a WASM function by compile-time hashed name (SAFE)
+   *
+   * Same as callFunction(const char *), but the export is found by the hash
+   * and length of its name in a table built at load, so no string is
+   * hashed and only the matching export's name is compared per call.
+   *
+   * @param func Name from WAMR_EXPORT()
+   * @param argc Number of arguments
+   * @param argv Array of arguments (uint32_t values)
+   * @return true if call succeeded, false otherwise
+   *
+   * Example:
+   *   uint32_t args[2] = {1, 2};
+   *   module.callFunction(WAMR_EXPORT("add"), 2, args);
+   *
+   * Note: The one export with the hash and length of the name has its
+   *       name compared too, so a colliding name that isn't exported fails
+   *       as with callFunction(const char *)
+   */
+  bool callFunction(const WamrExportName &func, uint32_t argc = 0,
+                    uint32_t *argv = nullptr);
+
+  /**
+   * Call a WASM function by compile-time hashed name (RAW - advanced)
+   *
+   * Same as callFunctionRaw(const char *), with the lookup of
+   * callFunction(const WamrExportName &).
+   */
+  bool callFunctionRaw(const WamrExportName &func, uint32_t argc = 0,
+                       uint32_t *argv = nullptr);
+
+  /**
+   * Resolve an exported function once for repeated calls
+   *
+   * @param func_name Name of the exported function
+   * @return Function handle; check isValid() before use
+   *
+   * Example:
+   *   WamrFunction add = module.getFunction("add");
+   *   uint32_t args[2] = {1, 2};
+   *   add.call(2, args);
+   */
+  WamrFunction getFunction(const char *func_name);
+
+  /**
+   * Resolve an exported function with a typed C++ signature
+   *
+   * The signature is checked against the export once, here. Calls through
+   * the returned handle marshal arguments into a stack cell array at
+   * compile time, with no heap use and no runtime type switches.
+   *
+   * Supported types: 32/64-bit integers, float, double (and void results)
+   *
+   * @param func_name Name of the exported function
+   * @return Typed handle; isValid() is false if the function was not found
+   *         or its signature does not match (see getError())
+   *
+   * Example:
+   *   auto fib = module.getFunction<int32_t(int32_t)>("fibonacci");
+   *   int32_t result;
+   *   fib.call(result, 10);
+   */
+  template <typename Signature>
+  WamrTypedFunction<Signature> getFunction(const char *func_name);
+
+  /**
+   * Call a WASM function once per row of an argument matrix (SAFE)
+   *
+   * The whole batch is executed in a single worker dispatch with one
+   * exec_env and one function lookup, so per-call overhead is only the
+   * interpreter entry itself.
+   *
+   * @param func_name Name of the exported function
+   * @param argc Cells per row (must fit both the arguments and the result)
+   * @param argv_matrix count rows of argc cells; each row's result is
+   *                    stored in its first cell
+   * @param count Number of rows (calls)
+   * @param failed_index If not null, receives the row that trapped
+   * @return true if all calls succeeded, false otherwise
+   *
+   * Note: Stops at the first trap; later rows are left untouched
+   * Note: getResult() returns the result of the last row
+   */
+  bool callBatch(const char *func_name, uint32_t argc, uint32_t *argv_matrix,
+                 uint32_t count, uint32_t *failed_index = nullptr);
+
+  /**
+   * Reset the instance to its state right after load()
+   *
+   * Memory is zeroed and its data segments copied again, globals and
+   * tables are initialized again, the app heap is emptied, the error is
+   * cleared and the start function runs again. The allocations are kept
+   * (a memory that grew gets its initial size back), so this costs about
+   * a memset of the linear memory instead of unload() and load() to
+   * recover from a trap. Function handles stay valid.
+   *
+   * @return true if successful; on failure the module is unloaded, except
+   *         for AOT modules, which can't be reset
+   *
+   * Note: Init code run by callFunction() after load() must be run again,
+   *       see takeSnapshot() to skip it
+   * Note: Must not be called while other tasks are calling into the module
+   */
+  bool reset();
+
+  /**
+   * Snapshot the state of the instance for restoreSnapshot() and cloneFrom()
+   *
+   * Take it once the module is initialized, e.g. after calling its init
+   * export. Linear memory, app heap, globals and tables are copied, so that
+   * restoring the snapshot skips the data segments and the init code.
+   * Replaces the previous snapshot.
+   *
+   * @return true if successful, false otherwise (e.g. for AOT modules, or
+   *         while clones share the previous snapshot)
+   *
+   * Note: The snapshot is about as large as the linear memory, see
+   *       getSnapshotSize()
+   * Note: Must not be called while other tasks are calling into the module
+   */
+  bool takeSnapshot();
+
+  /**
+   * Check if the module has a snapshot, see takeSnapshot()
+   */
+  bool hasSnapshot() const { return snapshot != nullptr; }
+
+  /**
+   * Get the bytes held by the snapshot, 0 without one
+   */
+  uint32_t getSnapshotSize() const;
+
+  /**
+   * Reset the instance to its snapshot
+   *
+   * Memory, globals, tables and the app heap are copied back in place and
+   * the error is cleared, function handles stay valid. Much cheaper than
+   * unload() and load() to recover from a trap.
+   *
+   * @return true if successful; on failure the module is unloaded
+   *
+   * Note: Must not be called while other tasks are calling into the module
+   */
+  bool restoreSnapshot();
+
+  /**
+   * Load another instance of a module, in the state of its snapshot
+   *
+   * The clone shares the source's loaded module and snapshot, so neither
+   * the binary nor the init code runs again; it can restoreSnapshot() too.
+   * The source may be unloaded before its clones, the shared module is
+   * freed with the last of them.
+   *
+   * @param source Loaded module with a snapshot, see takeSnapshot()
+   * @param stack_size Stack size for WASM execution (default: the source's)
+   * @return true if successful, false otherwise
+   *
+   * Note: The source's binary must stay valid until its clones are
+   *       unloaded too
+   */
+  bool cloneFrom(WamrModule &source, uint32_t stack_size = 0);
+
   /**
    * Set the pthread stack size for safe callFunction() calls
    *
    * @param stack_size Stack size in bytes (default: 32KB)
    *
-   * Note: Must be called before any callFunction() calls
-   * Note: Applies to all WamrModule instances
+   * Note: Must not be called while other tasks are calling into WASM
+   * Note: Applies to all WamrModule instances (it sizes the worker pool)
+   * Note: Ignored when called from a native function run by
+   *       callFunction(), whose worker would have to stop itself
    */
   static void setThreadStackSize(size_t stack_size);
 
@@ -144,6 +574,12 @@ public:
    */
   const char *getError();
 
+  /**
+   * Get the number of data segment bytes the loaded module references in
+   * the load buffer instead of copying them to RAM (0 for AOT modules)
+   */
+  uint32_t getBytesSaved() const { return bytes_saved; }
+
   /**
    * Check if module is loaded and valid
    */
@@ -160,6 +596,8 @@ public:
   wasm_module_inst_t getInstance() { return module_inst; }
 
 private:
+  friend class WamrFunction;
+
   /**
    * Internal function that performs the actual WASM call
    * Used by both callFunction() and callFunctionRaw()
@@ -167,18 +605,131 @@ private:
   bool callFunctionInternal(const char *func_name, uint32_t argc,
                              uint32_t *argv);
 
+  /**
+   * Unload after a failed reset or restore left the instance half
+   * initialized, keeping the error
+   */
+  void unloadAfterError(const char *what);
+
+  /**
+   * Load and instantiate a module, optionally with a code cache or lazily
+   */
+  bool loadModule(const uint8_t *wasm_bytes, uint32_t size,
+                  uint32_t stack_size, uint32_t heap_size,
+                  const uint8_t *code_cache, uint32_t cache_size,
+                  bool lazy_lowering = false);
+
+  /**
+   * Call a resolved function on this thread's cached exec_env
+   */
+  bool invokeInternal(wasm_function_inst_t func, const char *func_name,
+                      uint32_t argc, uint32_t *argv);
+
+  /**
+   * Call a resolved function once per row on this thread's exec_env
+   */
+  bool invokeBatchInternal(wasm_function_inst_t func, const char *func_name,
+                           uint32_t argc, uint32_t *argv_matrix,
+                           uint32_t count, uint32_t *failed_index);
+
+  /**
+   * Dispatch a call or batch to a worker thread
+   */
+  bool dispatch(wasm_function_inst_t func, const char *func_name,
+                uint32_t argc, uint32_t *argv, uint32_t batch_count,
+                uint32_t *failed_index);
+
+  /**
+   * Look up an exported function, memoizing the result by name
+   */
+  wasm_function_inst_t lookupFunction(const char *func_name);
+
+  /**
+   * Look up an exported function by the hash and length of its name
+   */
+  wasm_function_inst_t lookupExport(const WamrExportName &func);
+
+  /**
+   * Build the table of function exports by name hash for lookupExport()
+   */
+  void buildExportHashes();
+
+  /**
+   * Get the exec_env of the calling thread, creating it on first use
+   */
+  wasm_exec_env_t getExecEnv();
+
+  /**
+   * Destroy the exec_envs of all threads and forget cached lookups
+   */
+  void releaseCaches();
+
+  /**
+   * Destroy the exec_env of one thread
+   */
+  void releaseExecEnvOf(pthread_t owner);
+
+  /**
+   * Check an export's WASM signature against expected value kinds
+   */
+  bool checkSignature(wasm_function_inst_t func, const char *func_name,
+                      const wasm_valkind_t *param_kinds, uint32_t param_count,
+                      const wasm_valkind_t *result_kinds,
+                      uint32_t result_count);
+
+  struct FuncCacheEntry {
+    char name[WAMR_FUNC_CACHE_NAME_LEN];
+    wasm_function_inst_t func;
+  };
+
+  // A function export by the hash of its name. export_index is the same for
+  // every instance of the module, see wasm_runtime_get_export_index()
+  struct ExportHashEntry {
+    uint32_t hash;
+    uint16_t length;
+    uint16_t export_index;
+  };
+
   wasm_module_t module;
   wasm_module_inst_t module_inst;
   uint32_t stack_size_for_exec_env;  // Store stack size for exec_env creation
+  uint32_t instance_id;              // Unique per load(), 0 when unloaded
   char error_buf[128];
   uint32_t last_result;
+  uint32_t bytes_saved;              // Data segment bytes used in place
   bool loaded;
+  bool xip;                          // Code executes from the load image
+  bool code_cache_used;              // Code restored by loadCached()
+
+  // Snapshot from takeSnapshot(). Once cloned, the module and the snapshot
+  // are shared and freed by the last unload(), share_refs counts the users.
+  wasm_instance_snapshot_t snapshot;
+  uint32_t *share_refs;
+
+  // Image mapped by loadXipFile()/loadXipPartition(), released on unload()
+  const void *xip_map;
+  uint32_t xip_map_size;
+  uint32_t xip_map_handle;           // esp_partition_mmap_handle_t on ESP32
+
+  // exec_envs created for this instance, one per calling thread
+  WamrExecEnvEntry *exec_envs;
+  FuncCacheEntry func_cache[WAMR_FUNC_CACHE_SIZE];
+  uint32_t func_cache_next;
+
+  // Function exports sorted by hash, built at load, nullptr if that failed
+  ExportHashEntry *export_hashes;
+  uint32_t export_hash_count;
+  pthread_mutex_t cache_lock;  // Guards exec_envs and func_cache
+  WamrModule *next_module;     // In the list of all modules, see WAMR.cpp
 
   // Static configuration for pthread wrapper
   static size_t thread_stack_size;
+  static uint32_t next_instance_id;
+  friend class WamrRuntime;
+  template <typename Signature> friend class WamrTypedFunction;
 
-  // Friend function for pthread wrapper
-  friend void *wasm_thread_wrapper(void *arg);
+  // Friend function for worker pool jobs
+  friend void wasm_call_job(void *arg);
 };
 
 /**
@@ -193,9 +744,13 @@ public:
    * Initialize WAMR runtime
    *
    * @param heap_pool_size Size of global heap pool for runtime (default: 128KB)
+   * @param allocator Allocator managing the pool: Pool_Allocator_EMS (the
+   *        default) or Pool_Allocator_TLSF, whose malloc/free take bounded
+   *        time, for tasks with deadlines
    * @return true if initialization successful
    */
-  static bool begin(uint32_t heap_pool_size = WAMR_DEFAULT_HEAP_POOL);
+  static bool begin(uint32_t heap_pool_size = WAMR_DEFAULT_HEAP_POOL,
+                    pool_allocator_type_t allocator = Pool_Allocator_Default);
 
   /**
    * Shutdown WAMR runtime and free all resources
@@ -217,10 +772,293 @@ public:
    */
   static void printMemoryUsage();
 
+  /**
+   * Set the number of worker threads used by WamrModule::callFunction()
+   *
+   * @param count Number of workers (1-4, default: 1)
+   *
+   * Note: Must not be called while other tasks are calling into WASM
+   * Note: Use more than one worker only if several Arduino tasks call
+   *       into WASM concurrently
+   * Note: Ignored when called from a native function run by
+   *       callFunction(), whose worker would have to stop itself
+   */
+  static void setWorkerCount(uint32_t count);
+
+  /**
+   * Get the statistics of the per-thread allocation caches
+   *
+   * Small runtime allocations are served from a cache of the calling
+   * thread, which only takes the heap lock to refill or flush it in
+   * batches. Counts of each thread are added in batches too, so they may
+   * lag by a few hundred allocations.
+   *
+   * @param hits Receives the allocations served from a cache
+   * @param misses Receives the allocations that refilled a cache
+   * @param bytes_held Receives the bytes held in caches, which count as
+   *        used in the heap statistics
+   * @return false if the caches are disabled or the runtime isn't running
+   */
+  static bool getAllocCacheStats(uint64_t *hits, uint64_t *misses,
+                                 uint32_t *bytes_held);
+
+  /**
+   * Return the calling thread's cached blocks to the heap
+   *
+   * Call this from a task that used WASM before it deletes itself, or its
+   * cache is only reclaimed by end(). Worker threads do this on their own.
+   */
+  static void releaseThreadCache();
+
+  /**
+   * Free the calling thread's exec_envs in all modules
+   *
+   * Each holds a WASM stack. They are freed when the thread exits, or
+   * by unload(); call this from a thread that stops calling into WASM but
+   * keeps running. Also releases the thread's cache, see
+   * releaseThreadCache().
+   */
+  static void releaseThreadExecEnvs();
+
+  /**
+   * Give the runtime a second pool in internal SRAM for its hot objects
+   *
+   * begin() puts its pool in PSRAM when the board has some, where the
+   * interpreter's stacks, code and globals are slow to reach. With a fast
+   * pool, the blocks of the classes in fast_classes come from internal
+   * SRAM, and from the main pool once the fast pool is full. Linear
+   * memories then come from one of the pools too, instead of the system
+   * heap, so size the pool that holds them for their pages.
+   *
+   * @param fast_pool_size Size of the fast pool, 0 for none (the default)
+   * @param fast_classes MEM_CLASS_BIT() of each mem_class_t placed in it
+   *        (default: exec_env stacks, lowered code, constants and module
+   *        instances)
+   *
+   * Note: Takes effect at the next begin()
+   */
+  static void setMemoryPlacement(
+      uint32_t fast_pool_size,
+      uint32_t fast_classes = WAMR_DEFAULT_FAST_CLASSES);
+
+  /**
+   * Get the usage of the runtime pools
+   *
+   * Blocks held in the per-thread allocation caches count as used.
+   *
+   * @param main_info Receives the main pool's usage
+   * @param fast_info Receives the fast pool's usage, zeroed without one
+   * @return false if the runtime isn't running
+   */
+  static bool getPoolInfo(mem_alloc_info_t *main_info,
+                          mem_alloc_info_t *fast_info);
+
 private:
+  friend class WamrModule;
+  friend class WamrFunction;
+
+  /**
+   * Run fn(arg) on a pool worker, starting the pool on first use
+   */
+  static bool runOnWorker(void (*fn)(void *arg), void *arg);
+
+  /**
+   * Stop the workers so the next call restarts them with new settings
+   */
+  static void restartWorkers();
+
+  static uint32_t worker_count;
   static bool initialized;
   static char *global_heap_buf;
+  static char *fast_heap_buf;
+  static uint32_t fast_pool_size;
+  static uint32_t fast_classes;
   static const char *error_msg;
 };
 
+// ============================================================================
+// Typed function handles
+// ============================================================================
+
+/**
+ * Mapping of C++ argument/result types to WASM value kinds
+ *
+ * Only specialized for types with a direct WASM equivalent; using any
+ * other type in a WamrTypedFunction signature fails to compile.
+ */
+template <typename T, typename Enable = void> struct WamrValueTraits;
+
+template <typename T>
+struct WamrValueTraits<T, typename std::enable_if<std::is_integral<T>::value &&
+                                                  sizeof(T) == 4>::type> {
+  static constexpr wasm_valkind_t kind = WASM_I32;
+  static constexpr uint32_t cells = 1;
+};
+
+template <typename T>
+struct WamrValueTraits<T, typename std::enable_if<std::is_integral<T>::value &&
+                                                  sizeof(T) == 8>::type> {
+  static constexpr wasm_valkind_t kind = WASM_I64;
+  static constexpr uint32_t cells = 2;
+};
+
+template <> struct WamrValueTraits<float> {
+  static constexpr wasm_valkind_t kind = WASM_F32;
+  static constexpr uint32_t cells = 1;
+};
+
+template <> struct WamrValueTraits<double> {
+  static constexpr wasm_valkind_t kind = WASM_F64;
+  static constexpr uint32_t cells = 2;
+};
+
+// Total cells occupied by a list of values
+template <typename... Ts> struct WamrCellCount;
+
+template <> struct WamrCellCount<> {
+  static constexpr uint32_t value = 0;
+};
+
+template <typename T, typename... Ts> struct WamrCellCount<T, Ts...> {
+  static constexpr uint32_t value =
+      WamrValueTraits<T>::cells + WamrCellCount<Ts...>::value;
+};
+
+// Copy arguments into consecutive cells (unrolled at compile time)
+inline void wamr_pack_cells(uint32_t *) {}
+
+template <typename T, typename... Ts>
+inline void wamr_pack_cells(uint32_t *cells, T value, Ts... rest) {
+  memcpy(cells, &value, sizeof(T));
+  wamr_pack_cells(cells + WamrValueTraits<T>::cells, rest...);
+}
+
+/**
+ * Shared implementation of typed function handles
+ */
+template <uint32_t ResultCells, typename... Args> class WamrTypedFunctionBase {
+public:
+  static constexpr uint32_t param_count = sizeof...(Args);
+  static constexpr uint32_t param_cells = WamrCellCount<Args...>::value;
+  static constexpr uint32_t cell_count =
+      param_cells > ResultCells ? (param_cells > 0 ? param_cells : 1)
+                                : (ResultCells > 0 ? ResultCells : 1);
+
+  /**
+   * Check if the handle refers to a function of a currently loaded module
+   */
+  bool isValid() const { return handle.isValid(); }
+
+  /**
+   * Get the untyped handle
+   */
+  const WamrFunction &untyped() const { return handle; }
+
+protected:
+  template <typename Signature> friend class WamrTypedFunction;
+  friend class WamrModule;
+
+  // Expected parameter kinds; one spare slot so the array is never empty
+  static void paramKinds(wasm_valkind_t *out) {
+    const wasm_valkind_t kinds[] = {WamrValueTraits<Args>::kind..., WASM_I32};
+    memcpy(out, kinds, param_count);
+  }
+
+  bool invoke(uint32_t *cells, bool raw, Args... args) {
+    wamr_pack_cells(cells, args...);
+    return raw ? handle.callRaw(cell_count, cells)
+               : handle.call(cell_count, cells);
+  }
+
+  WamrFunction handle;
+};
+
+/**
+ * Typed WASM function handle
+ *
+ * Obtained from WamrModule::getFunction<R(Args...)>(). Arguments are
+ * packed into a stack-allocated cell array sized at compile time.
+ */
+template <typename R, typename... Args>
+class WamrTypedFunction<R(Args...)>
+    : public WamrTypedFunctionBase<WamrValueTraits<R>::cells, Args...> {
+  typedef WamrTypedFunctionBase<WamrValueTraits<R>::cells, Args...> Base;
+
+public:
+  static constexpr uint32_t result_count = 1;
+  static constexpr wasm_valkind_t result_kind = WamrValueTraits<R>::kind;
+
+  /**
+   * Call the function (SAFE - runs on a worker thread)
+   *
+   * @param result Receives the return value
+   * @return true if call succeeded (see WamrModule::getError() otherwise)
+   */
+  bool call(R &result, Args... args) { return run(result, false, args...); }
+
+  /**
+   * Call the function directly (RAW - must be in pthread context)
+   */
+  bool callRaw(R &result, Args... args) { return run(result, true, args...); }
+
+private:
+  bool run(R &result, bool raw, Args... args) {
+    uint32_t cells[Base::cell_count];
+    if (!this->invoke(cells, raw, args...)) {
+      return false;
+    }
+    memcpy(&result, cells, sizeof(R));
+    return true;
+  }
+};
+
+/**
+ * Typed WASM function handle for functions without a result
+ */
+template <typename... Args>
+class WamrTypedFunction<void(Args...)>
+    : public WamrTypedFunctionBase<0, Args...> {
+  typedef WamrTypedFunctionBase<0, Args...> Base;
+
+public:
+  static constexpr uint32_t result_count = 0;
+  static constexpr wasm_valkind_t result_kind = WASM_I32;  // unused
+
+  /**
+   * Call the function (SAFE - runs on a worker thread)
+   */
+  bool call(Args... args) {
+    uint32_t cells[Base::cell_count];
+    return this->invoke(cells, false, args...);
+  }
+
+  /**
+   * Call the function directly (RAW - must be in pthread context)
+   */
+  bool callRaw(Args... args) {
+    uint32_t cells[Base::cell_count];
+    return this->invoke(cells, true, args...);
+  }
+};
+
+template <typename Signature>
+WamrTypedFunction<Signature> WamrModule::getFunction(const char *func_name) {
+  WamrTypedFunction<Signature> typed;
+  WamrFunction handle = getFunction(func_name);
+  if (!handle.isValid()) {
+    return typed;
+  }
+
+  typedef WamrTypedFunction<Signature> Typed;
+  wasm_valkind_t param_kinds[Typed::param_count + 1];
+  wasm_valkind_t result_kind = Typed::result_kind;
+  Typed::paramKinds(param_kinds);
+
+  if (checkSignature(handle.func, func_name, param_kinds, Typed::param_count,
+                     &result_kind, Typed::result_count)) {
+    typed.handle = handle;
+  }
+  return typed;
+}
+
 #endif /* _WAMR_ARDUINO_H */
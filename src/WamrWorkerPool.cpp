@@ -0,0 +1,165 @@
+/*
+ * WAMR Arduino Wrapper Library - Worker Thread Pool Implementation
+ *
+ * Copyright (C) 2025 WAMR-ESP32-Arduino Contributors
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "WamrWorkerPool.h"
+
+// Set in worker threads so nested run() calls execute inline instead of
+// queueing behind themselves (e.g. callFunction() from a native function)
+static __thread bool in_pool_worker = false;
+
+WamrWorkerPool::WamrWorkerPool()
+    : queue_head(0), queue_count(0), worker_count(0), stopping(false),
+      exit_hook(nullptr) {
+  pthread_mutex_init(&lock, nullptr);
+  pthread_cond_init(&job_cond, nullptr);
+  pthread_cond_init(&done_cond, nullptr);
+  pthread_cond_init(&space_cond, nullptr);
+}
+
+WamrWorkerPool::~WamrWorkerPool() {
+  stop();
+  pthread_cond_destroy(&space_cond);
+  pthread_cond_destroy(&done_cond);
+  pthread_cond_destroy(&job_cond);
+  pthread_mutex_destroy(&lock);
+}
+
+bool WamrWorkerPool::start(uint32_t count, size_t stack_size) {
+  if (worker_count > 0) {
+    return true;
+  }
+  if (count == 0 || count > WAMR_POOL_MAX_WORKERS) {
+    return false;
+  }
+
+  pthread_attr_t attr;
+  if (pthread_attr_init(&attr) != 0) {
+    return false;
+  }
+  if (pthread_attr_setstacksize(&attr, stack_size) != 0) {
+    pthread_attr_destroy(&attr);
+    return false;
+  }
+  pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_JOINABLE);
+
+  pthread_mutex_lock(&lock);
+  stopping = false;
+  for (uint32_t i = 0; i < count; i++) {
+    if (pthread_create(&workers[i], &attr, workerMain, this) != 0) {
+      break;
+    }
+    worker_count++;
+  }
+  pthread_mutex_unlock(&lock);
+  pthread_attr_destroy(&attr);
+
+  if (worker_count != count) {
+    stop();
+    return false;
+  }
+  return true;
+}
+
+bool WamrWorkerPool::stop() {
+  if (in_pool_worker) {
+    return false; // would join this thread
+  }
+
+  pthread_mutex_lock(&lock);
+  if (worker_count == 0) {
+    pthread_mutex_unlock(&lock);
+    return true;
+  }
+  stopping = true;
+  pthread_cond_broadcast(&job_cond);
+  pthread_cond_broadcast(&space_cond);
+  pthread_mutex_unlock(&lock);
+
+  // The caller serializes start() and stop(), so workers[] and
+  // worker_count don't change while joining
+  for (uint32_t i = 0; i < worker_count; i++) {
+    pthread_join(workers[i], nullptr);
+  }
+
+  pthread_mutex_lock(&lock);
+  worker_count = 0;
+  stopping = false;
+  pthread_mutex_unlock(&lock);
+  return true;
+}
+
+bool WamrWorkerPool::isWorkerThread() { return in_pool_worker; }
+
+bool WamrWorkerPool::run(void (*fn)(void *arg), void *arg) {
+  if (in_pool_worker) {
+    fn(arg);
+    return true;
+  }
+
+  WamrPoolJob job;
+  job.fn = fn;
+  job.arg = arg;
+  job.done = false;
+
+  pthread_mutex_lock(&lock);
+  if (worker_count == 0 || stopping) {
+    pthread_mutex_unlock(&lock);
+    return false;
+  }
+
+  while (queue_count == WAMR_POOL_QUEUE_LEN && !stopping) {
+    pthread_cond_wait(&space_cond, &lock);
+  }
+  if (stopping) {
+    // The workers may exit before reaching a job queued now
+    pthread_mutex_unlock(&lock);
+    return false;
+  }
+  queue[(queue_head + queue_count) % WAMR_POOL_QUEUE_LEN] = &job;
+  queue_count++;
+  pthread_cond_signal(&job_cond);
+
+  while (!job.done) {
+    pthread_cond_wait(&done_cond, &lock);
+  }
+  pthread_mutex_unlock(&lock);
+
+  return true;
+}
+
+void *WamrWorkerPool::workerMain(void *arg) {
+  WamrWorkerPool *pool = (WamrWorkerPool *)arg;
+  in_pool_worker = true;
+
+  pthread_mutex_lock(&pool->lock);
+  for (;;) {
+    while (pool->queue_count == 0 && !pool->stopping) {
+      pthread_cond_wait(&pool->job_cond, &pool->lock);
+    }
+    if (pool->queue_count == 0) {
+      break; // stopping and queue drained
+    }
+
+    WamrPoolJob *job = pool->queue[pool->queue_head];
+    pool->queue_head = (pool->queue_head + 1) % WAMR_POOL_QUEUE_LEN;
+    pool->queue_count--;
+    pthread_cond_signal(&pool->space_cond);
+    pthread_mutex_unlock(&pool->lock);
+
+    job->fn(job->arg);
+
+    pthread_mutex_lock(&pool->lock);
+    job->done = true;
+    pthread_cond_broadcast(&pool->done_cond);
+  }
+  pthread_mutex_unlock(&pool->lock);
+
+  if (pool->exit_hook) {
+    pool->exit_hook();
+  }
+  return nullptr;
+}
@@ -0,0 +1,108 @@
+/*
+ * WAMR Arduino Wrapper Library - Worker Thread Pool
+ *
+ * Copyright (C) 2025 WAMR-ESP32-Arduino Contributors
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Pool of long-lived pthread workers used by WamrModule::callFunction().
+ * WAMR must execute inside a pthread context; instead of creating and
+ * joining a thread for every call, jobs are queued to persistent workers.
+ *
+ * This file only depends on pthreads so it can also be built on the host
+ * (see tools/benchmarks).
+ */
+
+#ifndef _WAMR_WORKER_POOL_H
+#define _WAMR_WORKER_POOL_H
+
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define WAMR_POOL_MAX_WORKERS 4   // Upper bound on worker threads
+#define WAMR_POOL_QUEUE_LEN 8     // Pending jobs before submit() blocks
+
+/**
+ * Job executed by a pool worker
+ *
+ * Jobs live on the submitting thread's stack; the submitter blocks in
+ * run() until a worker has executed the job and set done.
+ */
+struct WamrPoolJob {
+  void (*fn)(void *arg);
+  void *arg;
+  bool done;
+};
+
+class WamrWorkerPool {
+public:
+  WamrWorkerPool();
+  ~WamrWorkerPool();
+
+  /**
+   * Start worker threads
+   *
+   * @param worker_count Number of workers (1..WAMR_POOL_MAX_WORKERS)
+   * @param stack_size pthread stack size for each worker in bytes
+   * @return true if all workers were started
+   */
+  bool start(uint32_t worker_count, size_t stack_size);
+
+  /**
+   * Stop all workers and wait for them to exit
+   *
+   * Pending jobs are completed before the workers exit; run() calls still
+   * waiting for a queue slot fail.
+   *
+   * @return false if called from a worker (it can't join itself), the
+   *         pool is left running
+   */
+  bool stop();
+
+  /**
+   * Check if the pool has running workers
+   */
+  bool isRunning() const { return worker_count > 0; }
+
+  /**
+   * Check if the calling thread is a pool worker, e.g. a native function
+   * called from a job
+   */
+  static bool isWorkerThread();
+
+  /**
+   * Run a job on a pool worker and wait for it to complete
+   *
+   * @param fn Function to execute in the worker's pthread context
+   * @param arg Argument passed to fn
+   * @return true if the job was executed, false if the pool is not running
+   *         or is stopped before the job could be queued
+   */
+  bool run(void (*fn)(void *arg), void *arg);
+
+  /**
+   * Set a function each worker calls just before it exits
+   *
+   * Used to release per-thread state, must be set before start().
+   */
+  void setExitHook(void (*fn)()) { exit_hook = fn; }
+
+private:
+  static void *workerMain(void *arg);
+
+  pthread_mutex_t lock;
+  pthread_cond_t job_cond;   // Signalled when a job is queued or on stop
+  pthread_cond_t done_cond;  // Signalled when a job completes
+  pthread_cond_t space_cond; // Signalled when a queue slot frees up
+
+  WamrPoolJob *queue[WAMR_POOL_QUEUE_LEN];
+  uint32_t queue_head;
+  uint32_t queue_count;
+
+  pthread_t workers[WAMR_POOL_MAX_WORKERS];
+  uint32_t worker_count;
+  bool stopping;
+  void (*exit_hook)();
+};
+
+#endif /* _WAMR_WORKER_POOL_H */
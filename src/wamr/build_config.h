@@ -9,7 +9,10 @@
 #ifndef _WAMR_BUILD_CONFIG_H
 #define _WAMR_BUILD_CONFIG_H
 
-/* Platform configuration */
+/* Platform configuration
+ * WAMR_HOST_BUILD is set by the Linux host build (CMakeLists.txt), which
+ * provides its own platform and target definitions. */
+#ifndef WAMR_HOST_BUILD
 #ifndef BH_PLATFORM_ESP_IDF
 #define BH_PLATFORM_ESP_IDF 1
 #endif
@@ -19,6 +22,14 @@
 #define BUILD_TARGET_XTENSA 1
 #endif
 
+/* XIP AOT images mapped through the instruction bus only allow aligned
+ * 32-bit loads, so the AOT loader must read them word by word
+ * (see WamrModule::loadXipPartition()). Must match library.json. */
+#ifndef WASM_ENABLE_WORD_ALIGN_READ
+#define WASM_ENABLE_WORD_ALIGN_READ 1
+#endif
+#endif /* WAMR_HOST_BUILD */
+
 /* Interpreter configuration */
 #ifndef WASM_ENABLE_INTERP
 #define WASM_ENABLE_INTERP 1
@@ -28,6 +39,12 @@
 #define WASM_ENABLE_FAST_INTERP 1
 #endif
 
+/* AOT: precompiled modules produced by wamrc are loaded alongside the
+ * interpreter (see WamrModule::loadAot()). Must match library.json. */
+#ifndef WASM_ENABLE_AOT
+#define WASM_ENABLE_AOT 1
+#endif
+
 /* Library configuration */
 #ifndef WASM_ENABLE_LIBC_BUILTIN
 #define WASM_ENABLE_LIBC_BUILTIN 1
@@ -42,6 +59,69 @@
 #define WASM_ENABLE_REF_TYPES 1
 #endif
 
+/* Per-thread allocation caches in front of the runtime heap. Off by
+   default: they slow down uncontended load/unload bursts, and the blocks
+   cached by a task that exits outside the worker pool are lost */
+#ifndef WASM_ENABLE_THREAD_ALLOC_CACHE
+#define WASM_ENABLE_THREAD_ALLOC_CACHE 0
+#endif
+
+/* TLSF allocator, selectable for the heap in WamrRuntime::begin() */
+#ifndef WASM_ENABLE_TLSF_ALLOCATOR
+#define WASM_ENABLE_TLSF_ALLOCATOR 1
+#endif
+
+/* Per-module arenas, used by WamrModule::load() */
+#ifndef WASM_ENABLE_LOAD_ARENA
+#define WASM_ENABLE_LOAD_ARENA 1
+#endif
+
+/* Fast pool for hot object classes, see WamrRuntime::setMemoryPlacement() */
+#ifndef WASM_ENABLE_MEM_PLACEMENT
+#define WASM_ENABLE_MEM_PLACEMENT 1
+#endif
+
+/* Instance snapshots, see WamrModule::takeSnapshot() */
+#ifndef WASM_ENABLE_INSTANCE_SNAPSHOT
+#define WASM_ENABLE_INSTANCE_SNAPSHOT 1
+#endif
+
+/* Instance reset, see WamrModule::reset() */
+#ifndef WASM_ENABLE_INSTANCE_RESET
+#define WASM_ENABLE_INSTANCE_RESET 1
+#endif
+
+/* Fused opcodes for common instruction sequences, and immediate constant
+   operands, in the fast interpreter */
+#ifndef WASM_ENABLE_SUPERINSTRUCTIONS
+#define WASM_ENABLE_SUPERINSTRUCTIONS 1
+#endif
+
+/* Direct calls to natives of common signatures from the interpreter */
+#ifndef WASM_ENABLE_NATIVE_TRAMPOLINES
+#define WASM_ENABLE_NATIVE_TRAMPOLINES 1
+#endif
+
+/* Resolve imports with a hash index of the registered natives rather than a
+   walk over the registrations: 8 bytes per slot on 32-bit targets, with at
+   most 3/4 of the slots used */
+#ifndef WASM_ENABLE_NATIVE_INDEX
+#define WASM_ENABLE_NATIVE_INDEX 1
+#endif
+
+/* Natives that take the wasm cells of their params, see
+   wasm_runtime_register_natives_fast() */
+#ifndef WASM_ENABLE_FAST_NATIVES
+#define WASM_ENABLE_FAST_NATIVES 1
+#endif
+
+/* Compact function metadata (see config.h): about 24 bytes and one heap
+   block less per function on 32-bit targets, for a load more per call.
+   Set to 1 on boards that load large modules into little RAM */
+#ifndef WASM_ENABLE_COMPACT_METADATA
+#define WASM_ENABLE_COMPACT_METADATA 0
+#endif
+
 /* Memory management */
 #ifndef BH_MALLOC
 #define BH_MALLOC wasm_runtime_malloc
@@ -73,7 +153,6 @@
 #endif
 
 /* Disabled features (not needed for minimal build) */
-#define WASM_ENABLE_AOT 0
 #define WASM_ENABLE_JIT 0
 #define WASM_ENABLE_LAZY_JIT 0
 #define WASM_ENABLE_LIBC_WASI 0
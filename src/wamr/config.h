@@ -65,7 +65,15 @@
 #define MEM_ALLOCATOR_TLSF 1
 
 /* Default memory allocator */
+#ifndef DEFAULT_MEM_ALLOCATOR
 #define DEFAULT_MEM_ALLOCATOR MEM_ALLOCATOR_EMS
+#endif
+
+/* Build the TLSF allocator as well, so that the runtime pool can use it
+   (see pool_allocator_type_t), it has bounded malloc/free latency */
+#ifndef WASM_ENABLE_TLSF_ALLOCATOR
+#define WASM_ENABLE_TLSF_ALLOCATOR 0
+#endif
 
 #ifndef WASM_ENABLE_INTERP
 #define WASM_ENABLE_INTERP 0
@@ -299,6 +307,12 @@
 #define WASM_ENABLE_OPCODE_COUNTER 0
 #endif
 
+/* Print the opcode counts when a call returns, if the opcode counter is
+   enabled. Otherwise they are read with wasm_runtime_get_opcode_count() */
+#ifndef WASM_ENABLE_OPCODE_COUNTER_DUMP
+#define WASM_ENABLE_OPCODE_COUNTER_DUMP 1
+#endif
+
 /* Support a module with dependency, other modules */
 #ifndef WASM_ENABLE_MULTI_MODULE
 #define WASM_ENABLE_MULTI_MODULE 0
@@ -631,6 +645,106 @@ unless used elsewhere */
 #define WASM_MEM_ALLOC_WITH_USER_DATA 0
 #endif
 
+/* Per-thread caches of small blocks in front of the pool allocator, so
+   that threads on different cores don't contend for the heap lock on
+   every wasm_runtime_malloc/free. Only used with Alloc_With_Pool. */
+#ifndef WASM_ENABLE_THREAD_ALLOC_CACHE
+#define WASM_ENABLE_THREAD_ALLOC_CACHE 0
+#endif
+
+/* Blocks cached per size class and thread, half of them are moved
+   from/to the pool at once */
+#ifndef WASM_THREAD_ALLOC_CACHE_DEPTH
+#define WASM_THREAD_ALLOC_CACHE_DEPTH 8
+#endif
+
+/* Let the wasm loader serve a module's allocations from a per-module arena
+   (LoadArgs.load_arena), freed at once when the module is unloaded */
+#ifndef WASM_ENABLE_LOAD_ARENA
+#define WASM_ENABLE_LOAD_ARENA 0
+#endif
+
+/* Smallest and largest chunks of a module arena, a module's arena has a
+   first chunk sized from the binary size and smaller chunks after it */
+#ifndef WASM_LOAD_ARENA_CHUNK_SIZE
+#define WASM_LOAD_ARENA_CHUNK_SIZE 512
+#endif
+
+#ifndef WASM_LOAD_ARENA_MAX_CHUNK_SIZE
+#define WASM_LOAD_ARENA_MAX_CHUNK_SIZE 8192
+#endif
+
+/* Chunks of the loader's scratch arena after its first one, which is
+   WASM_LOAD_ARENA_CHUNK_SIZE, sized to hold a function context */
+#ifndef WASM_LOAD_ARENA_SCRATCH_SIZE
+#define WASM_LOAD_ARENA_SCRATCH_SIZE 2048
+#endif
+
+/* Let the embedder place object classes of the runtime (exec_env stacks,
+   linear memories, lowered code, ...) in a second, faster pool
+   (MemAllocOption.pool.fast_heap_buf) */
+#ifndef WASM_ENABLE_MEM_PLACEMENT
+#define WASM_ENABLE_MEM_PLACEMENT 0
+#endif
+
+/* Snapshots of initialized interpreter instances, which instances of the
+   same module are made from or restored to, see
+   wasm_runtime_snapshot_instance() */
+#ifndef WASM_ENABLE_INSTANCE_SNAPSHOT
+#define WASM_ENABLE_INSTANCE_SNAPSHOT 0
+#elif WASM_ENABLE_INSTANCE_SNAPSHOT != 0 && WASM_ENABLE_INTERP == 0
+#error "Instance snapshots need the interpreter"
+#endif
+
+/* Resetting interpreter instances in place to their state right after
+   instantiation, see wasm_runtime_reset_instance() */
+#ifndef WASM_ENABLE_INSTANCE_RESET
+#define WASM_ENABLE_INSTANCE_RESET 0
+#elif WASM_ENABLE_INSTANCE_RESET != 0 && WASM_ENABLE_INTERP == 0
+#error "Instance reset needs the interpreter"
+#endif
+
+/* Fused fast-interpreter opcodes for common instruction sequences, and
+   i32 arithmetic taking a constant operand as an immediate, emitted by the
+   loader unless LoadArgs.no_superinstructions is set */
+#ifndef WASM_ENABLE_SUPERINSTRUCTIONS
+#define WASM_ENABLE_SUPERINSTRUCTIONS 0
+#elif WASM_ENABLE_SUPERINSTRUCTIONS != 0 && WASM_ENABLE_FAST_INTERP == 0
+#error "Superinstructions need the fast interpreter"
+#endif
+
+/* Direct calls to natives whose signature has a common shape, such as
+   "(ii)i" or "(*~)", instead of wasm_runtime_invoke_native(), see
+   wasm_native_get_call_shape() */
+#ifndef WASM_ENABLE_NATIVE_TRAMPOLINES
+#define WASM_ENABLE_NATIVE_TRAMPOLINES 0
+#elif WASM_ENABLE_NATIVE_TRAMPOLINES != 0 && WASM_ENABLE_INTERP == 0
+#error "Native trampolines need the interpreter"
+#endif
+
+/* Hash index of the registered natives by (module name, symbol), for the
+   import resolution at load time */
+#ifndef WASM_ENABLE_NATIVE_INDEX
+#define WASM_ENABLE_NATIVE_INDEX 0
+#endif
+
+/* Natives registered with wasm_runtime_register_natives_fast(), which work
+   on the wasm cells of their params, and leaf ones called without a frame */
+#ifndef WASM_ENABLE_FAST_NATIVES
+#define WASM_ENABLE_FAST_NATIVES 0
+#endif
+
+/* Compact function metadata: 16-bit counts, the fields read on each call
+   packed at the front of WASMFunction, local offsets allocated with the
+   function and no per-instance copies of what the function holds */
+#ifndef WASM_ENABLE_COMPACT_METADATA
+#define WASM_ENABLE_COMPACT_METADATA 0
+#elif WASM_ENABLE_COMPACT_METADATA != 0                     \
+    && (WASM_ENABLE_FAST_INTERP == 0 || WASM_ENABLE_GC != 0 \
+        || WASM_ENABLE_JIT != 0 || WASM_ENABLE_FAST_JIT != 0)
+#error "Compact metadata needs the fast interpreter, without GC or JIT"
+#endif
+
 #ifndef WASM_ENABLE_WASM_CACHE
 #define WASM_ENABLE_WASM_CACHE 0
 #endif
@@ -161,7 +161,9 @@ GET_U16_FROM_ADDR(const uint8 *p)
     uint32 buf32 = *(const uint32 *)p_aligned;
     const uint8 *pbuf = (const uint8 *)&buf32;
 
-    res = *(uint16 *)(pbuf + (p - p_aligned));
+    /* memcpy rather than a uint16 load: buf32 must not be accessed through
+       an incompatible pointer type (strict aliasing) */
+    memcpy(&res, pbuf + (p - p_aligned), sizeof(res));
 
     return res;
 }
@@ -2421,6 +2423,7 @@ load_import_funcs(const uint8 **p_buf, const uint8 *buf_end, AOTModule *module,
         import_funcs[i].attachment = NULL;
         import_funcs[i].signature = NULL;
         import_funcs[i].call_conv_raw = false;
+        import_funcs[i].fast_native = FAST_NATIVE_NONE;
 
         if (!no_resolve) {
             aot_resolve_import_func(module, &import_funcs[i]);
@@ -3267,6 +3267,12 @@ aot_invoke_native(WASMExecEnv *exec_env, uint32 func_idx, uint32 argc,
             (WASMModuleInstanceCommon *)module_inst, func_ptr, func_type, argc,
             argv, c_api_func_import->with_env_arg, c_api_func_import->env_arg);
     }
+#if WASM_ENABLE_FAST_NATIVES != 0
+    else if (import_func->fast_native) {
+        ret = wasm_runtime_invoke_native_fast(exec_env, func_ptr, attachment,
+                                              argv);
+    }
+#endif
     else if (!import_func->call_conv_raw) {
         signature = import_func->signature;
 #if WASM_ENABLE_MULTI_MODULE != 0
@@ -3394,6 +3400,16 @@ aot_call_indirect(WASMExecEnv *exec_env, uint32 tbl_idx, uint32 table_elem_idx,
 
             return true;
         }
+#if WASM_ENABLE_FAST_NATIVES != 0
+        if (import_func->fast_native) {
+            ret = wasm_runtime_invoke_native_fast(exec_env, func_ptr,
+                                                  attachment, argv);
+            if (!ret)
+                goto fail;
+
+            return true;
+        }
+#endif
     }
 
     ext_ret_count =
@@ -5641,7 +5657,8 @@ aot_resolve_import_func(AOTModule *module, AOTImportFunc *import_func)
     import_func->func_ptr_linked = wasm_native_resolve_symbol(
         import_func->module_name, import_func->func_name,
         import_func->func_type, &import_func->signature,
-        &import_func->attachment, &import_func->call_conv_raw);
+        &import_func->attachment, &import_func->call_conv_raw,
+        &import_func->fast_native);
 #if WASM_ENABLE_MULTI_MODULE != 0
     if (!import_func->func_ptr_linked) {
         if (!wasm_runtime_is_built_in_module(import_func->module_name)) {
@@ -5,6 +5,7 @@
 
 #include "wasm_exec_env.h"
 #include "wasm_runtime_common.h"
+#include "wasm_memory.h"
 #if WASM_ENABLE_GC != 0
 #include "mem_alloc.h"
 #endif
@@ -35,10 +36,14 @@ wasm_exec_env_create_internal(struct WASMModuleInstanceCommon *module_inst,
     WASMExecEnv *exec_env;
 
     if (total_size >= UINT32_MAX
-        || !(exec_env = wasm_runtime_malloc((uint32)total_size)))
+        || !(exec_env = wasm_runtime_malloc_class((uint32)total_size,
+                                                  Mem_Class_Stack)))
         return NULL;
 
-    memset(exec_env, 0, (uint32)total_size);
+    /* The wasm stack is left as it is: frames set their fields and zero
+       their locals when they are pushed, and the stack is reused from
+       call to call without being cleared anyway */
+    memset(exec_env, 0, offsetof(WASMExecEnv, wasm_stack_u.bottom));
 
 #if WASM_ENABLE_AOT != 0
     if (!(exec_env->argv_buf = wasm_runtime_malloc(sizeof(uint32) * 64))) {
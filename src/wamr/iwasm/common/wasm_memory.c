@@ -69,6 +69,320 @@ static void (*free_func)(
 
 static unsigned int global_pool_size;
 
+#if WASM_ENABLE_THREAD_ALLOC_CACHE != 0
+#ifndef os_thread_local_attribute
+#error "WASM_ENABLE_THREAD_ALLOC_CACHE requires os_thread_local_attribute"
+#endif
+
+/* Per-thread caches of small blocks: a thread allocates and frees blocks
+   of the common sizes without the heap lock, and only takes it to refill
+   or flush half a cache at once. */
+
+#define ALLOC_CACHE_CLASS_NUM 8
+#define ALLOC_CACHE_MAX_SIZE 256
+#define ALLOC_CACHE_BATCH (WASM_THREAD_ALLOC_CACHE_DEPTH / 2)
+/* Allocations a thread counts before adding them to the global
+   statistics */
+#define ALLOC_CACHE_STATS_FOLD 256
+
+#if WASM_THREAD_ALLOC_CACHE_DEPTH < 2 || WASM_THREAD_ALLOC_CACHE_DEPTH > 255
+#error "WASM_THREAD_ALLOC_CACHE_DEPTH must be in [2, 255]"
+#endif
+
+/* Block size of each class, followed by the limit of the last class. A
+   freed block goes to the largest class not bigger than its usable size,
+   so blocks that weren't allocated through a cache can be cached too. */
+static const uint16 alloc_cache_class_size[ALLOC_CACHE_CLASS_NUM + 1] = {
+    16, 32, 48, 64, 96, 128, 192, 256, 320
+};
+
+/* Class of a request of n 16-byte granules */
+static const uint8 alloc_cache_class_of_granules[17] = {
+    0, 0, 1, 2, 3, 4, 4, 5, 5, 6, 6, 6, 6, 7, 7, 7, 7
+};
+
+typedef struct AllocCache {
+    uint8 count[ALLOC_CACHE_CLASS_NUM];
+    void *blocks[ALLOC_CACHE_CLASS_NUM][WASM_THREAD_ALLOC_CACHE_DEPTH];
+    /* Counts not added to alloc_cache_stats yet */
+    uint32 hits;
+    uint32 misses;
+    int32 bytes_held_delta;
+} AllocCache;
+
+/* The cache itself is allocated from the pool on first use, so a thread
+   that never allocates only costs these two words of TLS. A generation
+   other than pool_generation means no cache or one from a pool that has
+   been destroyed since. */
+static os_thread_local_attribute AllocCache *alloc_cache;
+static os_thread_local_attribute uint32 alloc_cache_generation;
+
+static uint32 pool_generation;
+static korp_mutex alloc_cache_stats_lock;
+static mem_alloc_cache_stats_t alloc_cache_stats;
+
+static AllocCache *
+alloc_cache_get(void)
+{
+    if (alloc_cache_generation != pool_generation) {
+        alloc_cache = mem_allocator_malloc(pool_allocator, sizeof(AllocCache));
+        if (!alloc_cache)
+            return NULL;
+        memset(alloc_cache, 0, sizeof(AllocCache));
+        alloc_cache_generation = pool_generation;
+    }
+    return alloc_cache;
+}
+
+static void
+alloc_cache_fold_stats(AllocCache *cache)
+{
+    os_mutex_lock(&alloc_cache_stats_lock);
+    alloc_cache_stats.hit_count += cache->hits;
+    alloc_cache_stats.miss_count += cache->misses;
+    alloc_cache_stats.bytes_held += (uint32)cache->bytes_held_delta;
+    os_mutex_unlock(&alloc_cache_stats_lock);
+
+    cache->hits = 0;
+    cache->misses = 0;
+    cache->bytes_held_delta = 0;
+}
+
+/* Return all blocks of a cache to the pool */
+static void
+alloc_cache_flush(AllocCache *cache)
+{
+    uint32 i;
+
+    for (i = 0; i < ALLOC_CACHE_CLASS_NUM; i++) {
+        if (cache->count[i] > 0) {
+            mem_allocator_free_batch(pool_allocator, cache->blocks[i],
+                                     cache->count[i]);
+            cache->bytes_held_delta -=
+                (int32)(alloc_cache_class_size[i] * cache->count[i]);
+            cache->count[i] = 0;
+        }
+    }
+    alloc_cache_fold_stats(cache);
+}
+
+static void *
+alloc_cache_malloc(unsigned int size)
+{
+    AllocCache *cache;
+    uint32 class_idx, class_size, n;
+    void **blocks;
+
+    if (size > ALLOC_CACHE_MAX_SIZE || !(cache = alloc_cache_get()))
+        return mem_allocator_malloc(pool_allocator, size);
+
+    class_idx = alloc_cache_class_of_granules[(size + 15) >> 4];
+    class_size = alloc_cache_class_size[class_idx];
+    blocks = cache->blocks[class_idx];
+
+    if (cache->count[class_idx] > 0) {
+        cache->bytes_held_delta -= (int32)class_size;
+        if (++cache->hits + cache->misses >= ALLOC_CACHE_STATS_FOLD)
+            alloc_cache_fold_stats(cache);
+        return blocks[--cache->count[class_idx]];
+    }
+
+    /* Refill half of the cache and hand out the last block */
+    cache->misses++;
+    n = mem_allocator_malloc_batch(pool_allocator, class_size, blocks,
+                                   ALLOC_CACHE_BATCH);
+    if (n == 0) {
+        /* The pool is short of memory, give back what this thread holds
+           and try the exact size */
+        alloc_cache_flush(cache);
+        return mem_allocator_malloc(pool_allocator, size);
+    }
+    cache->count[class_idx] = (uint8)(n - 1);
+    cache->bytes_held_delta += (int32)(class_size * (n - 1));
+    if (cache->hits + cache->misses >= ALLOC_CACHE_STATS_FOLD)
+        alloc_cache_fold_stats(cache);
+    return blocks[n - 1];
+}
+
+static void
+alloc_cache_free(void *ptr)
+{
+    AllocCache *cache;
+    uint32 usable_size = mem_allocator_get_usable_size(pool_allocator, ptr);
+    uint32 class_idx, class_size;
+    void **blocks;
+
+    /* A usable size of 0 means not a live block of the pool, which the
+       allocator reports or ignores as before */
+    if (usable_size < alloc_cache_class_size[0]
+        || usable_size >= alloc_cache_class_size[ALLOC_CACHE_CLASS_NUM]
+        || !(cache = alloc_cache_get())) {
+        mem_allocator_free(pool_allocator, ptr);
+        return;
+    }
+
+    class_idx = ALLOC_CACHE_CLASS_NUM - 1;
+    while (usable_size < alloc_cache_class_size[class_idx])
+        class_idx--;
+    class_size = alloc_cache_class_size[class_idx];
+    blocks = cache->blocks[class_idx];
+
+    if (cache->count[class_idx] == WASM_THREAD_ALLOC_CACHE_DEPTH) {
+        /* Full, return the oldest half to the pool */
+        mem_allocator_free_batch(pool_allocator, blocks, ALLOC_CACHE_BATCH);
+        memmove(blocks, blocks + ALLOC_CACHE_BATCH,
+                sizeof(void *)
+                    * (WASM_THREAD_ALLOC_CACHE_DEPTH - ALLOC_CACHE_BATCH));
+        cache->count[class_idx] -= ALLOC_CACHE_BATCH;
+        cache->bytes_held_delta -= (int32)(class_size * ALLOC_CACHE_BATCH);
+    }
+    blocks[cache->count[class_idx]++] = ptr;
+    cache->bytes_held_delta += (int32)class_size;
+}
+#endif /* end of WASM_ENABLE_THREAD_ALLOC_CACHE != 0 */
+
+void
+wasm_runtime_flush_thread_alloc_cache(void)
+{
+#if WASM_ENABLE_THREAD_ALLOC_CACHE != 0
+    if (memory_mode == MEMORY_MODE_POOL
+        && alloc_cache_generation == pool_generation) {
+        alloc_cache_flush(alloc_cache);
+        mem_allocator_free(pool_allocator, alloc_cache);
+        alloc_cache = NULL;
+        alloc_cache_generation = 0;
+    }
+#endif
+}
+
+bool
+wasm_runtime_get_alloc_cache_stats(mem_alloc_cache_stats_t *stats)
+{
+#if WASM_ENABLE_THREAD_ALLOC_CACHE != 0
+    if (memory_mode == MEMORY_MODE_POOL) {
+        os_mutex_lock(&alloc_cache_stats_lock);
+        *stats = alloc_cache_stats;
+        os_mutex_unlock(&alloc_cache_stats_lock);
+        return true;
+    }
+#endif
+    memset(stats, 0, sizeof(*stats));
+    return false;
+}
+
+#if WASM_ENABLE_MEM_PLACEMENT != 0
+/* Pool of MemAllocOption.pool.fast_heap_buf, NULL if none */
+static mem_allocator_t fast_pool_allocator = NULL;
+static uint8 *fast_pool_buf, *fast_pool_buf_end;
+/* Range of the main pool, to tell its linear memories from mapped ones */
+static uint8 *pool_buf, *pool_buf_end;
+/* Classes placed in the fast pool, 0 without one */
+static uint32 fast_mem_classes;
+static korp_mutex mem_class_stats_lock;
+static mem_class_stats_t mem_class_stats[Mem_Class_Num];
+
+static inline bool
+in_fast_pool(const void *ptr)
+{
+    return (const uint8 *)ptr >= fast_pool_buf
+           && (const uint8 *)ptr < fast_pool_buf_end;
+}
+
+static bool
+mem_placement_init(const MemAllocOption *alloc_option, int kind)
+{
+    void *buf = alloc_option->pool.fast_heap_buf;
+    uint32 size = alloc_option->pool.fast_heap_size;
+
+    memset(mem_class_stats, 0, sizeof(mem_class_stats));
+    pool_buf = alloc_option->pool.heap_buf;
+    pool_buf_end = pool_buf + alloc_option->pool.heap_size;
+    fast_pool_buf = fast_pool_buf_end = NULL;
+    fast_mem_classes = 0;
+
+    if (os_mutex_init(&mem_class_stats_lock) != 0)
+        return false;
+    if (!buf || size == 0)
+        return true;
+
+    if (!(fast_pool_allocator =
+              mem_allocator_create_with_kind(buf, size, kind))) {
+        LOG_ERROR("Init fast memory pool (%p, %u) failed.\n", buf, size);
+        os_mutex_destroy(&mem_class_stats_lock);
+        return false;
+    }
+    fast_pool_buf = buf;
+    fast_pool_buf_end = fast_pool_buf + size;
+    fast_mem_classes = alloc_option->pool.fast_mem_classes
+                       & (MEM_CLASS_BIT(Mem_Class_Num) - 1);
+    return true;
+}
+
+static void
+mem_placement_destroy(void)
+{
+    if (fast_pool_allocator) {
+        (void)mem_allocator_destroy(fast_pool_allocator);
+        fast_pool_allocator = NULL;
+    }
+    fast_pool_buf = fast_pool_buf_end = NULL;
+    fast_mem_classes = 0;
+    os_mutex_destroy(&mem_class_stats_lock);
+}
+
+static void
+mem_class_count(mem_class_t mem_class, bool fast, bool fallback, uint64 size)
+{
+    mem_class_stats_t *stats = &mem_class_stats[mem_class];
+
+    os_mutex_lock(&mem_class_stats_lock);
+    if (fast) {
+        stats->fast_count++;
+        stats->fast_bytes += size;
+    }
+    else {
+        stats->main_count++;
+        stats->main_bytes += size;
+    }
+    if (fallback)
+        stats->fallback_count++;
+    os_mutex_unlock(&mem_class_stats_lock);
+}
+
+/* Allocate from the fast pool if the class is placed in it, sets *fallback
+   if it is and the pool is full */
+static void *
+fast_pool_malloc(mem_class_t mem_class, uint32 size, bool *fallback)
+{
+    void *ptr;
+
+    if (!(fast_mem_classes & MEM_CLASS_BIT(mem_class)))
+        return NULL;
+    if (!(ptr = mem_allocator_malloc(fast_pool_allocator, size)))
+        *fallback = true;
+    return ptr;
+}
+
+/* Resize a block of the fast pool, moving it to the main pool if the fast
+   pool is full */
+static void *
+fast_pool_realloc(void *ptr, unsigned int size)
+{
+    uint32 size_old;
+    void *ptr_new;
+
+    if ((ptr_new = mem_allocator_realloc(fast_pool_allocator, ptr, size)))
+        return ptr_new;
+
+    size_old = mem_allocator_get_usable_size(fast_pool_allocator, ptr);
+    if (!(ptr_new = mem_allocator_malloc(pool_allocator, size)))
+        return NULL;
+    bh_memcpy_s(ptr_new, size, ptr, size_old < size ? size_old : size);
+    mem_allocator_free(fast_pool_allocator, ptr);
+    return ptr_new;
+}
+#endif /* end of WASM_ENABLE_MEM_PLACEMENT != 0 */
+
 static uint64
 align_as_and_cast(uint64 size, uint64 alignment)
 {
@@ -78,9 +392,38 @@ align_as_and_cast(uint64 size, uint64 alignment)
 }
 
 static bool
-wasm_memory_init_with_pool(void *mem, unsigned int bytes)
-{
-    mem_allocator_t allocator = mem_allocator_create(mem, bytes);
+wasm_memory_init_with_pool(const MemAllocOption *alloc_option)
+{
+    void *mem = alloc_option->pool.heap_buf;
+    unsigned int bytes = alloc_option->pool.heap_size;
+    pool_allocator_type_t allocator_type = alloc_option->pool.allocator_type;
+    int kind = allocator_type == Pool_Allocator_TLSF  ? MEM_ALLOCATOR_TLSF
+               : allocator_type == Pool_Allocator_EMS ? MEM_ALLOCATOR_EMS
+                                                      : DEFAULT_MEM_ALLOCATOR;
+    mem_allocator_t allocator =
+        mem_allocator_create_with_kind(mem, bytes, kind);
+
+#if WASM_ENABLE_THREAD_ALLOC_CACHE != 0
+    if (allocator && os_mutex_init(&alloc_cache_stats_lock) != 0) {
+        mem_allocator_destroy(allocator);
+        allocator = NULL;
+    }
+    if (allocator) {
+        memset(&alloc_cache_stats, 0, sizeof(alloc_cache_stats));
+        /* Caches of threads from a previous pool are dropped */
+        pool_generation++;
+    }
+#endif
+
+#if WASM_ENABLE_MEM_PLACEMENT != 0
+    if (allocator && !mem_placement_init(alloc_option, kind)) {
+#if WASM_ENABLE_THREAD_ALLOC_CACHE != 0
+        os_mutex_destroy(&alloc_cache_stats_lock);
+#endif
+        mem_allocator_destroy(allocator);
+        allocator = NULL;
+    }
+#endif
 
     if (allocator) {
         memory_mode = MEMORY_MODE_POOL;
@@ -784,8 +1127,7 @@ wasm_runtime_memory_init(mem_alloc_type_t mem_alloc_type,
 #endif
 
     if (mem_alloc_type == Alloc_With_Pool) {
-        ret = wasm_memory_init_with_pool(alloc_option->pool.heap_buf,
-                                         alloc_option->pool.heap_size);
+        ret = wasm_memory_init_with_pool(alloc_option);
     }
     else if (mem_alloc_type == Alloc_With_Allocator) {
         ret = wasm_memory_init_with_allocator(
@@ -853,6 +1195,14 @@ wasm_runtime_memory_destroy(void)
 #endif
 
     if (memory_mode == MEMORY_MODE_POOL) {
+#if WASM_ENABLE_THREAD_ALLOC_CACHE != 0
+        /* Blocks cached by other threads go away with the pool */
+        wasm_runtime_flush_thread_alloc_cache();
+        os_mutex_destroy(&alloc_cache_stats_lock);
+#endif
+#if WASM_ENABLE_MEM_PLACEMENT != 0
+        mem_placement_destroy();
+#endif
 #if BH_ENABLE_GC_VERIFY == 0
         (void)mem_allocator_destroy(pool_allocator);
 #else
@@ -884,7 +1234,18 @@ wasm_runtime_malloc_internal(unsigned int size)
         return NULL;
     }
     else if (memory_mode == MEMORY_MODE_POOL) {
+#if WASM_ENABLE_MEM_PLACEMENT != 0
+        void *ptr;
+
+        if ((fast_mem_classes & MEM_CLASS_BIT(Mem_Class_Metadata))
+            && (ptr = mem_allocator_malloc(fast_pool_allocator, size)))
+            return ptr;
+#endif
+#if WASM_ENABLE_THREAD_ALLOC_CACHE != 0
+        return alloc_cache_malloc(size);
+#else
         return mem_allocator_malloc(pool_allocator, size);
+#endif
     }
     else if (memory_mode == MEMORY_MODE_ALLOCATOR) {
         return malloc_func(
@@ -910,6 +1271,10 @@ wasm_runtime_realloc_internal(void *ptr, unsigned int size)
         return NULL;
     }
     else if (memory_mode == MEMORY_MODE_POOL) {
+#if WASM_ENABLE_MEM_PLACEMENT != 0
+        if (in_fast_pool(ptr))
+            return fast_pool_realloc(ptr, size);
+#endif
         return mem_allocator_realloc(pool_allocator, ptr, size);
     }
     else if (memory_mode == MEMORY_MODE_ALLOCATOR) {
@@ -946,7 +1311,17 @@ wasm_runtime_free_internal(void *ptr)
                     "memory hasn't been initialize.\n");
     }
     else if (memory_mode == MEMORY_MODE_POOL) {
+#if WASM_ENABLE_MEM_PLACEMENT != 0
+        if (in_fast_pool(ptr)) {
+            mem_allocator_free(fast_pool_allocator, ptr);
+            return;
+        }
+#endif
+#if WASM_ENABLE_THREAD_ALLOC_CACHE != 0
+        alloc_cache_free(ptr);
+#else
         mem_allocator_free(pool_allocator, ptr);
+#endif
     }
     else if (memory_mode == MEMORY_MODE_ALLOCATOR) {
         free_func(
@@ -1006,6 +1381,67 @@ wasm_runtime_get_mem_alloc_info(mem_alloc_info_t *mem_alloc_info)
     return false;
 }
 
+#if WASM_ENABLE_MEM_PLACEMENT != 0
+void *
+wasm_runtime_malloc_class(unsigned int size, mem_class_t mem_class)
+{
+    bool fallback = false;
+    void *ptr;
+
+    bh_assert(mem_class > Mem_Class_Metadata && mem_class < Mem_Class_Num
+              && mem_class != Mem_Class_LinearMemory);
+
+    if (memory_mode != MEMORY_MODE_POOL)
+        return wasm_runtime_malloc(size);
+
+    if ((ptr = fast_pool_malloc(mem_class, size, &fallback))) {
+        mem_class_count(mem_class, true, false, size);
+        return ptr;
+    }
+    if ((ptr = wasm_runtime_malloc(size)))
+        mem_class_count(mem_class, false, fallback, size);
+    return ptr;
+}
+
+bool
+wasm_runtime_mem_class_is_fast(mem_class_t mem_class)
+{
+    return memory_mode == MEMORY_MODE_POOL
+           && (fast_mem_classes & MEM_CLASS_BIT(mem_class));
+}
+#endif /* end of WASM_ENABLE_MEM_PLACEMENT != 0 */
+
+bool
+wasm_runtime_get_fast_mem_alloc_info(mem_alloc_info_t *mem_alloc_info)
+{
+#if WASM_ENABLE_MEM_PLACEMENT != 0
+    if (memory_mode == MEMORY_MODE_POOL && fast_pool_allocator) {
+        return mem_allocator_get_alloc_info(fast_pool_allocator,
+                                            mem_alloc_info);
+    }
+#endif
+    (void)mem_alloc_info;
+    return false;
+}
+
+bool
+wasm_runtime_get_mem_class_stats(mem_class_t mem_class,
+                                 mem_class_stats_t *stats)
+{
+#if WASM_ENABLE_MEM_PLACEMENT != 0
+    if (memory_mode == MEMORY_MODE_POOL && mem_class > Mem_Class_Metadata
+        && mem_class < Mem_Class_Num) {
+        os_mutex_lock(&mem_class_stats_lock);
+        *stats = mem_class_stats[mem_class];
+        os_mutex_unlock(&mem_class_stats_lock);
+        return true;
+    }
+#endif
+    (void)mem_class;
+    memset(stats, 0, sizeof(*stats));
+    return false;
+}
+
 bool
 wasm_runtime_validate_app_addr(WASMModuleInstanceCommon *module_inst_comm,
                                uint64 app_offset, uint64 size)
@@ -1539,6 +1975,77 @@ wasm_mmap_linear_memory(uint64 map_size, uint64 commit_size)
     return wasm_mremap_linear_memory(NULL, 0, map_size, commit_size);
 }
 
+#if WASM_ENABLE_MEM_PLACEMENT != 0 && !defined(OS_ENABLE_HW_BOUND_CHECK) \
+    && WASM_MEM_ALLOC_WITH_USAGE == 0
+#define PLACE_LINEAR_MEMORY 1
+
+/* Pool of a linear memory, NULL if it was mapped */
+static mem_allocator_t
+linear_memory_pool(void *mem)
+{
+    if (in_fast_pool(mem))
+        return fast_pool_allocator;
+    if ((uint8 *)mem >= pool_buf && (uint8 *)mem < pool_buf_end)
+        return pool_allocator;
+    return NULL;
+}
+
+/* With a fast pool, allocate a linear memory from the pool of its class,
+   or map it as without one if the pools are full. The bytes from
+   zero_from on are zeroed, the ones before are left for the caller to
+   copy in. */
+static void *
+placed_mmap_linear_memory(uint64 map_size, uint64 commit_size,
+                          uint64 zero_from)
+{
+    bool fast = false, fallback = false;
+    void *mem = NULL;
+
+    if (memory_mode != MEMORY_MODE_POOL || !fast_pool_allocator)
+        return wasm_mmap_linear_memory(map_size, commit_size);
+
+    if (commit_size <= UINT32_MAX) {
+        if ((mem = fast_pool_malloc(Mem_Class_LinearMemory, (uint32)commit_size,
+                                    &fallback)))
+            fast = true;
+        else
+            mem = mem_allocator_malloc(pool_allocator, (uint32)commit_size);
+        if (mem)
+            memset((uint8 *)mem + zero_from, 0,
+                   (uint32)(commit_size - zero_from));
+    }
+    /* A fresh mapping is zeroed once by os_mmap */
+    if (!mem && !(mem = wasm_mmap_linear_memory(map_size, commit_size)))
+        return NULL;
+
+    mem_class_count(Mem_Class_LinearMemory, fast, fallback, commit_size);
+    return mem;
+}
+
+/* Grow a linear memory in its pool, or move it to a new one */
+static void *
+placed_mremap_linear_memory(void *mem, uint64 old_size, uint64 new_size)
+{
+    mem_allocator_t pool = linear_memory_pool(mem);
+    void *new_mem;
+
+    if (!pool)
+        return wasm_mremap_linear_memory(mem, old_size, new_size, new_size);
+
+    if (new_size <= UINT32_MAX
+        && (new_mem = mem_allocator_realloc(pool, mem, (uint32)new_size))) {
+        memset((uint8 *)new_mem + old_size, 0, (uint32)(new_size - old_size));
+        return new_mem;
+    }
+
+    if (!(new_mem = placed_mmap_linear_memory(new_size, new_size, old_size)))
+        return NULL;
+    bh_memcpy_s(new_mem, (uint32)old_size, mem, (uint32)old_size);
+    mem_allocator_free(pool, mem);
+    return new_mem;
+}
+#endif /* end of PLACE_LINEAR_MEMORY */
+
 static bool
 wasm_enlarge_memory_internal(WASMModuleInstanceCommon *module,
                              WASMMemoryInstance *memory, uint32 inc_page_count)
@@ -1668,9 +2175,15 @@ wasm_enlarge_memory_internal(WASMModuleInstanceCommon *module,
             }
         }
 
-        if (!(memory_data_new =
-                  wasm_mremap_linear_memory(memory_data_old, total_size_old,
-                                            total_size_new, total_size_new))) {
+#ifdef PLACE_LINEAR_MEMORY
+        memory_data_new = placed_mremap_linear_memory(
+            memory_data_old, total_size_old, total_size_new);
+#else
+        memory_data_new =
+            wasm_mremap_linear_memory(memory_data_old, total_size_old,
+                                      total_size_new, total_size_new);
+#endif
+        if (!memory_data_new) {
             ret = false;
             goto return_func;
         }
@@ -1935,13 +2448,36 @@ wasm_deallocate_linear_memory(WASMMemoryInstance *memory_inst)
 #endif
               memory_inst->memory_data);
 #else
-    wasm_munmap_linear_memory(memory_inst->memory_data,
-                              memory_inst->memory_data_size, map_size);
+#ifdef PLACE_LINEAR_MEMORY
+    mem_allocator_t pool = linear_memory_pool(memory_inst->memory_data);
+
+    if (pool)
+        mem_allocator_free(pool, memory_inst->memory_data);
+    else
+#endif
+        wasm_munmap_linear_memory(memory_inst->memory_data,
+                                  memory_inst->memory_data_size, map_size);
 #endif
 
     memory_inst->memory_data = NULL;
 }
 
+#ifdef OS_ENABLE_COW_MAPPING
+bool
+wasm_linear_memory_is_mapped(const WASMMemoryInstance *memory_inst)
+{
+#if WASM_MEM_ALLOC_WITH_USAGE != 0
+    (void)memory_inst;
+    return false;
+#elif defined(PLACE_LINEAR_MEMORY)
+    return !linear_memory_pool(memory_inst->memory_data);
+#else
+    (void)memory_inst;
+    return true;
+#endif
+}
+#endif
+
 int
 wasm_allocate_linear_memory(uint8 **data, bool is_shared_memory,
                             bool is_memory64, uint64 num_bytes_per_page,
@@ -1990,7 +2526,15 @@ wasm_allocate_linear_memory(uint8 **data, bool is_shared_memory,
             return BHT_ERROR;
         }
 #else
-        if (!(*data = wasm_mmap_linear_memory(map_size, *memory_data_size))) {
+#ifdef PLACE_LINEAR_MEMORY
+        /* A shared memory is mapped at its maximum size and grows in
+           place */
+        if (!is_shared_memory)
+            *data = placed_mmap_linear_memory(map_size, *memory_data_size, 0);
+        else
+#endif
+            *data = wasm_mmap_linear_memory(map_size, *memory_data_size);
+        if (!*data) {
             return BHT_ERROR;
         }
 #endif
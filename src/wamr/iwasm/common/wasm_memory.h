@@ -130,6 +130,22 @@ wasm_runtime_memory_destroy(void);
 unsigned
 wasm_runtime_memory_pool_size(void);
 
+#if WASM_ENABLE_MEM_PLACEMENT != 0
+/* Allocate a block of an object class, from the fast pool if the class is
+   placed in it and it has room, otherwise as wasm_runtime_malloc() does.
+   Free it with wasm_runtime_free(). Linear memories are placed by
+   wasm_allocate_linear_memory() */
+void *
+wasm_runtime_malloc_class(unsigned int size, mem_class_t mem_class);
+
+/* Whether the class is placed in the fast pool */
+bool
+wasm_runtime_mem_class_is_fast(mem_class_t mem_class);
+#else
+#define wasm_runtime_malloc_class(size, mem_class) wasm_runtime_malloc(size)
+#define wasm_runtime_mem_class_is_fast(mem_class) false
+#endif
+
 void
 wasm_runtime_set_mem_bound_check_bytes(WASMMemoryInstance *memory,
                                        uint64 memory_data_size);
@@ -147,6 +163,13 @@ wasm_allocate_linear_memory(uint8 **data, bool is_shared_memory,
                             uint64 init_page_count, uint64 max_page_count,
                             uint64 *memory_data_size);
 
+#ifdef OS_ENABLE_COW_MAPPING
+/* Whether the linear memory was mapped rather than allocated from a pool
+   or by the embedder's allocator, so that its pages can be replaced */
+bool
+wasm_linear_memory_is_mapped(const WASMMemoryInstance *memory_inst);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -21,6 +21,27 @@
 
 static NativeSymbolsList g_native_symbols_list = NULL;
 
+#if WASM_ENABLE_NATIVE_INDEX != 0
+/* A slot of the native index, free if node is NULL */
+typedef struct NativeIndexEntry {
+    NativeSymbolsNode *node;
+    NativeSymbol *symbol;
+} NativeIndexEntry;
+
+/* Open-addressed hash table of all the registered natives by (module name,
+   symbol), updated at each registration, so that resolving an import costs
+   a hash instead of a walk over the registrations with a bsearch in each.
+   NULL if it couldn't be allocated, imports are then resolved with the
+   walk */
+static NativeIndexEntry *g_native_index;
+/* Slots, a power of 2, and used slots, at most 3/4 of them */
+static uint32 g_native_index_size;
+static uint32 g_native_index_count;
+/* Order of the registrations: a later one hides the same symbols of an
+   earlier one */
+static uint32 g_native_seq;
+#endif
+
 #if WASM_ENABLE_LIBC_WASI != 0
 static void *g_wasi_context_key;
 #endif /* WASM_ENABLE_LIBC_WASI */
@@ -198,34 +219,211 @@ lookup_symbol(NativeSymbol *native_symbols, uint32 n_native_symbols,
     return NULL;
 }
 
+#if WASM_ENABLE_NATIVE_INDEX != 0
+static uint32
+native_index_hash(const char *module_name, const char *symbol)
+{
+    /* FNV-1a, with the terminating '\0' of the module name as separator */
+    uint32 hash = 2166136261u;
+    const uint8 *p = (const uint8 *)module_name;
+
+    do {
+        hash = (hash ^ *p) * 16777619u;
+    } while (*p++);
+    for (p = (const uint8 *)symbol; *p; p++)
+        hash = (hash ^ *p) * 16777619u;
+    return hash;
+}
+
+static NativeIndexEntry *
+native_index_find(const char *module_name, const char *symbol)
+{
+    uint32 mask = g_native_index_size - 1;
+    uint32 i = native_index_hash(module_name, symbol) & mask;
+    NativeIndexEntry *entry;
+
+    while ((entry = g_native_index + i)->node) {
+        if (!strcmp(entry->symbol->symbol, symbol)
+            && !strcmp(entry->node->module_name, module_name))
+            return entry;
+        i = (i + 1) & mask;
+    }
+    return NULL;
+}
+
+static void
+native_index_insert(NativeIndexEntry *index, uint32 size,
+                    NativeSymbolsNode *node, NativeSymbol *symbol)
+{
+    uint32 mask = size - 1;
+    uint32 i = native_index_hash(node->module_name, symbol->symbol) & mask;
+    NativeIndexEntry *entry;
+
+    while ((entry = index + i)->node) {
+        if (!strcmp(entry->symbol->symbol, symbol->symbol)
+            && !strcmp(entry->node->module_name, node->module_name)) {
+            /* The later registration wins, whatever the insertion order */
+            if (entry->node->seq < node->seq) {
+                entry->node = node;
+                entry->symbol = symbol;
+            }
+            return;
+        }
+        i = (i + 1) & mask;
+    }
+    entry->node = node;
+    entry->symbol = symbol;
+    g_native_index_count++;
+}
+
+/* Make room for n_more symbols, rehashing into a larger table if needed */
+static bool
+native_index_reserve(uint32 n_more)
+{
+    NativeIndexEntry *index, *entry, *end;
+    uint64 count = (uint64)g_native_index_count + n_more, size_bytes;
+    uint32 size = g_native_index_size ? g_native_index_size : 64;
+
+    while (count * 4 > (uint64)size * 3) {
+        if (size >= (1u << 30))
+            return false;
+        size <<= 1;
+    }
+    if (g_native_index && size == g_native_index_size)
+        return true;
+
+    size_bytes = sizeof(NativeIndexEntry) * (uint64)size;
+    if (size_bytes >= UINT32_MAX
+        || !(index = wasm_runtime_malloc((uint32)size_bytes)))
+        return false;
+    memset(index, 0, (uint32)size_bytes);
+
+    g_native_index_count = 0;
+    if (g_native_index) {
+        end = g_native_index + g_native_index_size;
+        for (entry = g_native_index; entry < end; entry++) {
+            if (entry->node)
+                native_index_insert(index, size, entry->node, entry->symbol);
+        }
+        wasm_runtime_free(g_native_index);
+    }
+    g_native_index = index;
+    g_native_index_size = size;
+    return true;
+}
+
+static void
+native_index_destroy(void)
+{
+    if (g_native_index)
+        wasm_runtime_free(g_native_index);
+    g_native_index = NULL;
+    g_native_index_size = g_native_index_count = 0;
+}
+
+/* Index all the registrations from scratch, after one was removed or after
+   the index couldn't be allocated */
+static void
+native_index_rebuild(void)
+{
+    NativeSymbolsNode *node;
+    uint32 n_symbols = 0, i;
+
+    native_index_destroy();
+    for (node = g_native_symbols_list; node; node = node->next)
+        n_symbols += node->n_native_symbols;
+    if (!n_symbols)
+        return;
+
+    if (!native_index_reserve(n_symbols)) {
+        LOG_WARNING("failed to allocate the native index, resolving imports "
+                    "without it");
+        return;
+    }
+    for (node = g_native_symbols_list; node; node = node->next) {
+        for (i = 0; i < node->n_native_symbols; i++)
+            native_index_insert(g_native_index, g_native_index_size, node,
+                                node->native_symbols + i);
+    }
+}
+
+static void
+native_index_add(NativeSymbolsNode *node)
+{
+    uint32 i;
+
+    if (!g_native_index || !native_index_reserve(node->n_native_symbols)) {
+        native_index_rebuild();
+        return;
+    }
+    for (i = 0; i < node->n_native_symbols; i++)
+        native_index_insert(g_native_index, g_native_index_size, node,
+                            node->native_symbols + i);
+}
+
+/* The symbol that the walk over the registrations would find */
+static NativeSymbolsNode *
+native_index_lookup(const char *module_name, const char *field_name,
+                    NativeSymbol **p_symbol)
+{
+    NativeIndexEntry *entry, *entry_stripped;
+
+    entry = native_index_find(module_name, field_name);
+    /* "_foo" also resolves to "foo", unless a registration at least as
+       recent has "_foo" */
+    if (field_name[0] == '_'
+        && (entry_stripped = native_index_find(module_name, field_name + 1))
+        && (!entry || entry_stripped->node->seq > entry->node->seq))
+        entry = entry_stripped;
+
+    if (!entry)
+        return NULL;
+    *p_symbol = entry->symbol;
+    return entry->node;
+}
+#endif /* end of WASM_ENABLE_NATIVE_INDEX != 0 */
+
 /**
- * allow func_type and all outputs, like p_signature, p_attachment and
- * p_call_conv_raw to be NULL
+ * allow func_type and all outputs, like p_signature, p_attachment,
+ * p_call_conv_raw and p_fast_native to be NULL
  */
 void *
 wasm_native_resolve_symbol(const char *module_name, const char *field_name,
                            const WASMFuncType *func_type,
                            const char **p_signature, void **p_attachment,
-                           bool *p_call_conv_raw)
+                           bool *p_call_conv_raw, uint8 *p_fast_native)
 {
     NativeSymbolsNode *node, *node_next;
     const char *signature = NULL;
     void *func_ptr = NULL, *attachment = NULL;
-
-    node = g_native_symbols_list;
-    while (node) {
-        node_next = node->next;
-        if (!strcmp(node->module_name, module_name)) {
-            if ((func_ptr =
-                     lookup_symbol(node->native_symbols, node->n_native_symbols,
-                                   field_name, &signature, &attachment))
-                || (field_name[0] == '_'
-                    && (func_ptr = lookup_symbol(
-                            node->native_symbols, node->n_native_symbols,
-                            field_name + 1, &signature, &attachment))))
-                break;
+#if WASM_ENABLE_NATIVE_INDEX != 0
+    NativeSymbol *symbol;
+
+    if (g_native_index) {
+        if ((node = native_index_lookup(module_name, field_name, &symbol))) {
+            func_ptr = symbol->func_ptr;
+            signature = symbol->signature;
+            attachment = symbol->attachment;
+        }
+    }
+    else
+#endif
+    {
+        node = g_native_symbols_list;
+        while (node) {
+            node_next = node->next;
+            if (!strcmp(node->module_name, module_name)) {
+                if ((func_ptr = lookup_symbol(
+                         node->native_symbols, node->n_native_symbols,
+                         field_name, &signature, &attachment))
+                    || (field_name[0] == '_'
+                        && (func_ptr = lookup_symbol(
+                                node->native_symbols, node->n_native_symbols,
+                                field_name + 1, &signature, &attachment))))
+                    break;
+            }
+            node = node_next;
         }
-        node = node_next;
     }
 
     if (!p_signature || !p_attachment || !p_call_conv_raw)
@@ -252,16 +450,104 @@ wasm_native_resolve_symbol(const char *module_name, const char *field_name,
             /* signature is empty */
             *p_signature = NULL;
 
+        /* Fast natives write their result over their params' cells, and
+           callers only keep room for one */
+        if (node->fast_native && func_type && func_type->result_count > 1) {
+            LOG_WARNING("fast native of import function (%s, %s) can't "
+                        "have more than one result",
+                        module_name, field_name);
+            return NULL;
+        }
+
         *p_attachment = attachment;
         *p_call_conv_raw = node->call_conv_raw;
+        if (p_fast_native)
+            *p_fast_native = node->fast_native;
     }
 
     return func_ptr;
 }
 
+#if WASM_ENABLE_NATIVE_TRAMPOLINES != 0
+static const struct {
+    const char *signature;
+    uint8 shape;
+} native_call_shapes[] = {
+    { "()", NATIVE_SHAPE_VOID },
+    { "()i", NATIVE_SHAPE_RET_I },
+    { "(i)", NATIVE_SHAPE_I },
+    { "(i)i", NATIVE_SHAPE_I_RET_I },
+    { "(ii)", NATIVE_SHAPE_II },
+    { "(ii)i", NATIVE_SHAPE_II_RET_I },
+#if WASM_ENABLE_MEMORY64 == 0
+    /* Memory64 pointers are checked as i64 */
+    { "(*~)", NATIVE_SHAPE_PTR_LEN },
+#endif
+    { "(f)f", NATIVE_SHAPE_F_RET_F },
+};
+
+uint8
+wasm_native_get_call_shape(const WASMFuncType *func_type,
+                           const char *signature)
+{
+    /* "(" params ")" result, for the longest signature in the table */
+    char buf[8];
+    uint32 type_count, i, n = 0;
+
+    if (!func_type || func_type->param_count > 2
+        || func_type->result_count > 1)
+        return NATIVE_SHAPE_GENERIC;
+
+    if (!signature) {
+        /* Build the signature from the function type, no pointers */
+        type_count = (uint32)func_type->param_count + func_type->result_count;
+        buf[n++] = '(';
+        for (i = 0; i < type_count; i++) {
+            if (i == func_type->param_count)
+                buf[n++] = ')';
+            switch (func_type->types[i]) {
+                case VALUE_TYPE_I32:
+                    buf[n++] = 'i';
+                    break;
+                case VALUE_TYPE_F32:
+                    buf[n++] = 'f';
+                    break;
+                default:
+                    return NATIVE_SHAPE_GENERIC;
+            }
+        }
+        if (func_type->result_count == 0)
+            buf[n++] = ')';
+        buf[n] = '\0';
+        signature = buf;
+    }
+
+    for (i = 0; i < sizeof(native_call_shapes) / sizeof(native_call_shapes[0]);
+         i++) {
+        if (!strcmp(native_call_shapes[i].signature, signature))
+            return native_call_shapes[i].shape;
+    }
+    return NATIVE_SHAPE_GENERIC;
+}
+#endif /* end of WASM_ENABLE_NATIVE_TRAMPOLINES != 0 */
+
+static bool
+native_symbols_sorted(const NativeSymbol *native_symbols,
+                      uint32 n_native_symbols)
+{
+    uint32 i;
+
+    for (i = 1; i < n_native_symbols; i++) {
+        if (native_symbol_cmp(native_symbols + i - 1, native_symbols + i) > 0)
+            return false;
+    }
+    return true;
+}
+
 static bool
 register_natives(const char *module_name, NativeSymbol *native_symbols,
-                 uint32 n_native_symbols, bool call_conv_raw)
+                 uint32 n_native_symbols, bool call_conv_raw,
+                 uint8 fast_native)
 {
     NativeSymbolsNode *node;
 
@@ -275,13 +561,23 @@ register_natives(const char *module_name, NativeSymbol *native_symbols,
     node->native_symbols = native_symbols;
     node->n_native_symbols = n_native_symbols;
     node->call_conv_raw = call_conv_raw;
+    node->fast_native = fast_native;
+#if WASM_ENABLE_NATIVE_INDEX != 0
+    node->seq = g_native_seq++;
+#endif
 
     /* Add to list head */
     node->next = g_native_symbols_list;
     g_native_symbols_list = node;
 
-    qsort(native_symbols, n_native_symbols, sizeof(NativeSymbol),
-          native_symbol_cmp);
+    /* Tables registered before, or sorted at build time, are left alone */
+    if (!native_symbols_sorted(native_symbols, n_native_symbols))
+        qsort(native_symbols, n_native_symbols, sizeof(NativeSymbol),
+              native_symbol_cmp);
+
+#if WASM_ENABLE_NATIVE_INDEX != 0
+    native_index_add(node);
+#endif
 
     return true;
 }
@@ -292,7 +588,22 @@ wasm_native_register_natives(const char *module_name,
                              uint32 n_native_symbols)
 {
     return register_natives(module_name, native_symbols, n_native_symbols,
-                            false);
+                            false, FAST_NATIVE_NONE);
+}
+
+bool
+wasm_native_register_natives_sorted(const char *module_name,
+                                    const NativeSymbol *native_symbols,
+                                    uint32 n_native_symbols)
+{
+    /* The table may be in read-only memory, it can't be sorted here */
+    if (!native_symbols_sorted(native_symbols, n_native_symbols)) {
+        LOG_ERROR("native symbols of module %s are not sorted by name",
+                  module_name);
+        return false;
+    }
+    return register_natives(module_name, (NativeSymbol *)native_symbols,
+                            n_native_symbols, false, FAST_NATIVE_NONE);
 }
 
 bool
@@ -301,8 +612,20 @@ wasm_native_register_natives_raw(const char *module_name,
                                  uint32 n_native_symbols)
 {
     return register_natives(module_name, native_symbols, n_native_symbols,
-                            true);
+                            true, FAST_NATIVE_NONE);
+}
+
+#if WASM_ENABLE_FAST_NATIVES != 0
+bool
+wasm_native_register_natives_fast(const char *module_name,
+                                  NativeSymbol *native_symbols,
+                                  uint32 n_native_symbols, bool leaf)
+{
+    return register_natives(module_name, native_symbols, n_native_symbols,
+                            false,
+                            leaf ? FAST_NATIVE_LEAF : FAST_NATIVE_FRAMED);
 }
+#endif
 
 bool
 wasm_native_unregister_natives(const char *module_name,
@@ -317,6 +640,10 @@ wasm_native_unregister_natives(const char *module_name,
             && !strcmp(node->module_name, module_name)) {
             *prevp = node->next;
             wasm_runtime_free(node);
+#if WASM_ENABLE_NATIVE_INDEX != 0
+            /* Symbols the node hid come back */
+            native_index_rebuild();
+#endif
             return true;
         }
         prevp = &node->next;
@@ -659,6 +986,10 @@ wasm_native_destroy()
     }
 
     g_native_symbols_list = NULL;
+#if WASM_ENABLE_NATIVE_INDEX != 0
+    native_index_destroy();
+    g_native_seq = 0;
+#endif
 }
 
 #if WASM_ENABLE_QUICK_AOT_ENTRY != 0
@@ -20,8 +20,39 @@ typedef struct NativeSymbolsNode {
     NativeSymbol *native_symbols;
     uint32 n_native_symbols;
     bool call_conv_raw;
+    /* FastNativeKind of the natives */
+    uint8 fast_native;
+#if WASM_ENABLE_NATIVE_INDEX != 0
+    /* Registration order, later ones hide the same symbols */
+    uint32 seq;
+#endif
 } NativeSymbolsNode, *NativeSymbolsList;
 
+/* How natives registered with wasm_native_register_natives_fast() are
+   called: with the wasm cells of their params, which they overwrite with
+   their results */
+typedef enum FastNativeKind {
+    FAST_NATIVE_NONE = 0, /* not a fast native */
+    FAST_NATIVE_FRAMED,   /* may call back into wasm, gets a frame */
+    FAST_NATIVE_LEAF,     /* never calls back into wasm */
+} FastNativeKind;
+
+#if WASM_ENABLE_NATIVE_TRAMPOLINES != 0
+/* Native signatures called without wasm_runtime_invoke_native(), named
+   after their params and results */
+typedef enum NativeCallShape {
+    NATIVE_SHAPE_GENERIC = 0, /* any other signature */
+    NATIVE_SHAPE_VOID,        /* "()" */
+    NATIVE_SHAPE_RET_I,       /* "()i" */
+    NATIVE_SHAPE_I,           /* "(i)" */
+    NATIVE_SHAPE_I_RET_I,     /* "(i)i" */
+    NATIVE_SHAPE_II,          /* "(ii)" */
+    NATIVE_SHAPE_II_RET_I,    /* "(ii)i" */
+    NATIVE_SHAPE_PTR_LEN,     /* "(*~)" */
+    NATIVE_SHAPE_F_RET_F,     /* "(f)f" */
+} NativeCallShape;
+#endif
+
 /**
  * Lookup global variable of a given import global
  * from libc builtin globals
@@ -53,18 +84,45 @@ void *
 wasm_native_resolve_symbol(const char *module_name, const char *field_name,
                            const WASMFuncType *func_type,
                            const char **p_signature, void **p_attachment,
-                           bool *p_call_conv_raw);
+                           bool *p_call_conv_raw, uint8 *p_fast_native);
+
+#if WASM_ENABLE_NATIVE_TRAMPOLINES != 0
+/**
+ * Get the call shape of a resolved native, once when the import is linked
+ *
+ * @param func_type the function prototype of the import function
+ * @param signature the signature of the native, NULL if it has none
+ *
+ * @return the NativeCallShape, NATIVE_SHAPE_GENERIC if the native must be
+ *         called with wasm_runtime_invoke_native()
+ */
+uint8
+wasm_native_get_call_shape(const WASMFuncType *func_type,
+                           const char *signature);
+#endif
 
 bool
 wasm_native_register_natives(const char *module_name,
                              NativeSymbol *native_symbols,
                              uint32 n_native_symbols);
 
+bool
+wasm_native_register_natives_sorted(const char *module_name,
+                                    const NativeSymbol *native_symbols,
+                                    uint32 n_native_symbols);
+
 bool
 wasm_native_register_natives_raw(const char *module_name,
                                  NativeSymbol *native_symbols,
                                  uint32 n_native_symbols);
 
+#if WASM_ENABLE_FAST_NATIVES != 0
+bool
+wasm_native_register_natives_fast(const char *module_name,
+                                  NativeSymbol *native_symbols,
+                                  uint32 n_native_symbols, bool leaf);
+#endif
+
 bool
 wasm_native_unregister_natives(const char *module_name,
                                NativeSymbol *native_symbols);
@@ -12,6 +12,7 @@
 #include "wasm_memory.h"
 #if WASM_ENABLE_INTERP != 0
 #include "../interpreter/wasm_runtime.h"
+#include "../interpreter/wasm_interp.h"
 #endif
 #if WASM_ENABLE_AOT != 0
 #include "../aot/aot_runtime.h"
@@ -882,8 +883,15 @@ get_package_type(const uint8 *buf, uint32 size)
 {
     if (buf && size >= 4) {
 #if (WASM_ENABLE_WORD_ALIGN_READ != 0)
-        uint32 buf32 = *(uint32 *)buf;
-        buf = (const uint8 *)&buf32;
+        uint32 buf32;
+
+        /* Only a word read works on the instruction bus, whose mappings are
+           aligned. Other buffers may be at any address, e.g. a bytecode
+           module read from a file into a struct */
+        if (((uintptr_t)buf & 3) == 0) {
+            buf32 = *(uint32 *)buf;
+            buf = (const uint8 *)&buf32;
+        }
 #endif
         if (buf[0] == '\0' && buf[1] == 'a' && buf[2] == 's' && buf[3] == 'm')
             return Wasm_Module_Bytecode;
@@ -913,14 +921,18 @@ uint32
 wasm_runtime_get_file_package_version(const uint8 *buf, uint32 size)
 {
     if (buf && size >= 8) {
+        const uint8 *p = buf + sizeof(uint32);
         uint32 version;
 #if (WASM_ENABLE_WORD_ALIGN_READ != 0)
-        uint32 buf32 = *(uint32 *)(buf + sizeof(uint32));
-        buf = (const uint8 *)&buf32;
-        version = buf[0] | buf[1] << 8 | buf[2] << 16 | buf[3] << 24;
-#else
-        version = buf[4] | buf[5] << 8 | buf[6] << 16 | buf[7] << 24;
+        uint32 buf32;
+
+        /* See get_package_type() */
+        if (((uintptr_t)buf & 3) == 0) {
+            buf32 = *(uint32 *)p;
+            p = (const uint8 *)&buf32;
+        }
 #endif
+        version = p[0] | p[1] << 8 | p[2] << 16 | p[3] << 24;
         return version;
     }
 
@@ -1596,6 +1608,77 @@ wasm_runtime_unload(WASMModuleCommon *module)
 #endif
 }
 
+uint32
+wasm_runtime_save_code_cache(WASMModuleCommon *const module, uint8 *buf,
+                             uint32 buf_size)
+{
+#if WASM_ENABLE_INTERP != 0 && WASM_ENABLE_FAST_INTERP != 0
+    if (module && module->module_type == Wasm_Module_Bytecode)
+        return wasm_loader_save_code_cache((WASMModule *)module, buf,
+                                           buf_size);
+#endif
+    (void)module;
+    (void)buf;
+    (void)buf_size;
+    return 0;
+}
+
+bool
+wasm_runtime_is_code_cache_used(WASMModuleCommon *const module)
+{
+#if WASM_ENABLE_INTERP != 0 && WASM_ENABLE_FAST_INTERP != 0
+    if (module && module->module_type == Wasm_Module_Bytecode)
+        return ((WASMModule *)module)->code_cache_used;
+#endif
+    (void)module;
+    return false;
+}
+
+bool
+wasm_runtime_get_lazy_lowering_stats(WASMModuleCommon *const module,
+                                     uint32 *lowered_count,
+                                     uint64 *lowering_time_us)
+{
+#if WASM_ENABLE_INTERP != 0 && WASM_ENABLE_FAST_INTERP != 0
+    if (module && module->module_type == Wasm_Module_Bytecode
+        && ((WASMModule *)module)->lazy_lowering) {
+        WASMModule *wasm_module = (WASMModule *)module;
+
+        os_mutex_lock(&wasm_module->lazy_lowering_lock);
+        *lowered_count = wasm_module->lazy_lowered_count;
+        *lowering_time_us = wasm_module->lazy_lowering_time_us;
+        os_mutex_unlock(&wasm_module->lazy_lowering_lock);
+        return true;
+    }
+#endif
+    (void)module;
+    *lowered_count = 0;
+    *lowering_time_us = 0;
+    return false;
+}
+
+uint64
+wasm_runtime_get_opcode_count(uint32 opcode, const char **name)
+{
+#if WASM_ENABLE_INTERP != 0 && WASM_ENABLE_FAST_INTERP != 0 \
+    && WASM_ENABLE_OPCODE_COUNTER != 0
+    return wasm_interp_get_opcode_count(opcode, name);
+#else
+    (void)opcode;
+    *name = NULL;
+    return 0;
+#endif
+}
+
+void
+wasm_runtime_reset_opcode_counts(void)
+{
+#if WASM_ENABLE_INTERP != 0 && WASM_ENABLE_FAST_INTERP != 0 \
+    && WASM_ENABLE_OPCODE_COUNTER != 0
+    wasm_interp_reset_opcode_counts();
+#endif
+}
+
 uint32
 wasm_runtime_get_max_mem(uint32 max_memory_pages, uint32 module_init_page_count,
                          uint32 module_max_page_count)
@@ -1782,6 +1865,121 @@ wasm_runtime_deinstantiate(WASMModuleInstanceCommon *module_inst)
     wasm_runtime_deinstantiate_internal(module_inst, false);
 }
 
+bool
+wasm_runtime_reset_instance(WASMModuleInstanceCommon *module_inst,
+                            char *error_buf, uint32 error_buf_size)
+{
+#if WASM_ENABLE_INSTANCE_RESET != 0
+    if (module_inst->module_type == Wasm_Module_Bytecode)
+        return wasm_reset_instance((WASMModuleInstance *)module_inst,
+                                   error_buf, error_buf_size);
+    set_error_buf(error_buf, error_buf_size,
+                  "only interpreter instances can be reset");
+#else
+    (void)module_inst;
+    set_error_buf(error_buf, error_buf_size,
+                  "instance reset isn't enabled, build with "
+                  "WASM_ENABLE_INSTANCE_RESET=1");
+#endif
+    return false;
+}
+
+#if WASM_ENABLE_INSTANCE_SNAPSHOT == 0
+static void
+set_snapshot_disabled_error(char *error_buf, uint32 error_buf_size)
+{
+    set_error_buf(error_buf, error_buf_size,
+                  "instance snapshots aren't enabled, build with "
+                  "WASM_ENABLE_INSTANCE_SNAPSHOT=1");
+}
+#endif
+
+struct WASMInstanceSnapshot *
+wasm_runtime_snapshot_instance(WASMModuleInstanceCommon *module_inst,
+                               char *error_buf, uint32 error_buf_size)
+{
+#if WASM_ENABLE_INSTANCE_SNAPSHOT != 0
+    if (module_inst->module_type == Wasm_Module_Bytecode)
+        return wasm_snapshot_instance((WASMModuleInstance *)module_inst,
+                                      error_buf, error_buf_size);
+    set_error_buf(error_buf, error_buf_size,
+                  "only interpreter instances can be snapshotted");
+#else
+    (void)module_inst;
+    set_snapshot_disabled_error(error_buf, error_buf_size);
+#endif
+    return NULL;
+}
+
+bool
+wasm_runtime_restore_instance(WASMModuleInstanceCommon *module_inst,
+                              struct WASMInstanceSnapshot *const snapshot,
+                              char *error_buf, uint32 error_buf_size)
+{
+#if WASM_ENABLE_INSTANCE_SNAPSHOT != 0
+    if (module_inst->module_type == Wasm_Module_Bytecode)
+        return wasm_restore_instance((WASMModuleInstance *)module_inst,
+                                     snapshot, error_buf, error_buf_size);
+    set_error_buf(error_buf, error_buf_size,
+                  "only interpreter instances can be restored");
+#else
+    (void)module_inst;
+    (void)snapshot;
+    set_snapshot_disabled_error(error_buf, error_buf_size);
+#endif
+    return false;
+}
+
+WASMModuleInstanceCommon *
+wasm_runtime_instantiate_from_snapshot(
+    WASMModuleCommon *const module, struct WASMInstanceSnapshot *const snapshot,
+    uint32 default_stack_size, char *error_buf, uint32 error_buf_size)
+{
+#if WASM_ENABLE_INSTANCE_SNAPSHOT != 0
+    struct InstantiationArgs2 args;
+
+    if (!wasm_snapshot_is_of_module(snapshot, module)) {
+        set_error_buf(error_buf, error_buf_size,
+                      "snapshot is of another module");
+        return NULL;
+    }
+
+    wasm_runtime_instantiation_args_set_defaults(&args);
+    wasm_runtime_instantiation_args_set_default_stack_size(
+        &args, default_stack_size);
+    args.snapshot = snapshot;
+    return wasm_runtime_instantiate_internal(module, NULL, NULL, &args,
+                                             error_buf, error_buf_size);
+#else
+    (void)module;
+    (void)snapshot;
+    (void)default_stack_size;
+    set_snapshot_disabled_error(error_buf, error_buf_size);
+    return NULL;
+#endif
+}
+
+uint64
+wasm_runtime_get_snapshot_size(struct WASMInstanceSnapshot *const snapshot)
+{
+#if WASM_ENABLE_INSTANCE_SNAPSHOT != 0
+    return wasm_snapshot_get_size(snapshot);
+#else
+    (void)snapshot;
+    return 0;
+#endif
+}
+
+void
+wasm_runtime_destroy_snapshot(struct WASMInstanceSnapshot *snapshot)
+{
+#if WASM_ENABLE_INSTANCE_SNAPSHOT != 0
+    wasm_destroy_snapshot(snapshot);
+#else
+    (void)snapshot;
+#endif
+}
+
 WASMModuleCommon *
 wasm_runtime_get_module(WASMModuleInstanceCommon *module_inst)
 {
@@ -1867,6 +2065,8 @@ wasm_runtime_init_thread_env(void)
 void
 wasm_runtime_destroy_thread_env(void)
 {
+    wasm_runtime_flush_thread_alloc_cache();
+
 #ifdef OS_ENABLE_HW_BOUND_CHECK
     runtime_signal_destroy();
 #endif
@@ -2134,6 +2334,46 @@ wasm_runtime_set_module_inst(WASMExecEnv *exec_env,
     wasm_exec_env_set_module_inst(exec_env, module_inst);
 }
 
+/* Fill global_inst with the global global_index of module_inst */
+static void
+export_global_inst(WASMModuleInstanceCommon *const module_inst,
+                   uint32 global_index, wasm_global_inst_t *global_inst)
+{
+#if WASM_ENABLE_INTERP != 0
+    if (module_inst->module_type == Wasm_Module_Bytecode) {
+        const WASMModuleInstance *wasm_module_inst =
+            (const WASMModuleInstance *)module_inst;
+        const WASMModuleInstanceExtra *e =
+            (WASMModuleInstanceExtra *)wasm_module_inst->e;
+        const WASMGlobalInstance *global = &e->globals[global_index];
+        global_inst->kind = val_type_to_val_kind(global->type);
+        global_inst->is_mutable = global->is_mutable;
+#if WASM_ENABLE_MULTI_MODULE == 0
+        global_inst->global_data =
+            wasm_module_inst->global_data + global->data_offset;
+#else
+        global_inst->global_data =
+            global->import_global_inst
+                ? global->import_module_inst->global_data
+                      + global->import_global_inst->data_offset
+                : wasm_module_inst->global_data + global->data_offset;
+#endif
+    }
+#endif
+#if WASM_ENABLE_AOT != 0
+    if (module_inst->module_type == Wasm_Module_AoT) {
+        const AOTModuleInstance *aot_module_inst =
+            (AOTModuleInstance *)module_inst;
+        const AOTModule *aot_module = (AOTModule *)aot_module_inst->module;
+        const AOTGlobal *global = &aot_module->globals[global_index];
+        global_inst->kind = val_type_to_val_kind(global->type.val_type);
+        global_inst->is_mutable = global->type.is_mutable;
+        global_inst->global_data =
+            aot_module_inst->global_data + global->data_offset;
+    }
+#endif
+}
+
 bool
 wasm_runtime_get_export_global_inst(WASMModuleInstanceCommon *const module_inst,
                                     char const *name,
@@ -2141,30 +2381,15 @@ wasm_runtime_get_export_global_inst(WASMModuleInstanceCommon *const module_inst,
 {
 #if WASM_ENABLE_INTERP != 0
     if (module_inst->module_type == Wasm_Module_Bytecode) {
-        const WASMModuleInstance *wasm_module_inst =
-            (const WASMModuleInstance *)module_inst;
-        const WASMModule *wasm_module = wasm_module_inst->module;
+        const WASMModule *wasm_module =
+            ((const WASMModuleInstance *)module_inst)->module;
         uint32 i;
         for (i = 0; i < wasm_module->export_count; i++) {
             const WASMExport *wasm_export = &wasm_module->exports[i];
             if ((wasm_export->kind == WASM_IMPORT_EXPORT_KIND_GLOBAL)
                 && !strcmp(wasm_export->name, name)) {
-                const WASMModuleInstanceExtra *e =
-                    (WASMModuleInstanceExtra *)wasm_module_inst->e;
-                const WASMGlobalInstance *global =
-                    &e->globals[wasm_export->index];
-                global_inst->kind = val_type_to_val_kind(global->type);
-                global_inst->is_mutable = global->is_mutable;
-#if WASM_ENABLE_MULTI_MODULE == 0
-                global_inst->global_data =
-                    wasm_module_inst->global_data + global->data_offset;
-#else
-                global_inst->global_data =
-                    global->import_global_inst
-                        ? global->import_module_inst->global_data
-                              + global->import_global_inst->data_offset
-                        : wasm_module_inst->global_data + global->data_offset;
-#endif
+                export_global_inst(module_inst, wasm_export->index,
+                                   global_inst);
                 return true;
             }
         }
@@ -2172,20 +2397,15 @@ wasm_runtime_get_export_global_inst(WASMModuleInstanceCommon *const module_inst,
 #endif
 #if WASM_ENABLE_AOT != 0
     if (module_inst->module_type == Wasm_Module_AoT) {
-        const AOTModuleInstance *aot_module_inst =
-            (AOTModuleInstance *)module_inst;
-        const AOTModule *aot_module = (AOTModule *)aot_module_inst->module;
+        const AOTModule *aot_module =
+            (AOTModule *)((AOTModuleInstance *)module_inst)->module;
         uint32 i;
         for (i = 0; i < aot_module->export_count; i++) {
             const AOTExport *aot_export = &aot_module->exports[i];
             if ((aot_export->kind == WASM_IMPORT_EXPORT_KIND_GLOBAL)
                 && !strcmp(aot_export->name, name)) {
-                const AOTGlobal *global =
-                    &aot_module->globals[aot_export->index];
-                global_inst->kind = val_type_to_val_kind(global->type.val_type);
-                global_inst->is_mutable = global->type.is_mutable;
-                global_inst->global_data =
-                    aot_module_inst->global_data + global->data_offset;
+                export_global_inst(module_inst, aot_export->index,
+                                   global_inst);
                 return true;
             }
         }
@@ -2692,6 +2912,78 @@ wasm_runtime_call_wasm(WASMExecEnv *exec_env,
     return ret;
 }
 
+bool
+wasm_runtime_call_wasm_batch(WASMExecEnv *exec_env,
+                             WASMFunctionInstanceCommon *function, uint32 argc,
+                             uint32 argv_matrix[], uint32 count,
+                             uint32 *p_failed_index)
+{
+    WASMFuncType *func_type;
+    uint32 i;
+    bool ret = false;
+
+    if (!wasm_runtime_exec_env_check(exec_env)) {
+        LOG_ERROR("Invalid exec env stack info.");
+        return false;
+    }
+
+    func_type = wasm_runtime_get_function_type(
+        function, exec_env->module_inst->module_type);
+    bh_assert(func_type);
+
+    if (argc < func_type->param_cell_num || argc < func_type->ret_cell_num) {
+        wasm_runtime_set_exception(exec_env->module_inst,
+                                   "batch row smaller than function cells");
+        if (p_failed_index)
+            *p_failed_index = 0;
+        return false;
+    }
+
+    if (count == 0)
+        return true;
+
+#if WASM_ENABLE_GC == 0 && WASM_ENABLE_REF_TYPES != 0
+    /* externref arguments and results need per-call conversion */
+    for (i = 0; i < (uint32)(func_type->param_count + func_type->result_count);
+         i++) {
+        if (func_type->types[i] == VALUE_TYPE_EXTERNREF) {
+            for (i = 0; i < count; i++) {
+                if (!wasm_runtime_call_wasm(exec_env, function, argc,
+                                            argv_matrix + (uint64)argc * i)) {
+                    if (p_failed_index)
+                        *p_failed_index = i;
+                    return false;
+                }
+            }
+            return true;
+        }
+    }
+#endif
+
+#if WASM_ENABLE_INTERP != 0
+    if (exec_env->module_inst->module_type == Wasm_Module_Bytecode)
+        ret = wasm_call_function_batch(exec_env,
+                                       (WASMFunctionInstance *)function, argc,
+                                       argv_matrix, count, p_failed_index);
+#endif
+#if WASM_ENABLE_AOT != 0
+    if (exec_env->module_inst->module_type == Wasm_Module_AoT) {
+        ret = true;
+        for (i = 0; i < count; i++) {
+            if (!aot_call_function(exec_env, (AOTFunctionInstance *)function,
+                                   argc, argv_matrix + (uint64)argc * i)) {
+                if (p_failed_index)
+                    *p_failed_index = i;
+                ret = false;
+                break;
+            }
+        }
+    }
+#endif
+    (void)i;
+    return ret;
+}
+
 static void
 parse_args_to_uint32_array(WASMFuncType *type, wasm_val_t *args,
                            uint32 *out_argv)
@@ -4564,6 +4856,135 @@ wasm_runtime_get_export_type(WASMModuleCommon *const module, int32 export_index,
 #endif
 }
 
+int32
+wasm_runtime_get_export_index(WASMModuleCommon *const module,
+                              const char *name,
+                              wasm_import_export_kind_t kind)
+{
+    uint32 i;
+
+    if (!module || !name) {
+        bh_assert(0);
+        return -1;
+    }
+
+#if WASM_ENABLE_AOT != 0
+    if (module->module_type == Wasm_Module_AoT) {
+        const AOTModule *aot_module = (const AOTModule *)module;
+
+        for (i = 0; i < aot_module->export_count; i++) {
+            if (aot_module->exports[i].kind == kind
+                && !strcmp(aot_module->exports[i].name, name))
+                return (int32)i;
+        }
+    }
+#endif
+#if WASM_ENABLE_INTERP != 0
+    if (module->module_type == Wasm_Module_Bytecode) {
+        const WASMModule *wasm_module = (const WASMModule *)module;
+
+        for (i = 0; i < wasm_module->export_count; i++) {
+            if (wasm_module->exports[i].kind == kind
+                && !strcmp(wasm_module->exports[i].name, name))
+                return (int32)i;
+        }
+    }
+#endif
+
+    return -1;
+}
+
+/* Index in its own index space of the export export_index of the module of
+   module_inst, if the export is of the given kind */
+static bool
+get_export_item_index(WASMModuleInstanceCommon *const module_inst,
+                      int32 export_index, uint8 kind, uint32 *p_index)
+{
+#if WASM_ENABLE_AOT != 0
+    if (module_inst->module_type == Wasm_Module_AoT) {
+        const AOTModule *aot_module =
+            (AOTModule *)((AOTModuleInstance *)module_inst)->module;
+
+        if (export_index < 0 || (uint32)export_index >= aot_module->export_count
+            || aot_module->exports[export_index].kind != kind)
+            return false;
+        *p_index = aot_module->exports[export_index].index;
+        return true;
+    }
+#endif
+#if WASM_ENABLE_INTERP != 0
+    if (module_inst->module_type == Wasm_Module_Bytecode) {
+        const WASMModule *wasm_module =
+            ((WASMModuleInstance *)module_inst)->module;
+
+        if (export_index < 0
+            || (uint32)export_index >= wasm_module->export_count
+            || wasm_module->exports[export_index].kind != kind)
+            return false;
+        *p_index = wasm_module->exports[export_index].index;
+        return true;
+    }
+#endif
+
+    return false;
+}
+
+WASMFunctionInstanceCommon *
+wasm_runtime_get_export_function_by_index(
+    WASMModuleInstanceCommon *const module_inst, int32 export_index)
+{
+    uint32 func_index;
+
+    if (!get_export_item_index(module_inst, export_index,
+                               WASM_IMPORT_EXPORT_KIND_FUNC, &func_index))
+        return NULL;
+
+#if WASM_ENABLE_INTERP != 0
+    /* The instance wasm_lookup_function() finds through export_functions */
+    if (module_inst->module_type == Wasm_Module_Bytecode) {
+        WASMModuleInstance *wasm_module_inst =
+            (WASMModuleInstance *)module_inst;
+        return (WASMFunctionInstanceCommon *)&wasm_module_inst->e
+            ->functions[func_index];
+    }
+#endif
+#if WASM_ENABLE_AOT != 0
+    if (module_inst->module_type == Wasm_Module_AoT)
+        return (WASMFunctionInstanceCommon *)aot_lookup_function_with_idx(
+            (AOTModuleInstance *)module_inst, func_index);
+#endif
+
+    return NULL;
+}
+
+bool
+wasm_runtime_get_export_global_inst_by_index(
+    WASMModuleInstanceCommon *const module_inst, int32 export_index,
+    wasm_global_inst_t *global_inst)
+{
+    uint32 global_index;
+
+    if (!get_export_item_index(module_inst, export_index,
+                               WASM_IMPORT_EXPORT_KIND_GLOBAL, &global_index))
+        return false;
+
+    export_global_inst(module_inst, global_index, global_inst);
+    return true;
+}
+
+WASMMemoryInstance *
+wasm_runtime_get_export_memory_by_index(
+    WASMModuleInstanceCommon *const module_inst, int32 export_index)
+{
+    uint32 memory_index;
+
+    if (!get_export_item_index(module_inst, export_index,
+                               WASM_IMPORT_EXPORT_KIND_MEMORY, &memory_index))
+        return NULL;
+
+    return wasm_runtime_get_memory(module_inst, memory_index);
+}
+
 uint32
 wasm_func_type_get_param_count(WASMFuncType *const func_type)
 {
@@ -4732,6 +5153,15 @@ wasm_runtime_register_natives(const char *module_name,
                                         n_native_symbols);
 }
 
+bool
+wasm_runtime_register_natives_sorted(const char *module_name,
+                                     const NativeSymbol *native_symbols,
+                                     uint32 n_native_symbols)
+{
+    return wasm_native_register_natives_sorted(module_name, native_symbols,
+                                               n_native_symbols);
+}
+
 bool
 wasm_runtime_register_natives_raw(const char *module_name,
                                   NativeSymbol *native_symbols,
@@ -4741,6 +5171,17 @@ wasm_runtime_register_natives_raw(const char *module_name,
                                             n_native_symbols);
 }
 
+#if WASM_ENABLE_FAST_NATIVES != 0
+bool
+wasm_runtime_register_natives_fast(const char *module_name,
+                                   NativeSymbol *native_symbols,
+                                   uint32 n_native_symbols, bool leaf)
+{
+    return wasm_native_register_natives_fast(module_name, native_symbols,
+                                             n_native_symbols, leaf);
+}
+#endif
+
 bool
 wasm_runtime_unregister_natives(const char *module_name,
                                 NativeSymbol *native_symbols)
@@ -4995,6 +5436,84 @@ fail:
     return ret;
 }
 
+#if WASM_ENABLE_NATIVE_TRAMPOLINES != 0
+bool
+wasm_runtime_invoke_native_shape(WASMExecEnv *exec_env, void *func_ptr,
+                                 uint8 shape, void *attachment, uint32 *argv,
+                                 uint32 *argv_ret)
+{
+    WASMModuleInstanceCommon *module = wasm_runtime_get_module_inst(exec_env);
+    void *native_addr;
+    float32 arg_f32, ret_f32;
+
+    exec_env->attachment = attachment;
+    switch (shape) {
+        case NATIVE_SHAPE_VOID:
+            ((void (*)(WASMExecEnv *))func_ptr)(exec_env);
+            break;
+        case NATIVE_SHAPE_RET_I:
+            argv_ret[0] =
+                (uint32)((int32(*)(WASMExecEnv *))func_ptr)(exec_env);
+            break;
+        case NATIVE_SHAPE_I:
+            ((void (*)(WASMExecEnv *, int32))func_ptr)(exec_env,
+                                                        (int32)argv[0]);
+            break;
+        case NATIVE_SHAPE_I_RET_I:
+            argv_ret[0] = (uint32)((int32(*)(WASMExecEnv *, int32))func_ptr)(
+                exec_env, (int32)argv[0]);
+            break;
+        case NATIVE_SHAPE_II:
+            ((void (*)(WASMExecEnv *, int32, int32))func_ptr)(
+                exec_env, (int32)argv[0], (int32)argv[1]);
+            break;
+        case NATIVE_SHAPE_II_RET_I:
+            argv_ret[0] =
+                (uint32)((int32(*)(WASMExecEnv *, int32, int32))func_ptr)(
+                    exec_env, (int32)argv[0], (int32)argv[1]);
+            break;
+        case NATIVE_SHAPE_PTR_LEN:
+            /* Checked as wasm_runtime_invoke_native() does for '*~' */
+            if (!wasm_runtime_validate_app_addr(module, (uint64)argv[0],
+                                                (uint64)argv[1])) {
+                exec_env->attachment = NULL;
+                return false;
+            }
+            native_addr =
+                wasm_runtime_addr_app_to_native(module, (uint64)argv[0]);
+            ((void (*)(WASMExecEnv *, void *, uint32))func_ptr)(
+                exec_env, native_addr, argv[1]);
+            break;
+        case NATIVE_SHAPE_F_RET_F:
+            bh_memcpy_s(&arg_f32, sizeof(float32), argv, sizeof(uint32));
+            ret_f32 = ((float32(*)(WASMExecEnv *, float32))func_ptr)(exec_env,
+                                                                     arg_f32);
+            bh_memcpy_s(argv_ret, sizeof(uint32), &ret_f32, sizeof(float32));
+            break;
+        default:
+            bh_assert(0);
+            break;
+    }
+    exec_env->attachment = NULL;
+
+    return !wasm_runtime_copy_exception(module, NULL);
+}
+#endif /* end of WASM_ENABLE_NATIVE_TRAMPOLINES != 0 */
+
+#if WASM_ENABLE_FAST_NATIVES != 0
+bool
+wasm_runtime_invoke_native_fast(WASMExecEnv *exec_env, void *func_ptr,
+                                void *attachment, uint32 *cells)
+{
+    exec_env->attachment = attachment;
+    ((void (*)(WASMExecEnv *, uint32 *))func_ptr)(exec_env, cells);
+    exec_env->attachment = NULL;
+
+    return !wasm_runtime_copy_exception(
+        wasm_runtime_get_module_inst(exec_env), NULL);
+}
+#endif /* end of WASM_ENABLE_FAST_NATIVES != 0 */
+
 /**
  * Implementation of wasm_runtime_invoke_native()
  */
@@ -7429,7 +7948,7 @@ wasm_runtime_is_import_func_linked(const char *module_name,
                                    const char *func_name)
 {
     return wasm_native_resolve_symbol(module_name, func_name, NULL, NULL, NULL,
-                                      NULL);
+                                      NULL, NULL);
 }
 
 bool
@@ -614,6 +614,11 @@ wasm_runtime_get_exec_env_tls(void);
 
 struct InstantiationArgs2 {
     InstantiationArgs v1;
+#if WASM_ENABLE_INSTANCE_SNAPSHOT != 0
+    /* Set by wasm_runtime_instantiate_from_snapshot(), the instance is
+       made in the state of the snapshot */
+    const struct WASMInstanceSnapshot *snapshot;
+#endif
 };
 
 void
@@ -677,6 +682,29 @@ wasm_runtime_load_from_sections(WASMSection *section_list, bool is_aot,
 WASM_RUNTIME_API_EXTERN void
 wasm_runtime_unload(WASMModuleCommon *module);
 
+/* See wasm_export.h for description */
+WASM_RUNTIME_API_EXTERN uint32
+wasm_runtime_save_code_cache(WASMModuleCommon *const module, uint8 *buf,
+                             uint32 buf_size);
+
+/* See wasm_export.h for description */
+WASM_RUNTIME_API_EXTERN bool
+wasm_runtime_is_code_cache_used(WASMModuleCommon *const module);
+
+/* See wasm_export.h for description */
+WASM_RUNTIME_API_EXTERN bool
+wasm_runtime_get_lazy_lowering_stats(WASMModuleCommon *const module,
+                                     uint32 *lowered_count,
+                                     uint64 *lowering_time_us);
+
+/* See wasm_export.h for description */
+WASM_RUNTIME_API_EXTERN uint64
+wasm_runtime_get_opcode_count(uint32 opcode, const char **name);
+
+/* See wasm_export.h for description */
+WASM_RUNTIME_API_EXTERN void
+wasm_runtime_reset_opcode_counts(void);
+
 /* Internal API */
 uint32
 wasm_runtime_get_max_mem(uint32 max_memory_pages, uint32 module_init_page_count,
@@ -754,6 +782,36 @@ wasm_runtime_get_running_mode(wasm_module_inst_t module_inst);
 WASM_RUNTIME_API_EXTERN void
 wasm_runtime_deinstantiate(WASMModuleInstanceCommon *module_inst);
 
+/* See wasm_export.h for description */
+WASM_RUNTIME_API_EXTERN bool
+wasm_runtime_reset_instance(WASMModuleInstanceCommon *module_inst,
+                            char *error_buf, uint32 error_buf_size);
+
+/* See wasm_export.h for description */
+WASM_RUNTIME_API_EXTERN struct WASMInstanceSnapshot *
+wasm_runtime_snapshot_instance(WASMModuleInstanceCommon *module_inst,
+                               char *error_buf, uint32 error_buf_size);
+
+/* See wasm_export.h for description */
+WASM_RUNTIME_API_EXTERN bool
+wasm_runtime_restore_instance(WASMModuleInstanceCommon *module_inst,
+                              struct WASMInstanceSnapshot *const snapshot,
+                              char *error_buf, uint32 error_buf_size);
+
+/* See wasm_export.h for description */
+WASM_RUNTIME_API_EXTERN WASMModuleInstanceCommon *
+wasm_runtime_instantiate_from_snapshot(
+    WASMModuleCommon *const module, struct WASMInstanceSnapshot *const snapshot,
+    uint32 default_stack_size, char *error_buf, uint32 error_buf_size);
+
+/* See wasm_export.h for description */
+WASM_RUNTIME_API_EXTERN uint64
+wasm_runtime_get_snapshot_size(struct WASMInstanceSnapshot *const snapshot);
+
+/* See wasm_export.h for description */
+WASM_RUNTIME_API_EXTERN void
+wasm_runtime_destroy_snapshot(struct WASMInstanceSnapshot *snapshot);
+
 /* See wasm_export.h for description */
 WASM_RUNTIME_API_EXTERN WASMModuleCommon *
 wasm_runtime_get_module(WASMModuleInstanceCommon *module_inst);
@@ -863,6 +921,13 @@ wasm_runtime_call_wasm(WASMExecEnv *exec_env,
                        WASMFunctionInstanceCommon *function, uint32 argc,
                        uint32 argv[]);
 
+/* See wasm_export.h for description */
+WASM_RUNTIME_API_EXTERN bool
+wasm_runtime_call_wasm_batch(WASMExecEnv *exec_env,
+                             WASMFunctionInstanceCommon *function, uint32 argc,
+                             uint32 argv_matrix[], uint32 count,
+                             uint32 *p_failed_index);
+
 WASM_RUNTIME_API_EXTERN bool
 wasm_runtime_call_wasm_a(WASMExecEnv *exec_env,
                          WASMFunctionInstanceCommon *function,
@@ -1223,12 +1288,26 @@ wasm_runtime_register_natives(const char *module_name,
                               NativeSymbol *native_symbols,
                               uint32 n_native_symbols);
 
+/* See wasm_export.h for description */
+WASM_RUNTIME_API_EXTERN bool
+wasm_runtime_register_natives_sorted(const char *module_name,
+                                     const NativeSymbol *native_symbols,
+                                     uint32 n_native_symbols);
+
 /* See wasm_export.h for description */
 WASM_RUNTIME_API_EXTERN bool
 wasm_runtime_register_natives_raw(const char *module_name,
                                   NativeSymbol *native_symbols,
                                   uint32 n_native_symbols);
 
+#if WASM_ENABLE_FAST_NATIVES != 0
+/* See wasm_export.h for description */
+WASM_RUNTIME_API_EXTERN bool
+wasm_runtime_register_natives_fast(const char *module_name,
+                                   NativeSymbol *native_symbols,
+                                   uint32 n_native_symbols, bool leaf);
+#endif
+
 /* See wasm_export.h for description */
 WASM_RUNTIME_API_EXTERN bool
 wasm_runtime_unregister_natives(const char *module_name,
@@ -1266,6 +1345,24 @@ wasm_runtime_invoke_native_raw(WASMExecEnv *exec_env, void *func_ptr,
                                const char *signature, void *attachment,
                                uint32 *argv, uint32 argc, uint32 *ret);
 
+#if WASM_ENABLE_NATIVE_TRAMPOLINES != 0
+/* Call a native of a NativeCallShape other than NATIVE_SHAPE_GENERIC with
+   a direct C call, see wasm_native_get_call_shape(). argv holds the params'
+   cells and argv_ret receives the result's */
+bool
+wasm_runtime_invoke_native_shape(WASMExecEnv *exec_env, void *func_ptr,
+                                 uint8 shape, void *attachment, uint32 *argv,
+                                 uint32 *argv_ret);
+#endif
+
+#if WASM_ENABLE_FAST_NATIVES != 0
+/* Call a native registered with wasm_runtime_register_natives_fast(), which
+   reads its params from cells and writes its result back from cells[0] */
+bool
+wasm_runtime_invoke_native_fast(WASMExecEnv *exec_env, void *func_ptr,
+                                void *attachment, uint32 *cells);
+#endif
+
 void
 wasm_runtime_read_v128(const uint8 *bytes, uint64 *ret1, uint64 *ret2);
 
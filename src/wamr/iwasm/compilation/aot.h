@@ -199,6 +199,8 @@ typedef struct AOTImportFunc {
     bool call_conv_raw;
     bool call_conv_wasm_c_api;
     bool wasm_c_api_with_env;
+    /* FastNativeKind of the linked native */
+    uint8 fast_native;
 } AOTImportFunc;
 
 /**
@@ -157,6 +157,10 @@ typedef struct WASMExecEnv *wasm_exec_env_t;
 struct WASMSharedHeap;
 typedef struct WASMSharedHeap *wasm_shared_heap_t;
 
+/* Saved state of an initialized module instance */
+struct WASMInstanceSnapshot;
+typedef struct WASMInstanceSnapshot *wasm_instance_snapshot_t;
+
 /* Package Type */
 typedef enum {
     Wasm_Module_Bytecode = 0,
@@ -164,6 +168,26 @@ typedef enum {
     Package_Type_Unknown = 0xFFFF
 } package_type_t;
 
+/* Classes of the runtime's objects, which the embedder can place in a fast
+   memory pool, see MemAllocOption.pool.fast_heap_buf */
+typedef enum {
+    /* module metadata, and every block not in another class */
+    Mem_Class_Metadata = 0,
+    /* exec_env operand stacks, which hold the frames of the interpreter */
+    Mem_Class_Stack,
+    /* linear memories, with the app heaps inside them */
+    Mem_Class_LinearMemory,
+    /* code of the functions lowered by the fast interpreter */
+    Mem_Class_Code,
+    /* constant tables of the lowered functions */
+    Mem_Class_Consts,
+    /* module instances, with their globals, memory and table instances */
+    Mem_Class_Instance,
+    Mem_Class_Num,
+} mem_class_t;
+
+#define MEM_CLASS_BIT(mem_class) (1u << (mem_class))
+
 #ifndef MEM_ALLOC_OPTION_DEFINED
 #define MEM_ALLOC_OPTION_DEFINED
 /* Memory allocator type */
@@ -180,11 +204,30 @@ typedef enum {
 
 typedef enum { Alloc_For_Runtime, Alloc_For_LinearMemory } mem_alloc_usage_t;
 
+/* Allocator managing the heap buffer in pool mode */
+typedef enum {
+    /* the build's DEFAULT_MEM_ALLOCATOR, EMS unless configured */
+    Pool_Allocator_Default = 0,
+    Pool_Allocator_EMS,
+    /* bounded-latency allocator, requires WASM_ENABLE_TLSF_ALLOCATOR */
+    Pool_Allocator_TLSF,
+} pool_allocator_type_t;
+
 /* Memory allocator option */
 typedef union MemAllocOption {
     struct {
         void *heap_buf;
         uint32_t heap_size;
+        pool_allocator_type_t allocator_type;
+        /* optional second pool in faster memory, e.g. internal SRAM when
+           heap_buf is in PSRAM, managed by the same allocator type. The
+           blocks of the classes set in fast_mem_classes (MEM_CLASS_BIT of
+           mem_class_t) come from it, and from heap_buf when it is full.
+           With a fast pool, linear memories come from one of the pools
+           instead of the system heap. Requires WASM_ENABLE_MEM_PLACEMENT */
+        void *fast_heap_buf;
+        uint32_t fast_heap_size;
+        uint32_t fast_mem_classes;
     } pool;
     struct {
         /* the function signature is varied when
@@ -207,6 +250,32 @@ typedef struct mem_alloc_info_t {
     uint32_t highmark_size;
 } mem_alloc_info_t;
 
+/* Per-thread allocation cache statistics, see
+   wasm_runtime_get_alloc_cache_stats() */
+typedef struct mem_alloc_cache_stats_t {
+    /* cacheable allocations served from a thread's cache */
+    uint64_t hit_count;
+    /* cacheable allocations that had to refill the cache from the pool */
+    uint64_t miss_count;
+    /* bytes of free blocks held in the caches, allocated from the pool */
+    uint32_t bytes_held;
+} mem_alloc_cache_stats_t;
+
+/* Placement statistics of an object class, see
+   wasm_runtime_get_mem_class_stats(). Code and constants carved from a
+   module's load arena (LoadArgs.load_arena) aren't counted */
+typedef struct mem_class_stats_t {
+    /* blocks allocated from the fast pool, and their bytes */
+    uint32_t fast_count;
+    uint64_t fast_bytes;
+    /* blocks allocated from the main pool, or for linear memories from
+       the system heap when the pools are full, and their bytes */
+    uint32_t main_count;
+    uint64_t main_bytes;
+    /* blocks of a class placed in the fast pool that didn't fit in it */
+    uint32_t fallback_count;
+} mem_class_stats_t;
+
 /* Running mode of runtime and module instance*/
 typedef enum RunningMode {
     Mode_Interp = 1,
@@ -271,6 +340,56 @@ typedef struct LoadArgs {
     loading. */
     bool wasm_binary_freeable;
 
+    /* False by default, used by the wasm loader only. If true, the loader
+    never writes to the wasm binary buffer, so it can live in read-only
+    memory (e.g. flash). Const strings are copied, while data segments are
+    still referenced in place, so the buffer must outlive the module. The
+    AOT loader never writes to the buffer and ignores this flag. */
+    bool wasm_binary_readonly;
+
+    /* NULL by default, used by the fast interpreter only. Code cache saved
+    by wasm_runtime_save_code_cache() for the same wasm binary: when it
+    matches the binary and this runtime build, function bodies are restored
+    from it instead of being validated and lowered again, otherwise it is
+    ignored. The cache is trusted like an AOT file and only referenced
+    while loading. */
+    const uint8_t *code_cache;
+    uint32_t code_cache_size;
+
+    /* False by default, used by the fast interpreter only. If true, the
+    loader keeps the relocation info wasm_runtime_save_code_cache() needs. */
+    bool code_cache_record;
+
+    /* False by default, used by the fast interpreter only. If true, function
+    bodies are validated and lowered on their first call instead of while
+    loading, see wasm_runtime_get_lazy_lowering_stats(). All other sections
+    are still validated while loading, and the binary must stay valid
+    until the module is unloaded. Ignored when wasm_binary_freeable or
+    code_cache_record is set, or when the code cache is used. */
+    bool lazy_lowering;
+
+    /* False by default, used by the fast interpreter only. If true, the
+    loader lowers every instruction on its own instead of fusing common
+    sequences (i32 comparison and br_if, i32.add and load) into
+    superinstructions, and i32 arithmetic on a constant reads the constant
+    from the frame instead of an immediate. Meant for measuring and
+    debugging, see WASM_ENABLE_SUPERINSTRUCTIONS. */
+    bool no_superinstructions;
+
+    /* False by default, used by the interpreter only. If true, every call
+    to a native goes through wasm_runtime_invoke_native(), instead of a
+    direct call for natives of common signatures such as "(ii)i". Meant for
+    measuring and debugging, see WASM_ENABLE_NATIVE_TRAMPOLINES. */
+    bool no_native_trampolines;
+
+    /* False by default, used by the wasm loader only, when the runtime is
+    built with WASM_ENABLE_LOAD_ARENA. If true, the module's data is carved
+    from a few large chunks of the runtime heap, all freed at once when the
+    module is unloaded, and the loader's scratch data from a region dropped
+    when loading ends, instead of each being a heap block of its own.
+    Functions lowered lazily after loading still use heap blocks. */
+    bool load_arena;
+
     /* false by default, if true, don't resolve the symbols yet. The
        wasm_runtime_load_ex has to be followed by a wasm_runtime_resolve_symbols
        call */
@@ -445,6 +564,54 @@ wasm_runtime_free(void *ptr);
 WASM_RUNTIME_API_EXTERN bool
 wasm_runtime_get_mem_alloc_info(mem_alloc_info_t *mem_alloc_info);
 
+/**
+ * Get the statistics of the per-thread allocation caches
+ * (WASM_ENABLE_THREAD_ALLOC_CACHE). A thread adds its counts when it
+ * refills or flushes a cache, so they lag behind by up to one batch per
+ * thread.
+ *
+ * @param stats returns the statistics
+ *
+ * @return true if the caches are enabled, false otherwise
+ */
+WASM_RUNTIME_API_EXTERN bool
+wasm_runtime_get_alloc_cache_stats(mem_alloc_cache_stats_t *stats);
+
+/**
+ * Return the blocks cached by the calling thread to the pool. Call it
+ * before a thread that used the runtime exits, otherwise its cached
+ * blocks stay allocated until the runtime is destroyed.
+ * wasm_runtime_destroy_thread_env() does it too.
+ */
+WASM_RUNTIME_API_EXTERN void
+wasm_runtime_flush_thread_alloc_cache(void);
+
+/**
+ * Get the memory info of the fast pool (WASM_ENABLE_MEM_PLACEMENT), see
+ * MemAllocOption.pool.fast_heap_buf
+ *
+ * @param mem_alloc_info returns the info
+ *
+ * @return true if the runtime has a fast pool, false otherwise
+ */
+WASM_RUNTIME_API_EXTERN bool
+wasm_runtime_get_fast_mem_alloc_info(mem_alloc_info_t *mem_alloc_info);
+
+/**
+ * Get the placement statistics of an object class
+ * (WASM_ENABLE_MEM_PLACEMENT). They are kept for every class but
+ * Mem_Class_Metadata, whose blocks are all the untagged ones.
+ *
+ * @param mem_class the class
+ * @param stats returns the statistics
+ *
+ * @return true if placement is enabled and mem_class is a class with
+ *         statistics, false otherwise
+ */
+WASM_RUNTIME_API_EXTERN bool
+wasm_runtime_get_mem_class_stats(mem_class_t mem_class,
+                                 mem_class_stats_t *stats);
+
 /**
  * Get the package type of a buffer.
  *
@@ -627,6 +794,70 @@ wasm_runtime_load_from_sections(wasm_section_list_t section_list, bool is_aot,
 WASM_RUNTIME_API_EXTERN void
 wasm_runtime_unload(wasm_module_t module);
 
+/**
+ * Serialize the fast interpreter code of a WASM module, so that a later
+ * wasm_runtime_load_ex() of the same binary can restore it with
+ * LoadArgs.code_cache instead of lowering the functions again.
+ *
+ * @param module the module, loaded with LoadArgs.code_cache_record
+ * @param buf the buffer to write to, or NULL to query the size
+ * @param buf_size the size of buf
+ *
+ * @return the size of the cache, 0 if the module has no recorded code or
+ * buf is too small
+ */
+WASM_RUNTIME_API_EXTERN uint32_t
+wasm_runtime_save_code_cache(const wasm_module_t module, uint8_t *buf,
+                             uint32_t buf_size);
+
+/**
+ * Check whether a WASM module was restored from LoadArgs.code_cache
+ *
+ * @param module the module
+ *
+ * @return true if the code cache was used, false otherwise
+ */
+WASM_RUNTIME_API_EXTERN bool
+wasm_runtime_is_code_cache_used(const wasm_module_t module);
+
+/**
+ * Get the cost of lazy lowering (LoadArgs.lazy_lowering) so far. The time
+ * spent lowering functions on their first call is counted here, separately
+ * from the load time.
+ *
+ * @param module the module
+ * @param lowered_count returns the number of functions lowered on first call
+ * @param lowering_time_us returns the time spent lowering them
+ *
+ * @return true if the module is lazily lowered, false otherwise
+ */
+WASM_RUNTIME_API_EXTERN bool
+wasm_runtime_get_lazy_lowering_stats(const wasm_module_t module,
+                                     uint32_t *lowered_count,
+                                     uint64_t *lowering_time_us);
+
+/**
+ * Get how many times the fast interpreter dispatched an opcode, counted
+ * since the last wasm_runtime_reset_opcode_counts(). Only available when
+ * the runtime is built with WASM_ENABLE_OPCODE_COUNTER; the counts are
+ * global and not synchronized between threads.
+ *
+ * @param opcode the opcode, including the loader's internal ones
+ *        (below 256)
+ * @param name returns the name of the opcode, NULL if the interpreter has
+ *        no handler for it or the counter is disabled
+ *
+ * @return the number of dispatches
+ */
+WASM_RUNTIME_API_EXTERN uint64_t
+wasm_runtime_get_opcode_count(uint32_t opcode, const char **name);
+
+/**
+ * Reset the counts returned by wasm_runtime_get_opcode_count().
+ */
+WASM_RUNTIME_API_EXTERN void
+wasm_runtime_reset_opcode_counts(void);
+
 /**
  * Get the module hash of a WASM module, currently only available on
  * linux-sgx platform when the remote attestation feature is enabled
@@ -811,6 +1042,103 @@ wasm_runtime_get_running_mode(wasm_module_inst_t module_inst);
 WASM_RUNTIME_API_EXTERN void
 wasm_runtime_deinstantiate(wasm_module_inst_t module_inst);
 
+/**
+ * Reset an instance in place to its state right after instantiation, e.g.
+ * to recover from a trap without deinstantiating it. The linear memories
+ * are zeroed and their data segments copied again, globals, tables and
+ * dropped segments are initialized again, the app heap is emptied, the
+ * exception is cleared and the start function runs again. The allocations
+ * of the instance are kept, except for a memory that grew, which gets its
+ * initial size back. Only interpreter instances without shared memory, GC
+ * or linked sub modules can be reset. No function of the instance may be
+ * running meanwhile; function handles and exec_envs stay valid.
+ *
+ * @param module_inst the module instance
+ * @param error_buf buffer to output the error info if failed
+ * @param error_buf_size the size of the error buffer
+ *
+ * @return true if success, false otherwise, in which case the instance
+ *         must be deinstantiated
+ */
+WASM_RUNTIME_API_EXTERN bool
+wasm_runtime_reset_instance(wasm_module_inst_t module_inst, char *error_buf,
+                            uint32_t error_buf_size);
+
+/**
+ * Snapshot the state of an instance: its linear memories including the app
+ * heap, globals, tables and dropped segments. Take it once the instance is
+ * initialized, e.g. after its init export, so that more instances can be
+ * made from it, or the instance reset to it, without running the data
+ * segments and the init code again. Only interpreter instances without
+ * shared memory or GC can be snapshotted. No function of the instance may
+ * be running meanwhile.
+ *
+ * The linear memories are copied into buffers allocated like linear
+ * memories, the rest into one block of the runtime heap.
+ *
+ * @param module_inst the module instance
+ * @param error_buf buffer to output the error info if failed
+ * @param error_buf_size the size of the error buffer
+ *
+ * @return the snapshot, NULL if failed
+ */
+WASM_RUNTIME_API_EXTERN wasm_instance_snapshot_t
+wasm_runtime_snapshot_instance(wasm_module_inst_t module_inst,
+                               char *error_buf, uint32_t error_buf_size);
+
+/**
+ * Bring an instance back to a snapshot of itself or of another instance of
+ * the same module. Memory, globals, tables and the app heap are copied back
+ * in place, a memory whose page count changed since is reallocated, and the
+ * exception is cleared. No function of the instance may be running.
+ *
+ * @param module_inst the module instance
+ * @param snapshot the snapshot
+ * @param error_buf buffer to output the error info if failed
+ * @param error_buf_size the size of the error buffer
+ *
+ * @return true if success, false otherwise, in which case the instance
+ * should be deinstantiated
+ */
+WASM_RUNTIME_API_EXTERN bool
+wasm_runtime_restore_instance(wasm_module_inst_t module_inst,
+                              const wasm_instance_snapshot_t snapshot,
+                              char *error_buf, uint32_t error_buf_size);
+
+/**
+ * Instantiate a WASM module in the state of a snapshot of one of its
+ * instances. The data segments and the start, _initialize and
+ * __wasm_call_ctors functions aren't run, the snapshot already has their
+ * effects. The app heap size and memory limits are the ones of the
+ * snapshotted instance.
+ *
+ * @param module the module the snapshot was taken from
+ * @param snapshot the snapshot
+ * @param default_stack_size the default stack size of the instance
+ * @param error_buf buffer to output the error info if failed
+ * @param error_buf_size the size of the error buffer
+ *
+ * @return the instance, NULL if failed
+ */
+WASM_RUNTIME_API_EXTERN wasm_module_inst_t
+wasm_runtime_instantiate_from_snapshot(const wasm_module_t module,
+                                       const wasm_instance_snapshot_t snapshot,
+                                       uint32_t default_stack_size,
+                                       char *error_buf,
+                                       uint32_t error_buf_size);
+
+/**
+ * Get the bytes held by a snapshot
+ */
+WASM_RUNTIME_API_EXTERN uint64_t
+wasm_runtime_get_snapshot_size(const wasm_instance_snapshot_t snapshot);
+
+/**
+ * Destroy a snapshot. The instances made from it stay valid.
+ */
+WASM_RUNTIME_API_EXTERN void
+wasm_runtime_destroy_snapshot(wasm_instance_snapshot_t snapshot);
+
 /**
  * Get WASM module from WASM module instance
  *
@@ -1166,6 +1494,35 @@ WASM_RUNTIME_API_EXTERN bool
 wasm_runtime_call_wasm(wasm_exec_env_t exec_env, wasm_function_inst_t function,
                        uint32_t argc, uint32_t argv[]);
 
+/**
+ * Call the given WASM function once for each row of an argument matrix
+ * (bytecode and AoT). The thread info and exec env setup is done once
+ * for the whole batch, so this is cheaper than calling
+ * wasm_runtime_call_wasm in a loop.
+ *
+ * @param exec_env the execution environment to call the function,
+ *   which must be created from wasm_create_exec_env()
+ * @param function the function to call
+ * @param argc cell number of each row, must be no smaller than both the
+ *   parameter cell number and the result cell number of the function
+ * @param argv_matrix count rows of argc cells each. The arguments of call
+ *   i are read from argv_matrix[i * argc], and its return value (if any)
+ *   is stored in the first cell(s) of the same row.
+ * @param count the number of rows, i.e. the number of calls
+ * @param p_failed_index if not NULL, receives the row index of the call
+ *   that threw an exception when false is returned
+ *
+ * @return true if all calls succeeded, false otherwise. The batch stops at
+ *   the first exception; rows after the failed one are left untouched,
+ *   the caller can call wasm_runtime_get_exception to get the exception
+ *   info.
+ */
+WASM_RUNTIME_API_EXTERN bool
+wasm_runtime_call_wasm_batch(wasm_exec_env_t exec_env,
+                             wasm_function_inst_t function, uint32_t argc,
+                             uint32_t argv_matrix[], uint32_t count,
+                             uint32_t *p_failed_index);
+
 /**
  * Call the given WASM function of a WASM module instance with
  * provided results space and arguments (bytecode and AoT).
@@ -1581,6 +1938,67 @@ WASM_RUNTIME_API_EXTERN void
 wasm_runtime_get_export_type(const wasm_module_t module, int32_t export_index,
                              wasm_export_t *export_type);
 
+/**
+ * Get the index of a WASM module export by name and kind
+ *
+ * The index is the one taken by wasm_runtime_get_export_type(), and it is
+ * the same for every instance of the module. Resolve a name once with this,
+ * then get the export of any instance with
+ * wasm_runtime_get_export_function_by_index(),
+ * wasm_runtime_get_export_global_inst_by_index() or
+ * wasm_runtime_get_export_memory_by_index(), none of which compares names.
+ *
+ * @param module the WASM module
+ * @param name the export name
+ * @param kind the export kind
+ *
+ * @return the export index, or -1 if the module has no such export
+ */
+WASM_RUNTIME_API_EXTERN int32_t
+wasm_runtime_get_export_index(const wasm_module_t module, const char *name,
+                              wasm_import_export_kind_t kind);
+
+/**
+ * Get the function instance of an export, by export index
+ *
+ * @param module_inst the module instance
+ * @param export_index the index from wasm_runtime_get_export_index() for
+ *        the module of module_inst
+ *
+ * @return the function instance, or NULL if the export isn't a function
+ */
+WASM_RUNTIME_API_EXTERN wasm_function_inst_t
+wasm_runtime_get_export_function_by_index(const wasm_module_inst_t module_inst,
+                                          int32_t export_index);
+
+/**
+ * Get an export global instance, by export index
+ *
+ * @param module_inst the module instance
+ * @param export_index the index from wasm_runtime_get_export_index() for
+ *        the module of module_inst
+ * @param global_inst location to store the global instance
+ *
+ * @return true if success, false if the export isn't a global
+ */
+WASM_RUNTIME_API_EXTERN bool
+wasm_runtime_get_export_global_inst_by_index(
+    const wasm_module_inst_t module_inst, int32_t export_index,
+    wasm_global_inst_t *global_inst);
+
+/**
+ * Get the memory instance of an export, by export index
+ *
+ * @param module_inst the module instance
+ * @param export_index the index from wasm_runtime_get_export_index() for
+ *        the module of module_inst
+ *
+ * @return the memory instance, or NULL if the export isn't a memory
+ */
+WASM_RUNTIME_API_EXTERN wasm_memory_inst_t
+wasm_runtime_get_export_memory_by_index(const wasm_module_inst_t module_inst,
+                                        int32_t export_index);
+
 /**
  * Get the number of parameters for a function type
  *
@@ -1758,6 +2176,18 @@ wasm_runtime_register_natives(const char *module_name,
                               NativeSymbol *native_symbols,
                               uint32_t n_native_symbols);
 
+/**
+ * Register native functions with same module name, similar to
+ *   wasm_runtime_register_natives, the difference is that native_symbols
+ * must already be sorted by symbol name (in strcmp order) and is never
+ * written, so it can be a const table placed in flash. Registration fails if
+ * the table isn't sorted.
+ */
+WASM_RUNTIME_API_EXTERN bool
+wasm_runtime_register_natives_sorted(const char *module_name,
+                                     const NativeSymbol *native_symbols,
+                                     uint32_t n_native_symbols);
+
 /**
  * Register native functions with same module name, similar to
  *   wasm_runtime_register_natives, the difference is that runtime passes raw
@@ -1774,7 +2204,32 @@ wasm_runtime_register_natives_raw(const char *module_name,
                                   uint32_t n_native_symbols);
 
 /**
- * Undo wasm_runtime_register_natives or wasm_runtime_register_natives_raw
+ * Register native functions with same module name, similar to
+ *   wasm_runtime_register_natives_raw, the difference is that runtime passes
+ * the wasm cells of the params as they are, without copying them into an
+ * array, which means that the native API should be defined as
+ *   void foo(wasm_exec_env_t exec_env, uint32_t *cells);
+ * where an i32 or f32 param takes one cell and an i64 or f64 param two, and
+ * native API should write its result, if any, back from cells[0]. The
+ * signature is only checked against the import's function type: '*', '~'
+ * and '$' params are passed as app offsets, which native API should check
+ * with wasm_runtime_validate_app_addr. The natives can't have more than one
+ * result. Only available when the runtime is built with
+ * WASM_ENABLE_FAST_NATIVES.
+ *
+ * @param leaf true if none of the natives calls back into wasm, e.g. with
+ *        wasm_runtime_call_wasm or wasm_runtime_module_malloc: the
+ *        interpreter then calls them without allocating a frame and without
+ *        checking the native stack
+ */
+WASM_RUNTIME_API_EXTERN bool
+wasm_runtime_register_natives_fast(const char *module_name,
+                                   NativeSymbol *native_symbols,
+                                   uint32_t n_native_symbols, bool leaf);
+
+/**
+ * Undo wasm_runtime_register_natives, wasm_runtime_register_natives_sorted,
+ * wasm_runtime_register_natives_raw or wasm_runtime_register_natives_fast
  *
  * @param module_name    Should be the same as the corresponding
  *                       wasm_runtime_register_natives.
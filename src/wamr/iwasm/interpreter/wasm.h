@@ -9,6 +9,9 @@
 #include "bh_platform.h"
 #include "bh_hashmap.h"
 #include "bh_assert.h"
+#if WASM_ENABLE_LOAD_ARENA != 0
+#include "bh_arena.h"
+#endif
 #if WASM_ENABLE_GC != 0
 #include "gc_export.h"
 #endif
@@ -613,6 +616,12 @@ typedef struct WASMFunctionImport {
 #endif
     bool call_conv_raw;
     bool call_conv_wasm_c_api;
+    /* FastNativeKind of the linked native */
+    uint8 fast_native;
+#if WASM_ENABLE_NATIVE_TRAMPOLINES != 0
+    /* NativeCallShape of the linked native, from its signature */
+    uint8 call_shape;
+#endif
 #if WASM_ENABLE_MULTI_MODULE != 0
     WASMModule *import_module;
     WASMFunction *import_func_linked;
@@ -681,6 +690,41 @@ typedef struct WASMImport {
     } u;
 } WASMImport;
 
+#if WASM_ENABLE_COMPACT_METADATA != 0
+/* The fields the fast interpreter reads on each call come first, so they
+   share a cache line; the ones only used while loading follow. The local
+   offsets and local types are allocated with the function. Every count
+   here fits 16 bits, the loader checks it */
+struct WASMFunction {
+    uint8 *code_compiled;
+    uint8 *consts;
+    /* the type of function */
+    WASMFuncType *func_type;
+    uint16 param_cell_num;
+    uint16 ret_cell_num;
+    uint16 local_cell_num;
+    uint16 const_cell_num;
+    uint16 max_stack_cell_num;
+    uint16 local_count;
+
+    /* offset of each local, including function parameters
+       and local variables */
+    uint16 *local_offsets;
+    uint8 *local_types;
+    uint8 *code;
+    uint32 code_size;
+    uint32 code_compiled_size;
+#if WASM_ENABLE_EXCE_HANDLING != 0
+    uint32 exception_handler_count;
+#endif
+#if WASM_ENABLE_CUSTOM_NAME_SECTION != 0
+    char *field_name;
+#endif
+#if WASM_ENABLE_BRANCH_HINTS != 0
+    uint8 *code_body_begin;
+#endif
+};
+#else
 struct WASMFunction {
 #if WASM_ENABLE_CUSTOM_NAME_SECTION != 0
     char *field_name;
@@ -756,6 +800,7 @@ struct WASMFunction {
     uint8 *code_body_begin;
 #endif
 };
+#endif /* end of WASM_ENABLE_COMPACT_METADATA != 0 */
 
 #if WASM_ENABLE_TAGS != 0
 struct WASMTag {
@@ -1002,6 +1047,48 @@ struct WASMModule {
     /* Whether there is possible memory grow, e.g. memory.grow opcode */
     bool possible_memory_grow;
 
+#if WASM_ENABLE_FAST_INTERP != 0
+    /* LoadArgs.code_cache, only referenced while loading */
+    const uint8 *code_cache;
+    uint32 code_cache_size;
+    /* Size and FNV-1a hash of the wasm binary, set when a code cache is
+       given or recorded */
+    uint32 code_cache_wasm_size;
+    uint32 code_cache_wasm_hash;
+    /* Whether the functions were restored from the code cache */
+    bool code_cache_used;
+    /* LoadArgs.code_cache_record */
+    bool code_cache_record;
+    /* Relocations of each function's compiled code, kept when loading
+       with LoadArgs.code_cache_record: relocs[0] is the count, followed
+       by (offset << 1 | is_label) entries */
+    uint32 **code_relocs;
+
+    /* LoadArgs.lazy_lowering: functions are lowered on their first call,
+       serialized by lazy_lowering_lock */
+    bool lazy_lowering;
+    korp_mutex lazy_lowering_lock;
+    /* Functions lowered on first call and the time spent on them */
+    uint32 lazy_lowered_count;
+    uint64 lazy_lowering_time_us;
+#endif
+
+#if WASM_ENABLE_SUPERINSTRUCTIONS != 0
+    /* LoadArgs.no_superinstructions */
+    bool no_superinstructions;
+#endif
+
+#if WASM_ENABLE_NATIVE_TRAMPOLINES != 0
+    /* LoadArgs.no_native_trampolines */
+    bool no_native_trampolines;
+#endif
+
+#if WASM_ENABLE_LOAD_ARENA != 0
+    /* LoadArgs.load_arena: the module's data, the module struct aside,
+       not inited if the option isn't set */
+    bh_arena arena;
+#endif
+
     StringList const_str_list;
 #if WASM_ENABLE_FAST_INTERP == 0
     bh_list br_table_cache_list_head;
@@ -107,6 +107,16 @@ wasm_interp_call_wasm(struct WASMModuleInstance *module_inst,
                       struct WASMFunctionInstance *function, uint32 argc,
                       uint32 argv[]);
 
+#if WASM_ENABLE_OPCODE_COUNTER != 0
+/* Number of times the handler of an opcode ran and its name, NULL if the
+   interpreter has no handler for it */
+uint64
+wasm_interp_get_opcode_count(uint32 opcode, const char **p_name);
+
+void
+wasm_interp_reset_opcode_counts(void);
+#endif
+
 #if WASM_ENABLE_GC != 0
 bool
 wasm_interp_traverse_gc_rootset(struct WASMExecEnv *exec_env, void *heap);
@@ -404,16 +404,18 @@ wasm_interp_get_frame_ref(WASMInterpFrame *frame)
 #define read_uint32(p) \
     (p += sizeof(uint32), LOAD_U32_WITH_2U16S(p - sizeof(uint32)))
 
-#define GET_LOCAL_INDEX_TYPE_AND_OFFSET()                                \
-    do {                                                                 \
-        uint32 param_count = cur_func->param_count;                      \
-        local_idx = read_uint32(frame_ip);                               \
-        bh_assert(local_idx < param_count + cur_func->local_count);      \
-        local_offset = cur_func->local_offsets[local_idx];               \
-        if (local_idx < param_count)                                     \
-            local_type = cur_func->param_types[local_idx];               \
-        else                                                             \
-            local_type = cur_func->local_types[local_idx - param_count]; \
+#define GET_LOCAL_INDEX_TYPE_AND_OFFSET()                                  \
+    do {                                                                   \
+        uint32 param_count = cur_func->param_count;                        \
+        local_idx = read_uint32(frame_ip);                                 \
+        bh_assert(local_idx                                                \
+                  < param_count + wasm_func_inst_local_count(cur_func));   \
+        local_offset = wasm_func_inst_local_offsets(cur_func)[local_idx];  \
+        if (local_idx < param_count)                                       \
+            local_type = wasm_func_inst_param_types(cur_func)[local_idx];  \
+        else                                                               \
+            local_type = wasm_func_inst_local_types(                       \
+                cur_func)[local_idx - param_count];                        \
     } while (0)
 
 #define GET_OFFSET() (frame_ip += 2, *(int16 *)(frame_ip - 2))
@@ -580,6 +582,48 @@ wasm_interp_get_frame_ref(WASMInterpFrame *frame)
         frame_ip += 6;                                               \
     } while (0)
 
+#if WASM_ENABLE_SUPERINSTRUCTIONS != 0
+#if WASM_ENABLE_THREAD_MGR != 0
+#define CHECK_SUSPEND_FLAGS_FOR_BR() CHECK_SUSPEND_FLAGS()
+#else
+#define CHECK_SUSPEND_FLAGS_FOR_BR() (void)0
+#endif
+
+/* An i32 comparison fused with the br_if that consumes its result: the
+   two operands are followed by the br_if's branch info */
+#define DEF_OP_CMP_BR_IF(src_type, operation)                         \
+    do {                                                              \
+        CHECK_SUSPEND_FLAGS_FOR_BR();                                 \
+        cond = (uint32)(GET_OPERAND(src_type, I32, 2)                 \
+                            operation GET_OPERAND(src_type, I32, 0)); \
+        frame_ip += 4;                                                \
+        if (cond)                                                     \
+            goto recover_br_info;                                     \
+        SKIP_BR_INFO();                                               \
+    } while (0)
+
+/* An i32.add fused with the load that uses the sum as its address */
+#define DEF_OP_ADD_LOAD(bytes, load_value)                                \
+    do {                                                                  \
+        uint32 offset, addr;                                              \
+        offset = read_uint32(frame_ip);                                   \
+        addr = GET_OPERAND(uint32, I32, 2) + GET_OPERAND(uint32, I32, 0); \
+        frame_ip += 4;                                                    \
+        addr_ret = GET_OFFSET();                                          \
+        CHECK_MEMORY_OVERFLOW(bytes);                                     \
+        frame_lp[addr_ret] = (uint32)(load_value);                        \
+    } while (0)
+
+/* An i32 binary op whose constant operand is an immediate: the loader
+   has masked shift counts already */
+#define DEF_OP_NUMERIC_IMM(src_type, operation)                           \
+    do {                                                                  \
+        src_type imm = (src_type)read_uint32(frame_ip);                   \
+        SET_OPERAND(I32, 2, GET_OPERAND(src_type, I32, 0) operation imm); \
+        frame_ip += 4;                                                    \
+    } while (0)
+#endif /* end of WASM_ENABLE_SUPERINSTRUCTIONS != 0 */
+
 #define DEF_OP_BIT_COUNT(src_type, src_op_type, operation)               \
     do {                                                                 \
         SET_OPERAND(                                                     \
@@ -1189,6 +1233,83 @@ FREE_FRAME(WASMExecEnv *exec_env, WASMInterpFrame *frame)
     wasm_exec_env_free_wasm_frame(exec_env, frame);
 }
 
+/* Pairs with the release fence in wasm_loader_lower_function: a thread
+   that sees the lowered code also sees the const cells and stack sizes */
+static inline bool
+wasm_interp_is_lowered(const WASMFunction *func)
+{
+    if (!func->code_compiled)
+        return false;
+    os_atomic_thread_fence(os_memory_order_acquire);
+    return true;
+}
+
+/* Validate and lower a function of a lazily lowered module on its first
+   call, see LoadArgs.lazy_lowering */
+static bool
+wasm_interp_lower_function(WASMModuleInstance *module_inst,
+                           WASMFunctionInstance *func)
+{
+    WASMModule *module = module_inst->module;
+    uint32 func_idx = (uint32)(func - module_inst->e->functions)
+                      - module->import_function_count;
+    char error_buf[128];
+
+    if (!wasm_loader_lower_function(module, func_idx, error_buf,
+                                    sizeof(error_buf))) {
+        wasm_set_exception(module_inst, error_buf);
+        return false;
+    }
+    return true;
+}
+
+#if WASM_ENABLE_FAST_NATIVES != 0
+/* Leaf fast natives never call back into wasm, so they get neither a frame
+   nor the native stack check. The params are already at the wasm stack top,
+   where the frame's cells would start, and the native works on them there */
+static void
+wasm_interp_call_fast_native_leaf(WASMModuleInstance *module_inst,
+                                  WASMExecEnv *exec_env,
+                                  WASMFunctionInstance *cur_func,
+                                  WASMInterpFrame *prev_frame)
+{
+    WASMFunctionImport *func_import = cur_func->u.func_import;
+    uint32 cur_func_index = (uint32)(cur_func - module_inst->e->functions);
+    void *native_func_pointer = module_inst->import_func_ptrs[cur_func_index];
+    WASMInterpFrame *outs_area = wasm_exec_env_wasm_stack_top(exec_env);
+    uint32 *cells = outs_area->operand;
+
+    if (!native_func_pointer) {
+        char buf[128];
+        snprintf(buf, sizeof(buf),
+                 "failed to call unlinked import function (%s, %s)",
+                 func_import->module_name, func_import->field_name);
+        wasm_set_exception(module_inst, buf);
+        return;
+    }
+
+    /* The result may take more cells than the params */
+    if ((uint8 *)(cells + 2) > exec_env->wasm_stack.top_boundary) {
+        wasm_set_exception(module_inst, "wasm operand stack overflow");
+        return;
+    }
+
+    exec_env->attachment = func_import->attachment;
+    ((void (*)(WASMExecEnv *, uint32 *))native_func_pointer)(exec_env, cells);
+    exec_env->attachment = NULL;
+
+    /* Copied even if the native raised an exception, the callers check it
+       and drop the result */
+    if (cur_func->ret_cell_num == 1) {
+        prev_frame->lp[prev_frame->ret_offset] = cells[0];
+    }
+    else if (cur_func->ret_cell_num == 2) {
+        prev_frame->lp[prev_frame->ret_offset] = cells[0];
+        prev_frame->lp[prev_frame->ret_offset + 1] = cells[1];
+    }
+}
+#endif /* end of WASM_ENABLE_FAST_NATIVES != 0 */
+
 static void
 wasm_interp_call_func_native(WASMModuleInstance *module_inst,
                              WASMExecEnv *exec_env,
@@ -1209,6 +1330,15 @@ wasm_interp_call_func_native(WASMModuleInstance *module_inst,
     uint8 *frame_ref;
 #endif
 
+#if WASM_ENABLE_FAST_NATIVES != 0
+    if (func_import->fast_native == FAST_NATIVE_LEAF
+        && !func_import->call_conv_wasm_c_api) {
+        wasm_interp_call_fast_native_leaf(module_inst, exec_env, cur_func,
+                                          prev_frame);
+        return;
+    }
+#endif
+
     all_cell_num = local_cell_num;
 #if WASM_ENABLE_GC != 0
     all_cell_num += (local_cell_num + 3) / 4;
@@ -1262,6 +1392,25 @@ wasm_interp_call_func_native(WASMModuleInstance *module_inst,
             argv_ret[1] = frame->lp[1];
         }
     }
+#if WASM_ENABLE_FAST_NATIVES != 0
+    else if (func_import->fast_native) {
+        /* The frame's cells start with the params */
+        ret = wasm_runtime_invoke_native_fast(exec_env, native_func_pointer,
+                                              func_import->attachment,
+                                              frame->lp);
+        if (ret) {
+            argv_ret[0] = frame->lp[0];
+            argv_ret[1] = frame->lp[1];
+        }
+    }
+#endif
+#if WASM_ENABLE_NATIVE_TRAMPOLINES != 0
+    else if (func_import->call_shape != NATIVE_SHAPE_GENERIC) {
+        ret = wasm_runtime_invoke_native_shape(
+            exec_env, native_func_pointer, func_import->call_shape,
+            func_import->attachment, frame->lp, argv_ret);
+    }
+#endif
     else if (!func_import->call_conv_raw) {
         ret = wasm_runtime_invoke_native(
             exec_env, native_func_pointer, func_import->func_type,
@@ -1408,6 +1557,7 @@ DEFINE_GOTO_TABLE(OpcodeInfo, opcode_table);
 #undef HANDLE_OPCODE
 /* clang-format on */
 
+#if WASM_ENABLE_OPCODE_COUNTER_DUMP != 0
 static void
 wasm_interp_dump_op_count()
 {
@@ -1425,6 +1575,27 @@ wasm_interp_dump_op_count()
 }
 #endif
 
+uint64
+wasm_interp_get_opcode_count(uint32 opcode, const char **p_name)
+{
+    if (opcode >= WASM_INSTRUCTION_NUM || !opcode_table[opcode].name) {
+        *p_name = NULL;
+        return 0;
+    }
+    *p_name = opcode_table[opcode].name;
+    return opcode_table[opcode].count;
+}
+
+void
+wasm_interp_reset_opcode_counts(void)
+{
+    uint32 i;
+
+    for (i = 0; i < WASM_INSTRUCTION_NUM; i++)
+        opcode_table[i].count = 0;
+}
+#endif
+
 #if WASM_ENABLE_LABELS_AS_VALUES != 0
 
 /* #define HANDLE_OP(opcode) HANDLE_##opcode:printf(#opcode"\n"); */
@@ -3805,6 +3976,38 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                 HANDLE_OP_END();
             }
 
+#if WASM_ENABLE_SUPERINSTRUCTIONS != 0
+            HANDLE_OP(EXT_OP_I32_ADD_LOAD)
+            {
+                DEF_OP_ADD_LOAD(4, LOAD_I32(maddr));
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_I32_ADD_LOAD8_S)
+            {
+                DEF_OP_ADD_LOAD(1, sign_ext_8_32(*(int8 *)maddr));
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_I32_ADD_LOAD8_U)
+            {
+                DEF_OP_ADD_LOAD(1, *(uint8 *)maddr);
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_I32_ADD_LOAD16_S)
+            {
+                DEF_OP_ADD_LOAD(2, sign_ext_16_32(LOAD_I16(maddr)));
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_I32_ADD_LOAD16_U)
+            {
+                DEF_OP_ADD_LOAD(2, LOAD_U16(maddr));
+                HANDLE_OP_END();
+            }
+#endif /* end of WASM_ENABLE_SUPERINSTRUCTIONS != 0 */
+
             HANDLE_OP(WASM_OP_I64_LOAD8_S)
             {
                 uint32 offset, addr;
@@ -4105,6 +4308,79 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                 HANDLE_OP_END();
             }
 
+#if WASM_ENABLE_SUPERINSTRUCTIONS != 0
+            HANDLE_OP(EXT_OP_I32_EQZ_BR_IF)
+            {
+                CHECK_SUSPEND_FLAGS_FOR_BR();
+                cond = (uint32)(GET_OPERAND(uint32, I32, 0) == 0);
+                frame_ip += 2;
+                if (cond)
+                    goto recover_br_info;
+                SKIP_BR_INFO();
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_I32_EQ_BR_IF)
+            {
+                DEF_OP_CMP_BR_IF(uint32, ==);
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_I32_NE_BR_IF)
+            {
+                DEF_OP_CMP_BR_IF(uint32, !=);
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_I32_LT_S_BR_IF)
+            {
+                DEF_OP_CMP_BR_IF(int32, <);
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_I32_LT_U_BR_IF)
+            {
+                DEF_OP_CMP_BR_IF(uint32, <);
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_I32_GT_S_BR_IF)
+            {
+                DEF_OP_CMP_BR_IF(int32, >);
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_I32_GT_U_BR_IF)
+            {
+                DEF_OP_CMP_BR_IF(uint32, >);
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_I32_LE_S_BR_IF)
+            {
+                DEF_OP_CMP_BR_IF(int32, <=);
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_I32_LE_U_BR_IF)
+            {
+                DEF_OP_CMP_BR_IF(uint32, <=);
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_I32_GE_S_BR_IF)
+            {
+                DEF_OP_CMP_BR_IF(int32, >=);
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_I32_GE_U_BR_IF)
+            {
+                DEF_OP_CMP_BR_IF(uint32, >=);
+                HANDLE_OP_END();
+            }
+#endif /* end of WASM_ENABLE_SUPERINSTRUCTIONS != 0 */
+
             /* comparison instructions of i64 */
             HANDLE_OP(WASM_OP_I64_EQZ)
             {
@@ -4416,6 +4692,56 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                 HANDLE_OP_END();
             }
 
+#if WASM_ENABLE_SUPERINSTRUCTIONS != 0
+            HANDLE_OP(EXT_OP_I32_ADD_IMM)
+            {
+                DEF_OP_NUMERIC_IMM(uint32, +);
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_I32_MUL_IMM)
+            {
+                DEF_OP_NUMERIC_IMM(uint32, *);
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_I32_AND_IMM)
+            {
+                DEF_OP_NUMERIC_IMM(uint32, &);
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_I32_OR_IMM)
+            {
+                DEF_OP_NUMERIC_IMM(uint32, |);
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_I32_XOR_IMM)
+            {
+                DEF_OP_NUMERIC_IMM(uint32, ^);
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_I32_SHL_IMM)
+            {
+                DEF_OP_NUMERIC_IMM(uint32, <<);
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_I32_SHR_S_IMM)
+            {
+                DEF_OP_NUMERIC_IMM(int32, >>);
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_I32_SHR_U_IMM)
+            {
+                DEF_OP_NUMERIC_IMM(uint32, >>);
+                HANDLE_OP_END();
+            }
+#endif /* end of WASM_ENABLE_SUPERINSTRUCTIONS != 0 */
+
             /* numeric instructions of i64 */
             HANDLE_OP(WASM_OP_I64_CLZ)
             {
@@ -7549,9 +7875,15 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
 #if WASM_ENABLE_TAIL_CALL != 0 || WASM_ENABLE_GC != 0
     call_func_from_return_call:
     {
+        uint8 *param_types = wasm_func_inst_param_types(cur_func);
         uint32 *lp_base = NULL, *lp = NULL;
         int i;
 
+        if (!cur_func->is_import_func
+            && !wasm_interp_is_lowered(cur_func->u.func)
+            && !wasm_interp_lower_function(module, cur_func))
+            goto got_exception;
+
         if (cur_func->param_cell_num > 0
             && !(lp_base = lp = wasm_runtime_malloc(cur_func->param_cell_num
                                                     * sizeof(uint32)))) {
@@ -7559,8 +7891,8 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
             goto got_exception;
         }
         for (i = 0; i < cur_func->param_count; i++) {
-            if (cur_func->param_types[i] == VALUE_TYPE_I64
-                || cur_func->param_types[i] == VALUE_TYPE_F64) {
+            if (param_types[i] == VALUE_TYPE_I64
+                || param_types[i] == VALUE_TYPE_F64) {
                 PUT_I64_TO_ADDR(
                     lp, GET_OPERAND(uint64, I64,
                                     2 * (cur_func->param_count - i - 1)));
@@ -7572,7 +7904,10 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                 lp++;
             }
         }
-        frame->lp = frame->operand + cur_func->const_cell_num;
+        frame->lp = frame->operand
+                    + (cur_func->is_import_func
+                           ? 0
+                           : cur_func->u.func->const_cell_num);
         if (lp - lp_base > 0) {
             word_copy(frame->lp, lp_base, lp - lp_base);
         }
@@ -7590,6 +7925,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
     {
         /* Only do the copy when it's called from interpreter. */
         WASMInterpFrame *outs_area = wasm_exec_env_wasm_stack_top(exec_env);
+        uint8 *param_types = wasm_func_inst_param_types(cur_func);
         int i;
 
 #if WASM_ENABLE_MULTI_MODULE != 0
@@ -7601,8 +7937,18 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
         }
         else
 #endif
-        {
-            outs_area->lp = outs_area->operand + cur_func->const_cell_num;
+        if (cur_func->is_import_func) {
+            outs_area->lp = outs_area->operand;
+        }
+        else {
+            /* Lazily lowered modules lower a function on its first call */
+            if (!wasm_interp_is_lowered(cur_func->u.func)
+                && !wasm_interp_lower_function(module, cur_func))
+                goto got_exception;
+            /* Read the const cell num from the module, the instance's copy
+               is stale if the function was lowered after instantiation */
+            outs_area->lp =
+                outs_area->operand + cur_func->u.func->const_cell_num;
         }
 
         if ((uint8 *)(outs_area->lp + cur_func->param_cell_num)
@@ -7612,14 +7958,14 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
         }
 
         for (i = 0; i < cur_func->param_count; i++) {
-            if (cur_func->param_types[i] == VALUE_TYPE_V128) {
+            if (param_types[i] == VALUE_TYPE_V128) {
                 PUT_V128_TO_ADDR(
                     outs_area->lp,
                     GET_OPERAND_V128(2 * (cur_func->param_count - i - 1)));
                 outs_area->lp += 4;
             }
-            else if (cur_func->param_types[i] == VALUE_TYPE_I64
-                     || cur_func->param_types[i] == VALUE_TYPE_F64) {
+            else if (param_types[i] == VALUE_TYPE_I64
+                     || param_types[i] == VALUE_TYPE_F64) {
                 PUT_I64_TO_ADDR(
                     outs_area->lp,
                     GET_OPERAND(uint64, I64,
@@ -7627,7 +7973,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                 outs_area->lp += 2;
             }
 #if WASM_ENABLE_GC != 0
-            else if (wasm_is_type_reftype(cur_func->param_types[i])) {
+            else if (wasm_is_type_reftype(param_types[i])) {
                 PUT_REF_TO_ADDR(
                     outs_area->lp,
                     GET_OPERAND(void *, REF,
@@ -7716,7 +8062,8 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
             cell_num_of_local_stack = cur_func->param_cell_num
                                       + cur_func->local_cell_num
                                       + cur_wasm_func->max_stack_cell_num;
-            all_cell_num = cur_func->const_cell_num + cell_num_of_local_stack;
+            all_cell_num =
+                cur_wasm_func->const_cell_num + cell_num_of_local_stack;
 #if WASM_ENABLE_GC != 0
             /* area of frame_ref */
             all_cell_num += (cell_num_of_local_stack + 3) / 4;
@@ -7895,6 +8242,7 @@ wasm_interp_call_wasm(WASMModuleInstance *module_inst, WASMExecEnv *exec_env,
     /* This frame won't be used by JITed code, so only allocate interp
        frame here.  */
     unsigned frame_size;
+    uint32 const_cell_num = 0;
 
 #if WASM_ENABLE_GC != 0
     all_cell_num += (all_cell_num + 3) / 4;
@@ -7924,6 +8272,13 @@ wasm_interp_call_wasm(WASMModuleInstance *module_inst, WASMExecEnv *exec_env,
     }
 #endif
 
+    if (!function->is_import_func) {
+        if (!wasm_interp_is_lowered(function->u.func)
+            && !wasm_interp_lower_function(module_inst, function))
+            return;
+        const_cell_num = function->u.func->const_cell_num;
+    }
+
     if (!(frame =
               ALLOC_FRAME(exec_env, frame_size, (WASMInterpFrame *)prev_frame)))
         return;
@@ -7940,7 +8295,7 @@ wasm_interp_call_wasm(WASMModuleInstance *module_inst, WASMExecEnv *exec_env,
 #endif
     frame->ret_offset = 0;
 
-    if ((uint8 *)(outs_area->operand + function->const_cell_num + argc)
+    if ((uint8 *)(outs_area->operand + const_cell_num + argc)
         > exec_env->wasm_stack.top_boundary) {
         wasm_set_exception((WASMModuleInstance *)exec_env->module_inst,
                            "wasm operand stack overflow");
@@ -7948,7 +8303,7 @@ wasm_interp_call_wasm(WASMModuleInstance *module_inst, WASMExecEnv *exec_env,
     }
 
     if (argc > 0)
-        word_copy(outs_area->operand + function->const_cell_num, argv, argc);
+        word_copy(outs_area->operand + const_cell_num, argv, argc);
 
     wasm_exec_env_set_cur_frame(exec_env, frame);
 
@@ -7995,7 +8350,7 @@ wasm_interp_call_wasm(WASMModuleInstance *module_inst, WASMExecEnv *exec_env,
 
     wasm_exec_env_set_cur_frame(exec_env, prev_frame);
     FREE_FRAME(exec_env, frame);
-#if WASM_ENABLE_OPCODE_COUNTER != 0
+#if WASM_ENABLE_OPCODE_COUNTER != 0 && WASM_ENABLE_OPCODE_COUNTER_DUMP != 0
     wasm_interp_dump_op_count();
 #endif
 }
@@ -337,12 +337,100 @@ read_i8x16(uint8 *p_buf, char *error_buf, uint32 error_buf_size)
           (WASM_ENABLE_FAST_INTERP != 0) */
 #endif /* end of WASM_ENABLE_SIMD */
 
+#if WASM_ENABLE_LOAD_ARENA != 0
+#ifndef os_thread_local_attribute
+#error "WASM_ENABLE_LOAD_ARENA requires os_thread_local_attribute"
+#endif
+
+/* Arenas of the module this thread is loading with LoadArgs.load_arena:
+   loader_malloc() allocates from the module arena, and the data dropped
+   when loading ends, such as the function contexts, from the scratch
+   arena. Both are NULL otherwise, e.g. when lowering a function lazily,
+   and the loader then uses heap blocks. While a module is unloaded, the
+   module arena is set so that loader_free() knows its blocks. */
+static os_thread_local_attribute bh_arena *loader_arena;
+static os_thread_local_attribute bh_arena *loader_scratch;
+
+static void *
+loader_alloc(uint32 size, bool scratch)
+{
+    bh_arena *arena = scratch ? loader_scratch : loader_arena;
+
+    return arena ? bh_arena_alloc(arena, size) : wasm_runtime_malloc(size);
+}
+
+static bh_arena *
+loader_arena_of(void *ptr)
+{
+    if (loader_scratch && bh_arena_contains(loader_scratch, ptr))
+        return loader_scratch;
+    if (loader_arena && bh_arena_contains(loader_arena, ptr))
+        return loader_arena;
+    return NULL;
+}
+
+/* Free a heap block, or an arena block, which goes with its arena */
+static void
+loader_free(void *ptr)
+{
+    bh_arena *arena = loader_arena_of(ptr);
+
+    if (arena)
+        bh_arena_free(arena, ptr);
+    else
+        wasm_runtime_free(ptr);
+}
+#else
+#define loader_alloc(size, scratch) wasm_runtime_malloc(size)
+#define loader_free wasm_runtime_free
+#endif /* end of WASM_ENABLE_LOAD_ARENA != 0 */
+
+static void *
+loader_malloc_ex(uint64 size, bool scratch, char *error_buf,
+                 uint32 error_buf_size)
+{
+    void *mem;
+
+    if (size >= UINT32_MAX || !(mem = loader_alloc((uint32)size, scratch))) {
+        set_error_buf(error_buf, error_buf_size, "allocate memory failed");
+        return NULL;
+    }
+
+    memset(mem, 0, (uint32)size);
+    return mem;
+}
+
 static void *
 loader_malloc(uint64 size, char *error_buf, uint32 error_buf_size)
+{
+    return loader_malloc_ex(size, false, error_buf, error_buf_size);
+}
+
+/* Allocate data only used while loading, which must be freed before the
+   module is: with LoadArgs.load_arena it goes with the scratch arena */
+static void *
+loader_scratch_malloc(uint64 size, char *error_buf, uint32 error_buf_size)
+{
+    return loader_malloc_ex(size, true, error_buf, error_buf_size);
+}
+
+#if WASM_ENABLE_FAST_INTERP != 0
+/* Allocate the lowered code or the constants of a function, from the fast
+   pool if the embedder placed their class in it, otherwise as
+   loader_malloc() */
+static void *
+loader_malloc_class(uint64 size, mem_class_t mem_class, char *error_buf,
+                    uint32 error_buf_size)
 {
     void *mem;
 
-    if (size >= UINT32_MAX || !(mem = wasm_runtime_malloc((uint32)size))) {
+#if WASM_ENABLE_LOAD_ARENA != 0
+    if (loader_arena && !wasm_runtime_mem_class_is_fast(mem_class))
+        return loader_malloc(size, error_buf, error_buf_size);
+#endif
+
+    if (size >= UINT32_MAX
+        || !(mem = wasm_runtime_malloc_class((uint32)size, mem_class))) {
         set_error_buf(error_buf, error_buf_size, "allocate memory failed");
         return NULL;
     }
@@ -350,14 +438,29 @@ loader_malloc(uint64 size, char *error_buf, uint32 error_buf_size)
     memset(mem, 0, (uint32)size);
     return mem;
 }
+#endif /* end of WASM_ENABLE_FAST_INTERP != 0 */
 
 static void *
 memory_realloc(void *mem_old, uint32 size_old, uint32 size_new, char *error_buf,
                uint32 error_buf_size)
 {
     uint8 *mem_new;
+#if WASM_ENABLE_LOAD_ARENA != 0
+    bh_arena *arena = loader_arena_of(mem_old);
+#endif
     bh_assert(size_new > size_old);
 
+#if WASM_ENABLE_LOAD_ARENA != 0
+    if (arena) {
+        if (!(mem_new = bh_arena_realloc(arena, mem_old, size_old, size_new))) {
+            set_error_buf(error_buf, error_buf_size, "allocate memory failed");
+            return NULL;
+        }
+        memset(mem_new + size_old, 0, size_new - size_old);
+        return mem_new;
+    }
+#endif
+
     if ((mem_new = wasm_runtime_realloc(mem_old, size_new))) {
         memset(mem_new + size_old, 0, size_new - size_old);
         return mem_new;
@@ -365,7 +468,7 @@ memory_realloc(void *mem_old, uint32 size_old, uint32 size_new, char *error_buf,
 
     if ((mem_new = loader_malloc(size_new, error_buf, error_buf_size))) {
         bh_memcpy_s(mem_new, size_new, mem_old, size_old);
-        wasm_runtime_free(mem_old);
+        loader_free(mem_old);
     }
     return mem_new;
 }
@@ -494,9 +597,9 @@ push_const_expr_stack(ConstExprContext *ctx, uint8 flag, uint8 type,
                         (ctx->size + 4) * sizeof(InitValue));
         }
         else {
-            if (!(ctx->stack =
-                      loader_malloc((ctx->size + 4) * (uint64)sizeof(InitValue),
-                                    error_buf, error_buf_size))) {
+            if (!(ctx->stack = loader_scratch_malloc(
+                      (ctx->size + 4) * (uint64)sizeof(InitValue), error_buf,
+                      error_buf_size))) {
                 goto fail;
             }
             bh_memcpy_s(ctx->stack, (ctx->size + 4) * (uint32)sizeof(InitValue),
@@ -589,7 +692,7 @@ destroy_init_expr_data_recursive(WASMModule *module, void *data)
         }
     }
 
-    wasm_runtime_free(data);
+    loader_free(data);
 }
 #endif
 
@@ -684,7 +787,7 @@ destroy_const_expr_stack(ConstExprContext *ctx, bool free_exprs)
 #endif
 
     if (ctx->stack != ctx->data) {
-        wasm_runtime_free(ctx->stack);
+        loader_free(ctx->stack);
     }
 }
 
@@ -1516,7 +1619,7 @@ load_init_expr(WASMModule *module, const uint8 **p_buf, const uint8 *buf_end,
     if (cur_expr != NULL) {
         bh_memcpy_s(init_expr, sizeof(InitializerExpression), cur_expr,
                     sizeof(InitializerExpression));
-        wasm_runtime_free(cur_expr);
+        loader_free(cur_expr);
     }
     else {
         init_expr->init_expr_type = flag;
@@ -1581,7 +1684,7 @@ destroy_func_type(WASMFuncType *type)
 {
     /* Destroy the reference type hash set */
     if (type->ref_type_maps)
-        wasm_runtime_free(type->ref_type_maps);
+        loader_free(type->ref_type_maps);
 
 #if WASM_ENABLE_FAST_JIT != 0 && WASM_ENABLE_JIT != 0 \
     && WASM_ENABLE_LAZY_JIT != 0
@@ -1589,22 +1692,22 @@ destroy_func_type(WASMFuncType *type)
         jit_code_cache_free(type->call_to_llvm_jit_from_fast_jit);
 #endif
     /* Free the type */
-    wasm_runtime_free(type);
+    loader_free(type);
 }
 
 static void
 destroy_struct_type(WASMStructType *type)
 {
     if (type->ref_type_maps)
-        wasm_runtime_free(type->ref_type_maps);
+        loader_free(type->ref_type_maps);
 
-    wasm_runtime_free(type);
+    loader_free(type);
 }
 
 static void
 destroy_array_type(WASMArrayType *type)
 {
-    wasm_runtime_free(type);
+    loader_free(type);
 }
 
 static void
@@ -2158,7 +2261,7 @@ destroy_wasm_type(WASMType *type)
         jit_code_cache_free(type->call_to_llvm_jit_from_fast_jit);
 #endif
 
-    wasm_runtime_free(type);
+    loader_free(type);
 }
 #endif /* end of WASM_ENABLE_GC != 0 */
 
@@ -2803,6 +2906,10 @@ load_function_import(const uint8 **p_buf, const uint8 *buf_end,
     function->attachment = NULL;
     function->signature = NULL;
     function->call_conv_raw = false;
+    function->fast_native = FAST_NATIVE_NONE;
+#if WASM_ENABLE_NATIVE_TRAMPOLINES != 0
+    function->call_shape = NATIVE_SHAPE_GENERIC;
+#endif
 
     /* lookup registered native symbols first */
     if (!no_resolve) {
@@ -3809,6 +3916,7 @@ init_function_local_offsets(WASMFunction *func, char *error_buf,
     uint32 local_count = func->local_count;
     uint8 *local_types = func->local_types;
     uint32 i, local_offset = 0;
+#if WASM_ENABLE_COMPACT_METADATA == 0
     uint64 total_size = sizeof(uint16) * ((uint64)param_count + local_count);
 
     /*
@@ -3821,6 +3929,11 @@ init_function_local_offsets(WASMFunction *func, char *error_buf,
                  loader_malloc(total_size, error_buf, error_buf_size))) {
         return false;
     }
+#else
+    /* Allocated with the function */
+    (void)error_buf;
+    (void)error_buf_size;
+#endif
 
     for (i = 0; i < param_count; i++) {
         func->local_offsets[i] = (uint16)local_offset;
@@ -3963,7 +4076,21 @@ load_function_section(const uint8 *buf, const uint8 *buf_end,
             /* Alloc memory, layout: function structure + local types */
             code_size = (uint32)(p_code_end - p_code);
 
+#if WASM_ENABLE_COMPACT_METADATA == 0
             total_size = sizeof(WASMFunction) + (uint64)local_count;
+#else
+            if (local_count > UINT16_MAX) {
+                set_error_buf(error_buf, error_buf_size,
+                              "local count too large");
+                return false;
+            }
+            /* layout: function structure + local offsets + local types */
+            total_size = sizeof(WASMFunction)
+                         + sizeof(uint16)
+                               * ((uint64)module->types[type_index]->param_count
+                                  + local_count)
+                         + local_count;
+#endif
             if (!(func = module->functions[i] =
                       loader_malloc(total_size, error_buf, error_buf_size))) {
                 return false;
@@ -3987,9 +4114,18 @@ load_function_section(const uint8 *buf, const uint8 *buf_end,
 
             /* Set function type, local count, code size and code body */
             func->func_type = (WASMFuncType *)module->types[type_index];
+#if WASM_ENABLE_COMPACT_METADATA == 0
             func->local_count = local_count;
             if (local_count > 0)
                 func->local_types = (uint8 *)func + sizeof(WASMFunction);
+#else
+            func->local_count = (uint16)local_count;
+            func->local_offsets = (uint16 *)(func + 1);
+            if (local_count > 0)
+                func->local_types =
+                    (uint8 *)(func->local_offsets
+                              + func->func_type->param_count + local_count);
+#endif
             func->code_size = code_size;
 #if WASM_ENABLE_BRANCH_HINTS != 0
             func->code_body_begin = p_body_start;
@@ -4426,8 +4562,8 @@ check_duplicate_exports(WASMModule *module, char *error_buf,
     char *names_buf[32], **names = names_buf;
 
     if (module->export_count > 32) {
-        names = loader_malloc(module->export_count * sizeof(char *), error_buf,
-                              error_buf_size);
+        names = loader_scratch_malloc(module->export_count * sizeof(char *),
+                                      error_buf, error_buf_size);
         if (!names) {
             return result;
         }
@@ -4449,7 +4585,7 @@ check_duplicate_exports(WASMModule *module, char *error_buf,
     result = true;
 cleanup:
     if (module->export_count > 32) {
-        wasm_runtime_free(names);
+        loader_free(names);
     }
     return result;
 }
@@ -5616,7 +5752,7 @@ handle_branch_hint_section(const uint8 *buf, const uint8 *buf_end,
                 set_error_buf_v(error_buf, error_buf_size,
                                 "invalid branch hint size, expected 1, got %d.",
                                 size);
-                wasm_runtime_free(new_hint);
+                loader_free(new_hint);
                 goto fail;
             }
 
@@ -5629,7 +5765,7 @@ handle_branch_hint_section(const uint8 *buf, const uint8 *buf_end,
                 set_error_buf_v(error_buf, error_buf_size,
                                 "invalid branch hint, expected 0 or 1, got %d",
                                 data);
-                wasm_runtime_free(new_hint);
+                loader_free(new_hint);
                 goto fail;
             }
 
@@ -6247,10 +6383,472 @@ wasm_interp_get_handle_table(void);
 static void **handle_table;
 #endif
 
+#if WASM_ENABLE_FAST_INTERP != 0
+/*
+ * Code cache: the compiled code of all functions, serialized so that a
+ * later load of the same binary skips validation and lowering. All fields
+ * are uint32 in host byte order:
+ *   header: magic, version, config, interp hash, wasm size, wasm hash,
+ *           function count, flags (CODE_CACHE_FLAG_*), payload size, hash
+ *   function: code_compiled_size, const_cell_num, max_stack_cell_num,
+ *             max_block_num, reloc count, code (padded to 4 bytes),
+ *             consts, relocs
+ * A relocated slot holds the code offset or the opcode of a label instead
+ * of an address, in its first 4 bytes. The payload is everything after the
+ * header. The last header word hashes the rest of the header and the
+ * payload, and is checked before any of them is used, so a corrupted cache
+ * is ignored instead of restored.
+ */
+#define CODE_CACHE_MAGIC 0x63696677 /* "wfic" */
+#define CODE_CACHE_VERSION 5
+#define CODE_CACHE_HEADER_NUM 10
+#define CODE_CACHE_FUNC_HEADER_NUM 5
+#define CODE_CACHE_FLAG_MEMORY_GROW 1
+/* Lowered with LoadArgs.no_superinstructions */
+#define CODE_CACHE_FLAG_NO_SUPERINSTRUCTIONS 2
+
+/* Without labels as values the opcodes are their numbers, which don't
+   change with the interpreter, so the build flags that add opcodes or
+   change their operands are recorded here */
+#define CODE_CACHE_CONFIG                                                 \
+    ((uint32)sizeof(void *) | WASM_CPU_SUPPORTS_UNALIGNED_ADDR_ACCESS << 8 \
+     | WASM_ENABLE_LABELS_AS_VALUES << 9 | WASM_ENABLE_SIMD << 10          \
+     | WASM_ENABLE_REF_TYPES << 11 | WASM_ENABLE_GC << 12                  \
+     | WASM_ENABLE_MEMORY64 << 13 | WASM_ENABLE_EXCE_HANDLING << 14        \
+     | WASM_ENABLE_SUPERINSTRUCTIONS << 15)
+
+#if WASM_ENABLE_LABELS_AS_VALUES != 0 \
+    && WASM_CPU_SUPPORTS_UNALIGNED_ADDR_ACCESS != 0
+#define CODE_CACHE_LABEL_SIZE sizeof(void *)
+#else
+#define CODE_CACHE_LABEL_SIZE sizeof(uint32)
+#endif
+
+#define CODE_CACHE_HASH_INIT 2166136261u
+
+/* FNV-1a */
+static uint32
+code_cache_hash(uint32 hash, const uint8 *buf, uint32 size)
+{
+    const uint8 *buf_end = buf + size;
+
+    while (buf < buf_end)
+        hash = (hash ^ *buf++) * 16777619u;
+    return hash;
+}
+
+/* Hash of a cache's header, without its last word, and payload */
+static uint32
+code_cache_checksum(const uint32 *header, const uint8 *payload,
+                    uint32 payload_size)
+{
+    uint32 hash = code_cache_hash(CODE_CACHE_HASH_INIT, (const uint8 *)header,
+                                  sizeof(uint32) * (CODE_CACHE_HEADER_NUM - 1));
+
+    return code_cache_hash(hash, payload, payload_size);
+}
+
+/* Flags of the LoadArgs that change how the module was lowered */
+static uint32
+code_cache_lowering_flags(const WASMModule *module)
+{
+#if WASM_ENABLE_SUPERINSTRUCTIONS != 0
+    if (module->no_superinstructions)
+        return CODE_CACHE_FLAG_NO_SUPERINSTRUCTIONS;
+#endif
+    (void)module;
+    return 0;
+}
+
+/* Fingerprint of the interpreter build: the layout of the opcode handlers
+   changes with the interpreter, which invalidates the opcodes' encoding */
+static uint32
+code_cache_interp_hash(void)
+{
+    uint32 hash = CODE_CACHE_HASH_INIT;
+#if WASM_ENABLE_LABELS_AS_VALUES != 0
+    uint32 i;
+    int32 offset;
+
+    for (i = 0; i < WASM_INSTRUCTION_NUM; i++) {
+        offset = (int32)((uint8 *)handle_table[i] - (uint8 *)handle_table[0]);
+        hash = code_cache_hash(hash, (uint8 *)&offset, sizeof(offset));
+    }
+#endif
+    return hash;
+}
+
+#if WASM_ENABLE_LABELS_AS_VALUES != 0
+/* Read a label slot as emitted by emit_label() */
+static void *
+code_cache_read_label(const uint8 *slot)
+{
+#if WASM_CPU_SUPPORTS_UNALIGNED_ADDR_ACCESS != 0
+    void *addr;
+    bh_memcpy_s(&addr, sizeof(addr), slot, sizeof(addr));
+    return addr;
+#elif UINTPTR_MAX == UINT64_MAX
+    int32 offset;
+    bh_memcpy_s(&offset, sizeof(offset), slot, sizeof(offset));
+    return (uint8 *)handle_table[0] + offset;
+#else
+    uint32 addr;
+    bh_memcpy_s(&addr, sizeof(addr), slot, sizeof(addr));
+    return (void *)(uintptr_t)addr;
+#endif
+}
+
+/* Write a label slot as emit_label() does */
+static void
+code_cache_write_label(uint8 *slot, uint32 opcode)
+{
+#if WASM_CPU_SUPPORTS_UNALIGNED_ADDR_ACCESS != 0
+    void *addr = handle_table[opcode];
+#elif UINTPTR_MAX == UINT64_MAX
+    int32 addr =
+        (int32)((uint8 *)handle_table[opcode] - (uint8 *)handle_table[0]);
+#else
+    uint32 addr = (uint32)(uintptr_t)handle_table[opcode];
+#endif
+    bh_memcpy_s(slot, sizeof(addr), &addr, sizeof(addr));
+}
+#endif /* end of WASM_ENABLE_LABELS_AS_VALUES != 0 */
+
+static bool
+load_code_cache_function(WASMModule *module, uint32 func_idx,
+                         const uint8 **p_buf, const uint8 *buf_end)
+{
+    WASMFunction *func = module->functions[func_idx];
+    const uint8 *p = *p_buf, *code, *consts, *relocs;
+    uint32 header[CODE_CACHE_FUNC_HEADER_NUM], code_size, reloc, offset;
+    uint32 target, i;
+    uint64 code_total_size, consts_size, relocs_size;
+    uint8 *addr;
+
+    if ((uint64)(buf_end - p) < sizeof(header))
+        return false;
+    bh_memcpy_s(header, sizeof(header), p, sizeof(header));
+    p += sizeof(header);
+
+    code_size = header[0];
+    code_total_size = ((uint64)code_size + 3) & ~(uint64)3;
+    consts_size = (uint64)sizeof(uint32) * header[1];
+    relocs_size = (uint64)sizeof(uint32) * header[4];
+    if (code_size == 0
+        || code_total_size + consts_size + relocs_size
+               > (uint64)(buf_end - p))
+        return false;
+    code = p;
+    consts = code + code_total_size;
+    relocs = consts + consts_size;
+
+    if (!(func->code_compiled =
+              loader_malloc_class(code_size, Mem_Class_Code, NULL, 0)))
+        return false;
+    bh_memcpy_s(func->code_compiled, code_size, code, code_size);
+    func->code_compiled_size = code_size;
+    if (consts_size > 0) {
+        if (!(func->consts =
+                  loader_malloc_class(consts_size, Mem_Class_Consts, NULL, 0)))
+            return false;
+        bh_memcpy_s(func->consts, (uint32)consts_size, consts,
+                    (uint32)consts_size);
+    }
+    /* The frame is sized from these, and lowering never produces more than
+       UINT16_MAX of either, see wasm_loader_push_frame_offset() and
+       wasm_loader_push_frame_csp() */
+    if (header[2] > UINT16_MAX || header[3] > UINT16_MAX)
+        return false;
+#if WASM_ENABLE_COMPACT_METADATA != 0
+    if (header[1] > UINT16_MAX)
+        return false;
+    func->const_cell_num = (uint16)header[1];
+    func->max_stack_cell_num = (uint16)header[2];
+#else
+    func->const_cell_num = header[1];
+    func->max_stack_cell_num = header[2];
+    func->max_block_num = header[3];
+#endif
+
+    for (i = 0; i < header[4]; i++) {
+        bh_memcpy_s(&reloc, sizeof(reloc), relocs + sizeof(uint32) * i,
+                    sizeof(reloc));
+        offset = reloc >> 1;
+        if (reloc & 1) {
+#if WASM_ENABLE_LABELS_AS_VALUES != 0
+            if ((uint64)offset + CODE_CACHE_LABEL_SIZE > code_size)
+                return false;
+            bh_memcpy_s(&target, sizeof(target), code + offset,
+                        sizeof(target));
+            if (target >= WASM_INSTRUCTION_NUM)
+                return false;
+            code_cache_write_label(func->code_compiled + offset, target);
+#else
+            return false;
+#endif
+        }
+        else {
+            if ((uint64)offset + sizeof(void *) > code_size)
+                return false;
+            bh_memcpy_s(&target, sizeof(target), code + offset,
+                        sizeof(target));
+            if (target >= code_size)
+                return false;
+            addr = func->code_compiled + target;
+            bh_memcpy_s(func->code_compiled + offset, sizeof(void *), &addr,
+                        sizeof(void *));
+        }
+    }
+
+    if (module->code_relocs) {
+        /* Keep the relocations so that the module can be saved again */
+        if (!(module->code_relocs[func_idx] =
+                  loader_malloc(relocs_size + sizeof(uint32), NULL, 0)))
+            return false;
+        module->code_relocs[func_idx][0] = header[4];
+        if (relocs_size > 0)
+            bh_memcpy_s(module->code_relocs[func_idx] + 1, (uint32)relocs_size,
+                        relocs, (uint32)relocs_size);
+    }
+
+    *p_buf = p + code_total_size + consts_size + relocs_size;
+    return true;
+}
+
+/* Restore the compiled code of all functions from module->code_cache,
+   return false to lower the functions as usual */
+static bool
+load_code_cache(WASMModule *module)
+{
+    const uint8 *p = module->code_cache;
+    const uint8 *p_end = p + module->code_cache_size;
+    uint32 header[CODE_CACHE_HEADER_NUM], i;
+
+    if (module->code_cache_size < sizeof(header))
+        return false;
+    bh_memcpy_s(header, sizeof(header), p, sizeof(header));
+    p += sizeof(header);
+
+    if (header[0] != CODE_CACHE_MAGIC || header[1] != CODE_CACHE_VERSION
+        || header[2] != CODE_CACHE_CONFIG
+        || header[3] != code_cache_interp_hash()
+        || header[4] != module->code_cache_wasm_size
+        || header[5] != module->code_cache_wasm_hash
+        || header[6] != module->function_count
+        || (header[7] & CODE_CACHE_FLAG_NO_SUPERINSTRUCTIONS)
+               != code_cache_lowering_flags(module)) {
+        LOG_VERBOSE("Code cache doesn't match the module, ignore it");
+        return false;
+    }
+
+    if (header[8] > (uint64)(p_end - p)
+        || header[9] != code_cache_checksum(header, p, header[8])) {
+        LOG_WARNING("warning: corrupted code cache, ignore it");
+        return false;
+    }
+    p_end = p + header[8];
+
+    for (i = 0; i < module->function_count; i++) {
+        if (!load_code_cache_function(module, i, &p, p_end))
+            goto fail;
+    }
+
+    if (header[7] & CODE_CACHE_FLAG_MEMORY_GROW)
+        module->possible_memory_grow = true;
+    LOG_VERBOSE("Restore %u functions from code cache",
+                module->function_count);
+    return true;
+
+fail:
+    LOG_WARNING("warning: invalid code cache, ignore it");
+    for (i = 0; i < module->function_count; i++) {
+        WASMFunction *func = module->functions[i];
+        if (func->code_compiled)
+            loader_free(func->code_compiled);
+        if (func->consts)
+            loader_free(func->consts);
+        func->code_compiled = func->consts = NULL;
+        func->code_compiled_size = func->const_cell_num = 0;
+        if (module->code_relocs && module->code_relocs[i]) {
+            loader_free(module->code_relocs[i]);
+            module->code_relocs[i] = NULL;
+        }
+    }
+    return false;
+}
+
+uint32
+wasm_loader_save_code_cache(WASMModule *module, uint8 *buf, uint32 buf_size)
+{
+    uint32 header[CODE_CACHE_HEADER_NUM];
+    uint32 func_header[CODE_CACHE_FUNC_HEADER_NUM];
+    uint32 i, j, code_size, consts_size, offset, value;
+    uint64 total_size = sizeof(header);
+    uint8 *p = buf, *slot;
+
+    if (!module->code_relocs)
+        return 0;
+
+    for (i = 0; i < module->function_count; i++) {
+        WASMFunction *func = module->functions[i];
+        if (!module->code_relocs[i])
+            return 0;
+        total_size += sizeof(func_header)
+                      + align_uint(func->code_compiled_size, 4)
+                      + (uint64)sizeof(uint32) * func->const_cell_num
+                      + (uint64)sizeof(uint32) * module->code_relocs[i][0];
+    }
+    if (total_size > UINT32_MAX)
+        return 0;
+    if (!buf)
+        return (uint32)total_size;
+    if (buf_size < total_size)
+        return 0;
+
+#if WASM_ENABLE_LABELS_AS_VALUES != 0
+    handle_table = wasm_interp_get_handle_table();
+#endif
+
+    header[0] = CODE_CACHE_MAGIC;
+    header[1] = CODE_CACHE_VERSION;
+    header[2] = CODE_CACHE_CONFIG;
+    header[3] = code_cache_interp_hash();
+    header[4] = module->code_cache_wasm_size;
+    header[5] = module->code_cache_wasm_hash;
+    header[6] = module->function_count;
+    header[7] = module->possible_memory_grow ? CODE_CACHE_FLAG_MEMORY_GROW : 0;
+    header[7] |= code_cache_lowering_flags(module);
+    /* Payload size and hash are filled in once it is written */
+    header[8] = header[9] = 0;
+    p += sizeof(header);
+
+    for (i = 0; i < module->function_count; i++) {
+        WASMFunction *func = module->functions[i];
+        uint32 *relocs = module->code_relocs[i];
+
+        code_size = func->code_compiled_size;
+        consts_size = (uint32)sizeof(uint32) * func->const_cell_num;
+        func_header[0] = code_size;
+        func_header[1] = func->const_cell_num;
+        func_header[2] = func->max_stack_cell_num;
+#if WASM_ENABLE_COMPACT_METADATA == 0
+        func_header[3] = func->max_block_num;
+#else
+        /* Not kept, the fast interpreter never reads it */
+        func_header[3] = 0;
+#endif
+        func_header[4] = relocs[0];
+        bh_memcpy_s(p, sizeof(func_header), func_header, sizeof(func_header));
+        p += sizeof(func_header);
+
+        memset(p, 0, align_uint(code_size, 4));
+        bh_memcpy_s(p, code_size, func->code_compiled, code_size);
+        for (j = 1; j <= relocs[0]; j++) {
+            offset = relocs[j] >> 1;
+            slot = func->code_compiled + offset;
+            if (relocs[j] & 1) {
+#if WASM_ENABLE_LABELS_AS_VALUES != 0
+                void *addr = code_cache_read_label(slot);
+                for (value = 0; value < WASM_INSTRUCTION_NUM; value++) {
+                    if (handle_table[value] == addr)
+                        break;
+                }
+                if (value == WASM_INSTRUCTION_NUM)
+                    return 0;
+                memset(p + offset, 0, CODE_CACHE_LABEL_SIZE);
+#else
+                return 0;
+#endif
+            }
+            else {
+                uint8 *addr;
+                bh_memcpy_s(&addr, sizeof(addr), slot, sizeof(addr));
+                if (addr < func->code_compiled
+                    || addr >= func->code_compiled + code_size)
+                    return 0;
+                value = (uint32)(addr - func->code_compiled);
+                memset(p + offset, 0, sizeof(void *));
+            }
+            bh_memcpy_s(p + offset, sizeof(value), &value, sizeof(value));
+        }
+        p += align_uint(code_size, 4);
+
+        if (consts_size > 0) {
+            bh_memcpy_s(p, consts_size, func->consts, consts_size);
+            p += consts_size;
+        }
+        bh_memcpy_s(p, (uint32)sizeof(uint32) * relocs[0], relocs + 1,
+                    (uint32)sizeof(uint32) * relocs[0]);
+        p += sizeof(uint32) * relocs[0];
+    }
+
+    bh_assert(p == buf + total_size);
+    header[8] = (uint32)(total_size - sizeof(header));
+    header[9] = code_cache_checksum(header, buf + sizeof(header), header[8]);
+    bh_memcpy_s(buf, sizeof(header), header, sizeof(header));
+    return (uint32)total_size;
+}
+
+bool
+wasm_loader_lower_function(WASMModule *module, uint32 func_idx,
+                           char *error_buf, uint32 error_buf_size)
+{
+    WASMFunction *func = module->functions[func_idx];
+    WASMFunction lowered;
+    uint64 start_us;
+    bool ret = true;
+
+    bh_assert(module->lazy_lowering);
+
+    os_mutex_lock(&module->lazy_lowering_lock);
+    /* Another thread may have lowered it while we waited */
+    if (func->code_compiled)
+        goto unlock;
+
+    start_us = os_time_get_boot_us();
+#if WASM_ENABLE_LABELS_AS_VALUES != 0
+    handle_table = wasm_interp_get_handle_table();
+#endif
+    /* Lower into a copy, callers only check func->code_compiled */
+    lowered = *func;
+    if (!wasm_loader_prepare_bytecode(module, &lowered, func_idx, error_buf,
+                                      error_buf_size)) {
+        if (lowered.code_compiled)
+            loader_free(lowered.code_compiled);
+        if (lowered.consts)
+            loader_free(lowered.consts);
+        ret = false;
+        goto unlock;
+    }
+
+    func->code_compiled_size = lowered.code_compiled_size;
+    func->consts = lowered.consts;
+    func->const_cell_num = lowered.const_cell_num;
+    func->max_stack_cell_num = lowered.max_stack_cell_num;
+#if WASM_ENABLE_COMPACT_METADATA == 0
+    func->max_block_num = lowered.max_block_num;
+#endif
+#if WASM_ENABLE_EXCE_HANDLING != 0
+    func->exception_handler_count = lowered.exception_handler_count;
+#endif
+    /* Publish the code last so that a thread seeing it sees the rest */
+    os_atomic_thread_fence(os_memory_order_release);
+    func->code_compiled = lowered.code_compiled;
+
+    module->lazy_lowered_count++;
+    module->lazy_lowering_time_us += os_time_get_boot_us() - start_us;
+
+unlock:
+    os_mutex_unlock(&module->lazy_lowering_lock);
+    return ret;
+}
+#endif /* end of WASM_ENABLE_FAST_INTERP != 0 */
+
 static bool
 load_from_sections(WASMModule *module, WASMSection *sections,
                    bool is_load_from_file_buf, bool wasm_binary_freeable,
-                   bool no_resolve, char *error_buf, uint32 error_buf_size)
+                   bool wasm_binary_readonly, bool no_resolve, char *error_buf,
+                   uint32 error_buf_size)
 {
     WASMExport *export;
     WASMSection *section = sections;
@@ -6265,7 +6863,10 @@ load_from_sections(WASMModule *module, WASMSection *sections,
     uint32 aux_heap_base_global_index = (uint32)-1;
     WASMFuncType *func_type;
     uint8 malloc_free_io_type = VALUE_TYPE_I32;
-    bool reuse_const_strings = is_load_from_file_buf && !wasm_binary_freeable;
+    /* Const strings are NUL-terminated in place by overwriting the LEB
+       length byte in front of them, which a read-only binary can't allow */
+    bool reuse_const_strings = is_load_from_file_buf && !wasm_binary_freeable
+                               && !wasm_binary_readonly;
     bool clone_data_seg = is_load_from_file_buf && wasm_binary_freeable;
 #if WASM_ENABLE_BULK_MEMORY != 0
     bool has_datacount_section = false;
@@ -6623,10 +7224,35 @@ load_from_sections(WASMModule *module, WASMSection *sections,
     handle_table = wasm_interp_get_handle_table();
 #endif
 
+#if WASM_ENABLE_FAST_INTERP != 0
+    if (module->code_cache_record
+        && !(module->code_relocs = loader_malloc(
+                 sizeof(uint32 *) * ((uint64)module->function_count + 1),
+                 error_buf, error_buf_size)))
+        return false;
+    if (module->code_cache)
+        module->code_cache_used = load_code_cache(module);
+    module->code_cache = NULL;
+    module->code_cache_size = 0;
+
+    if (module->lazy_lowering && !module->code_cache_used) {
+        /* memory.grow may be in any function lowered later, so keep the
+           memory growable */
+        module->possible_memory_grow = true;
+    }
+#endif
+
     for (i = 0; i < module->function_count; i++) {
         WASMFunction *func = module->functions[i];
-        if (!wasm_loader_prepare_bytecode(module, func, i, error_buf,
-                                          error_buf_size)) {
+        bool prepared = false;
+#if WASM_ENABLE_FAST_INTERP != 0
+        /* Lazily lowered functions are prepared on their first call by
+           wasm_loader_lower_function() */
+        prepared = module->code_cache_used || module->lazy_lowering;
+#endif
+        if (!prepared
+            && !wasm_loader_prepare_bytecode(module, func, i, error_buf,
+                                             error_buf_size)) {
             return false;
         }
 
@@ -6841,7 +7467,7 @@ fail2:
     bh_hash_map_destroy(module->ref_type_set);
 fail1:
 #endif
-    wasm_runtime_free(module);
+    loader_free(module);
     return NULL;
 }
 
@@ -6869,8 +7495,8 @@ wasm_loader_load_from_sections(WASMSection *section_list, char *error_buf,
     if (!module)
         return NULL;
 
-    if (!load_from_sections(module, section_list, false, true, false, error_buf,
-                            error_buf_size)) {
+    if (!load_from_sections(module, section_list, false, true, false, false,
+                            error_buf, error_buf_size)) {
         wasm_loader_unload(module);
         return NULL;
     }
@@ -6885,7 +7511,7 @@ destroy_sections(WASMSection *section_list)
     WASMSection *section = section_list, *next;
     while (section) {
         next = section->next;
-        wasm_runtime_free(section);
+        loader_free(section);
         section = next;
     }
 }
@@ -6964,8 +7590,8 @@ create_sections(const uint8 *buf, uint32 size, WASMSection **p_section_list,
             read_leb_uint32(p, p_end, section_size);
             CHECK_BUF1(p, p_end, section_size);
 
-            if (!(section = loader_malloc(sizeof(WASMSection), error_buf,
-                                          error_buf_size))) {
+            if (!(section = loader_scratch_malloc(sizeof(WASMSection),
+                                                  error_buf, error_buf_size))) {
                 return false;
             }
 
@@ -7014,8 +7640,8 @@ static union {
 
 static bool
 load(const uint8 *buf, uint32 size, WASMModule *module,
-     bool wasm_binary_freeable, bool no_resolve, char *error_buf,
-     uint32 error_buf_size)
+     bool wasm_binary_freeable, bool wasm_binary_readonly, bool no_resolve,
+     char *error_buf, uint32 error_buf_size)
 {
     const uint8 *buf_end = buf + size;
     const uint8 *p = buf, *p_end = buf_end;
@@ -7046,7 +7672,8 @@ load(const uint8 *buf, uint32 size, WASMModule *module,
 
     if (!create_sections(buf, size, &section_list, error_buf, error_buf_size)
         || !load_from_sections(module, section_list, true, wasm_binary_freeable,
-                               no_resolve, error_buf, error_buf_size)) {
+                               wasm_binary_readonly, no_resolve, error_buf,
+                               error_buf_size)) {
         destroy_sections(section_list);
         return false;
     }
@@ -7204,6 +7831,47 @@ check_wasi_abi_compatibility(const WASMModule *module,
 }
 #endif
 
+#if WASM_ENABLE_LOAD_ARENA != 0
+static uint32
+clamp_chunk_size(uint64 size, uint32 max_size)
+{
+    if (size < WASM_LOAD_ARENA_CHUNK_SIZE)
+        return WASM_LOAD_ARENA_CHUNK_SIZE;
+    return size > max_size ? max_size : (uint32)size;
+}
+
+/* The module data takes about LOAD_ARENA_DATA_RATIO times the binary size,
+   mostly the fast interpreter's code, and much less when the functions
+   are lowered lazily. The first chunk holds most of it, so that the
+   unused end of the last chunk is small next to the data, and the next
+   chunks are smaller. */
+#define LOAD_ARENA_DATA_RATIO 3
+static void
+init_module_arena(WASMModule *module, uint32 wasm_size)
+{
+    uint64 first_size = (uint64)wasm_size;
+
+#if WASM_ENABLE_FAST_INTERP != 0
+    if (!module->lazy_lowering)
+        first_size *= LOAD_ARENA_DATA_RATIO;
+#endif
+    bh_arena_init(
+        &module->arena,
+        clamp_chunk_size(first_size, WASM_LOAD_ARENA_MAX_CHUNK_SIZE * 8),
+        clamp_chunk_size(wasm_size / 2, WASM_LOAD_ARENA_MAX_CHUNK_SIZE));
+}
+
+/* Drop the scratch arena and give back the arenas of the outer load */
+static void
+load_arena_end(bh_arena *arena_prev, bh_arena *scratch_prev)
+{
+    if (loader_scratch)
+        bh_arena_destroy(loader_scratch);
+    loader_arena = arena_prev;
+    loader_scratch = scratch_prev;
+}
+#endif
+
 WASMModule *
 wasm_loader_load(uint8 *buf, uint32 size,
 #if WASM_ENABLE_MULTI_MODULE != 0
@@ -7211,19 +7879,71 @@ wasm_loader_load(uint8 *buf, uint32 size,
 #endif
                  const LoadArgs *args, char *error_buf, uint32 error_buf_size)
 {
+#if WASM_ENABLE_LOAD_ARENA != 0
+    bh_arena scratch, *arena_prev = loader_arena;
+    bh_arena *scratch_prev = loader_scratch;
+#endif
     WASMModule *module = create_module(args->name, error_buf, error_buf_size);
     if (!module) {
         return NULL;
     }
 
+#if WASM_ENABLE_LOAD_ARENA != 0
+    /* Set even when not used, a module loaded while loading another one
+       mustn't use the other one's arenas */
+    loader_arena = loader_scratch = NULL;
+#endif
+
 #if WASM_ENABLE_DEBUG_INTERP != 0 || WASM_ENABLE_FAST_JIT != 0 \
     || WASM_ENABLE_DUMP_CALL_STACK != 0 || WASM_ENABLE_JIT != 0
     module->load_addr = (uint8 *)buf;
     module->load_size = size;
 #endif
 
-    if (!load(buf, size, module, args->wasm_binary_freeable, args->no_resolve,
-              error_buf, error_buf_size)) {
+#if WASM_ENABLE_FAST_INTERP != 0
+    if (args->code_cache || args->code_cache_record) {
+        module->code_cache = args->code_cache;
+        module->code_cache_size = args->code_cache_size;
+        module->code_cache_record = args->code_cache_record;
+        module->code_cache_wasm_size = size;
+        module->code_cache_wasm_hash =
+            code_cache_hash(CODE_CACHE_HASH_INIT, buf, size);
+    }
+#if WASM_ENABLE_SUPERINSTRUCTIONS != 0
+    module->no_superinstructions = args->no_superinstructions;
+#endif
+    /* A recorded cache needs every function lowered, and lazy lowering
+       reads the function bodies from the binary after loading */
+    if (args->lazy_lowering && !args->code_cache_record
+        && !args->wasm_binary_freeable) {
+        if (os_mutex_init(&module->lazy_lowering_lock) != 0) {
+            set_error_buf(error_buf, error_buf_size,
+                          "init lazy lowering lock failed");
+            goto fail;
+        }
+        module->lazy_lowering = true;
+    }
+#endif
+
+#if WASM_ENABLE_NATIVE_TRAMPOLINES != 0
+    module->no_native_trampolines = args->no_native_trampolines;
+#endif
+
+#if WASM_ENABLE_LOAD_ARENA != 0
+    if (args->load_arena) {
+        init_module_arena(module, size);
+        /* A small first chunk for the section list, which is all the
+           scratch data when the functions are lowered lazily */
+        bh_arena_init(&scratch, WASM_LOAD_ARENA_CHUNK_SIZE,
+                      WASM_LOAD_ARENA_SCRATCH_SIZE);
+        loader_arena = &module->arena;
+        loader_scratch = &scratch;
+    }
+#endif
+
+    if (!load(buf, size, module, args->wasm_binary_freeable,
+              args->wasm_binary_readonly, args->no_resolve, error_buf,
+              error_buf_size)) {
         goto fail;
     }
 
@@ -7238,10 +7958,16 @@ wasm_loader_load(uint8 *buf, uint32 size,
     }
 #endif
 
+#if WASM_ENABLE_LOAD_ARENA != 0
+    load_arena_end(arena_prev, scratch_prev);
+#endif
     LOG_VERBOSE("Load module success.\n");
     return module;
 
 fail:
+#if WASM_ENABLE_LOAD_ARENA != 0
+    load_arena_end(arena_prev, scratch_prev);
+#endif
     wasm_loader_unload(module);
     return NULL;
 }
@@ -7250,10 +7976,20 @@ void
 wasm_loader_unload(WASMModule *module)
 {
     uint32 i;
+#if WASM_ENABLE_LOAD_ARENA != 0
+    bh_arena *arena_prev = loader_arena, *scratch_prev = loader_scratch;
+#endif
 
     if (!module)
         return;
 
+#if WASM_ENABLE_LOAD_ARENA != 0
+    /* Let loader_free() skip the blocks of the module arena */
+    loader_arena =
+        bh_arena_is_inited(&module->arena) ? &module->arena : NULL;
+    loader_scratch = NULL;
+#endif
+
 #if WASM_ENABLE_FAST_JIT != 0 && WASM_ENABLE_JIT != 0 \
     && WASM_ENABLE_LAZY_JIT != 0
     module->orcjit_stop_compiling = true;
@@ -7269,7 +8005,7 @@ wasm_loader_unload(WASMModule *module)
 
 #if WASM_ENABLE_JIT != 0
     if (module->func_ptrs)
-        wasm_runtime_free(module->func_ptrs);
+        loader_free(module->func_ptrs);
     if (module->comp_ctx)
         aot_destroy_comp_context(module->comp_ctx);
     if (module->comp_data)
@@ -7285,18 +8021,20 @@ wasm_loader_unload(WASMModule *module)
 #endif
 
     if (module->imports)
-        wasm_runtime_free(module->imports);
+        loader_free(module->imports);
 
     if (module->functions) {
         for (i = 0; i < module->function_count; i++) {
             if (module->functions[i]) {
+#if WASM_ENABLE_COMPACT_METADATA == 0
                 if (module->functions[i]->local_offsets)
-                    wasm_runtime_free(module->functions[i]->local_offsets);
+                    loader_free(module->functions[i]->local_offsets);
+#endif
 #if WASM_ENABLE_FAST_INTERP != 0
                 if (module->functions[i]->code_compiled)
-                    wasm_runtime_free(module->functions[i]->code_compiled);
+                    loader_free(module->functions[i]->code_compiled);
                 if (module->functions[i]->consts)
-                    wasm_runtime_free(module->functions[i]->consts);
+                    loader_free(module->functions[i]->consts);
 #endif
 #if WASM_ENABLE_FAST_JIT != 0
                 if (module->functions[i]->fast_jit_jitted_code) {
@@ -7312,27 +8050,39 @@ wasm_loader_unload(WASMModule *module)
 #endif
 #if WASM_ENABLE_GC != 0
                 if (module->functions[i]->local_ref_type_maps) {
-                    wasm_runtime_free(
+                    loader_free(
                         module->functions[i]->local_ref_type_maps);
                 }
 #endif
-                wasm_runtime_free(module->functions[i]);
+                loader_free(module->functions[i]);
             }
         }
-        wasm_runtime_free(module->functions);
+        loader_free(module->functions);
     }
 
+#if WASM_ENABLE_FAST_INTERP != 0
+    if (module->code_relocs) {
+        for (i = 0; i < module->function_count; i++) {
+            if (module->code_relocs[i])
+                loader_free(module->code_relocs[i]);
+        }
+        loader_free(module->code_relocs);
+    }
+    if (module->lazy_lowering)
+        os_mutex_destroy(&module->lazy_lowering_lock);
+#endif
+
     if (module->tables) {
 #if WASM_ENABLE_GC != 0
         for (i = 0; i < module->table_count; i++) {
             destroy_init_expr(module, &module->tables[i].init_expr);
         }
 #endif
-        wasm_runtime_free(module->tables);
+        loader_free(module->tables);
     }
 
     if (module->memories)
-        wasm_runtime_free(module->memories);
+        loader_free(module->memories);
 
     if (module->globals) {
 #if WASM_ENABLE_GC != 0 || WASM_ENABLE_EXTENDED_CONST_EXPR != 0
@@ -7340,21 +8090,21 @@ wasm_loader_unload(WASMModule *module)
             destroy_init_expr(module, &module->globals[i].init_expr);
         }
 #endif
-        wasm_runtime_free(module->globals);
+        loader_free(module->globals);
     }
 
 #if WASM_ENABLE_TAGS != 0
     if (module->tags) {
         for (i = 0; i < module->tag_count; i++) {
             if (module->tags[i])
-                wasm_runtime_free(module->tags[i]);
+                loader_free(module->tags[i]);
         }
-        wasm_runtime_free(module->tags);
+        loader_free(module->tags);
     }
 #endif
 
     if (module->exports)
-        wasm_runtime_free(module->exports);
+        loader_free(module->exports);
 
     if (module->table_segments) {
         for (i = 0; i < module->table_seg_count; i++) {
@@ -7366,28 +8116,28 @@ wasm_loader_unload(WASMModule *module)
                         module, &module->table_segments[i].init_values[j]);
                 }
 #endif
-                wasm_runtime_free(module->table_segments[i].init_values);
+                loader_free(module->table_segments[i].init_values);
             }
 #if WASM_ENABLE_EXTENDED_CONST_EXPR != 0
             destroy_init_expr(module, &module->table_segments[i].base_offset);
 #endif
         }
-        wasm_runtime_free(module->table_segments);
+        loader_free(module->table_segments);
     }
 
     if (module->data_segments) {
         for (i = 0; i < module->data_seg_count; i++) {
             if (module->data_segments[i]) {
                 if (module->data_segments[i]->is_data_cloned)
-                    wasm_runtime_free(module->data_segments[i]->data);
+                    loader_free(module->data_segments[i]->data);
 #if WASM_ENABLE_EXTENDED_CONST_EXPR != 0
                 destroy_init_expr(module,
                                   &(module->data_segments[i]->base_offset));
 #endif
-                wasm_runtime_free(module->data_segments[i]);
+                loader_free(module->data_segments[i]);
             }
         }
-        wasm_runtime_free(module->data_segments);
+        loader_free(module->data_segments);
     }
 
     if (module->types) {
@@ -7395,24 +8145,24 @@ wasm_loader_unload(WASMModule *module)
             if (module->types[i])
                 destroy_wasm_type(module->types[i]);
         }
-        wasm_runtime_free(module->types);
+        loader_free(module->types);
     }
 
     if (module->const_str_list) {
         StringNode *node = module->const_str_list, *node_next;
         while (node) {
             node_next = node->next;
-            wasm_runtime_free(node);
+            loader_free(node);
             node = node_next;
         }
     }
 
 #if WASM_ENABLE_STRINGREF != 0
     if (module->string_literal_ptrs) {
-        wasm_runtime_free((void *)module->string_literal_ptrs);
+        loader_free((void *)module->string_literal_ptrs);
     }
     if (module->string_literal_lengths) {
-        wasm_runtime_free(module->string_literal_lengths);
+        loader_free(module->string_literal_lengths);
     }
 #endif
 
@@ -7422,7 +8172,7 @@ wasm_loader_unload(WASMModule *module)
         BrTableCache *node_next;
         while (node) {
             node_next = bh_list_elem_next(node);
-            wasm_runtime_free(node);
+            loader_free(node);
             node = node_next;
         }
     }
@@ -7441,7 +8191,7 @@ wasm_loader_unload(WASMModule *module)
              * every module in the global module list will be unloaded one by
              * one. so don't worry.
              */
-            wasm_runtime_free(node);
+            loader_free(node);
             /*
              * the module file reading buffer will be released
              * in runtime_destroy()
@@ -7456,7 +8206,7 @@ wasm_loader_unload(WASMModule *module)
         bh_list_first_elem(&module->fast_opcode_list);
     while (fast_opcode) {
         WASMFastOPCodeNode *next = bh_list_elem_next(fast_opcode);
-        wasm_runtime_free(fast_opcode);
+        loader_free(fast_opcode);
         fast_opcode = next;
     }
 #endif
@@ -7473,7 +8223,7 @@ wasm_loader_unload(WASMModule *module)
 
 #if WASM_ENABLE_FAST_JIT != 0
     if (module->fast_jit_func_ptrs) {
-        wasm_runtime_free(module->fast_jit_func_ptrs);
+        loader_free(module->fast_jit_func_ptrs);
     }
 
     for (i = 0; i < WASM_ORC_JIT_BACKEND_THREAD_NUM; i++) {
@@ -7489,14 +8239,14 @@ wasm_loader_unload(WASMModule *module)
     if (module->rtt_types) {
         for (i = 0; i < module->type_count; i++) {
             if (module->rtt_types[i])
-                wasm_runtime_free(module->rtt_types[i]);
+                loader_free(module->rtt_types[i]);
         }
-        wasm_runtime_free(module->rtt_types);
+        loader_free(module->rtt_types);
     }
 #if WASM_ENABLE_STRINGREF != 0
     for (i = 0; i < WASM_TYPE_STRINGVIEWITER - WASM_TYPE_STRINGREF + 1; i++) {
         if (module->stringref_rtts[i])
-            wasm_runtime_free(module->stringref_rtts[i]);
+            loader_free(module->stringref_rtts[i]);
     }
 #endif
 #endif
@@ -7506,12 +8256,18 @@ wasm_loader_unload(WASMModule *module)
         // the hint structs have been allocated all at once as an array.
         // With only branch-hints at the moment, this is the case.
         if (module->function_hints != NULL && module->function_hints[i] != NULL)
-            wasm_runtime_free(module->function_hints[i]);
+            loader_free(module->function_hints[i]);
     }
     if (module->function_hints != NULL)
-        wasm_runtime_free(module->function_hints);
+        loader_free(module->function_hints);
+#endif
+#if WASM_ENABLE_LOAD_ARENA != 0
+    if (bh_arena_is_inited(&module->arena))
+        bh_arena_destroy(&module->arena);
+    loader_arena = arena_prev;
+    loader_scratch = scratch_prev;
 #endif
-    wasm_runtime_free(module);
+    loader_free(module);
 }
 
 bool
@@ -8488,6 +9244,18 @@ typedef struct WASMLoaderContext {
      * than the final code_compiled_size, we record the peak size to ensure
      * there will not be invalid memory access during second traverse */
     uint32 code_compiled_peak_size;
+
+    /* relocations of the processed code, recorded in the second traverse
+     * when the module keeps them for the code cache, see
+     * WASMModule::code_relocs */
+    uint32 *relocs;
+    uint32 reloc_max_num;
+    bool record_relocs;
+    bool reloc_failed;
+#endif
+#if WASM_ENABLE_LOAD_ARENA != 0
+    /* Where the scratch arena goes back to when the context is destroyed */
+    bh_arena_mark scratch_mark;
 #endif
 } WASMLoaderContext;
 
@@ -8558,7 +9326,7 @@ free_label_patch_list(BranchBlock *frame_csp)
     BranchBlockPatch *next;
     while (label_patch != NULL) {
         next = label_patch->next;
-        wasm_runtime_free(label_patch);
+        loader_free(label_patch);
         label_patch = next;
     }
     frame_csp->patch_list = NULL;
@@ -8584,7 +9352,7 @@ free_all_label_param_frame_offsets(BranchBlock *frame_csp, uint32 csp_num)
 
     for (i = 0; i < csp_num; i++) {
         if (tmp_csp->param_frame_offsets)
-            wasm_runtime_free(tmp_csp->param_frame_offsets);
+            loader_free(tmp_csp->param_frame_offsets);
         tmp_csp++;
     }
 }
@@ -8607,8 +9375,8 @@ wasm_loader_init_local_use_masks(WASMLoaderContext *ctx, uint32 local_count,
      * else branch, we don't need to allocate memory again */
     if (!current_csp->local_use_mask) {
         local_mask_size = (local_count + 7) / sizeof(uint8);
-        if (!(current_csp->local_use_mask =
-                  loader_malloc(local_mask_size, error_buf, error_buf_size))) {
+        if (!(current_csp->local_use_mask = loader_scratch_malloc(
+                  local_mask_size, error_buf, error_buf_size))) {
             return false;
         }
         current_csp->local_use_mask_size = local_mask_size;
@@ -8641,7 +9409,7 @@ wasm_loader_destroy_curr_local_use_masks(WASMLoaderContext *ctx)
               || current_csp->local_use_mask_size == 0);
 
     if (current_csp->local_use_mask) {
-        wasm_runtime_free(current_csp->local_use_mask);
+        loader_free(current_csp->local_use_mask);
     }
 
     current_csp->local_use_mask = NULL;
@@ -8656,7 +9424,7 @@ wasm_loader_clean_all_local_use_masks(WASMLoaderContext *ctx)
 
     for (i = 0; i < ctx->csp_num; i++) {
         if (tmp_csp->local_use_mask) {
-            wasm_runtime_free(tmp_csp->local_use_mask);
+            loader_free(tmp_csp->local_use_mask);
             tmp_csp->local_use_mask = NULL;
             tmp_csp->local_use_mask_size = 0;
         }
@@ -8698,10 +9466,10 @@ wasm_loader_ctx_destroy(WASMLoaderContext *ctx)
 {
     if (ctx) {
         if (ctx->frame_ref_bottom)
-            wasm_runtime_free(ctx->frame_ref_bottom);
+            loader_free(ctx->frame_ref_bottom);
 #if WASM_ENABLE_GC != 0
         if (ctx->frame_reftype_map_bottom)
-            wasm_runtime_free(ctx->frame_reftype_map_bottom);
+            loader_free(ctx->frame_reftype_map_bottom);
 #endif
         if (ctx->frame_csp_bottom) {
 #if WASM_ENABLE_FAST_INTERP != 0
@@ -8712,49 +9480,71 @@ wasm_loader_ctx_destroy(WASMLoaderContext *ctx)
 #if WASM_ENABLE_GC != 0
             wasm_loader_clean_all_local_use_masks(ctx);
 #endif
-            wasm_runtime_free(ctx->frame_csp_bottom);
+            loader_free(ctx->frame_csp_bottom);
         }
 #if WASM_ENABLE_FAST_INTERP != 0
         if (ctx->frame_offset_bottom)
-            wasm_runtime_free(ctx->frame_offset_bottom);
+            loader_free(ctx->frame_offset_bottom);
         if (ctx->i64_consts)
-            wasm_runtime_free(ctx->i64_consts);
+            loader_free(ctx->i64_consts);
         if (ctx->i32_consts)
-            wasm_runtime_free(ctx->i32_consts);
+            loader_free(ctx->i32_consts);
         if (ctx->v128_consts)
-            wasm_runtime_free(ctx->v128_consts);
+            loader_free(ctx->v128_consts);
+        if (ctx->relocs)
+            loader_free(ctx->relocs);
+#endif
+#if WASM_ENABLE_LOAD_ARENA != 0
+        if (loader_scratch) {
+            bh_arena_mark scratch_mark = ctx->scratch_mark;
+            bh_arena_release(loader_scratch, &scratch_mark);
+            return;
+        }
 #endif
-        wasm_runtime_free(ctx);
+        loader_free(ctx);
     }
 }
 
 static WASMLoaderContext *
 wasm_loader_ctx_init(WASMFunction *func, char *error_buf, uint32 error_buf_size)
 {
-    WASMLoaderContext *loader_ctx =
-        loader_malloc(sizeof(WASMLoaderContext), error_buf, error_buf_size);
+    WASMLoaderContext *loader_ctx;
+#if WASM_ENABLE_LOAD_ARENA != 0
+    bh_arena_mark scratch_mark = { 0 };
+
+    if (loader_scratch)
+        bh_arena_get_mark(loader_scratch, &scratch_mark);
+#endif
+
+    loader_ctx = loader_scratch_malloc(sizeof(WASMLoaderContext), error_buf,
+                                       error_buf_size);
     if (!loader_ctx)
         return NULL;
+#if WASM_ENABLE_LOAD_ARENA != 0
+    loader_ctx->scratch_mark = scratch_mark;
+#endif
 
     loader_ctx->frame_ref_size = 32;
-    if (!(loader_ctx->frame_ref_bottom = loader_ctx->frame_ref = loader_malloc(
-              loader_ctx->frame_ref_size, error_buf, error_buf_size)))
+    if (!(loader_ctx->frame_ref_bottom = loader_ctx->frame_ref =
+              loader_scratch_malloc(loader_ctx->frame_ref_size, error_buf,
+                                    error_buf_size)))
         goto fail;
     loader_ctx->frame_ref_boundary = loader_ctx->frame_ref_bottom + 32;
 
 #if WASM_ENABLE_GC != 0
     loader_ctx->frame_reftype_map_size = sizeof(WASMRefTypeMap) * 16;
     if (!(loader_ctx->frame_reftype_map_bottom = loader_ctx->frame_reftype_map =
-              loader_malloc(loader_ctx->frame_reftype_map_size, error_buf,
-                            error_buf_size)))
+              loader_scratch_malloc(loader_ctx->frame_reftype_map_size,
+                                    error_buf, error_buf_size)))
         goto fail;
     loader_ctx->frame_reftype_map_boundary =
         loader_ctx->frame_reftype_map_bottom + 16;
 #endif
 
     loader_ctx->frame_csp_size = sizeof(BranchBlock) * 8;
-    if (!(loader_ctx->frame_csp_bottom = loader_ctx->frame_csp = loader_malloc(
-              loader_ctx->frame_csp_size, error_buf, error_buf_size)))
+    if (!(loader_ctx->frame_csp_bottom = loader_ctx->frame_csp =
+              loader_scratch_malloc(loader_ctx->frame_csp_size, error_buf,
+                                    error_buf_size)))
         goto fail;
     loader_ctx->frame_csp_boundary = loader_ctx->frame_csp_bottom + 8;
 
@@ -8765,25 +9555,25 @@ wasm_loader_ctx_init(WASMFunction *func, char *error_buf, uint32 error_buf_size)
 #if WASM_ENABLE_FAST_INTERP != 0
     loader_ctx->frame_offset_size = sizeof(int16) * 32;
     if (!(loader_ctx->frame_offset_bottom = loader_ctx->frame_offset =
-              loader_malloc(loader_ctx->frame_offset_size, error_buf,
-                            error_buf_size)))
+              loader_scratch_malloc(loader_ctx->frame_offset_size, error_buf,
+                                    error_buf_size)))
         goto fail;
     loader_ctx->frame_offset_boundary = loader_ctx->frame_offset_bottom + 32;
 
     loader_ctx->i64_const_max_num = 8;
-    if (!(loader_ctx->i64_consts =
-              loader_malloc(sizeof(int64) * loader_ctx->i64_const_max_num,
-                            error_buf, error_buf_size)))
+    if (!(loader_ctx->i64_consts = loader_scratch_malloc(
+              sizeof(int64) * loader_ctx->i64_const_max_num, error_buf,
+              error_buf_size)))
         goto fail;
     loader_ctx->i32_const_max_num = 8;
-    if (!(loader_ctx->i32_consts =
-              loader_malloc(sizeof(int32) * loader_ctx->i32_const_max_num,
-                            error_buf, error_buf_size)))
+    if (!(loader_ctx->i32_consts = loader_scratch_malloc(
+              sizeof(int32) * loader_ctx->i32_const_max_num, error_buf,
+              error_buf_size)))
         goto fail;
     loader_ctx->v128_const_max_num = 8;
-    if (!(loader_ctx->v128_consts =
-              loader_malloc(sizeof(V128) * loader_ctx->v128_const_max_num,
-                            error_buf, error_buf_size)))
+    if (!(loader_ctx->v128_consts = loader_scratch_malloc(
+              sizeof(V128) * loader_ctx->v128_const_max_num, error_buf,
+              error_buf_size)))
         goto fail;
 
     if (func->param_cell_num >= (int32)INT16_MAX - func->local_cell_num) {
@@ -9305,7 +10095,7 @@ wasm_loader_pop_frame_csp(WASMLoaderContext *ctx, char *error_buf,
     CHECK_CSP_POP();
 #if WASM_ENABLE_FAST_INTERP != 0
     if ((ctx->frame_csp - 1)->param_frame_offsets)
-        wasm_runtime_free((ctx->frame_csp - 1)->param_frame_offsets);
+        loader_free((ctx->frame_csp - 1)->param_frame_offsets);
 #endif
     ctx->frame_csp--;
     ctx->csp_num--;
@@ -9321,6 +10111,7 @@ fail:
 #if WASM_CPU_SUPPORTS_UNALIGNED_ADDR_ACCESS != 0
 #define emit_label(opcode)                                      \
     do {                                                        \
+        wasm_loader_add_reloc(loader_ctx, true);                \
         wasm_loader_emit_ptr(loader_ctx, handle_table[opcode]); \
         LOG_OP("\nemit_op [%02x]\t", opcode);                   \
     } while (0)
@@ -9336,6 +10127,7 @@ fail:
         int32 offset =                                                         \
             (int32)((uint8 *)handle_table[opcode] - (uint8 *)handle_table[0]); \
         /* emit int32 relative offset in 64-bit target */                      \
+        wasm_loader_add_reloc(loader_ctx, true);                               \
         wasm_loader_emit_uint32(loader_ctx, offset);                           \
         LOG_OP("\nemit_op [%02x]\t", opcode);                                  \
     } while (0)
@@ -9344,6 +10136,7 @@ fail:
     do {                                                             \
         uint32 label_addr = (uint32)(uintptr_t)handle_table[opcode]; \
         /* emit uint32 label address in 32-bit target */             \
+        wasm_loader_add_reloc(loader_ctx, true);                     \
         wasm_loader_emit_uint32(loader_ctx, label_addr);             \
         LOG_OP("\nemit_op [%02x]\t", opcode);                        \
     } while (0)
@@ -9374,6 +10167,7 @@ fail:
                                      error_buf_size))                        \
             goto fail;                                                       \
         /* label address, to be patched */                                   \
+        wasm_loader_add_reloc(loader_ctx, false);                            \
         wasm_loader_emit_ptr(loader_ctx, NULL);                              \
     } while (0)
 
@@ -9384,6 +10178,13 @@ fail:
             goto fail;                                                         \
     } while (0)
 
+#if WASM_ENABLE_SUPERINSTRUCTIONS != 0
+#define LAST_OP_OUTPUT_I32_IMM() \
+    (last_op >= EXT_OP_I32_ADD_IMM && last_op <= EXT_OP_I32_SHR_U_IMM)
+#else
+#define LAST_OP_OUTPUT_I32_IMM() false
+#endif
+
 #define LAST_OP_OUTPUT_I32()                                                   \
     (last_op >= WASM_OP_I32_EQZ && last_op <= WASM_OP_I32_ROTR)                \
         || (last_op == WASM_OP_I32_LOAD || last_op == WASM_OP_F32_LOAD)        \
@@ -9395,7 +10196,8 @@ fail:
             && last_op <= WASM_OP_F32_DEMOTE_F64)                              \
         || (last_op == WASM_OP_I32_REINTERPRET_F32)                            \
         || (last_op == WASM_OP_F32_REINTERPRET_I32)                            \
-        || (last_op == EXT_OP_COPY_STACK_TOP)
+        || (last_op == EXT_OP_COPY_STACK_TOP)                                  \
+        || LAST_OP_OUTPUT_I32_IMM()
 
 #define LAST_OP_OUTPUT_I64()                                                   \
     (last_op >= WASM_OP_I64_CLZ && last_op <= WASM_OP_I64_ROTR)                \
@@ -9473,8 +10275,8 @@ fail:
 static bool
 wasm_loader_ctx_reinit(WASMLoaderContext *ctx)
 {
-    if (!(ctx->p_code_compiled =
-              loader_malloc(ctx->code_compiled_peak_size, NULL, 0)))
+    if (!(ctx->p_code_compiled = loader_malloc_class(
+              ctx->code_compiled_peak_size, Mem_Class_Code, NULL, 0)))
         return false;
     ctx->p_code_compiled_end =
         ctx->p_code_compiled + ctx->code_compiled_peak_size;
@@ -9518,6 +10320,40 @@ increase_compiled_code_space(WASMLoaderContext *ctx, int32 size)
     }
 }
 
+/* Record that the next emitted slot holds a label (opcode handler) or a
+   code address, so that the code cache can relocate it */
+static void
+wasm_loader_add_reloc(WASMLoaderContext *ctx, bool is_label)
+{
+    uint8 *code_compiled;
+    uint32 *relocs;
+
+    if (!ctx->record_relocs || !ctx->p_code_compiled || ctx->reloc_failed)
+        return;
+
+    if (!ctx->relocs || ctx->relocs[0] + 1 >= ctx->reloc_max_num) {
+        uint32 max_num = ctx->reloc_max_num ? ctx->reloc_max_num * 2 : 32;
+
+        if (ctx->relocs)
+            relocs = memory_realloc(ctx->relocs,
+                                    sizeof(uint32) * ctx->reloc_max_num,
+                                    sizeof(uint32) * max_num, NULL, 0);
+        else
+            relocs = loader_malloc(sizeof(uint32) * max_num, NULL, 0);
+        if (!relocs) {
+            /* The module loads fine, it just can't be saved to a cache */
+            ctx->reloc_failed = true;
+            return;
+        }
+        ctx->relocs = relocs;
+        ctx->reloc_max_num = max_num;
+    }
+
+    code_compiled = ctx->p_code_compiled_end - ctx->code_compiled_peak_size;
+    ctx->relocs[++ctx->relocs[0]] =
+        (uint32)(ctx->p_code_compiled - code_compiled) << 1 | is_label;
+}
+
 static void
 wasm_loader_emit_const(WASMLoaderContext *ctx, void *value, bool is_32_bit)
 {
@@ -9625,6 +10461,15 @@ wasm_loader_emit_backspace(WASMLoaderContext *ctx, uint32 size)
             bh_assert(((uintptr_t)ctx->p_code_compiled & 1) == 0);
         }
 #endif
+        /* Drop the relocations of the removed slots */
+        if (ctx->relocs) {
+            uint32 offset = (uint32)(ctx->p_code_compiled
+                                     - (ctx->p_code_compiled_end
+                                        - ctx->code_compiled_peak_size));
+            while (ctx->relocs[0] > 0
+                   && (ctx->relocs[ctx->relocs[0]] >> 1) >= offset)
+                ctx->relocs[0]--;
+        }
     }
     else {
         ctx->code_compiled_size -= size;
@@ -9746,13 +10591,184 @@ preserve_local_for_block(WASMLoaderContext *loader_ctx, uint8 opcode,
     return true;
 }
 
+#if WASM_ENABLE_SUPERINSTRUCTIONS != 0
+/* Replace the i32 comparison and the br_if just emitted, which takes the
+   comparison's result as its condition, with the fused opcode. The br_if's
+   branch info is emitted after it. */
+static void
+fuse_cmp_br_if(WASMLoaderContext *loader_ctx, uint8 cmp_opcode)
+{
+    int16 operands[2] = { 0 };
+    uint32 operand_size =
+        (uint32)sizeof(int16) * (cmp_opcode == WASM_OP_I32_EQZ ? 1 : 2);
+    uint32 i;
+
+    bh_assert(cmp_opcode >= WASM_OP_I32_EQZ && cmp_opcode <= WASM_OP_I32_GE_U);
+
+    /* br_if: label, condition */
+    wasm_loader_emit_backspace(loader_ctx, sizeof(int16));
+    skip_label();
+    /* comparison: label, operands, result */
+    wasm_loader_emit_backspace(loader_ctx, sizeof(int16));
+    if (loader_ctx->p_code_compiled)
+        bh_memcpy_s(operands, sizeof(operands),
+                    loader_ctx->p_code_compiled - operand_size, operand_size);
+    wasm_loader_emit_backspace(loader_ctx, operand_size);
+    skip_label();
+
+    emit_label(EXT_OP_I32_EQZ_BR_IF + (cmp_opcode - WASM_OP_I32_EQZ));
+    for (i = 0; i < operand_size / sizeof(int16); i++)
+        emit_operand(loader_ctx, operands[i]);
+}
+
+/* Replace the i32.add and the i32 load just emitted, which takes the sum
+   as its address, with the fused opcode */
+static void
+fuse_add_load(WASMLoaderContext *loader_ctx, uint8 load_opcode,
+              uint32 mem_offset)
+{
+    int16 operands[2] = { 0 }, result = 0;
+    uint8 fused_opcode;
+
+    switch (load_opcode) {
+        case WASM_OP_I32_LOAD:
+        case WASM_OP_F32_LOAD:
+            fused_opcode = EXT_OP_I32_ADD_LOAD;
+            break;
+        case WASM_OP_I32_LOAD8_S:
+            fused_opcode = EXT_OP_I32_ADD_LOAD8_S;
+            break;
+        case WASM_OP_I32_LOAD8_U:
+            fused_opcode = EXT_OP_I32_ADD_LOAD8_U;
+            break;
+        case WASM_OP_I32_LOAD16_S:
+            fused_opcode = EXT_OP_I32_ADD_LOAD16_S;
+            break;
+        default:
+            bh_assert(load_opcode == WASM_OP_I32_LOAD16_U);
+            fused_opcode = EXT_OP_I32_ADD_LOAD16_U;
+            break;
+    }
+
+    /* load: label, offset, address, result */
+    if (loader_ctx->p_code_compiled)
+        bh_memcpy_s(&result, sizeof(result),
+                    loader_ctx->p_code_compiled - sizeof(int16),
+                    sizeof(int16));
+    wasm_loader_emit_backspace(loader_ctx,
+                               sizeof(int16) * 2 + sizeof(uint32));
+    skip_label();
+    /* add: label, operands, result */
+    wasm_loader_emit_backspace(loader_ctx, sizeof(int16));
+    if (loader_ctx->p_code_compiled)
+        bh_memcpy_s(operands, sizeof(operands),
+                    loader_ctx->p_code_compiled - sizeof(operands),
+                    sizeof(operands));
+    wasm_loader_emit_backspace(loader_ctx, sizeof(operands));
+    skip_label();
+
+    emit_label(fused_opcode);
+    emit_uint32(loader_ctx, mem_offset);
+    emit_operand(loader_ctx, operands[0]);
+    emit_operand(loader_ctx, operands[1]);
+    emit_operand(loader_ctx, result);
+}
+
+/* Replace the i32 binary op just emitted with its variant taking a
+   constant operand as an immediate, if it has one. The operand offsets are
+   those it popped, constants having negative offsets. Returns the opcode
+   emitted, or 0 if the op is left as it is */
+static uint8
+fuse_i32_const_operand(WASMLoaderContext *loader_ctx, uint8 opcode,
+                       int16 lhs_offset, int16 rhs_offset)
+{
+    int16 src_offset, const_offset, result = 0;
+    uint32 imm = 0;
+    uint8 imm_opcode;
+    bool commutative = true;
+
+    switch (opcode) {
+        case WASM_OP_I32_ADD:
+            imm_opcode = EXT_OP_I32_ADD_IMM;
+            break;
+        case WASM_OP_I32_SUB:
+            /* x - c is x + (-c) */
+            imm_opcode = EXT_OP_I32_ADD_IMM;
+            commutative = false;
+            break;
+        case WASM_OP_I32_MUL:
+            imm_opcode = EXT_OP_I32_MUL_IMM;
+            break;
+        case WASM_OP_I32_AND:
+            imm_opcode = EXT_OP_I32_AND_IMM;
+            break;
+        case WASM_OP_I32_OR:
+            imm_opcode = EXT_OP_I32_OR_IMM;
+            break;
+        case WASM_OP_I32_XOR:
+            imm_opcode = EXT_OP_I32_XOR_IMM;
+            break;
+        case WASM_OP_I32_SHL:
+            imm_opcode = EXT_OP_I32_SHL_IMM;
+            commutative = false;
+            break;
+        case WASM_OP_I32_SHR_S:
+            imm_opcode = EXT_OP_I32_SHR_S_IMM;
+            commutative = false;
+            break;
+        case WASM_OP_I32_SHR_U:
+            imm_opcode = EXT_OP_I32_SHR_U_IMM;
+            commutative = false;
+            break;
+        default:
+            return 0;
+    }
+
+    if (rhs_offset < 0) {
+        const_offset = rhs_offset;
+        src_offset = lhs_offset;
+    }
+    else if (lhs_offset < 0 && commutative) {
+        const_offset = lhs_offset;
+        src_offset = rhs_offset;
+    }
+    else {
+        return 0;
+    }
+
+    /* The consts are only known in the second traversal */
+    if (loader_ctx->p_code_compiled) {
+        bh_assert(const_offset >= -(int32)loader_ctx->i32_const_num);
+        imm = (uint32)
+            loader_ctx->i32_consts[loader_ctx->i32_const_num + const_offset];
+        if (opcode == WASM_OP_I32_SUB)
+            imm = 0 - imm;
+        else if (!commutative)
+            imm &= 31;
+        bh_memcpy_s(&result, sizeof(result),
+                    loader_ctx->p_code_compiled - sizeof(int16),
+                    sizeof(int16));
+    }
+
+    /* op: label, operands, result */
+    wasm_loader_emit_backspace(loader_ctx, sizeof(int16) * 3);
+    skip_label();
+
+    emit_label(imm_opcode);
+    emit_uint32(loader_ctx, imm);
+    emit_operand(loader_ctx, src_offset);
+    emit_operand(loader_ctx, result);
+    return imm_opcode;
+}
+#endif /* end of WASM_ENABLE_SUPERINSTRUCTIONS != 0 */
+
 static bool
 add_label_patch_to_list(BranchBlock *frame_csp, uint8 patch_type,
                         uint8 *p_code_compiled, char *error_buf,
                         uint32 error_buf_size)
 {
-    BranchBlockPatch *patch =
-        loader_malloc(sizeof(BranchBlockPatch), error_buf, error_buf_size);
+    BranchBlockPatch *patch = loader_scratch_malloc(
+        sizeof(BranchBlockPatch), error_buf, error_buf_size);
     if (!patch) {
         return false;
     }
@@ -9789,7 +10805,7 @@ apply_label_patch(WASMLoaderContext *ctx, uint8 depth, uint8 patch_type)
             else {
                 node_prev->next = node_next;
             }
-            wasm_runtime_free(node);
+            loader_free(node);
         }
         else {
             node_prev = node;
@@ -9877,6 +10893,7 @@ wasm_loader_emit_br_info(WASMLoaderContext *ctx, BranchBlock *frame_csp,
     }
 
     /* Part f */
+    wasm_loader_add_reloc(ctx, false);
     if (frame_csp->label_type == LABEL_TYPE_LOOP) {
         wasm_loader_emit_ptr(ctx, frame_csp->code_compiled);
     }
@@ -10497,7 +11514,8 @@ reserve_block_ret(WASMLoaderContext *loader_ctx, uint8 opcode,
             * (sizeof(*cells) + sizeof(*src_offsets) + sizeof(*dst_offsets));
 
         /* Allocate memory for the emit data */
-        if (!(emit_data = loader_malloc(size, error_buf, error_buf_size)))
+        if (!(emit_data =
+                  loader_scratch_malloc(size, error_buf, error_buf_size)))
             return false;
 
         cells = emit_data;
@@ -10570,7 +11588,7 @@ reserve_block_ret(WASMLoaderContext *loader_ctx, uint8 opcode,
                 if (!(wasm_loader_push_frame_offset(
                         loader_ctx, return_types[i], disable_emit,
                         operand_offset, error_buf, error_buf_size))) {
-                    wasm_runtime_free(emit_data);
+                    loader_free(emit_data);
                     goto fail;
                 }
                 wasm_loader_emit_backspace(loader_ctx, sizeof(int16));
@@ -10592,7 +11610,7 @@ reserve_block_ret(WASMLoaderContext *loader_ctx, uint8 opcode,
         if (opcode == WASM_OP_ELSE)
             emit_label(opcode);
 
-        wasm_runtime_free(emit_data);
+        loader_free(emit_data);
     }
 
     return true;
@@ -10976,8 +11994,8 @@ wasm_loader_check_br(WASMLoaderContext *loader_ctx, uint32 depth, uint8 opcode,
             total_size = (uint64)sizeof(uint8)
                          * (frame_ref_old - frame_ref_after_popped);
             if (total_size > sizeof(frame_ref_tmp)
-                && !(frame_ref_buf = loader_malloc(total_size, error_buf,
-                                                   error_buf_size))) {
+                && !(frame_ref_buf = loader_scratch_malloc(
+                         total_size, error_buf, error_buf_size))) {
                 goto fail;
             }
             bh_memcpy_s(frame_ref_buf, (uint32)total_size,
@@ -10989,7 +12007,7 @@ wasm_loader_check_br(WASMLoaderContext *loader_ctx, uint32 depth, uint8 opcode,
                 (uint64)sizeof(WASMRefTypeMap)
                 * (frame_reftype_map_old - frame_reftype_map_after_popped);
             if (total_size > sizeof(frame_reftype_map_tmp)
-                && !(frame_reftype_map_buf = loader_malloc(
+                && !(frame_reftype_map_buf = loader_scratch_malloc(
                          total_size, error_buf, error_buf_size))) {
                 goto fail;
             }
@@ -11002,8 +12020,8 @@ wasm_loader_check_br(WASMLoaderContext *loader_ctx, uint32 depth, uint8 opcode,
             total_size = (uint64)sizeof(int16)
                          * (frame_offset_old - frame_offset_after_popped);
             if (total_size > sizeof(frame_offset_tmp)
-                && !(frame_offset_buf = loader_malloc(total_size, error_buf,
-                                                      error_buf_size))) {
+                && !(frame_offset_buf = loader_scratch_malloc(
+                         total_size, error_buf, error_buf_size))) {
                 goto fail;
             }
             bh_memcpy_s(frame_offset_buf, (uint32)total_size,
@@ -11139,14 +12157,14 @@ wasm_loader_check_br(WASMLoaderContext *loader_ctx, uint32 depth, uint8 opcode,
 cleanup_and_return:
 fail:
     if (frame_ref_buf && frame_ref_buf != frame_ref_tmp)
-        wasm_runtime_free(frame_ref_buf);
+        loader_free(frame_ref_buf);
 #if WASM_ENABLE_GC != 0
     if (frame_reftype_map_buf && frame_reftype_map_buf != frame_reftype_map_tmp)
-        wasm_runtime_free(frame_reftype_map_buf);
+        loader_free(frame_reftype_map_buf);
 #endif
 #if WASM_ENABLE_FAST_INTERP != 0
     if (frame_offset_buf && frame_offset_buf != frame_offset_tmp)
-        wasm_runtime_free(frame_offset_buf);
+        loader_free(frame_offset_buf);
 #endif
 
     return ret;
@@ -11408,7 +12426,7 @@ copy_params_to_dynamic_space(WASMLoaderContext *loader_ctx, char *error_buf,
         size += sizeof(*cells) + sizeof(*src_offsets);
 
     /* Allocate memory for the emit data */
-    if (!(emit_data = loader_malloc(size, error_buf, error_buf_size)))
+    if (!(emit_data = loader_scratch_malloc(size, error_buf, error_buf_size)))
         return false;
 
     cells = emit_data;
@@ -11469,7 +12487,7 @@ copy_params_to_dynamic_space(WASMLoaderContext *loader_ctx, char *error_buf,
 
 fail:
     /* Free the emit data */
-    wasm_runtime_free(emit_data);
+    loader_free(emit_data);
 
     return ret;
 }
@@ -11724,6 +12742,9 @@ wasm_loader_prepare_bytecode(WASMModule *module, WASMFunction *func,
     int16 operand_offset = 0;
     uint8 last_op = 0;
     bool disable_emit, preserve_local = false, if_condition_available = true;
+#if WASM_ENABLE_SUPERINSTRUCTIONS != 0
+    bool fuse_ops = !module->no_superinstructions;
+#endif
     float32 f32_const;
     float64 f64_const;
     /*
@@ -11768,6 +12789,9 @@ wasm_loader_prepare_bytecode(WASMModule *module, WASMFunction *func,
     if (!(loader_ctx = wasm_loader_ctx_init(func, error_buf, error_buf_size))) {
         goto fail;
     }
+#if WASM_ENABLE_FAST_INTERP != 0
+    loader_ctx->record_relocs = module->code_relocs != NULL;
+#endif
 #if WASM_ENABLE_GC != 0
     loader_ctx->module = module;
     loader_ctx->ref_type_set = module->ref_type_set;
@@ -11814,11 +12838,11 @@ re_scan:
                 int64 *i64_consts_new;
                 /* Try to reallocate memory with a smaller size */
                 if ((i64_consts_new =
-                         wasm_runtime_malloc((uint32)sizeof(int64) * k))) {
+                         loader_alloc((uint32)sizeof(int64) * k, true))) {
                     bh_memcpy_s(i64_consts_new, (uint32)sizeof(int64) * k,
                                 i64_consts_old, (uint32)sizeof(int64) * k);
                     /* Free the old memory */
-                    wasm_runtime_free(i64_consts_old);
+                    loader_free(i64_consts_old);
                     loader_ctx->i64_consts = i64_consts_new;
                     loader_ctx->i64_const_max_num = k;
                 }
@@ -11847,11 +12871,11 @@ re_scan:
                 V128 *v128_consts_new;
                 /* Try to reallocate memory with a smaller size */
                 if ((v128_consts_new =
-                         wasm_runtime_malloc((uint32)sizeof(V128) * k))) {
+                         loader_alloc((uint32)sizeof(V128) * k, true))) {
                     bh_memcpy_s(v128_consts_new, (uint32)sizeof(V128) * k,
                                 v128_consts_old, (uint32)sizeof(V128) * k);
                     /* Free the old memory */
-                    wasm_runtime_free(v128_consts_old);
+                    loader_free(v128_consts_old);
                     loader_ctx->v128_consts = v128_consts_new;
                     loader_ctx->v128_const_max_num = k;
                 }
@@ -11878,11 +12902,11 @@ re_scan:
                 int32 *i32_consts_new;
                 /* Try to reallocate memory with a smaller size */
                 if ((i32_consts_new =
-                         wasm_runtime_malloc((uint32)sizeof(int32) * k))) {
+                         loader_alloc((uint32)sizeof(int32) * k, true))) {
                     bh_memcpy_s(i32_consts_new, (uint32)sizeof(int32) * k,
                                 i32_consts_old, (uint32)sizeof(int32) * k);
                     /* Free the old memory */
-                    wasm_runtime_free(i32_consts_old);
+                    loader_free(i32_consts_old);
                     loader_ctx->i32_consts = i32_consts_new;
                     loader_ctx->i32_const_max_num = k;
                 }
@@ -12247,8 +13271,9 @@ re_scan:
                          */
                         size = sizeof(int16)
                                * (uint64)block_type.u.type->param_cell_num;
-                        if (!(block->param_frame_offsets = loader_malloc(
-                                  size, error_buf, error_buf_size)))
+                        if (!(block->param_frame_offsets =
+                                  loader_scratch_malloc(size, error_buf,
+                                                        error_buf_size)))
                             goto fail;
                         bh_memcpy_s(block->param_frame_offsets, (uint32)size,
                                     loader_ctx->frame_offset
@@ -12673,6 +13698,14 @@ re_scan:
             case WASM_OP_BR_IF:
             {
                 POP_I32();
+#if WASM_ENABLE_SUPERINSTRUCTIONS != 0
+                /* The condition is the result of the comparison just
+                   emitted, unless the stack is polymorphic */
+                if (fuse_ops && last_op >= WASM_OP_I32_EQZ
+                    && last_op <= WASM_OP_I32_GE_U
+                    && !(loader_ctx->frame_csp - 1)->is_stack_polymorphic)
+                    fuse_cmp_br_if(loader_ctx, last_op);
+#endif
 
                 if (!(frame_csp_tmp =
                           check_branch_block(loader_ctx, &p, p_end, opcode,
@@ -14365,6 +15398,16 @@ re_scan:
                     default:
                         break;
                 }
+#if WASM_ENABLE_SUPERINSTRUCTIONS != 0
+                /* The address is the result of the i32.add just emitted */
+                if (fuse_ops && last_op == WASM_OP_I32_ADD
+                    && mem_offset_type == VALUE_TYPE_I32
+                    && !(loader_ctx->frame_csp - 1)->is_stack_polymorphic
+                    && (opcode == WASM_OP_I32_LOAD || opcode == WASM_OP_F32_LOAD
+                        || (opcode >= WASM_OP_I32_LOAD8_S
+                            && opcode <= WASM_OP_I32_LOAD16_U)))
+                    fuse_add_load(loader_ctx, opcode, (uint32)mem_offset);
+#endif
                 break;
             }
 
@@ -14542,8 +15585,31 @@ re_scan:
             case WASM_OP_I32_SHR_U:
             case WASM_OP_I32_ROTL:
             case WASM_OP_I32_ROTR:
+            {
+#if WASM_ENABLE_SUPERINSTRUCTIONS != 0
+                BranchBlock *cur_block = loader_ctx->frame_csp - 1;
+                int16 lhs_offset = 0, rhs_offset = 0;
+                bool fuse_const = fuse_ops && !cur_block->is_stack_polymorphic
+                                  && loader_ctx->stack_cell_num
+                                         >= cur_block->stack_cell_num + 2;
+                uint8 imm_opcode;
+
+                if (fuse_const) {
+                    rhs_offset = *(loader_ctx->frame_offset - 1);
+                    lhs_offset = *(loader_ctx->frame_offset - 2);
+                }
+#endif
                 POP2_AND_PUSH(VALUE_TYPE_I32, VALUE_TYPE_I32);
+#if WASM_ENABLE_SUPERINSTRUCTIONS != 0
+                if (fuse_const
+                    && (imm_opcode = fuse_i32_const_operand(
+                            loader_ctx, opcode, lhs_offset, rhs_offset)))
+                    /* Lets local.set write its result to the local and
+                       keeps i32.add + load from fusing it */
+                    opcode = imm_opcode;
+#endif
                 break;
+            }
 
             case WASM_OP_I64_CLZ:
             case WASM_OP_I64_CTZ:
@@ -16969,13 +18035,15 @@ re_scan:
     if (loader_ctx->p_code_compiled == NULL)
         goto re_scan;
 
+    /* The i64 and i32 consts and the v128 ones are each limited to
+       INT16_MAX cells, so the sum fits 16 bits */
     func->const_cell_num = loader_ctx->i64_const_num * 2
                            + loader_ctx->v128_const_num * 4
                            + loader_ctx->i32_const_num;
     if (func->const_cell_num > 0) {
-        if (!(func->consts =
-                  loader_malloc((uint64)sizeof(uint32) * func->const_cell_num,
-                                error_buf, error_buf_size)))
+        if (!(func->consts = loader_malloc_class(
+                  (uint64)sizeof(uint32) * func->const_cell_num,
+                  Mem_Class_Consts, error_buf, error_buf_size)))
             goto fail;
         if (loader_ctx->i64_const_num > 0) {
             bh_memcpy_s(func->consts,
@@ -17003,7 +18071,18 @@ re_scan:
 #else
     func->max_stack_cell_num = loader_ctx->max_stack_cell_num;
 #endif
+#if WASM_ENABLE_COMPACT_METADATA == 0
     func->max_block_num = loader_ctx->max_csp_num;
+#endif
+#if WASM_ENABLE_FAST_INTERP != 0
+    if (loader_ctx->record_relocs && !loader_ctx->reloc_failed) {
+        if (!loader_ctx->relocs)
+            loader_ctx->relocs = loader_malloc(sizeof(uint32), NULL, 0);
+        /* Left NULL on failure, the module just can't be saved */
+        module->code_relocs[cur_func_idx] = loader_ctx->relocs;
+        loader_ctx->relocs = NULL;
+    }
+#endif
     return_value = true;
 
 fail:
@@ -287,6 +287,36 @@ typedef enum WASMOpcode {
     WASM_OP_SELECT_128 = 0xe2,
 #endif
 
+#if WASM_ENABLE_SUPERINSTRUCTIONS != 0
+    /* fused i32 comparison and br_if */
+    EXT_OP_I32_EQZ_BR_IF = 0xe3,
+    EXT_OP_I32_EQ_BR_IF = 0xe4,
+    EXT_OP_I32_NE_BR_IF = 0xe5,
+    EXT_OP_I32_LT_S_BR_IF = 0xe6,
+    EXT_OP_I32_LT_U_BR_IF = 0xe7,
+    EXT_OP_I32_GT_S_BR_IF = 0xe8,
+    EXT_OP_I32_GT_U_BR_IF = 0xe9,
+    EXT_OP_I32_LE_S_BR_IF = 0xea,
+    EXT_OP_I32_LE_U_BR_IF = 0xeb,
+    EXT_OP_I32_GE_S_BR_IF = 0xec,
+    EXT_OP_I32_GE_U_BR_IF = 0xed,
+    /* fused i32.add and i32 load, the sum being the address */
+    EXT_OP_I32_ADD_LOAD = 0xee,
+    EXT_OP_I32_ADD_LOAD8_S = 0xef,
+    EXT_OP_I32_ADD_LOAD8_U = 0xf0,
+    EXT_OP_I32_ADD_LOAD16_S = 0xf1,
+    EXT_OP_I32_ADD_LOAD16_U = 0xf2,
+    /* i32 arithmetic with a constant operand as an immediate */
+    EXT_OP_I32_ADD_IMM = 0xf3,
+    EXT_OP_I32_MUL_IMM = 0xf4,
+    EXT_OP_I32_AND_IMM = 0xf5,
+    EXT_OP_I32_OR_IMM = 0xf6,
+    EXT_OP_I32_XOR_IMM = 0xf7,
+    EXT_OP_I32_SHL_IMM = 0xf8,
+    EXT_OP_I32_SHR_S_IMM = 0xf9,
+    EXT_OP_I32_SHR_U_IMM = 0xfa,
+#endif
+
     /* Post-MVP extend op prefix */
     WASM_OP_GC_PREFIX = 0xfb,
     WASM_OP_MISC_PREFIX = 0xfc,
@@ -809,6 +839,37 @@ typedef enum WASMAtomicEXTOpcode {
 #else
 #define DEF_EXT_V128_HANDLE()
 #endif
+
+#if WASM_ENABLE_SUPERINSTRUCTIONS != 0
+#define DEF_EXT_SUPERINSTRUCTION_HANDLE()                        \
+    SET_GOTO_TABLE_ELEM(EXT_OP_I32_EQZ_BR_IF),        /* 0xe3 */ \
+        SET_GOTO_TABLE_ELEM(EXT_OP_I32_EQ_BR_IF),     /* 0xe4 */ \
+        SET_GOTO_TABLE_ELEM(EXT_OP_I32_NE_BR_IF),     /* 0xe5 */ \
+        SET_GOTO_TABLE_ELEM(EXT_OP_I32_LT_S_BR_IF),   /* 0xe6 */ \
+        SET_GOTO_TABLE_ELEM(EXT_OP_I32_LT_U_BR_IF),   /* 0xe7 */ \
+        SET_GOTO_TABLE_ELEM(EXT_OP_I32_GT_S_BR_IF),   /* 0xe8 */ \
+        SET_GOTO_TABLE_ELEM(EXT_OP_I32_GT_U_BR_IF),   /* 0xe9 */ \
+        SET_GOTO_TABLE_ELEM(EXT_OP_I32_LE_S_BR_IF),   /* 0xea */ \
+        SET_GOTO_TABLE_ELEM(EXT_OP_I32_LE_U_BR_IF),   /* 0xeb */ \
+        SET_GOTO_TABLE_ELEM(EXT_OP_I32_GE_S_BR_IF),   /* 0xec */ \
+        SET_GOTO_TABLE_ELEM(EXT_OP_I32_GE_U_BR_IF),   /* 0xed */ \
+        SET_GOTO_TABLE_ELEM(EXT_OP_I32_ADD_LOAD),     /* 0xee */ \
+        SET_GOTO_TABLE_ELEM(EXT_OP_I32_ADD_LOAD8_S),  /* 0xef */ \
+        SET_GOTO_TABLE_ELEM(EXT_OP_I32_ADD_LOAD8_U),  /* 0xf0 */ \
+        SET_GOTO_TABLE_ELEM(EXT_OP_I32_ADD_LOAD16_S), /* 0xf1 */ \
+        SET_GOTO_TABLE_ELEM(EXT_OP_I32_ADD_LOAD16_U), /* 0xf2 */ \
+        SET_GOTO_TABLE_ELEM(EXT_OP_I32_ADD_IMM),      /* 0xf3 */ \
+        SET_GOTO_TABLE_ELEM(EXT_OP_I32_MUL_IMM),      /* 0xf4 */ \
+        SET_GOTO_TABLE_ELEM(EXT_OP_I32_AND_IMM),      /* 0xf5 */ \
+        SET_GOTO_TABLE_ELEM(EXT_OP_I32_OR_IMM),       /* 0xf6 */ \
+        SET_GOTO_TABLE_ELEM(EXT_OP_I32_XOR_IMM),      /* 0xf7 */ \
+        SET_GOTO_TABLE_ELEM(EXT_OP_I32_SHL_IMM),      /* 0xf8 */ \
+        SET_GOTO_TABLE_ELEM(EXT_OP_I32_SHR_S_IMM),    /* 0xf9 */ \
+        SET_GOTO_TABLE_ELEM(EXT_OP_I32_SHR_U_IMM),    /* 0xfa */
+
+#else
+#define DEF_EXT_SUPERINSTRUCTION_HANDLE()
+#endif
 /*
  * Macro used to generate computed goto tables for the C interpreter.
  */
@@ -1041,6 +1102,7 @@ typedef enum WASMAtomicEXTOpcode {
         SET_GOTO_TABLE_SIMD_PREFIX_ELEM()            /* 0xfd */ \
         SET_GOTO_TABLE_ELEM(WASM_OP_ATOMIC_PREFIX),  /* 0xfe */ \
         DEF_DEBUG_BREAK_HANDLE() DEF_EXT_V128_HANDLE()          \
+            DEF_EXT_SUPERINSTRUCTION_HANDLE()                   \
     };
 
 #ifdef __cplusplus
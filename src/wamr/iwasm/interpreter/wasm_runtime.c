@@ -168,9 +168,18 @@ wasm_resolve_import_func(const WASMModule *module, WASMFunctionImport *function)
 #endif
     function->func_ptr_linked = wasm_native_resolve_symbol(
         function->module_name, function->field_name, function->func_type,
-        &function->signature, &function->attachment, &function->call_conv_raw);
+        &function->signature, &function->attachment, &function->call_conv_raw,
+        &function->fast_native);
 
     if (function->func_ptr_linked) {
+#if WASM_ENABLE_NATIVE_TRAMPOLINES != 0
+        /* Raw and fast natives take their params in an array, whatever the
+           shape */
+        if (!function->call_conv_raw && !function->fast_native
+            && !module->no_native_trampolines)
+            function->call_shape = wasm_native_get_call_shape(
+                function->func_type, function->signature);
+#endif
         return true;
     }
 
@@ -215,6 +224,23 @@ runtime_malloc(uint64 size, char *error_buf, uint32 error_buf_size)
     return mem;
 }
 
+/* runtime_malloc() for a block of an object class, see mem_class_t */
+static void *
+runtime_malloc_class(uint64 size, mem_class_t mem_class, char *error_buf,
+                     uint32 error_buf_size)
+{
+    void *mem;
+
+    if (size >= UINT32_MAX
+        || !(mem = wasm_runtime_malloc_class((uint32)size, mem_class))) {
+        set_error_buf(error_buf, error_buf_size, "allocate memory failed");
+        return NULL;
+    }
+
+    memset(mem, 0, (uint32)size);
+    return mem;
+}
+
 #if WASM_ENABLE_MULTI_MODULE != 0
 static WASMModuleInstance *
 get_sub_module_inst(const WASMModuleInstance *parent_module_inst,
@@ -448,6 +474,10 @@ memory_instantiate(WASMModuleInstance *module_inst, WASMModuleInstance *parent,
     memory->cur_page_count = init_page_count;
     memory->max_page_count = max_page_count;
     memory->memory_data_size = memory_data_size;
+#if WASM_ENABLE_INSTANCE_RESET != 0
+    if (memory_idx == 0)
+        module_inst->e->default_memory_init_page_count = init_page_count;
+#endif
 
     if (memory_idx == 0) {
         memory->heap_data = memory->memory_data + heap_offset;
@@ -819,10 +849,12 @@ functions_instantiate(const WASMModule *module, WASMModuleInstance *module_inst,
         function->ret_cell_num = import->u.function.func_type->ret_cell_num;
         function->param_count =
             (uint16)function->u.func_import->func_type->param_count;
-        function->param_types = function->u.func_import->func_type->types;
         function->local_cell_num = 0;
+#if WASM_ENABLE_COMPACT_METADATA == 0
+        function->param_types = function->u.func_import->func_type->types;
         function->local_count = 0;
         function->local_types = NULL;
+#endif
 
         /* Copy the function pointer to current instance */
         module_inst->import_func_ptrs[i] =
@@ -842,11 +874,13 @@ functions_instantiate(const WASMModule *module, WASMModuleInstance *module_inst,
 
         function->param_count =
             (uint16)function->u.func->func_type->param_count;
+#if WASM_ENABLE_COMPACT_METADATA == 0
         function->local_count = (uint16)function->u.func->local_count;
         function->param_types = function->u.func->func_type->types;
         function->local_types = function->u.func->local_types;
 
         function->local_offsets = function->u.func->local_offsets;
+#endif
 
 #if WASM_ENABLE_FAST_INTERP != 0
         function->const_cell_num = function->u.func->const_cell_num;
@@ -2419,400 +2453,200 @@ wasm_set_running_mode(WASMModuleInstance *module_inst, RunningMode running_mode)
 /**
  * Instantiate module
  */
-WASMModuleInstance *
-wasm_instantiate(WASMModule *module, WASMModuleInstance *parent,
-                 WASMExecEnv *exec_env_main,
-                 const struct InstantiationArgs2 *args, char *error_buf,
-                 uint32 error_buf_size)
-{
-    WASMModuleInstance *module_inst;
-    WASMGlobalInstance *globals = NULL, *global;
-    WASMTableInstance *first_table;
-    uint32 global_count, i;
-    uint32 length, extra_info_offset;
-    mem_offset_t base_offset;
-    uint32 module_inst_struct_size =
-        offsetof(WASMModuleInstance, global_table_data.bytes);
-    uint64 module_inst_mem_inst_size;
-    uint64 total_size, table_size = 0;
-    uint8 *global_data, *global_data_end;
-#if WASM_ENABLE_MULTI_MODULE != 0
-    bool ret = false;
+#if WASM_ENABLE_INSTANCE_SNAPSHOT != 0
+typedef struct WASMMemorySnapshot {
+    uint32 num_bytes_per_page;
+    uint32 cur_page_count;
+    uint32 max_page_count;
+    /* Size of the app heap, 0 without one */
+    uint32 heap_size;
+    uint64 heap_offset;
+    uint64 memory_data_size;
+    /* Copy of the memory data, allocated like a linear memory or a
+       read-only mapping of cow_file */
+    uint8 *data;
+#ifdef OS_ENABLE_COW_MAPPING
+    /* File holding the copy, that restores map copy-on-write */
+    os_file_handle cow_file;
 #endif
-    const bool is_sub_inst = parent != NULL;
-    uint32 stack_size = args->v1.default_stack_size;
-    uint32 heap_size = args->v1.host_managed_heap_size;
-    uint32 max_memory_pages = args->v1.max_memory_pages;
-
-    if (!module)
-        return NULL;
-
-    /* Check the heap size */
-    heap_size = align_uint(heap_size, 8);
-    if (heap_size > APP_HEAP_SIZE_MAX)
-        heap_size = APP_HEAP_SIZE_MAX;
+    /* Saved state of the app heap allocator */
+    uint8 *heap_state;
+} WASMMemorySnapshot;
 
-    module_inst_mem_inst_size =
-        sizeof(WASMMemoryInstance)
-        * ((uint64)module->import_memory_count + module->memory_count);
+typedef struct WASMTableSnapshot {
+    uint32 cur_size;
+    table_elem_type_t *elems;
+} WASMTableSnapshot;
 
-#if WASM_ENABLE_JIT != 0
-    /* If the module doesn't have memory, reserve one mem_info space
-       with empty content to align with llvm jit compiler */
-    if (module_inst_mem_inst_size == 0)
-        module_inst_mem_inst_size = (uint64)sizeof(WASMMemoryInstance);
+struct WASMInstanceSnapshot {
+    WASMModule *module;
+    uint32 host_managed_heap_size;
+    uint32 max_memory_pages;
+    uint32 memory_count;
+    uint32 table_count;
+    uint32 global_data_size;
+    uint8 *global_data;
+    WASMMemorySnapshot *memories;
+    WASMTableSnapshot *tables;
+#if WASM_ENABLE_BULK_MEMORY != 0
+    uint8 *data_dropped;
 #endif
-
-    /* Size of module inst, memory instances and global data */
-    total_size = (uint64)module_inst_struct_size + module_inst_mem_inst_size
-                 + module->global_data_size;
-
-    /* Calculate the size of table data */
-    for (i = 0; i < module->import_table_count; i++) {
-        WASMTableImport *import_table = &module->import_tables[i].u.table;
-        table_size += offsetof(WASMTableInstance, elems);
-#if WASM_ENABLE_MULTI_MODULE != 0
-        table_size += (uint64)sizeof(table_elem_type_t)
-                      * import_table->table_type.max_size;
-#else
-        table_size += (uint64)sizeof(table_elem_type_t)
-                      * (import_table->table_type.possible_grow
-                             ? import_table->table_type.max_size
-                             : import_table->table_type.init_size);
+#if WASM_ENABLE_REF_TYPES != 0
+    uint8 *elem_dropped;
 #endif
-    }
-    for (i = 0; i < module->table_count; i++) {
-        WASMTable *table = module->tables + i;
-        table_size += offsetof(WASMTableInstance, elems);
-#if WASM_ENABLE_MULTI_MODULE != 0
-        table_size +=
-            (uint64)sizeof(table_elem_type_t) * table->table_type.max_size;
-#else
-        table_size +=
-            (uint64)sizeof(table_elem_type_t)
-            * (table->table_type.possible_grow ? table->table_type.max_size
-                                               : table->table_type.init_size);
+    /* Bytes held, including the memory copies */
+    uint64 total_size;
+};
 #endif
-    }
-    total_size += table_size;
 
-    /* The offset of WASMModuleInstanceExtra, make it 8-byte aligned */
-    total_size = (total_size + 7LL) & ~7LL;
-    extra_info_offset = (uint32)total_size;
-    total_size += sizeof(WASMModuleInstanceExtra);
+/* Set the globals to their initial values */
+static bool
+init_global_data(WASMModuleInstance *module_inst, char *error_buf,
+                 uint32 error_buf_size)
+{
+    WASMModule *module = module_inst->module;
+    WASMGlobalInstance *global = module_inst->e->globals;
+    uint32 global_count = module_inst->e->global_count, i;
+    uint8 *global_data = module_inst->global_data;
+    uint8 *global_data_end = global_data + module->global_data_size;
 
-    /* Allocate the memory for module instance with memory instances,
-       global data, table data appended at the end */
-    if (!(module_inst =
-              runtime_malloc(total_size, error_buf, error_buf_size))) {
-        return NULL;
-    }
+    for (i = 0; i < global_count; i++, global++) {
+        switch (global->type) {
+            case VALUE_TYPE_I32:
+            case VALUE_TYPE_F32:
+#if WASM_ENABLE_GC == 0 && WASM_ENABLE_REF_TYPES != 0
+            case VALUE_TYPE_FUNCREF:
+            case VALUE_TYPE_EXTERNREF:
+#endif
+                *(int32 *)global_data = global->initial_value.i32;
+                global_data += sizeof(int32);
+                break;
+            case VALUE_TYPE_I64:
+            case VALUE_TYPE_F64:
+                bh_memcpy_s(global_data,
+                            (uint32)(global_data_end - global_data),
+                            &global->initial_value.i64, sizeof(int64));
+                global_data += sizeof(int64);
+                break;
+#if WASM_ENABLE_SIMD != 0
+            case VALUE_TYPE_V128:
+                bh_memcpy_s(global_data, (uint32)sizeof(V128),
+                            &global->initial_value.v128, sizeof(V128));
+                global_data += sizeof(V128);
+                break;
+#endif
+#if WASM_ENABLE_GC != 0
+            case VALUE_TYPE_EXTERNREF:
+                /* the initial value should be a null reference */
+                bh_assert(global->initial_value.gc_obj == NULL_REF);
+                STORE_PTR((void **)global_data, NULL_REF);
+                global_data += sizeof(void *);
+                break;
+#endif
+            default:
+            {
+#if WASM_ENABLE_GC != 0
+                InitializerExpression *global_init = NULL;
+                bh_assert(wasm_is_type_reftype(global->type));
 
-    module_inst->module_type = Wasm_Module_Bytecode;
-    module_inst->module = module;
-    module_inst->e =
-        (WASMModuleInstanceExtra *)((uint8 *)module_inst + extra_info_offset);
+                if (i >= module->import_global_count) {
+                    global_init =
+                        &module->globals[i - module->import_global_count]
+                             .init_expr;
+                }
 
-#if WASM_ENABLE_MULTI_MODULE != 0
-    module_inst->e->sub_module_inst_list =
-        &module_inst->e->sub_module_inst_list_head;
-    ret = wasm_runtime_sub_module_instantiate(
-        (WASMModuleCommon *)module, (WASMModuleInstanceCommon *)module_inst,
-        args, error_buf, error_buf_size);
-    if (!ret) {
-        LOG_DEBUG("build a sub module list failed");
-        goto fail;
-    }
-#endif
+                if (global->type == REF_TYPE_NULLFUNCREF
+                    || global->type == REF_TYPE_NULLEXTERNREF
+                    || global->type == REF_TYPE_NULLREF) {
+                    STORE_PTR((void **)global_data, NULL_REF);
+                    global_data += sizeof(void *);
+                    break;
+                }
 
-#if WASM_ENABLE_BULK_MEMORY != 0
-    if (module->data_seg_count > 0) {
-        module_inst->e->common.data_dropped =
-            bh_bitmap_new(0, module->data_seg_count);
-        if (module_inst->e->common.data_dropped == NULL) {
-            LOG_DEBUG("failed to allocate bitmaps");
-            set_error_buf(error_buf, error_buf_size,
-                          "failed to allocate bitmaps");
-            goto fail;
-        }
-        for (i = 0; i < module->data_seg_count; i++) {
-            if (!module->data_segments[i]->is_passive)
-                bh_bitmap_set_bit(module_inst->e->common.data_dropped, i);
-        }
-    }
+                /* We can't create funcref obj during global instantiation
+                 * since the functions are not instantiated yet, so we need
+                 * to defer the initialization here */
+                if (global_init
+                    && (global_init->init_expr_type
+                        == INIT_EXPR_TYPE_FUNCREF_CONST)
+                    && wasm_reftype_is_subtype_of(
+                        global->type, global->ref_type, REF_TYPE_FUNCREF,
+                        NULL, module_inst->module->types,
+                        module_inst->module->type_count)) {
+                    WASMFuncObjectRef func_obj = NULL;
+                    /* UINT32_MAX indicates that it is a null reference */
+                    if ((uint32)global->initial_value.i32 != UINT32_MAX) {
+                        if (!(func_obj = wasm_create_func_obj(
+                                  module_inst, global->initial_value.i32,
+                                  false, error_buf, error_buf_size)))
+                            return false;
+                    }
+                    STORE_PTR((void **)global_data, func_obj);
+                    global_data += sizeof(void *);
+                    /* Also update the initial_value since other globals may
+                     * refer to this */
+                    global->initial_value.gc_obj = (wasm_obj_t)func_obj;
+                    break;
+                }
+                else {
+                    STORE_PTR((void **)global_data,
+                              global->initial_value.gc_obj);
+                    global_data += sizeof(void *);
+                    break;
+                }
 #endif
-#if WASM_ENABLE_REF_TYPES != 0
-    if (module->table_seg_count > 0) {
-        module_inst->e->common.elem_dropped =
-            bh_bitmap_new(0, module->table_seg_count);
-        if (module_inst->e->common.elem_dropped == NULL) {
-            LOG_DEBUG("failed to allocate bitmaps");
-            set_error_buf(error_buf, error_buf_size,
-                          "failed to allocate bitmaps");
-            goto fail;
-        }
-        for (i = 0; i < module->table_seg_count; i++) {
-            if (wasm_elem_is_active(module->table_segments[i].mode)
-                || wasm_elem_is_declarative(module->table_segments[i].mode))
-                bh_bitmap_set_bit(module_inst->e->common.elem_dropped, i);
+                bh_assert(0);
+                break;
+            }
         }
     }
-#endif
-
-#if WASM_ENABLE_GC != 0
-    if (!is_sub_inst) {
-        uint32 gc_heap_size = wasm_runtime_get_gc_heap_size_default();
+    bh_assert(global_data == global_data_end);
 
-        if (gc_heap_size < GC_HEAP_SIZE_MIN)
-            gc_heap_size = GC_HEAP_SIZE_MIN;
-        if (gc_heap_size > GC_HEAP_SIZE_MAX)
-            gc_heap_size = GC_HEAP_SIZE_MAX;
+    (void)global_data_end;
+    (void)error_buf;
+    (void)error_buf_size;
+    return true;
+}
 
-        module_inst->e->common.gc_heap_pool =
-            runtime_malloc(gc_heap_size, error_buf, error_buf_size);
-        if (!module_inst->e->common.gc_heap_pool)
-            goto fail;
+/* Copy the active data segments into the memories */
+static bool
+init_memory_data(WASMModuleInstance *module_inst, char *error_buf,
+                 uint32 error_buf_size)
+{
+    WASMModule *module = module_inst->module;
+    WASMGlobalInstance *globals = module_inst->e->globals;
+    mem_offset_t base_offset;
+    uint32 length, i;
 
-        module_inst->e->common.gc_heap_handle = mem_allocator_create(
-            module_inst->e->common.gc_heap_pool, gc_heap_size);
-        if (!module_inst->e->common.gc_heap_handle)
-            goto fail;
-    }
-#endif
+    for (i = 0; i < module->data_seg_count; i++) {
+        WASMMemoryInstance *memory = NULL;
+        uint8 *memory_data = NULL;
+        uint64 memory_size = 0;
+        WASMDataSeg *data_seg = module->data_segments[i];
+        WASMValue offset_value;
 
-#if WASM_ENABLE_DUMP_CALL_STACK != 0
-    if (!(module_inst->frames = runtime_malloc((uint64)sizeof(Vector),
-                                               error_buf, error_buf_size))) {
-        goto fail;
-    }
+#if WASM_ENABLE_BULK_MEMORY != 0
+        if (data_seg->is_passive)
+            continue;
 #endif
+        /* has check it in loader */
+        memory = module_inst->memories[data_seg->memory_index];
+        bh_assert(memory);
 
-    /* Instantiate global firstly to get the mutable data size */
-    global_count = module->import_global_count + module->global_count;
-    if (global_count
-        && !(globals = globals_instantiate(module, module_inst, error_buf,
-                                           error_buf_size))) {
-        goto fail;
-    }
-    module_inst->e->global_count = global_count;
-    module_inst->e->globals = globals;
-    module_inst->global_data = (uint8 *)module_inst + module_inst_struct_size
-                               + module_inst_mem_inst_size;
-    module_inst->global_data_size = module->global_data_size;
-    first_table = (WASMTableInstance *)(module_inst->global_data
-                                        + module->global_data_size);
+        memory_data = memory->memory_data;
+        memory_size =
+            (uint64)memory->num_bytes_per_page * memory->cur_page_count;
+        bh_assert(memory_data || memory_size == 0);
 
-    module_inst->memory_count =
-        module->import_memory_count + module->memory_count;
-    module_inst->table_count = module->import_table_count + module->table_count;
-    module_inst->e->function_count =
-        module->import_function_count + module->function_count;
-#if WASM_ENABLE_TAGS != 0
-    module_inst->e->tag_count = module->import_tag_count + module->tag_count;
-#endif
-
-    /* export */
-    module_inst->export_func_count = get_export_count(module, EXPORT_KIND_FUNC);
-#if WASM_ENABLE_MULTI_MEMORY != 0
-    module_inst->export_memory_count =
-        get_export_count(module, EXPORT_KIND_MEMORY);
-#endif
-#if WASM_ENABLE_MULTI_MODULE != 0
-    module_inst->export_table_count =
-        get_export_count(module, EXPORT_KIND_TABLE);
-#if WASM_ENABLE_TAGS != 0
-    module_inst->e->export_tag_count =
-        get_export_count(module, EXPORT_KIND_TAG);
-#endif
-    module_inst->export_global_count =
-        get_export_count(module, EXPORT_KIND_GLOBAL);
-#endif
-
-    /* Instantiate memories/tables/functions/tags */
-    if ((module_inst->memory_count > 0
-         && !(module_inst->memories = memories_instantiate(
-                  module, module_inst, parent, heap_size, max_memory_pages,
-                  error_buf, error_buf_size)))
-        || (module_inst->table_count > 0
-            && !(module_inst->tables =
-                     tables_instantiate(module, module_inst, first_table,
-                                        error_buf, error_buf_size)))
-        || (module_inst->e->function_count > 0
-            && !(module_inst->e->functions = functions_instantiate(
-                     module, module_inst, error_buf, error_buf_size)))
-        || (module_inst->export_func_count > 0
-            && !(module_inst->export_functions = export_functions_instantiate(
-                     module, module_inst, module_inst->export_func_count,
-                     error_buf, error_buf_size)))
-#if WASM_ENABLE_TAGS != 0
-        || (module_inst->e->tag_count > 0
-            && !(module_inst->e->tags = tags_instantiate(
-                     module, module_inst, error_buf, error_buf_size)))
-        || (module_inst->e->export_tag_count > 0
-            && !(module_inst->e->export_tags = export_tags_instantiate(
-                     module, module_inst, module_inst->e->export_tag_count,
-                     error_buf, error_buf_size)))
-#endif
-#if WASM_ENABLE_MULTI_MODULE != 0
-        || (module_inst->export_global_count > 0
-            && !(module_inst->export_globals = export_globals_instantiate(
-                     module, module_inst, module_inst->export_global_count,
-                     error_buf, error_buf_size)))
-#endif
-#if WASM_ENABLE_MULTI_MEMORY != 0
-        || (module_inst->export_memory_count > 0
-            && !(module_inst->export_memories = export_memories_instantiate(
-                     module, module_inst, module_inst->export_memory_count,
-                     error_buf, error_buf_size)))
-#endif
-#if WASM_ENABLE_JIT != 0
-        || (module_inst->e->function_count > 0
-            && !init_func_ptrs(module_inst, module, error_buf, error_buf_size))
-#endif
-#if WASM_ENABLE_FAST_JIT != 0 || WASM_ENABLE_JIT != 0
-        || (module_inst->e->function_count > 0
-            && !init_func_type_indexes(module_inst, error_buf, error_buf_size))
-#endif
-    ) {
-        goto fail;
-    }
-    if (global_count > 0) {
-        /* Initialize the global data */
-        global_data = module_inst->global_data;
-        global_data_end = global_data + module->global_data_size;
-        global = globals;
-        for (i = 0; i < global_count; i++, global++) {
-            switch (global->type) {
-                case VALUE_TYPE_I32:
-                case VALUE_TYPE_F32:
-#if WASM_ENABLE_GC == 0 && WASM_ENABLE_REF_TYPES != 0
-                case VALUE_TYPE_FUNCREF:
-                case VALUE_TYPE_EXTERNREF:
-#endif
-                    *(int32 *)global_data = global->initial_value.i32;
-                    global_data += sizeof(int32);
-                    break;
-                case VALUE_TYPE_I64:
-                case VALUE_TYPE_F64:
-                    bh_memcpy_s(global_data,
-                                (uint32)(global_data_end - global_data),
-                                &global->initial_value.i64, sizeof(int64));
-                    global_data += sizeof(int64);
-                    break;
-#if WASM_ENABLE_SIMD != 0
-                case VALUE_TYPE_V128:
-                    bh_memcpy_s(global_data, (uint32)sizeof(V128),
-                                &global->initial_value.v128, sizeof(V128));
-                    global_data += sizeof(V128);
-                    break;
-#endif
-#if WASM_ENABLE_GC != 0
-                case VALUE_TYPE_EXTERNREF:
-                    /* the initial value should be a null reference */
-                    bh_assert(global->initial_value.gc_obj == NULL_REF);
-                    STORE_PTR((void **)global_data, NULL_REF);
-                    global_data += sizeof(void *);
-                    break;
-#endif
-                default:
-                {
-#if WASM_ENABLE_GC != 0
-                    InitializerExpression *global_init = NULL;
-                    bh_assert(wasm_is_type_reftype(global->type));
-
-                    if (i >= module->import_global_count) {
-                        global_init =
-                            &module->globals[i - module->import_global_count]
-                                 .init_expr;
-                    }
-
-                    if (global->type == REF_TYPE_NULLFUNCREF
-                        || global->type == REF_TYPE_NULLEXTERNREF
-                        || global->type == REF_TYPE_NULLREF) {
-                        STORE_PTR((void **)global_data, NULL_REF);
-                        global_data += sizeof(void *);
-                        break;
-                    }
-
-                    /* We can't create funcref obj during global instantiation
-                     * since the functions are not instantiated yet, so we need
-                     * to defer the initialization here */
-                    if (global_init
-                        && (global_init->init_expr_type
-                            == INIT_EXPR_TYPE_FUNCREF_CONST)
-                        && wasm_reftype_is_subtype_of(
-                            global->type, global->ref_type, REF_TYPE_FUNCREF,
-                            NULL, module_inst->module->types,
-                            module_inst->module->type_count)) {
-                        WASMFuncObjectRef func_obj = NULL;
-                        /* UINT32_MAX indicates that it is a null reference */
-                        if ((uint32)global->initial_value.i32 != UINT32_MAX) {
-                            if (!(func_obj = wasm_create_func_obj(
-                                      module_inst, global->initial_value.i32,
-                                      false, error_buf, error_buf_size)))
-                                goto fail;
-                        }
-                        STORE_PTR((void **)global_data, func_obj);
-                        global_data += sizeof(void *);
-                        /* Also update the initial_value since other globals may
-                         * refer to this */
-                        global->initial_value.gc_obj = (wasm_obj_t)func_obj;
-                        break;
-                    }
-                    else {
-                        STORE_PTR((void **)global_data,
-                                  global->initial_value.gc_obj);
-                        global_data += sizeof(void *);
-                        break;
-                    }
-#endif
-                    bh_assert(0);
-                    break;
-                }
-            }
-        }
-        bh_assert(global_data == global_data_end);
-    }
-
-    if (!check_linked_symbol(module_inst, error_buf, error_buf_size)) {
-        goto fail;
-    }
-
-    /* Initialize the memory data with data segment section */
-    for (i = 0; i < module->data_seg_count; i++) {
-        WASMMemoryInstance *memory = NULL;
-        uint8 *memory_data = NULL;
-        uint64 memory_size = 0;
-        WASMDataSeg *data_seg = module->data_segments[i];
-        WASMValue offset_value;
-
-#if WASM_ENABLE_BULK_MEMORY != 0
-        if (data_seg->is_passive)
-            continue;
-#endif
-        if (is_sub_inst)
-            /* Ignore setting memory init data if the memory has been
-               initialized */
-            continue;
-
-        /* has check it in loader */
-        memory = module_inst->memories[data_seg->memory_index];
-        bh_assert(memory);
-
-        memory_data = memory->memory_data;
-        memory_size =
-            (uint64)memory->num_bytes_per_page * memory->cur_page_count;
-        bh_assert(memory_data || memory_size == 0);
-
-        uint8 offset_flag = data_seg->base_offset.init_expr_type;
-        bh_assert(offset_flag == INIT_EXPR_TYPE_GET_GLOBAL
-                  || (memory->is_memory64 ? is_valid_i64_offset(offset_flag)
-                                          : is_valid_i32_offset(offset_flag)));
+        uint8 offset_flag = data_seg->base_offset.init_expr_type;
+        bh_assert(offset_flag == INIT_EXPR_TYPE_GET_GLOBAL
+                  || (memory->is_memory64 ? is_valid_i64_offset(offset_flag)
+                                          : is_valid_i32_offset(offset_flag)));
 
         if (!get_init_value_recursive(module, &data_seg->base_offset, globals,
                                       &offset_value, error_buf,
                                       error_buf_size)) {
-            goto fail;
+            return false;
         }
 
         if (offset_flag == INIT_EXPR_TYPE_GET_GLOBAL) {
@@ -2822,7 +2656,7 @@ wasm_instantiate(WASMModule *module, WASMModuleInstance *parent,
                                                : VALUE_TYPE_I32)) {
                 set_error_buf(error_buf, error_buf_size,
                               "data segment does not fit");
-                goto fail;
+                return false;
             }
         }
 
@@ -2851,7 +2685,7 @@ wasm_instantiate(WASMModule *module, WASMModuleInstance *parent,
             set_error_buf(error_buf, error_buf_size,
                           "data segment does not fit");
 #endif
-            goto fail;
+            return false;
         }
 
         /* check offset + length(could be zero) */
@@ -2872,7 +2706,7 @@ wasm_instantiate(WASMModule *module, WASMModuleInstance *parent,
             set_error_buf(error_buf, error_buf_size,
                           "data segment does not fit");
 #endif
-            goto fail;
+            return false;
         }
 
         if (memory_data) {
@@ -2881,15 +2715,17 @@ wasm_instantiate(WASMModule *module, WASMModuleInstance *parent,
                         length);
         }
     }
+    return true;
+}
 
-#if WASM_ENABLE_JIT != 0 && WASM_ENABLE_SHARED_HEAP != 0
-#if UINTPTR_MAX == UINT64_MAX
-    module_inst->e->shared_heap_start_off.u64 = UINT64_MAX;
-#else
-    module_inst->e->shared_heap_start_off.u32[0] = UINT32_MAX;
-#endif
-    module_inst->e->shared_heap = NULL;
-#endif
+/* Fill the tables from their init exprs and the active element segments */
+static bool
+init_table_data(WASMModuleInstance *module_inst, char *error_buf,
+                uint32 error_buf_size)
+{
+    WASMModule *module = module_inst->module;
+    WASMGlobalInstance *globals = module_inst->e->globals;
+    uint32 length, i;
 
 #if WASM_ENABLE_GC != 0
     /* Initialize the table data with init expr */
@@ -2915,7 +2751,7 @@ wasm_instantiate(WASMModule *module, WASMModuleInstance *parent,
             if (!check_global_init_expr(module,
                                         table->init_expr.u.unary.v.global_index,
                                         error_buf, error_buf_size)) {
-                goto fail;
+                return false;
             }
 
             table->init_expr.u.unary.v.gc_obj =
@@ -2929,7 +2765,7 @@ wasm_instantiate(WASMModule *module, WASMModuleInstance *parent,
                 if (!(table->init_expr.u.unary.v.gc_obj =
                           wasm_create_func_obj(module_inst, func_idx, false,
                                                error_buf, error_buf_size)))
-                    goto fail;
+                    return false;
             }
             else {
                 table->init_expr.u.unary.v.gc_obj = NULL_REF;
@@ -2982,7 +2818,7 @@ wasm_instantiate(WASMModule *module, WASMModuleInstance *parent,
             && tbl_elem_type != VALUE_TYPE_EXTERNREF) {
             set_error_buf(error_buf, error_buf_size,
                           "type mismatch: elements segment does not fit");
-            goto fail;
+            return false;
         }
 #elif WASM_ENABLE_GC != 0
         if (!wasm_elem_is_declarative(table_seg->mode)
@@ -2992,7 +2828,7 @@ wasm_instantiate(WASMModule *module, WASMModuleInstance *parent,
                 module->types, module->type_count)) {
             set_error_buf(error_buf, error_buf_size,
                           "type mismatch: elements segment does not fit");
-            goto fail;
+            return false;
         }
 #endif
         (void)tbl_init_size;
@@ -3029,7 +2865,7 @@ wasm_instantiate(WASMModule *module, WASMModuleInstance *parent,
         if (!get_init_value_recursive(module, &table_seg->base_offset, globals,
                                       &offset_value, error_buf,
                                       error_buf_size)) {
-            goto fail;
+            return false;
         }
 
         if (offset_flag == INIT_EXPR_TYPE_GET_GLOBAL) {
@@ -3038,7 +2874,7 @@ wasm_instantiate(WASMModule *module, WASMModuleInstance *parent,
                        != VALUE_TYPE_I32) {
                 set_error_buf(error_buf, error_buf_size,
                               "type mismatch: elements segment does not fit");
-                goto fail;
+                return false;
             }
         }
 
@@ -3053,7 +2889,7 @@ wasm_instantiate(WASMModule *module, WASMModuleInstance *parent,
             set_error_buf(error_buf, error_buf_size,
                           "type mismatch: elements segment does not fit");
 #endif
-            goto fail;
+            return false;
         }
 
         /* check offset + length(could be zero) */
@@ -3068,7 +2904,7 @@ wasm_instantiate(WASMModule *module, WASMModuleInstance *parent,
             set_error_buf(error_buf, error_buf_size,
                           "type mismatch: elements segment does not fit");
 #endif
-            goto fail;
+            return false;
         }
 
         for (j = 0; j < length; j++) {
@@ -3099,7 +2935,7 @@ wasm_instantiate(WASMModule *module, WASMModuleInstance *parent,
                         if (!(func_obj = wasm_create_func_obj(
                                   module_inst, func_idx, false, error_buf,
                                   error_buf_size))) {
-                            goto fail;
+                            return false;
                         }
                         ref = func_obj;
                     }
@@ -3115,7 +2951,7 @@ wasm_instantiate(WASMModule *module, WASMModuleInstance *parent,
                     if (!check_global_init_expr(
                             module, init_expr->u.unary.v.global_index,
                             error_buf, error_buf_size)) {
-                        goto fail;
+                        return false;
                     }
 
                     ref = globals[init_expr->u.unary.v.global_index]
@@ -3148,7 +2984,7 @@ wasm_instantiate(WASMModule *module, WASMModuleInstance *parent,
                               &module->rtt_type_lock))) {
                         set_error_buf(error_buf, error_buf_size,
                                       "create rtt object failed");
-                        goto fail;
+                        return false;
                     }
 
                     if (!(struct_obj = wasm_struct_obj_new_internal(
@@ -3156,7 +2992,7 @@ wasm_instantiate(WASMModule *module, WASMModuleInstance *parent,
                               rtt_type))) {
                         set_error_buf(error_buf, error_buf_size,
                                       "create struct object failed");
-                        goto fail;
+                        return false;
                     }
 
                     if (flag == INIT_EXPR_TYPE_STRUCT_NEW) {
@@ -3212,7 +3048,7 @@ wasm_instantiate(WASMModule *module, WASMModuleInstance *parent,
                               &module->rtt_type_lock))) {
                         set_error_buf(error_buf, error_buf_size,
                                       "create rtt object failed");
-                        goto fail;
+                        return false;
                     }
 
                     if (!(array_obj = wasm_array_obj_new_internal(
@@ -3220,7 +3056,7 @@ wasm_instantiate(WASMModule *module, WASMModuleInstance *parent,
                               len, arr_init_val))) {
                         set_error_buf(error_buf, error_buf_size,
                                       "create array object failed");
-                        goto fail;
+                        return false;
                     }
 
                     if (flag == INIT_EXPR_TYPE_ARRAY_NEW_FIXED) {
@@ -3251,6 +3087,307 @@ wasm_instantiate(WASMModule *module, WASMModuleInstance *parent,
             *(table_data + offset_value.i32 + j) = (table_elem_type_t)ref;
         }
     }
+    return true;
+}
+
+WASMModuleInstance *
+wasm_instantiate(WASMModule *module, WASMModuleInstance *parent,
+                 WASMExecEnv *exec_env_main,
+                 const struct InstantiationArgs2 *args, char *error_buf,
+                 uint32 error_buf_size)
+{
+    WASMModuleInstance *module_inst;
+    WASMGlobalInstance *globals = NULL;
+    WASMTableInstance *first_table;
+    uint32 global_count, i;
+    uint32 extra_info_offset;
+    uint32 module_inst_struct_size =
+        offsetof(WASMModuleInstance, global_table_data.bytes);
+    uint64 module_inst_mem_inst_size;
+    uint64 total_size, table_size = 0;
+#if WASM_ENABLE_MULTI_MODULE != 0
+    bool ret = false;
+#endif
+    const bool is_sub_inst = parent != NULL;
+    uint32 stack_size = args->v1.default_stack_size;
+    uint32 heap_size = args->v1.host_managed_heap_size;
+    uint32 max_memory_pages = args->v1.max_memory_pages;
+
+    if (!module)
+        return NULL;
+
+#if WASM_ENABLE_INSTANCE_SNAPSHOT != 0
+    /* Same memory layout as the snapshotted instance */
+    if (args->snapshot) {
+        heap_size = args->snapshot->host_managed_heap_size;
+        max_memory_pages = args->snapshot->max_memory_pages;
+    }
+#endif
+
+    /* Check the heap size */
+    heap_size = align_uint(heap_size, 8);
+    if (heap_size > APP_HEAP_SIZE_MAX)
+        heap_size = APP_HEAP_SIZE_MAX;
+
+    module_inst_mem_inst_size =
+        sizeof(WASMMemoryInstance)
+        * ((uint64)module->import_memory_count + module->memory_count);
+
+#if WASM_ENABLE_JIT != 0
+    /* If the module doesn't have memory, reserve one mem_info space
+       with empty content to align with llvm jit compiler */
+    if (module_inst_mem_inst_size == 0)
+        module_inst_mem_inst_size = (uint64)sizeof(WASMMemoryInstance);
+#endif
+
+    /* Size of module inst, memory instances and global data */
+    total_size = (uint64)module_inst_struct_size + module_inst_mem_inst_size
+                 + module->global_data_size;
+
+    /* Calculate the size of table data */
+    for (i = 0; i < module->import_table_count; i++) {
+        WASMTableImport *import_table = &module->import_tables[i].u.table;
+        table_size += offsetof(WASMTableInstance, elems);
+#if WASM_ENABLE_MULTI_MODULE != 0
+        table_size += (uint64)sizeof(table_elem_type_t)
+                      * import_table->table_type.max_size;
+#else
+        table_size += (uint64)sizeof(table_elem_type_t)
+                      * (import_table->table_type.possible_grow
+                             ? import_table->table_type.max_size
+                             : import_table->table_type.init_size);
+#endif
+    }
+    for (i = 0; i < module->table_count; i++) {
+        WASMTable *table = module->tables + i;
+        table_size += offsetof(WASMTableInstance, elems);
+#if WASM_ENABLE_MULTI_MODULE != 0
+        table_size +=
+            (uint64)sizeof(table_elem_type_t) * table->table_type.max_size;
+#else
+        table_size +=
+            (uint64)sizeof(table_elem_type_t)
+            * (table->table_type.possible_grow ? table->table_type.max_size
+                                               : table->table_type.init_size);
+#endif
+    }
+    total_size += table_size;
+
+    /* The offset of WASMModuleInstanceExtra, make it 8-byte aligned */
+    total_size = (total_size + 7LL) & ~7LL;
+    extra_info_offset = (uint32)total_size;
+    total_size += sizeof(WASMModuleInstanceExtra);
+
+    /* Allocate the memory for module instance with memory instances,
+       global data, table data appended at the end */
+    if (!(module_inst = runtime_malloc_class(total_size, Mem_Class_Instance,
+                                             error_buf, error_buf_size))) {
+        return NULL;
+    }
+
+    module_inst->module_type = Wasm_Module_Bytecode;
+    module_inst->module = module;
+    module_inst->e =
+        (WASMModuleInstanceExtra *)((uint8 *)module_inst + extra_info_offset);
+#if WASM_ENABLE_INSTANCE_SNAPSHOT != 0
+    module_inst->e->host_managed_heap_size = heap_size;
+    module_inst->e->max_memory_pages = max_memory_pages;
+#endif
+
+#if WASM_ENABLE_MULTI_MODULE != 0
+    module_inst->e->sub_module_inst_list =
+        &module_inst->e->sub_module_inst_list_head;
+    ret = wasm_runtime_sub_module_instantiate(
+        (WASMModuleCommon *)module, (WASMModuleInstanceCommon *)module_inst,
+        args, error_buf, error_buf_size);
+    if (!ret) {
+        LOG_DEBUG("build a sub module list failed");
+        goto fail;
+    }
+#endif
+
+#if WASM_ENABLE_BULK_MEMORY != 0
+    if (module->data_seg_count > 0) {
+        module_inst->e->common.data_dropped =
+            bh_bitmap_new(0, module->data_seg_count);
+        if (module_inst->e->common.data_dropped == NULL) {
+            LOG_DEBUG("failed to allocate bitmaps");
+            set_error_buf(error_buf, error_buf_size,
+                          "failed to allocate bitmaps");
+            goto fail;
+        }
+        for (i = 0; i < module->data_seg_count; i++) {
+            if (!module->data_segments[i]->is_passive)
+                bh_bitmap_set_bit(module_inst->e->common.data_dropped, i);
+        }
+    }
+#endif
+#if WASM_ENABLE_REF_TYPES != 0
+    if (module->table_seg_count > 0) {
+        module_inst->e->common.elem_dropped =
+            bh_bitmap_new(0, module->table_seg_count);
+        if (module_inst->e->common.elem_dropped == NULL) {
+            LOG_DEBUG("failed to allocate bitmaps");
+            set_error_buf(error_buf, error_buf_size,
+                          "failed to allocate bitmaps");
+            goto fail;
+        }
+        for (i = 0; i < module->table_seg_count; i++) {
+            if (wasm_elem_is_active(module->table_segments[i].mode)
+                || wasm_elem_is_declarative(module->table_segments[i].mode))
+                bh_bitmap_set_bit(module_inst->e->common.elem_dropped, i);
+        }
+    }
+#endif
+
+#if WASM_ENABLE_GC != 0
+    if (!is_sub_inst) {
+        uint32 gc_heap_size = wasm_runtime_get_gc_heap_size_default();
+
+        if (gc_heap_size < GC_HEAP_SIZE_MIN)
+            gc_heap_size = GC_HEAP_SIZE_MIN;
+        if (gc_heap_size > GC_HEAP_SIZE_MAX)
+            gc_heap_size = GC_HEAP_SIZE_MAX;
+
+        module_inst->e->common.gc_heap_pool =
+            runtime_malloc(gc_heap_size, error_buf, error_buf_size);
+        if (!module_inst->e->common.gc_heap_pool)
+            goto fail;
+
+        module_inst->e->common.gc_heap_handle = mem_allocator_create(
+            module_inst->e->common.gc_heap_pool, gc_heap_size);
+        if (!module_inst->e->common.gc_heap_handle)
+            goto fail;
+    }
+#endif
+
+#if WASM_ENABLE_DUMP_CALL_STACK != 0
+    if (!(module_inst->frames = runtime_malloc((uint64)sizeof(Vector),
+                                               error_buf, error_buf_size))) {
+        goto fail;
+    }
+#endif
+
+    /* Instantiate global firstly to get the mutable data size */
+    global_count = module->import_global_count + module->global_count;
+    if (global_count
+        && !(globals = globals_instantiate(module, module_inst, error_buf,
+                                           error_buf_size))) {
+        goto fail;
+    }
+    module_inst->e->global_count = global_count;
+    module_inst->e->globals = globals;
+    module_inst->global_data = (uint8 *)module_inst + module_inst_struct_size
+                               + module_inst_mem_inst_size;
+    module_inst->global_data_size = module->global_data_size;
+    first_table = (WASMTableInstance *)(module_inst->global_data
+                                        + module->global_data_size);
+
+    module_inst->memory_count =
+        module->import_memory_count + module->memory_count;
+    module_inst->table_count = module->import_table_count + module->table_count;
+    module_inst->e->function_count =
+        module->import_function_count + module->function_count;
+#if WASM_ENABLE_TAGS != 0
+    module_inst->e->tag_count = module->import_tag_count + module->tag_count;
+#endif
+
+    /* export */
+    module_inst->export_func_count = get_export_count(module, EXPORT_KIND_FUNC);
+#if WASM_ENABLE_MULTI_MEMORY != 0
+    module_inst->export_memory_count =
+        get_export_count(module, EXPORT_KIND_MEMORY);
+#endif
+#if WASM_ENABLE_MULTI_MODULE != 0
+    module_inst->export_table_count =
+        get_export_count(module, EXPORT_KIND_TABLE);
+#if WASM_ENABLE_TAGS != 0
+    module_inst->e->export_tag_count =
+        get_export_count(module, EXPORT_KIND_TAG);
+#endif
+    module_inst->export_global_count =
+        get_export_count(module, EXPORT_KIND_GLOBAL);
+#endif
+
+    /* Instantiate memories/tables/functions/tags */
+    if ((module_inst->memory_count > 0
+         && !(module_inst->memories = memories_instantiate(
+                  module, module_inst, parent, heap_size, max_memory_pages,
+                  error_buf, error_buf_size)))
+        || (module_inst->table_count > 0
+            && !(module_inst->tables =
+                     tables_instantiate(module, module_inst, first_table,
+                                        error_buf, error_buf_size)))
+        || (module_inst->e->function_count > 0
+            && !(module_inst->e->functions = functions_instantiate(
+                     module, module_inst, error_buf, error_buf_size)))
+        || (module_inst->export_func_count > 0
+            && !(module_inst->export_functions = export_functions_instantiate(
+                     module, module_inst, module_inst->export_func_count,
+                     error_buf, error_buf_size)))
+#if WASM_ENABLE_TAGS != 0
+        || (module_inst->e->tag_count > 0
+            && !(module_inst->e->tags = tags_instantiate(
+                     module, module_inst, error_buf, error_buf_size)))
+        || (module_inst->e->export_tag_count > 0
+            && !(module_inst->e->export_tags = export_tags_instantiate(
+                     module, module_inst, module_inst->e->export_tag_count,
+                     error_buf, error_buf_size)))
+#endif
+#if WASM_ENABLE_MULTI_MODULE != 0
+        || (module_inst->export_global_count > 0
+            && !(module_inst->export_globals = export_globals_instantiate(
+                     module, module_inst, module_inst->export_global_count,
+                     error_buf, error_buf_size)))
+#endif
+#if WASM_ENABLE_MULTI_MEMORY != 0
+        || (module_inst->export_memory_count > 0
+            && !(module_inst->export_memories = export_memories_instantiate(
+                     module, module_inst, module_inst->export_memory_count,
+                     error_buf, error_buf_size)))
+#endif
+#if WASM_ENABLE_JIT != 0
+        || (module_inst->e->function_count > 0
+            && !init_func_ptrs(module_inst, module, error_buf, error_buf_size))
+#endif
+#if WASM_ENABLE_FAST_JIT != 0 || WASM_ENABLE_JIT != 0
+        || (module_inst->e->function_count > 0
+            && !init_func_type_indexes(module_inst, error_buf, error_buf_size))
+#endif
+    ) {
+        goto fail;
+    }
+    if (global_count > 0
+        && !init_global_data(module_inst, error_buf, error_buf_size)) {
+        goto fail;
+    }
+
+    if (!check_linked_symbol(module_inst, error_buf, error_buf_size)) {
+        goto fail;
+    }
+
+    /* Initialize the memory data with data segment section, unless the
+       memory has been initialized or is copied from a snapshot */
+    if (!is_sub_inst
+#if WASM_ENABLE_INSTANCE_SNAPSHOT != 0
+        && !args->snapshot
+#endif
+        && !init_memory_data(module_inst, error_buf, error_buf_size)) {
+        goto fail;
+    }
+
+#if WASM_ENABLE_JIT != 0 && WASM_ENABLE_SHARED_HEAP != 0
+#if UINTPTR_MAX == UINT64_MAX
+    module_inst->e->shared_heap_start_off.u64 = UINT64_MAX;
+#else
+    module_inst->e->shared_heap_start_off.u32[0] = UINT32_MAX;
+#endif
+    module_inst->e->shared_heap = NULL;
+#endif
+
+    if (!init_table_data(module_inst, error_buf, error_buf_size)) {
+        goto fail;
+    }
 
     /* Initialize the thread related data */
     if (stack_size == 0)
@@ -3322,10 +3459,22 @@ wasm_instantiate(WASMModule *module, WASMModuleInstance *parent,
                 &module_inst->e->functions[module->start_function];
     }
 
-    if (!execute_post_instantiate_functions(module_inst, is_sub_inst,
-                                            exec_env_main)) {
-        set_error_buf(error_buf, error_buf_size, module_inst->cur_exception);
-        goto fail;
+#if WASM_ENABLE_INSTANCE_SNAPSHOT != 0
+    if (args->snapshot) {
+        /* The start functions already ran in the snapshotted instance */
+        if (!wasm_restore_instance(module_inst, args->snapshot, error_buf,
+                                   error_buf_size))
+            goto fail;
+    }
+    else
+#endif
+    {
+        if (!execute_post_instantiate_functions(module_inst, is_sub_inst,
+                                                exec_env_main)) {
+            set_error_buf(error_buf, error_buf_size,
+                          module_inst->cur_exception);
+            goto fail;
+        }
     }
 
 #if WASM_ENABLE_MEMORY_TRACING != 0
@@ -3333,7 +3482,6 @@ wasm_instantiate(WASMModule *module, WASMModuleInstance *parent,
         (WASMModuleInstanceCommon *)module_inst);
 #endif
 
-    (void)global_data_end;
     return module_inst;
 
 fail:
@@ -3496,6 +3644,531 @@ wasm_deinstantiate(WASMModuleInstance *module_inst, bool is_sub_inst)
     wasm_runtime_free(module_inst);
 }
 
+#if WASM_ENABLE_INSTANCE_SNAPSHOT != 0 || WASM_ENABLE_INSTANCE_RESET != 0
+/* Give a memory another page count in a new zeroed allocation, the data
+   and the app heap state aren't kept */
+static bool
+resize_memory(WASMMemoryInstance *memory, uint32 page_count)
+{
+    uint8 *memory_data_new = NULL;
+    uint64 memory_data_size, heap_offset = 0;
+    uint32 heap_size = 0;
+
+    if (memory->heap_data) {
+        heap_offset = (uint64)(memory->heap_data - memory->memory_data);
+        heap_size = (uint32)(memory->heap_data_end - memory->heap_data);
+    }
+
+    if (wasm_allocate_linear_memory(&memory_data_new, false,
+                                    memory->is_memory64,
+                                    memory->num_bytes_per_page, page_count,
+                                    memory->max_page_count, &memory_data_size)
+        != BHT_OK)
+        return false;
+
+    if (memory->memory_data)
+        wasm_deallocate_linear_memory(memory);
+
+    memory->memory_data = memory_data_new;
+    memory->cur_page_count = page_count;
+    memory->memory_data_size = memory_data_size;
+    memory->memory_data_end = memory_data_new + memory_data_size;
+    if (memory->heap_data) {
+        memory->heap_data = memory_data_new + heap_offset;
+        memory->heap_data_end = memory->heap_data + heap_size;
+    }
+    wasm_runtime_set_mem_bound_check_bytes(memory, memory_data_size);
+    return true;
+}
+#endif
+
+#if WASM_ENABLE_INSTANCE_RESET != 0
+/* Page count a memory of the instance was instantiated with */
+static uint32
+memory_init_page_count(const WASMModuleInstance *module_inst, uint32 index)
+{
+    const WASMModule *module = module_inst->module;
+    const WASMMemoryImport *import;
+
+    if (index == 0)
+        return module_inst->e->default_memory_init_page_count;
+    if (index < module->import_memory_count) {
+        import = &module->import_memories[index].u.memory;
+        return import->mem_type.init_page_count;
+    }
+    return module->memories[index - module->import_memory_count]
+        .init_page_count;
+}
+
+/* Size a table of the instance was instantiated with */
+static uint32
+table_init_size(const WASMModule *module, uint32 index)
+{
+    const WASMTableImport *import;
+
+    if (index < module->import_table_count) {
+        import = &module->import_tables[index].u.table;
+        return import->table_type.init_size;
+    }
+    return module->tables[index - module->import_table_count]
+        .table_type.init_size;
+}
+
+bool
+wasm_reset_instance(WASMModuleInstance *module_inst, char *error_buf,
+                    uint32 error_buf_size)
+{
+    WASMModule *module = module_inst->module;
+    uint32 i;
+
+#if WASM_ENABLE_GC != 0
+    set_error_buf(error_buf, error_buf_size,
+                  "instances with GC objects can't be reset");
+    return false;
+#endif
+#if WASM_ENABLE_MULTI_MODULE != 0
+    if (bh_list_first_elem(module_inst->e->sub_module_inst_list)) {
+        set_error_buf(error_buf, error_buf_size,
+                      "instances linked to sub modules can't be reset");
+        return false;
+    }
+#endif
+#if WASM_ENABLE_SHARED_MEMORY != 0
+    for (i = 0; i < module_inst->memory_count; i++) {
+        if (shared_memory_is_shared(module_inst->memories[i])) {
+            set_error_buf(error_buf, error_buf_size,
+                          "instances with shared memory can't be reset");
+            return false;
+        }
+    }
+#endif
+
+    for (i = 0; i < module_inst->memory_count; i++) {
+        WASMMemoryInstance *memory = module_inst->memories[i];
+        uint32 init_page_count = memory_init_page_count(module_inst, i);
+
+        /* Only a memory that grew is allocated again */
+        if (memory->cur_page_count != init_page_count) {
+            if (!resize_memory(memory, init_page_count)) {
+                set_error_buf(error_buf, error_buf_size,
+                              "allocate memory failed");
+                return false;
+            }
+        }
+        else if (memory->memory_data_size > 0) {
+            memset(memory->memory_data, 0, (size_t)memory->memory_data_size);
+        }
+
+        if (memory->heap_handle
+            && mem_allocator_reset(
+                   memory->heap_handle, (char *)memory->heap_data,
+                   (uint32)(memory->heap_data_end - memory->heap_data))
+                   != 0) {
+            set_error_buf(error_buf, error_buf_size, "reset app heap failed");
+            return false;
+        }
+    }
+
+    for (i = 0; i < module_inst->table_count; i++) {
+        WASMTableInstance *table = module_inst->tables[i];
+
+        /* Uninitialized elements are -1, as in tables_instantiate() */
+        memset(table->elems, -1,
+               sizeof(table_elem_type_t) * (size_t)table->max_size);
+        table->cur_size = table_init_size(module, i);
+    }
+
+#if WASM_ENABLE_BULK_MEMORY != 0
+    for (i = 0; i < module->data_seg_count; i++) {
+        if (module->data_segments[i]->is_passive)
+            bh_bitmap_clear_bit(module_inst->e->common.data_dropped, i);
+        else
+            bh_bitmap_set_bit(module_inst->e->common.data_dropped, i);
+    }
+#endif
+#if WASM_ENABLE_REF_TYPES != 0
+    for (i = 0; i < module->table_seg_count; i++) {
+        uint32 mode = module->table_segments[i].mode;
+
+        if (wasm_elem_is_active(mode) || wasm_elem_is_declarative(mode))
+            bh_bitmap_set_bit(module_inst->e->common.elem_dropped, i);
+        else
+            bh_bitmap_clear_bit(module_inst->e->common.elem_dropped, i);
+    }
+#endif
+
+    if ((module_inst->e->global_count > 0
+         && !init_global_data(module_inst, error_buf, error_buf_size))
+        || !init_memory_data(module_inst, error_buf, error_buf_size)
+        || !init_table_data(module_inst, error_buf, error_buf_size))
+        return false;
+
+    wasm_set_exception(module_inst, NULL);
+
+    /* The start function runs again on the fresh state, as it did after
+       instantiation */
+    if (!execute_post_instantiate_functions(module_inst, false, NULL)) {
+        set_error_buf(error_buf, error_buf_size, module_inst->cur_exception);
+        return false;
+    }
+    return true;
+}
+#endif /* end of WASM_ENABLE_INSTANCE_RESET != 0 */
+
+#if WASM_ENABLE_INSTANCE_SNAPSHOT != 0
+#define SNAPSHOT_ALIGN(size) (((uint64)(size) + 7) & ~(uint64)7)
+
+static uint32
+bitmap_bytes(const bh_bitmap *bitmap)
+{
+    return bitmap ? (uint32)((bitmap->end_index - bitmap->begin_index + 7) / 8)
+                  : 0;
+}
+
+/* Hand out the next part of the snapshot block */
+static void *
+snapshot_carve(uint8 **p_cur, uint64 size)
+{
+    void *ptr = *p_cur;
+
+    *p_cur += SNAPSHOT_ALIGN(size);
+    return ptr;
+}
+
+struct WASMInstanceSnapshot *
+wasm_snapshot_instance(WASMModuleInstance *module_inst, char *error_buf,
+                       uint32 error_buf_size)
+{
+    struct WASMInstanceSnapshot *snapshot;
+    uint32 heap_struct_size = mem_allocator_get_heap_struct_size();
+    uint64 total_size;
+    uint8 *p;
+    uint32 i;
+
+#if WASM_ENABLE_GC != 0
+    set_error_buf(error_buf, error_buf_size,
+                  "instances with GC objects can't be snapshotted");
+    return NULL;
+#endif
+    if (wasm_get_exception(module_inst)) {
+        set_error_buf(error_buf, error_buf_size,
+                      "instance with an exception can't be snapshotted");
+        return NULL;
+    }
+
+    total_size = SNAPSHOT_ALIGN(sizeof(struct WASMInstanceSnapshot))
+                 + SNAPSHOT_ALIGN(sizeof(WASMMemorySnapshot)
+                                  * (uint64)module_inst->memory_count)
+                 + SNAPSHOT_ALIGN(sizeof(WASMTableSnapshot)
+                                  * (uint64)module_inst->table_count)
+                 + SNAPSHOT_ALIGN(module_inst->global_data_size);
+    for (i = 0; i < module_inst->memory_count; i++) {
+        WASMMemoryInstance *memory = module_inst->memories[i];
+
+#if WASM_ENABLE_SHARED_MEMORY != 0
+        if (shared_memory_is_shared(memory)) {
+            set_error_buf(error_buf, error_buf_size,
+                          "instances with shared memory can't be "
+                          "snapshotted");
+            return NULL;
+        }
+#endif
+        if (memory->heap_handle) {
+            if (mem_allocator_is_heap_corrupted(memory->heap_handle)) {
+                set_error_buf(error_buf, error_buf_size,
+                              "app heap corrupted");
+                return NULL;
+            }
+            total_size += SNAPSHOT_ALIGN(heap_struct_size);
+        }
+    }
+    for (i = 0; i < module_inst->table_count; i++) {
+        WASMTableInstance *table = module_inst->tables[i];
+        total_size +=
+            SNAPSHOT_ALIGN(sizeof(table_elem_type_t) * (uint64)table->cur_size);
+    }
+#if WASM_ENABLE_BULK_MEMORY != 0
+    total_size +=
+        SNAPSHOT_ALIGN(bitmap_bytes(module_inst->e->common.data_dropped));
+#endif
+#if WASM_ENABLE_REF_TYPES != 0
+    total_size +=
+        SNAPSHOT_ALIGN(bitmap_bytes(module_inst->e->common.elem_dropped));
+#endif
+
+    if (!(snapshot = runtime_malloc(total_size, error_buf, error_buf_size)))
+        return NULL;
+
+    p = (uint8 *)snapshot + SNAPSHOT_ALIGN(sizeof(struct WASMInstanceSnapshot));
+    snapshot->module = module_inst->module;
+    snapshot->host_managed_heap_size = module_inst->e->host_managed_heap_size;
+    snapshot->max_memory_pages = module_inst->e->max_memory_pages;
+    snapshot->memory_count = module_inst->memory_count;
+    snapshot->table_count = module_inst->table_count;
+    snapshot->total_size = total_size;
+    snapshot->memories = snapshot_carve(
+        &p, sizeof(WASMMemorySnapshot) * (uint64)snapshot->memory_count);
+    snapshot->tables = snapshot_carve(
+        &p, sizeof(WASMTableSnapshot) * (uint64)snapshot->table_count);
+#ifdef OS_ENABLE_COW_MAPPING
+    for (i = 0; i < snapshot->memory_count; i++)
+        snapshot->memories[i].cow_file = os_get_invalid_handle();
+#endif
+
+    snapshot->global_data_size = module_inst->global_data_size;
+    snapshot->global_data = snapshot_carve(&p, snapshot->global_data_size);
+    if (snapshot->global_data_size > 0)
+        bh_memcpy_s(snapshot->global_data, snapshot->global_data_size,
+                    module_inst->global_data, module_inst->global_data_size);
+
+    for (i = 0; i < module_inst->memory_count; i++) {
+        WASMMemoryInstance *memory = module_inst->memories[i];
+        WASMMemorySnapshot *memory_snapshot = &snapshot->memories[i];
+
+        memory_snapshot->num_bytes_per_page = memory->num_bytes_per_page;
+        memory_snapshot->cur_page_count = memory->cur_page_count;
+        memory_snapshot->max_page_count = memory->max_page_count;
+        memory_snapshot->memory_data_size = memory->memory_data_size;
+
+        if (memory->memory_data_size > 0) {
+#ifdef OS_ENABLE_COW_MAPPING
+            uint64 file_size = (uint64)memory->num_bytes_per_page
+                               * memory->max_page_count;
+
+            /* The file spans the maximum size, so the pages that a
+               memory.grow maps after restoring read as zero */
+            if (file_size < memory->memory_data_size)
+                file_size = memory->memory_data_size;
+            memory_snapshot->cow_file = os_create_cow_file(
+                memory->memory_data, (size_t)memory->memory_data_size,
+                (size_t)file_size);
+            if (memory_snapshot->cow_file != os_get_invalid_handle())
+                memory_snapshot->data =
+                    os_mmap_cow(NULL, (size_t)memory->memory_data_size,
+                                MMAP_PROT_READ, MMAP_MAP_NONE,
+                                memory_snapshot->cow_file);
+#endif
+            /* The data segments and the init code wrote all over the
+               memory, so copy it whole rather than only the dirty parts */
+            if (!memory_snapshot->data) {
+                if (!(memory_snapshot->data = os_mmap(
+                          NULL, (size_t)memory->memory_data_size,
+                          MMAP_PROT_READ | MMAP_PROT_WRITE, MMAP_MAP_NOZERO,
+                          os_get_invalid_handle()))) {
+                    set_error_buf(error_buf, error_buf_size,
+                                  "allocate memory failed");
+                    goto fail;
+                }
+                memcpy(memory_snapshot->data, memory->memory_data,
+                       (size_t)memory->memory_data_size);
+            }
+            snapshot->total_size += memory->memory_data_size;
+        }
+
+        if (memory->heap_handle) {
+            memory_snapshot->heap_size =
+                (uint32)(memory->heap_data_end - memory->heap_data);
+            memory_snapshot->heap_offset =
+                (uint64)(memory->heap_data - memory->memory_data);
+            memory_snapshot->heap_state = snapshot_carve(&p, heap_struct_size);
+            mem_allocator_save_state(memory->heap_handle,
+                                     memory_snapshot->heap_state);
+        }
+    }
+
+    for (i = 0; i < module_inst->table_count; i++) {
+        WASMTableInstance *table = module_inst->tables[i];
+        WASMTableSnapshot *table_snapshot = &snapshot->tables[i];
+        uint64 elems_size = sizeof(table_elem_type_t) * (uint64)table->cur_size;
+
+        table_snapshot->cur_size = table->cur_size;
+        table_snapshot->elems = snapshot_carve(&p, elems_size);
+        if (elems_size > 0)
+            bh_memcpy_s(table_snapshot->elems, (uint32)elems_size, table->elems,
+                        (uint32)elems_size);
+    }
+
+#if WASM_ENABLE_BULK_MEMORY != 0
+    if (module_inst->e->common.data_dropped) {
+        uint32 size = bitmap_bytes(module_inst->e->common.data_dropped);
+
+        snapshot->data_dropped = snapshot_carve(&p, size);
+        bh_memcpy_s(snapshot->data_dropped, size,
+                    module_inst->e->common.data_dropped->map, size);
+    }
+#endif
+#if WASM_ENABLE_REF_TYPES != 0
+    if (module_inst->e->common.elem_dropped) {
+        uint32 size = bitmap_bytes(module_inst->e->common.elem_dropped);
+
+        snapshot->elem_dropped = snapshot_carve(&p, size);
+        bh_memcpy_s(snapshot->elem_dropped, size,
+                    module_inst->e->common.elem_dropped->map, size);
+    }
+#endif
+
+    bh_assert(p == (uint8 *)snapshot + total_size);
+    return snapshot;
+
+fail:
+    wasm_destroy_snapshot(snapshot);
+    return NULL;
+}
+
+bool
+wasm_restore_instance(WASMModuleInstance *module_inst,
+                      const struct WASMInstanceSnapshot *snapshot,
+                      char *error_buf, uint32 error_buf_size)
+{
+    uint32 i;
+
+    if (snapshot->module != module_inst->module) {
+        set_error_buf(error_buf, error_buf_size,
+                      "snapshot is of another module");
+        return false;
+    }
+    bh_assert(snapshot->memory_count == module_inst->memory_count);
+    bh_assert(snapshot->table_count == module_inst->table_count);
+    bh_assert(snapshot->global_data_size == module_inst->global_data_size);
+
+    for (i = 0; i < module_inst->memory_count; i++) {
+        WASMMemoryInstance *memory = module_inst->memories[i];
+        const WASMMemorySnapshot *memory_snapshot = &snapshot->memories[i];
+        uint32 heap_size = 0;
+        uint64 heap_offset = 0;
+        bool mapped = false;
+
+        if (memory->heap_handle) {
+            heap_size = (uint32)(memory->heap_data_end - memory->heap_data);
+            heap_offset = (uint64)(memory->heap_data - memory->memory_data);
+        }
+
+        /* Instantiated with other heap size or memory limits */
+        if (memory->num_bytes_per_page != memory_snapshot->num_bytes_per_page
+            || memory->max_page_count != memory_snapshot->max_page_count
+            || heap_size != memory_snapshot->heap_size
+            || heap_offset != memory_snapshot->heap_offset) {
+            set_error_buf(error_buf, error_buf_size,
+                          "snapshot memory layout doesn't match the instance");
+            return false;
+        }
+
+        if (memory->cur_page_count != memory_snapshot->cur_page_count
+            && !resize_memory(memory, memory_snapshot->cur_page_count)) {
+            set_error_buf(error_buf, error_buf_size, "allocate memory failed");
+            return false;
+        }
+        bh_assert(memory->memory_data_size
+                  == memory_snapshot->memory_data_size);
+
+#ifdef OS_ENABLE_COW_MAPPING
+        /* A mapped memory takes the snapshot's pages copy-on-write in place
+           of its own, so only the pages written after this get copied.
+           A memory in a pool is copied into */
+        if (memory_snapshot->cow_file != os_get_invalid_handle()
+            && wasm_linear_memory_is_mapped(memory)) {
+            if (!os_mmap_cow(memory->memory_data,
+                             (size_t)memory_snapshot->memory_data_size,
+                             MMAP_PROT_READ | MMAP_PROT_WRITE, MMAP_MAP_FIXED,
+                             memory_snapshot->cow_file)) {
+                /* The old pages may be gone too */
+                set_error_buf(error_buf, error_buf_size,
+                              "map snapshot memory failed");
+                return false;
+            }
+            mapped = true;
+        }
+#endif
+        if (!mapped && memory_snapshot->memory_data_size > 0)
+            memcpy(memory->memory_data, memory_snapshot->data,
+                   (size_t)memory_snapshot->memory_data_size);
+
+        if (memory_snapshot->heap_state
+            && mem_allocator_restore_state(
+                   memory->heap_handle, memory_snapshot->heap_state,
+                   (char *)memory->heap_data, heap_size)
+                   != 0) {
+            set_error_buf(error_buf, error_buf_size,
+                          "restore app heap failed");
+            return false;
+        }
+    }
+
+    if (snapshot->global_data_size > 0)
+        bh_memcpy_s(module_inst->global_data, module_inst->global_data_size,
+                    snapshot->global_data, snapshot->global_data_size);
+
+    for (i = 0; i < module_inst->table_count; i++) {
+        WASMTableInstance *table = module_inst->tables[i];
+        const WASMTableSnapshot *table_snapshot = &snapshot->tables[i];
+
+        bh_assert(table_snapshot->cur_size <= table->max_size);
+        table->cur_size = table_snapshot->cur_size;
+        if (table->cur_size > 0)
+            bh_memcpy_s(table->elems,
+                        (uint32)(sizeof(table_elem_type_t) * table->cur_size),
+                        table_snapshot->elems,
+                        (uint32)(sizeof(table_elem_type_t) * table->cur_size));
+    }
+
+#if WASM_ENABLE_BULK_MEMORY != 0
+    if (snapshot->data_dropped) {
+        uint32 size = bitmap_bytes(module_inst->e->common.data_dropped);
+
+        bh_memcpy_s(module_inst->e->common.data_dropped->map, size,
+                    snapshot->data_dropped, size);
+    }
+#endif
+#if WASM_ENABLE_REF_TYPES != 0
+    if (snapshot->elem_dropped) {
+        uint32 size = bitmap_bytes(module_inst->e->common.elem_dropped);
+
+        bh_memcpy_s(module_inst->e->common.elem_dropped->map, size,
+                    snapshot->elem_dropped, size);
+    }
+#endif
+
+    wasm_set_exception(module_inst, NULL);
+    return true;
+}
+
+bool
+wasm_snapshot_is_of_module(const struct WASMInstanceSnapshot *snapshot,
+                           const WASMModuleCommon *module)
+{
+    return (const WASMModuleCommon *)snapshot->module == module;
+}
+
+uint64
+wasm_snapshot_get_size(const struct WASMInstanceSnapshot *snapshot)
+{
+    return snapshot ? snapshot->total_size : 0;
+}
+
+void
+wasm_destroy_snapshot(struct WASMInstanceSnapshot *snapshot)
+{
+    uint32 i;
+
+    if (!snapshot)
+        return;
+
+    for (i = 0; i < snapshot->memory_count; i++) {
+        WASMMemorySnapshot *memory_snapshot = &snapshot->memories[i];
+
+        if (memory_snapshot->data)
+            os_munmap(memory_snapshot->data,
+                      (size_t)memory_snapshot->memory_data_size);
+#ifdef OS_ENABLE_COW_MAPPING
+        /* Restored memories keep their mappings of it */
+        if (memory_snapshot->cow_file != os_get_invalid_handle())
+            os_close_cow_file(memory_snapshot->cow_file);
+#endif
+    }
+    wasm_runtime_free(snapshot);
+}
+#endif /* end of WASM_ENABLE_INSTANCE_SNAPSHOT != 0 */
+
 WASMFunctionInstance *
 wasm_lookup_function(const WASMModuleInstance *module_inst, const char *name)
 {
@@ -3693,6 +4366,34 @@ wasm_call_function(WASMExecEnv *exec_env, WASMFunctionInstance *function,
     return !wasm_copy_exception(module_inst, NULL);
 }
 
+bool
+wasm_call_function_batch(WASMExecEnv *exec_env, WASMFunctionInstance *function,
+                         uint32 argc, uint32 argv_matrix[], uint32 count,
+                         uint32 *p_failed_index)
+{
+    WASMModuleInstance *module_inst =
+        (WASMModuleInstance *)exec_env->module_inst;
+    uint32 *argv = argv_matrix;
+    uint32 i;
+
+#ifndef OS_ENABLE_HW_BOUND_CHECK
+    /* Set thread handle and stack boundary once for the whole batch */
+    wasm_exec_env_set_thread_info(exec_env);
+#endif
+
+    module_inst->cur_exec_env = exec_env;
+
+    for (i = 0; i < count; i++, argv += argc) {
+        interp_call_wasm(module_inst, exec_env, function, argc, argv);
+        if (wasm_copy_exception(module_inst, NULL)) {
+            if (p_failed_index)
+                *p_failed_index = i;
+            return false;
+        }
+    }
+    return true;
+}
+
 #if WASM_ENABLE_PERF_PROFILING != 0 || WASM_ENABLE_DUMP_CALL_STACK != 0
 /* look for the function name */
 static char *
@@ -4641,6 +5342,12 @@ llvm_jit_invoke_native(WASMExecEnv *exec_env, uint32 func_idx, uint32 argc,
             (WASMModuleInstanceCommon *)module_inst, func_ptr, func_type, argc,
             argv, c_api_func_import->with_env_arg, c_api_func_import->env_arg);
     }
+#if WASM_ENABLE_FAST_NATIVES != 0
+    else if (import_func->fast_native) {
+        ret = wasm_runtime_invoke_native_fast(exec_env, func_ptr, attachment,
+                                              argv);
+    }
+#endif
     else if (!import_func->call_conv_raw) {
         signature = import_func->signature;
         ret =
@@ -5105,8 +5812,15 @@ wasm_const_str_list_insert(const uint8 *str, uint32 len, WASMModule *module,
         return node->str;
     }
 
-    if (!(node = runtime_malloc(sizeof(StringNode) + len + 1, error_buf,
-                                error_buf_size))) {
+#if WASM_ENABLE_LOAD_ARENA != 0
+    /* Freed with the module, which skips the blocks of its arena */
+    if (bh_arena_is_inited(&module->arena))
+        node = bh_arena_alloc(&module->arena,
+                              (uint32)sizeof(StringNode) + len + 1);
+#endif
+    if (!node
+        && !(node = runtime_malloc(sizeof(StringNode) + len + 1, error_buf,
+                                   error_buf_size))) {
         return NULL;
     }
 
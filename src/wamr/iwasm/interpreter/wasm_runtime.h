@@ -216,8 +216,10 @@ struct WASMFunctionInstance {
     bool is_import_func;
     /* parameter count */
     uint16 param_count;
+#if WASM_ENABLE_COMPACT_METADATA == 0
     /* local variable count, 0 for import function */
     uint16 local_count;
+#endif
     /* cell num of parameters */
     uint16 param_cell_num;
     /* cell num of return type */
@@ -228,11 +230,13 @@ struct WASMFunctionInstance {
     /* cell num of consts */
     uint16 const_cell_num;
 #endif
+#if WASM_ENABLE_COMPACT_METADATA == 0
     uint16 *local_offsets;
     /* parameter types */
     uint8 *param_types;
     /* local types, NULL for import function */
     uint8 *local_types;
+#endif
     union {
         WASMFunctionImport *func_import;
         WASMFunction *func;
@@ -251,6 +255,25 @@ struct WASMFunctionInstance {
 #endif
 };
 
+/* With compact metadata the function instance keeps no copies of the types
+   and locals, they are read from the function or import it refers to */
+#if WASM_ENABLE_COMPACT_METADATA != 0
+#define wasm_func_inst_param_types(f)                           \
+    ((f)->is_import_func ? (f)->u.func_import->func_type->types \
+                         : (f)->u.func->func_type->types)
+#define wasm_func_inst_local_count(f) \
+    ((f)->is_import_func ? 0 : (uint32)(f)->u.func->local_count)
+#define wasm_func_inst_local_types(f) \
+    ((f)->is_import_func ? NULL : (f)->u.func->local_types)
+#define wasm_func_inst_local_offsets(f) \
+    ((f)->is_import_func ? NULL : (f)->u.func->local_offsets)
+#else
+#define wasm_func_inst_param_types(f) ((f)->param_types)
+#define wasm_func_inst_local_count(f) ((uint32)(f)->local_count)
+#define wasm_func_inst_local_types(f) ((f)->local_types)
+#define wasm_func_inst_local_offsets(f) ((f)->local_offsets)
+#endif
+
 #if WASM_ENABLE_TAGS != 0
 struct WASMTagInstance {
     bool is_import_tag;
@@ -389,6 +412,19 @@ typedef struct WASMModuleInstanceExtra {
         && WASM_ENABLE_LAZY_JIT != 0)
     WASMModuleInstance *next;
 #endif
+
+#if WASM_ENABLE_INSTANCE_SNAPSHOT != 0
+    /* Instantiation args that set the memory layout, kept so that the
+       instances made from a snapshot of this one get the same layout */
+    uint32 host_managed_heap_size;
+    uint32 max_memory_pages;
+#endif
+
+#if WASM_ENABLE_INSTANCE_RESET != 0
+    /* Page count of the default memory once instantiated, app heap
+       included, which wasm_reset_instance() gives it back */
+    uint32 default_memory_init_page_count;
+#endif
 } WASMModuleInstanceExtra;
 
 struct AOTFuncPerfProfInfo;
@@ -570,6 +606,33 @@ wasm_get_wasm_func_exec_time(const WASMModuleInstance *inst,
 void
 wasm_deinstantiate(WASMModuleInstance *module_inst, bool is_sub_inst);
 
+#if WASM_ENABLE_INSTANCE_RESET != 0
+bool
+wasm_reset_instance(WASMModuleInstance *module_inst, char *error_buf,
+                    uint32 error_buf_size);
+#endif
+
+#if WASM_ENABLE_INSTANCE_SNAPSHOT != 0
+struct WASMInstanceSnapshot *
+wasm_snapshot_instance(WASMModuleInstance *module_inst, char *error_buf,
+                       uint32 error_buf_size);
+
+bool
+wasm_restore_instance(WASMModuleInstance *module_inst,
+                      const struct WASMInstanceSnapshot *snapshot,
+                      char *error_buf, uint32 error_buf_size);
+
+bool
+wasm_snapshot_is_of_module(const struct WASMInstanceSnapshot *snapshot,
+                           const WASMModuleCommon *module);
+
+uint64
+wasm_snapshot_get_size(const struct WASMInstanceSnapshot *snapshot);
+
+void
+wasm_destroy_snapshot(struct WASMInstanceSnapshot *snapshot);
+#endif
+
 bool
 wasm_set_running_mode(WASMModuleInstance *module_inst,
                       RunningMode running_mode);
@@ -599,6 +662,11 @@ bool
 wasm_call_function(WASMExecEnv *exec_env, WASMFunctionInstance *function,
                    unsigned argc, uint32 argv[]);
 
+bool
+wasm_call_function_batch(WASMExecEnv *exec_env, WASMFunctionInstance *function,
+                         uint32 argc, uint32 argv_matrix[], uint32 count,
+                         uint32 *p_failed_index);
+
 void
 wasm_set_exception(WASMModuleInstance *module, const char *exception);
 
@@ -771,6 +839,15 @@ const uint8 *
 wasm_loader_get_custom_section(WASMModule *module, const char *name,
                                uint32 *len);
 
+#if WASM_ENABLE_FAST_INTERP != 0
+uint32
+wasm_loader_save_code_cache(WASMModule *module, uint8 *buf, uint32 buf_size);
+
+bool
+wasm_loader_lower_function(WASMModule *module, uint32 func_idx,
+                           char *error_buf, uint32 error_buf_size);
+#endif
+
 #if WASM_ENABLE_FAST_JIT != 0 || WASM_ENABLE_JIT != 0 \
     || WASM_ENABLE_WAMR_COMPILER != 0
 void
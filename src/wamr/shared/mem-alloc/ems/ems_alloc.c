@@ -33,6 +33,58 @@ hmu_is_in_heap(void *hmu, gc_uint8 *heap_base_addr, gc_uint8 *heap_end_addr)
     return (addr >= heap_base_addr && addr < heap_end_addr) ? true : false;
 }
 
+static inline void
+normal_bitmap_set(gc_heap_t *heap, uint32 node_idx)
+{
+    heap->kfc_normal_bitmap[node_idx >> 5] |= (gc_uint32)1 << (node_idx & 31);
+}
+
+static inline void
+normal_bitmap_clear(gc_heap_t *heap, uint32 node_idx)
+{
+    heap->kfc_normal_bitmap[node_idx >> 5] &=
+        ~((gc_uint32)1 << (node_idx & 31));
+}
+
+static inline uint32
+normal_bitmap_ctz(gc_uint32 word)
+{
+    bh_assert(word);
+#if defined(__GNUC__) || defined(__clang__)
+    /* a nsau/clz based sequence on Xtensa, tzcnt/bsf on x86 */
+    return (uint32)__builtin_ctz(word);
+#else
+    {
+        uint32 n = 0;
+        while (!(word & 1)) {
+            word >>= 1;
+            n++;
+        }
+        return n;
+    }
+#endif
+}
+
+/**
+ * Find the first non-empty normal list whose index is at least @node_idx
+ *
+ * @return the index of the list, HMU_NORMAL_NODE_CNT if there is none
+ */
+static inline uint32
+normal_bitmap_find(gc_heap_t *heap, uint32 node_idx)
+{
+    uint32 word_idx = node_idx >> 5;
+    gc_uint32 word =
+        heap->kfc_normal_bitmap[word_idx] & (~(gc_uint32)0 << (node_idx & 31));
+
+    while (!word) {
+        if (++word_idx == HMU_NORMAL_BITMAP_WORDS)
+            return HMU_NORMAL_NODE_CNT;
+        word = heap->kfc_normal_bitmap[word_idx];
+    }
+    return (word_idx << 5) + normal_bitmap_ctz(word);
+}
+
 /**
  * Remove a node from the tree it belongs to
  *
@@ -209,8 +261,11 @@ unlink_hmu(gc_heap_t *heap, hmu_t *hmu)
 #endif
             node_next = get_hmu_normal_node_next(node);
             if ((hmu_t *)node == hmu) {
-                if (!node_prev) /* list head */
+                if (!node_prev) { /* list head */
                     heap->kfc_normal_list[node_idx].next = node_next;
+                    if (!node_next)
+                        normal_bitmap_clear(heap, node_idx);
+                }
                 else
                     set_hmu_normal_node_next(node_prev, node_next);
                 break;
@@ -289,6 +344,7 @@ gci_add_fc(gc_heap_t *heap, hmu_t *hmu, gc_size_t size)
         node_idx = size >> 3;
         set_hmu_normal_node_next(np, heap->kfc_normal_list[node_idx].next);
         heap->kfc_normal_list[node_idx].next = np;
+        normal_bitmap_set(heap, node_idx);
         return true;
     }
 
@@ -368,12 +424,10 @@ alloc_hmu(gc_heap_t *heap, gc_size_t size)
     if (HMU_IS_FC_NORMAL(size)) {
         /* find a non-empty slot in normal_node_list with good size*/
         init_node_idx = (size >> 3);
-        for (node_idx = init_node_idx; node_idx < HMU_NORMAL_NODE_CNT;
-             node_idx++) {
+        node_idx = normal_bitmap_find(heap, init_node_idx);
+        if (node_idx < HMU_NORMAL_NODE_CNT) {
             normal_head = heap->kfc_normal_list + node_idx;
-            if (normal_head->next)
-                break;
-            normal_head = NULL;
+            bh_assert(normal_head->next);
         }
 
         /* found in normal list*/
@@ -388,6 +442,8 @@ alloc_hmu(gc_heap_t *heap, gc_size_t size)
             }
 #endif
             normal_head->next = get_hmu_normal_node_next(p);
+            if (!normal_head->next)
+                normal_bitmap_clear(heap, node_idx);
 #if BH_ENABLE_GC_CORRUPTION_CHECK != 0
             if (((gc_int32)(uintptr_t)hmu_to_obj(p) & 7) != 0) {
                 heap->is_heap_corrupted = true;
@@ -552,19 +608,17 @@ alloc_hmu_ex(gc_heap_t *heap, gc_size_t size)
     return alloc_hmu(heap, size);
 }
 
-#if BH_ENABLE_GC_VERIFY == 0
-gc_object_t
-gc_alloc_vo(void *vheap, gc_size_t size)
-#else
-gc_object_t
-gc_alloc_vo_internal(void *vheap, gc_size_t size, const char *file, int line)
-#endif
+/* Allocate a VO with the heap locked */
+static gc_object_t
+alloc_vo_locked(gc_heap_t *heap, gc_size_t size, const char *file, int line)
 {
-    gc_heap_t *heap = (gc_heap_t *)vheap;
     hmu_t *hmu = NULL;
     gc_object_t ret = (gc_object_t)NULL;
     gc_size_t tot_size = 0, tot_size_unaligned;
 
+    (void)file;
+    (void)line;
+
     /* hmu header + prefix + obj + suffix */
     tot_size_unaligned = HMU_SIZE + OBJ_PREFIX_SIZE + size + OBJ_SUFFIX_SIZE;
     /* aligned size*/
@@ -580,11 +634,9 @@ gc_alloc_vo_internal(void *vheap, gc_size_t size, const char *file, int line)
     }
 #endif
 
-    LOCK_HEAP(heap);
-
     hmu = alloc_hmu_ex(heap, tot_size);
     if (!hmu)
-        goto finish;
+        return NULL;
 
     bh_assert(hmu_get_size(hmu) >= tot_size);
     /* the total size allocated may be larger than
@@ -607,11 +659,56 @@ gc_alloc_vo_internal(void *vheap, gc_size_t size, const char *file, int line)
         /* clear buffer appended by GC_ALIGN_8() */
         memset((uint8 *)ret + size, 0, tot_size - tot_size_unaligned);
 
-finish:
+    return ret;
+}
+
+#if BH_ENABLE_GC_VERIFY == 0
+gc_object_t
+gc_alloc_vo(void *vheap, gc_size_t size)
+#else
+gc_object_t
+gc_alloc_vo_internal(void *vheap, gc_size_t size, const char *file, int line)
+#endif
+{
+    gc_heap_t *heap = (gc_heap_t *)vheap;
+    gc_object_t ret;
+#if BH_ENABLE_GC_VERIFY == 0
+    const char *file = NULL;
+    int line = 0;
+#endif
+
+    LOCK_HEAP(heap);
+    ret = alloc_vo_locked(heap, size, file, line);
     UNLOCK_HEAP(heap);
     return ret;
 }
 
+#if BH_ENABLE_GC_VERIFY == 0
+uint32
+gc_alloc_vo_batch(void *vheap, gc_size_t size, gc_object_t *objs,
+                  uint32 count)
+#else
+uint32
+gc_alloc_vo_batch_internal(void *vheap, gc_size_t size, gc_object_t *objs,
+                           uint32 count, const char *file, int line)
+#endif
+{
+    gc_heap_t *heap = (gc_heap_t *)vheap;
+    uint32 i;
+#if BH_ENABLE_GC_VERIFY == 0
+    const char *file = NULL;
+    int line = 0;
+#endif
+
+    LOCK_HEAP(heap);
+    for (i = 0; i < count; i++) {
+        if (!(objs[i] = alloc_vo_locked(heap, size, file, line)))
+            break;
+    }
+    UNLOCK_HEAP(heap);
+    return i;
+}
+
 #if BH_ENABLE_GC_VERIFY == 0
 gc_object_t
 gc_realloc_vo(void *vheap, void *ptr, gc_size_t size)
@@ -833,22 +930,19 @@ gci_is_heap_valid(gc_heap_t *heap)
     return GC_TRUE;
 }
 
-#if BH_ENABLE_GC_VERIFY == 0
-int
-gc_free_vo(void *vheap, gc_object_t obj)
-#else
-int
-gc_free_vo_internal(void *vheap, gc_object_t obj, const char *file, int line)
-#endif
+/* Free a VO with the heap locked */
+static int
+free_vo_locked(gc_heap_t *heap, gc_object_t obj, const char *file, int line)
 {
-    gc_heap_t *heap = (gc_heap_t *)vheap;
     gc_uint8 *base_addr, *end_addr;
     hmu_t *hmu = NULL;
     hmu_t *prev = NULL;
     hmu_t *next = NULL;
     gc_size_t size = 0;
     hmu_type_t ut;
-    int ret = GC_SUCCESS;
+
+    (void)file;
+    (void)line;
 
     if (!obj) {
         return GC_SUCCESS;
@@ -866,76 +960,121 @@ gc_free_vo_internal(void *vheap, gc_object_t obj, const char *file, int line)
     base_addr = heap->base_addr;
     end_addr = base_addr + heap->current_size;
 
-    LOCK_HEAP(heap);
+    if (!hmu_is_in_heap(hmu, base_addr, end_addr))
+        return GC_SUCCESS;
 
-    if (hmu_is_in_heap(hmu, base_addr, end_addr)) {
 #if BH_ENABLE_GC_VERIFY != 0
-        hmu_verify(heap, hmu);
+    hmu_verify(heap, hmu);
 #endif
-        ut = hmu_get_ut(hmu);
-        if (ut == HMU_VO) {
-            if (hmu_is_vo_freed(hmu)) {
-                bh_assert(0);
-                ret = GC_ERROR;
-                goto out;
-            }
+    ut = hmu_get_ut(hmu);
+    if (ut != HMU_VO)
+        return GC_ERROR;
+    if (hmu_is_vo_freed(hmu)) {
+        bh_assert(0);
+        return GC_ERROR;
+    }
 
-            size = hmu_get_size(hmu);
+    size = hmu_get_size(hmu);
 
-            heap->total_free_size += size;
+    heap->total_free_size += size;
 
 #if GC_STAT_DATA != 0
-            heap->total_size_freed += size;
+    heap->total_size_freed += size;
 #endif
 
-            if (!hmu_get_pinuse(hmu)) {
-                prev = (hmu_t *)((char *)hmu - *((int *)hmu - 1));
+    if (!hmu_get_pinuse(hmu)) {
+        prev = (hmu_t *)((char *)hmu - *((int *)hmu - 1));
 
-                if (hmu_is_in_heap(prev, base_addr, end_addr)
-                    && hmu_get_ut(prev) == HMU_FC) {
-                    size += hmu_get_size(prev);
-                    hmu = prev;
-                    if (!unlink_hmu(heap, prev)) {
-                        ret = GC_ERROR;
-                        goto out;
-                    }
-                }
-            }
+        if (hmu_is_in_heap(prev, base_addr, end_addr)
+            && hmu_get_ut(prev) == HMU_FC) {
+            size += hmu_get_size(prev);
+            hmu = prev;
+            if (!unlink_hmu(heap, prev))
+                return GC_ERROR;
+        }
+    }
 
+    next = (hmu_t *)((char *)hmu + size);
+    if (hmu_is_in_heap(next, base_addr, end_addr)) {
+        if (hmu_get_ut(next) == HMU_FC) {
+            size += hmu_get_size(next);
+            if (!unlink_hmu(heap, next))
+                return GC_ERROR;
             next = (hmu_t *)((char *)hmu + size);
-            if (hmu_is_in_heap(next, base_addr, end_addr)) {
-                if (hmu_get_ut(next) == HMU_FC) {
-                    size += hmu_get_size(next);
-                    if (!unlink_hmu(heap, next)) {
-                        ret = GC_ERROR;
-                        goto out;
-                    }
-                    next = (hmu_t *)((char *)hmu + size);
-                }
-            }
+        }
+    }
 
-            if (!gci_add_fc(heap, hmu, size)) {
-                ret = GC_ERROR;
-                goto out;
-            }
+    if (!gci_add_fc(heap, hmu, size))
+        return GC_ERROR;
 
-            if (hmu_is_in_heap(next, base_addr, end_addr)) {
-                hmu_unmark_pinuse(next);
-            }
-        }
-        else {
-            ret = GC_ERROR;
-            goto out;
-        }
-        ret = GC_SUCCESS;
-        goto out;
+    if (hmu_is_in_heap(next, base_addr, end_addr)) {
+        hmu_unmark_pinuse(next);
     }
+    return GC_SUCCESS;
+}
 
-out:
+#if BH_ENABLE_GC_VERIFY == 0
+int
+gc_free_vo(void *vheap, gc_object_t obj)
+#else
+int
+gc_free_vo_internal(void *vheap, gc_object_t obj, const char *file, int line)
+#endif
+{
+    gc_heap_t *heap = (gc_heap_t *)vheap;
+    int ret;
+#if BH_ENABLE_GC_VERIFY == 0
+    const char *file = NULL;
+    int line = 0;
+#endif
+
+    LOCK_HEAP(heap);
+    ret = free_vo_locked(heap, obj, file, line);
     UNLOCK_HEAP(heap);
     return ret;
 }
 
+#if BH_ENABLE_GC_VERIFY == 0
+void
+gc_free_vo_batch(void *vheap, gc_object_t *objs, uint32 count)
+#else
+void
+gc_free_vo_batch_internal(void *vheap, gc_object_t *objs, uint32 count,
+                          const char *file, int line)
+#endif
+{
+    gc_heap_t *heap = (gc_heap_t *)vheap;
+    uint32 i;
+#if BH_ENABLE_GC_VERIFY == 0
+    const char *file = NULL;
+    int line = 0;
+#endif
+
+    LOCK_HEAP(heap);
+    for (i = 0; i < count; i++)
+        free_vo_locked(heap, objs[i], file, line);
+    UNLOCK_HEAP(heap);
+}
+
+gc_size_t
+gc_get_vo_size(void *vheap, gc_object_t obj)
+{
+    gc_heap_t *heap = (gc_heap_t *)vheap;
+    gc_uint8 *base_addr = heap->base_addr;
+    gc_uint8 *end_addr = base_addr + heap->current_size;
+    hmu_t *hmu;
+
+    if (!obj)
+        return 0;
+
+    hmu = obj_to_hmu(obj);
+    if (!hmu_is_in_heap(hmu, base_addr, end_addr)
+        || hmu_get_ut(hmu) != HMU_VO || hmu_is_vo_freed(hmu))
+        return 0;
+
+    return hmu_obj_size(hmu_get_size(hmu));
+}
+
 void
 gc_dump_heap_stats(gc_heap_t *heap)
 {
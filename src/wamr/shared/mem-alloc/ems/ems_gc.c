@@ -86,6 +86,7 @@ sweep_instance_heap(gc_heap_t *heap)
     for (i = 0; i < lsize; i++) {
         heap->kfc_normal_list[i].next = NULL;
     }
+    memset(heap->kfc_normal_bitmap, 0, sizeof(heap->kfc_normal_bitmap));
     heap->kfc_tree_root->right = NULL;
     heap->root_set = NULL;
 
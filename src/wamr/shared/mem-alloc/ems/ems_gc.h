@@ -105,7 +105,8 @@ gc_init_with_pool(char *buf, gc_size_t buf_size);
  *
  * @param struct_buf the struct buffer to create the heap structure
  * @param struct_buf_size the size of struct buffer
- * @param pool_buf the pool buffer to create pool data
+ * @param pool_buf the pool buffer to create pool data, which must be
+ *        zeroed, as the app heap part of a new linear memory is
  * @param pool_buf_size the size of poll buffer
  *
  * @return gc handle if success, NULL otherwise
@@ -165,6 +166,46 @@ gc_get_heap_struct_size(void);
 int
 gc_migrate(gc_handle_t handle, char *pool_buf_new, gc_size_t pool_buf_size);
 
+/**
+ * Save the state of a heap, so that gc_restore_state() can bring a heap
+ * back to it once its pool holds a copy of this heap's pool
+ *
+ * @param handle handle of the heap
+ * @param state buffer of gc_get_heap_struct_size() bytes
+ */
+void
+gc_save_state(gc_handle_t handle, void *state);
+
+/**
+ * Restore a heap to a state saved by gc_save_state(), of this heap or of
+ * another one
+ *
+ * @param handle handle of the heap, which keeps its lock
+ * @param state the saved state
+ * @param pool_buf the pool buffer of the heap, holding a copy of the pool
+ *        the state was saved from, possibly at another address
+ * @param pool_buf_size the size of pool buffer
+ *
+ * @return GC_SUCCESS if success, GC_ERROR otherwise
+ */
+int
+gc_restore_state(gc_handle_t handle, const void *state, char *pool_buf,
+                 gc_size_t pool_buf_size);
+
+/**
+ * Empty a heap in place, as if it was just created over a pool, even if
+ * it was corrupted
+ *
+ * @param handle handle of the heap, which keeps its lock
+ * @param pool_buf the pool buffer of the heap, which must be zeroed, as
+ *        for gc_init_with_struct_and_pool(); it may have moved
+ * @param pool_buf_size the size of pool buffer
+ *
+ * @return GC_SUCCESS if success, GC_ERROR otherwise
+ */
+int
+gc_reset(gc_handle_t handle, char *pool_buf, gc_size_t pool_buf_size);
+
 /**
  * Check whether the heap is corrupted
  *
@@ -196,6 +237,21 @@ gc_realloc_vo(void *heap, void *ptr, gc_size_t size);
 int
 gc_free_vo(void *heap, gc_object_t obj);
 
+/**
+ * Allocate up to @count VOs of @size with one lock of the heap
+ *
+ * @return the number of VOs allocated into @objs
+ */
+uint32
+gc_alloc_vo_batch(void *heap, gc_size_t size, gc_object_t *objs,
+                  uint32 count);
+
+/**
+ * Free @count VOs with one lock of the heap
+ */
+void
+gc_free_vo_batch(void *heap, gc_object_t *objs, uint32 count);
+
 #if WASM_ENABLE_GC != 0
 gc_object_t
 gc_alloc_wo(void *heap, gc_size_t size);
@@ -216,6 +272,14 @@ gc_realloc_vo_internal(void *heap, void *ptr, gc_size_t size, const char *file,
 int
 gc_free_vo_internal(void *heap, gc_object_t obj, const char *file, int line);
 
+uint32
+gc_alloc_vo_batch_internal(void *heap, gc_size_t size, gc_object_t *objs,
+                           uint32 count, const char *file, int line);
+
+void
+gc_free_vo_batch_internal(void *heap, gc_object_t *objs, uint32 count,
+                          const char *file, int line);
+
 #if WASM_ENABLE_GC != 0
 gc_object_t
 gc_alloc_wo_internal(void *heap, gc_size_t size, const char *file, int line);
@@ -234,6 +298,12 @@ gc_free_wo_internal(void *vheap, void *ptr, const char *file, int line);
 #define gc_free_vo(heap, obj) \
     gc_free_vo_internal(heap, obj, __FILE__, __LINE__)
 
+#define gc_alloc_vo_batch(heap, size, objs, count) \
+    gc_alloc_vo_batch_internal(heap, size, objs, count, __FILE__, __LINE__)
+
+#define gc_free_vo_batch(heap, objs, count) \
+    gc_free_vo_batch_internal(heap, objs, count, __FILE__, __LINE__)
+
 #if WASM_ENABLE_GC != 0
 #define gc_alloc_wo(heap, size) \
     gc_alloc_wo_internal(heap, size, __FILE__, __LINE__)
@@ -245,6 +315,15 @@ gc_free_wo_internal(void *vheap, void *ptr, const char *file, int line);
 
 #endif /* end of BH_ENABLE_GC_VERIFY */
 
+/**
+ * Get the usable size of a VO, which may be larger than the size it was
+ * allocated with
+ *
+ * @return the size, or 0 if obj isn't an allocated VO of the heap
+ */
+gc_size_t
+gc_get_vo_size(void *heap, gc_object_t obj);
+
 #if WASM_ENABLE_GC != 0
 /**
  * Add gc object ref to the rootset of a gc heap.
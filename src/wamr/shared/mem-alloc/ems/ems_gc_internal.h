@@ -174,6 +174,8 @@ hmu_verify(void *vheap, hmu_t *hmu);
 #if HMU_FC_NORMAL_MAX_SIZE >= GC_MAX_HEAP_SIZE
 #error "Too small GC_MAX_HEAP_SIZE"
 #endif
+/* Words of the normal list occupancy bitmap, one bit per list */
+#define HMU_NORMAL_BITMAP_WORDS ((HMU_NORMAL_NODE_CNT + 31) >> 5)
 
 typedef struct hmu_normal_node {
     hmu_t hmu_header;
@@ -271,6 +273,10 @@ typedef struct gc_heap_struct {
          size[left] <= size[cur] < size[right] */
     hmu_tree_node_t *kfc_tree_root;
 
+    /* bit i is set when kfc_normal_list[i] isn't empty, so that the
+       allocator finds the first fitting list without scanning them all */
+    gc_uint32 kfc_normal_bitmap[HMU_NORMAL_BITMAP_WORDS];
+
 #if WASM_ENABLE_GC != 0
     /* for rootset enumeration of private heap*/
     void *root_set;
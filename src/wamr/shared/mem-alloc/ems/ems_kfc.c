@@ -5,20 +5,12 @@
 
 #include "ems_gc_internal.h"
 
-static gc_handle_t
-gc_init_internal(gc_heap_t *heap, char *base_addr, gc_size_t heap_max_size)
+/* Set up an empty heap over a zeroed pool, the heap struct is zeroed
+   but for its lock */
+static void
+init_heap(gc_heap_t *heap, char *base_addr, gc_size_t heap_max_size)
 {
     hmu_tree_node_t *root = NULL, *q = NULL;
-    int ret;
-
-    memset(heap, 0, sizeof *heap);
-    memset(base_addr, 0, heap_max_size);
-
-    ret = os_mutex_init(&heap->lock);
-    if (ret != BHT_OK) {
-        LOG_ERROR("[GC_ERROR]failed to init lock\n");
-        return NULL;
-    }
 
     /* init all data structures*/
     heap->current_size = heap_max_size;
@@ -52,7 +44,25 @@ gc_init_internal(gc_heap_t *heap, char *base_addr, gc_size_t heap_max_size)
     q->size = heap->current_size;
 
     bh_assert(root->size <= HMU_FC_NORMAL_MAX_SIZE);
+}
+
+static gc_handle_t
+gc_init_internal(gc_heap_t *heap, char *base_addr, gc_size_t heap_max_size,
+                 bool pool_zeroed)
+{
+    int ret;
 
+    memset(heap, 0, sizeof *heap);
+    if (!pool_zeroed)
+        memset(base_addr, 0, heap_max_size);
+
+    ret = os_mutex_init(&heap->lock);
+    if (ret != BHT_OK) {
+        LOG_ERROR("[GC_ERROR]failed to init lock\n");
+        return NULL;
+    }
+
+    init_heap(heap, base_addr, heap_max_size);
     return heap;
 }
 
@@ -82,7 +92,7 @@ gc_init_with_pool(char *buf, gc_size_t buf_size)
     os_printf("   padding bytes: %u\n",
               buf_size - sizeof(gc_heap_t) - heap_max_size);
 #endif
-    return gc_init_internal(heap, base_addr, heap_max_size);
+    return gc_init_internal(heap, base_addr, heap_max_size, false);
 }
 
 gc_handle_t
@@ -125,7 +135,8 @@ gc_init_with_struct_and_pool(char *struct_buf, gc_size_t struct_buf_size,
     os_printf("   actual heap size: %u\n", heap_max_size);
     os_printf("   padding bytes: %u\n", pool_buf_size - heap_max_size);
 #endif
-    return gc_init_internal(heap, base_addr, heap_max_size);
+    /* The pool is in a new linear memory or shared heap, already zeroed */
+    return gc_init_internal(heap, base_addr, heap_max_size, true);
 }
 
 int
@@ -232,41 +243,17 @@ adjust_ptr(uint8 **p_ptr, intptr_t offset)
     }
 }
 
-int
-gc_migrate(gc_handle_t handle, char *pool_buf_new, gc_size_t pool_buf_size)
+/* Move the pointers of a heap whose pool was moved or copied by offset
+   bytes. The tree nodes whose parent is old_root hang off the root in the
+   heap structure, they get this heap's root instead. */
+static int
+relocate_heap(gc_heap_t *heap, intptr_t offset, hmu_tree_node_t *old_root)
 {
-    gc_heap_t *heap = (gc_heap_t *)handle;
-    char *base_addr_new = pool_buf_new + GC_HEAD_PADDING;
-    char *pool_buf_end = pool_buf_new + pool_buf_size;
-    intptr_t offset = (uint8 *)base_addr_new - (uint8 *)heap->base_addr;
     hmu_t *cur = NULL, *end = NULL;
     hmu_tree_node_t *tree_node;
     uint8 **p_left, **p_right, **p_parent;
-    gc_size_t heap_max_size, size;
-
-    if ((((uintptr_t)pool_buf_new) & 7) != 0) {
-        LOG_ERROR("[GC_ERROR]heap migrate pool buf not 8-byte aligned\n");
-        return GC_ERROR;
-    }
-
-    heap_max_size = (uint32)(pool_buf_end - base_addr_new) & (uint32)~7;
-
-    if (pool_buf_end < base_addr_new || heap_max_size < heap->current_size) {
-        LOG_ERROR("[GC_ERROR]heap migrate invalid pool buf size\n");
-        return GC_ERROR;
-    }
-
-    if (offset == 0)
-        return 0;
-
-#if BH_ENABLE_GC_CORRUPTION_CHECK != 0
-    if (heap->is_heap_corrupted) {
-        LOG_ERROR("[GC_ERROR]Heap is corrupted, heap migrate failed.\n");
-        return GC_ERROR;
-    }
-#endif
-
-    heap->base_addr = (uint8 *)base_addr_new;
+    gc_size_t size;
+    uint32 i;
 
     ASSERT_TREE_NODE_ALIGNED_ACCESS(heap->kfc_tree_root);
 
@@ -280,6 +267,11 @@ gc_migrate(gc_handle_t handle, char *pool_buf_new, gc_size_t pool_buf_size)
     adjust_ptr(p_right, offset);
     adjust_ptr(p_parent, offset);
 
+    /* The list heads point into the pool too, only the links between the
+       nodes are relative */
+    for (i = 0; i < HMU_NORMAL_NODE_CNT; i++)
+        adjust_ptr((uint8 **)&heap->kfc_normal_list[i].next, offset);
+
     cur = (hmu_t *)heap->base_addr;
     end = (hmu_t *)((char *)heap->base_addr + heap->current_size);
 
@@ -307,9 +299,11 @@ gc_migrate(gc_handle_t handle, char *pool_buf_new, gc_size_t pool_buf_size)
                                   + offsetof(hmu_tree_node_t, parent));
             adjust_ptr(p_left, offset);
             adjust_ptr(p_right, offset);
-            if (tree_node->parent != heap->kfc_tree_root)
+            if (tree_node->parent == old_root)
                 /* The root node belongs to heap structure,
                    it is fixed part and isn't changed. */
+                tree_node->parent = heap->kfc_tree_root;
+            else
                 adjust_ptr(p_parent, offset);
         }
         cur = (hmu_t *)((char *)cur + size);
@@ -328,6 +322,119 @@ gc_migrate(gc_handle_t handle, char *pool_buf_new, gc_size_t pool_buf_size)
     return 0;
 }
 
+int
+gc_migrate(gc_handle_t handle, char *pool_buf_new, gc_size_t pool_buf_size)
+{
+    gc_heap_t *heap = (gc_heap_t *)handle;
+    char *base_addr_new = pool_buf_new + GC_HEAD_PADDING;
+    char *pool_buf_end = pool_buf_new + pool_buf_size;
+    intptr_t offset = (uint8 *)base_addr_new - (uint8 *)heap->base_addr;
+    gc_size_t heap_max_size;
+
+    if ((((uintptr_t)pool_buf_new) & 7) != 0) {
+        LOG_ERROR("[GC_ERROR]heap migrate pool buf not 8-byte aligned\n");
+        return GC_ERROR;
+    }
+
+    heap_max_size = (uint32)(pool_buf_end - base_addr_new) & (uint32)~7;
+
+    if (pool_buf_end < base_addr_new || heap_max_size < heap->current_size) {
+        LOG_ERROR("[GC_ERROR]heap migrate invalid pool buf size\n");
+        return GC_ERROR;
+    }
+
+    if (offset == 0)
+        return 0;
+
+#if BH_ENABLE_GC_CORRUPTION_CHECK != 0
+    if (heap->is_heap_corrupted) {
+        LOG_ERROR("[GC_ERROR]Heap is corrupted, heap migrate failed.\n");
+        return GC_ERROR;
+    }
+#endif
+
+    heap->base_addr = (uint8 *)base_addr_new;
+    return relocate_heap(heap, offset, heap->kfc_tree_root);
+}
+
+void
+gc_save_state(gc_handle_t handle, void *state)
+{
+    gc_heap_t *heap = (gc_heap_t *)handle;
+
+    os_mutex_lock(&heap->lock);
+    bh_memcpy_s(state, sizeof(gc_heap_t), heap, sizeof(gc_heap_t));
+    os_mutex_unlock(&heap->lock);
+}
+
+int
+gc_restore_state(gc_handle_t handle, const void *state, char *pool_buf,
+                 gc_size_t pool_buf_size)
+{
+    gc_heap_t *heap = (gc_heap_t *)handle;
+    const gc_heap_t *saved = (const gc_heap_t *)state;
+    char *base_addr = pool_buf + GC_HEAD_PADDING;
+    char *pool_buf_end = pool_buf + pool_buf_size;
+    hmu_tree_node_t *old_root = saved->kfc_tree_root;
+    intptr_t offset = (uint8 *)base_addr - saved->base_addr;
+    uint32 lock_end = offsetof(gc_heap_t, lock) + sizeof(korp_mutex);
+    int ret = GC_SUCCESS;
+
+    if ((((uintptr_t)pool_buf) & 7) != 0 || pool_buf_end < base_addr
+        || ((uint32)(pool_buf_end - base_addr) & (uint32)~7)
+               < saved->current_size) {
+        LOG_ERROR("[GC_ERROR]heap restore invalid pool buf\n");
+        return GC_ERROR;
+    }
+
+    /* Everything but the lock, which stays this heap's own */
+    os_mutex_lock(&heap->lock);
+    memcpy(heap, saved, offsetof(gc_heap_t, lock));
+    memcpy((uint8 *)heap + lock_end, (const uint8 *)saved + lock_end,
+           sizeof(gc_heap_t) - lock_end);
+    heap->heap_id = (gc_handle_t)heap;
+    heap->base_addr = (gc_uint8 *)base_addr;
+    heap->kfc_tree_root = (hmu_tree_node_t *)heap->kfc_tree_root_buf;
+
+    /* Nothing to move when a heap gets back its own state in place */
+    if (offset != 0 || old_root != heap->kfc_tree_root)
+        ret = relocate_heap(heap, offset, old_root);
+    os_mutex_unlock(&heap->lock);
+    return ret;
+}
+
+int
+gc_reset(gc_handle_t handle, char *pool_buf, gc_size_t pool_buf_size)
+{
+    gc_heap_t *heap = (gc_heap_t *)handle;
+    char *base_addr = pool_buf + GC_HEAD_PADDING;
+    char *pool_buf_end = pool_buf + pool_buf_size;
+    uint32 lock_end = offsetof(gc_heap_t, lock) + sizeof(korp_mutex);
+
+    if ((((uintptr_t)pool_buf) & 7) != 0
+        || pool_buf_size < APP_HEAP_SIZE_MIN) {
+        LOG_ERROR("[GC_ERROR]heap reset invalid pool buf\n");
+        return GC_ERROR;
+    }
+
+#if WASM_ENABLE_GC != 0
+    /* Their finalizers would never run */
+    if (heap->extra_info_node_cnt > 0) {
+        LOG_ERROR("[GC_ERROR]heap reset with finalizers pending\n");
+        return GC_ERROR;
+    }
+#endif
+
+    /* Everything but the lock, as gc_init_internal() leaves it */
+    os_mutex_lock(&heap->lock);
+    memset(heap, 0, offsetof(gc_heap_t, lock));
+    memset((uint8 *)heap + lock_end, 0, sizeof(gc_heap_t) - lock_end);
+    init_heap(heap, base_addr,
+              (uint32)(pool_buf_end - base_addr) & (uint32)~7);
+    os_mutex_unlock(&heap->lock);
+    return GC_SUCCESS;
+}
+
 bool
 gc_is_heap_corrupted(gc_handle_t handle)
 {
@@ -6,13 +6,46 @@
 #include "mem_alloc.h"
 #include <stdbool.h>
 
-#if DEFAULT_MEM_ALLOCATOR == MEM_ALLOCATOR_EMS
-
 #include "ems/ems_gc.h"
 
+#if WASM_ENABLE_TLSF_ALLOCATOR != 0
+#include "tlsf/tlsf.h"
+
+/* A TLSF allocator handle is its heap with bit 0 set, EMS heaps are
+   aligned so the bit tells which allocator a handle belongs to. Only
+   runtime pools can be TLSF, app heaps are always EMS. */
+#define IS_TLSF(allocator) (((uintptr_t)(allocator)) & 1)
+#define TO_TLSF(allocator) \
+    ((tlsf_heap_t *)((uintptr_t)(allocator) & ~(uintptr_t)1))
+#else
+#define IS_TLSF(allocator) false
+#define TO_TLSF(allocator) NULL
+#endif
+
+#if DEFAULT_MEM_ALLOCATOR == MEM_ALLOCATOR_TLSF \
+    && WASM_ENABLE_TLSF_ALLOCATOR == 0
+#error "DEFAULT_MEM_ALLOCATOR is TLSF but WASM_ENABLE_TLSF_ALLOCATOR is 0"
+#endif
+
 mem_allocator_t
 mem_allocator_create(void *mem, uint32_t size)
 {
+    return mem_allocator_create_with_kind(mem, size, DEFAULT_MEM_ALLOCATOR);
+}
+
+mem_allocator_t
+mem_allocator_create_with_kind(void *mem, uint32_t size, int kind)
+{
+    if (kind == MEM_ALLOCATOR_TLSF) {
+#if WASM_ENABLE_TLSF_ALLOCATOR != 0
+        tlsf_heap_t *heap = tlsf_create_with_pool(mem, size);
+        return heap ? (mem_allocator_t)((uintptr_t)heap | 1) : NULL;
+#else
+        LOG_ERROR("Create mem allocator failed: TLSF allocator isn't "
+                  "enabled, build with WASM_ENABLE_TLSF_ALLOCATOR=1.\n");
+        return NULL;
+#endif
+    }
     return gc_init_with_pool((char *)mem, size);
 }
 
@@ -29,6 +62,10 @@ mem_allocator_create_with_struct_and_pool(void *struct_buf,
 int
 mem_allocator_destroy(mem_allocator_t allocator)
 {
+    if (IS_TLSF(allocator)) {
+        tlsf_destroy(TO_TLSF(allocator));
+        return 0;
+    }
     return gc_destroy_with_pool((gc_handle_t)allocator);
 }
 
@@ -41,22 +78,57 @@ mem_allocator_get_heap_struct_size()
 void *
 mem_allocator_malloc(mem_allocator_t allocator, uint32_t size)
 {
+    if (IS_TLSF(allocator))
+        return tlsf_malloc(TO_TLSF(allocator), size);
     return gc_alloc_vo((gc_handle_t)allocator, size);
 }
 
 void *
 mem_allocator_realloc(mem_allocator_t allocator, void *ptr, uint32_t size)
 {
+    if (IS_TLSF(allocator))
+        return tlsf_realloc(TO_TLSF(allocator), ptr, size);
     return gc_realloc_vo((gc_handle_t)allocator, ptr, size);
 }
 
 void
 mem_allocator_free(mem_allocator_t allocator, void *ptr)
 {
-    if (ptr)
+    if (!ptr)
+        return;
+    if (IS_TLSF(allocator))
+        tlsf_free(TO_TLSF(allocator), ptr);
+    else
         gc_free_vo((gc_handle_t)allocator, ptr);
 }
 
+uint32
+mem_allocator_malloc_batch(mem_allocator_t allocator, uint32_t size,
+                           void **ptrs, uint32 count)
+{
+    if (IS_TLSF(allocator))
+        return tlsf_malloc_batch(TO_TLSF(allocator), size, ptrs, count);
+    return gc_alloc_vo_batch((gc_handle_t)allocator, size,
+                             (gc_object_t *)ptrs, count);
+}
+
+void
+mem_allocator_free_batch(mem_allocator_t allocator, void **ptrs, uint32 count)
+{
+    if (IS_TLSF(allocator))
+        tlsf_free_batch(TO_TLSF(allocator), ptrs, count);
+    else
+        gc_free_vo_batch((gc_handle_t)allocator, (gc_object_t *)ptrs, count);
+}
+
+uint32
+mem_allocator_get_usable_size(mem_allocator_t allocator, void *ptr)
+{
+    if (IS_TLSF(allocator))
+        return tlsf_get_usable_size(TO_TLSF(allocator), ptr);
+    return gc_get_vo_size((gc_handle_t)allocator, (gc_object_t)ptr);
+}
+
 #if WASM_ENABLE_GC != 0
 void *
 mem_allocator_malloc_with_gc(mem_allocator_t allocator, uint32_t size)
@@ -98,19 +170,52 @@ int
 mem_allocator_migrate(mem_allocator_t allocator, char *pool_buf_new,
                       uint32 pool_buf_size)
 {
+    if (IS_TLSF(allocator))
+        return -1;
     return gc_migrate((gc_handle_t)allocator, pool_buf_new, pool_buf_size);
 }
 
+void
+mem_allocator_save_state(mem_allocator_t allocator, void *state)
+{
+    bh_assert(!IS_TLSF(allocator));
+    gc_save_state((gc_handle_t)allocator, state);
+}
+
+int
+mem_allocator_restore_state(mem_allocator_t allocator, const void *state,
+                            char *pool_buf, uint32 pool_buf_size)
+{
+    if (IS_TLSF(allocator))
+        return -1;
+    return gc_restore_state((gc_handle_t)allocator, state, pool_buf,
+                            pool_buf_size);
+}
+
+int
+mem_allocator_reset(mem_allocator_t allocator, char *pool_buf,
+                    uint32 pool_buf_size)
+{
+    if (IS_TLSF(allocator))
+        return -1;
+    return gc_reset((gc_handle_t)allocator, pool_buf, pool_buf_size);
+}
+
 bool
 mem_allocator_is_heap_corrupted(mem_allocator_t allocator)
 {
+    if (IS_TLSF(allocator))
+        return tlsf_is_heap_corrupted(TO_TLSF(allocator));
     return gc_is_heap_corrupted((gc_handle_t)allocator);
 }
 
 bool
 mem_allocator_get_alloc_info(mem_allocator_t allocator, void *mem_alloc_info)
 {
-    gc_heap_stats((gc_handle_t)allocator, mem_alloc_info, 3);
+    if (IS_TLSF(allocator))
+        tlsf_heap_stats(TO_TLSF(allocator), (uint32 *)mem_alloc_info, 3);
+    else
+        gc_heap_stats((gc_handle_t)allocator, mem_alloc_info, 3);
     return true;
 }
 
@@ -137,116 +242,3 @@ mem_allocator_dump_perf_profiling(mem_allocator_t allocator)
 #endif
 
 #endif
-
-#else /* else of DEFAULT_MEM_ALLOCATOR */
-
-#include "tlsf/tlsf.h"
-
-typedef struct mem_allocator_tlsf {
-    tlsf_t tlsf;
-    korp_mutex lock;
-} mem_allocator_tlsf;
-
-mem_allocator_t
-mem_allocator_create(void *mem, uint32_t size)
-{
-    mem_allocator_tlsf *allocator_tlsf;
-    tlsf_t tlsf;
-    char *mem_aligned = (char *)(((uintptr_t)mem + 3) & ~3);
-
-    if (size < 1024) {
-        printf("Create mem allocator failed: pool size must be "
-               "at least 1024 bytes.\n");
-        return NULL;
-    }
-
-    size -= mem_aligned - (char *)mem;
-    mem = (void *)mem_aligned;
-
-    tlsf = tlsf_create_with_pool(mem, size);
-    if (!tlsf) {
-        printf("Create mem allocator failed: tlsf_create_with_pool failed.\n");
-        return NULL;
-    }
-
-    allocator_tlsf = tlsf_malloc(tlsf, sizeof(mem_allocator_tlsf));
-    if (!allocator_tlsf) {
-        printf("Create mem allocator failed: tlsf_malloc failed.\n");
-        tlsf_destroy(tlsf);
-        return NULL;
-    }
-
-    allocator_tlsf->tlsf = tlsf;
-
-    if (os_mutex_init(&allocator_tlsf->lock)) {
-        printf("Create mem allocator failed: tlsf_malloc failed.\n");
-        tlsf_free(tlsf, allocator_tlsf);
-        tlsf_destroy(tlsf);
-        return NULL;
-    }
-
-    return allocator_tlsf;
-}
-
-void
-mem_allocator_destroy(mem_allocator_t allocator)
-{
-    mem_allocator_tlsf *allocator_tlsf = (mem_allocator_tlsf *)allocator;
-    tlsf_t tlsf = allocator_tlsf->tlsf;
-
-    os_mutex_destroy(&allocator_tlsf->lock);
-    tlsf_free(tlsf, allocator_tlsf);
-    tlsf_destroy(tlsf);
-}
-
-void *
-mem_allocator_malloc(mem_allocator_t allocator, uint32_t size)
-{
-    void *ret;
-    mem_allocator_tlsf *allocator_tlsf = (mem_allocator_tlsf *)allocator;
-
-    if (size == 0)
-        /* tlsf doesn't allow to allocate 0 byte */
-        size = 1;
-
-    os_mutex_lock(&allocator_tlsf->lock);
-    ret = tlsf_malloc(allocator_tlsf->tlsf, size);
-    os_mutex_unlock(&allocator_tlsf->lock);
-    return ret;
-}
-
-void *
-mem_allocator_realloc(mem_allocator_t allocator, void *ptr, uint32_t size)
-{
-    void *ret;
-    mem_allocator_tlsf *allocator_tlsf = (mem_allocator_tlsf *)allocator;
-
-    if (size == 0)
-        /* tlsf doesn't allow to allocate 0 byte */
-        size = 1;
-
-    os_mutex_lock(&allocator_tlsf->lock);
-    ret = tlsf_realloc(allocator_tlsf->tlsf, ptr, size);
-    os_mutex_unlock(&allocator_tlsf->lock);
-    return ret;
-}
-
-void
-mem_allocator_free(mem_allocator_t allocator, void *ptr)
-{
-    if (ptr) {
-        mem_allocator_tlsf *allocator_tlsf = (mem_allocator_tlsf *)allocator;
-        os_mutex_lock(&allocator_tlsf->lock);
-        tlsf_free(allocator_tlsf->tlsf, ptr);
-        os_mutex_unlock(&allocator_tlsf->lock);
-    }
-}
-
-int
-mem_allocator_migrate(mem_allocator_t allocator, mem_allocator_t allocator_old)
-{
-    return tlsf_migrate((mem_allocator_tlsf *)allocator,
-                        (mem_allocator_tlsf *)allocator_old);
-}
-
-#endif /* end of DEFAULT_MEM_ALLOCATOR */
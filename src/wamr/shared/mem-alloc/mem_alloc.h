@@ -25,6 +25,13 @@ typedef void (*gc_finalizer_t)(void *obj, void *data);
 mem_allocator_t
 mem_allocator_create(void *mem, uint32_t size);
 
+/* Create an allocator of the given kind, MEM_ALLOCATOR_EMS or
+   MEM_ALLOCATOR_TLSF, mem_allocator_create() uses DEFAULT_MEM_ALLOCATOR */
+mem_allocator_t
+mem_allocator_create_with_kind(void *mem, uint32_t size, int kind);
+
+/* Create an EMS allocator in a zeroed pool, e.g. the app heap part of a new
+   linear memory, with its heap structure in struct_buf */
 mem_allocator_t
 mem_allocator_create_with_struct_and_pool(void *struct_buf,
                                           uint32_t struct_buf_size,
@@ -46,10 +53,42 @@ mem_allocator_realloc(mem_allocator_t allocator, void *ptr, uint32_t size);
 void
 mem_allocator_free(mem_allocator_t allocator, void *ptr);
 
+/* Allocate up to count blocks of size under one lock, returns the number
+   of blocks stored in ptrs */
+uint32
+mem_allocator_malloc_batch(mem_allocator_t allocator, uint32_t size,
+                           void **ptrs, uint32 count);
+
+/* Free count blocks under one lock */
+void
+mem_allocator_free_batch(mem_allocator_t allocator, void **ptrs, uint32 count);
+
+/* Usable size of an allocated block, at least the size it was allocated
+   with */
+uint32
+mem_allocator_get_usable_size(mem_allocator_t allocator, void *ptr);
+
 int
 mem_allocator_migrate(mem_allocator_t allocator, char *pool_buf_new,
                       uint32 pool_buf_size);
 
+/* Save the state of an EMS allocator into a buffer of
+   mem_allocator_get_heap_struct_size() bytes */
+void
+mem_allocator_save_state(mem_allocator_t allocator, void *state);
+
+/* Bring an EMS allocator back to a saved state, of itself or of another
+   allocator, once its pool holds a copy of the pool the state was saved
+   from */
+int
+mem_allocator_restore_state(mem_allocator_t allocator, const void *state,
+                            char *pool_buf, uint32 pool_buf_size);
+
+/* Empty an EMS allocator in place over its pool, which must be zeroed */
+int
+mem_allocator_reset(mem_allocator_t allocator, char *pool_buf,
+                    uint32 pool_buf_size);
+
 bool
 mem_allocator_is_heap_corrupted(mem_allocator_t allocator);
 
@@ -0,0 +1,540 @@
+/*
+ * Copyright (C) 2025 WAMR-ESP32-Arduino Contributors
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "tlsf.h"
+#include "bh_log.h"
+
+#if WASM_ENABLE_TLSF_ALLOCATOR != 0
+
+/* Block sizes are multiples of 8 */
+#define TLSF_ALIGN_LOG2 3
+#define TLSF_ALIGN (1U << TLSF_ALIGN_LOG2)
+
+/* Linear subdivisions of each power of two */
+#define TLSF_SL_LOG2 4
+#define TLSF_SL_COUNT (1U << TLSF_SL_LOG2)
+
+/* Blocks smaller than this are all in first level 0, in lists that are
+   TLSF_ALIGN apart */
+#define TLSF_FL_SHIFT (TLSF_SL_LOG2 + TLSF_ALIGN_LOG2)
+#define TLSF_SMALL_BLOCK (1U << TLSF_FL_SHIFT)
+
+/* Blocks are smaller than 1 << TLSF_FL_MAX (256MB) */
+#define TLSF_FL_MAX 28
+#define TLSF_FL_COUNT (TLSF_FL_MAX - TLSF_FL_SHIFT + 1)
+
+/* The header holds the size of the block including the header, and the
+   flags in the low bits that the alignment leaves clear */
+#define TLSF_HEADER_SIZE 4
+#define TLSF_BLOCK_FREE 1U
+#define TLSF_PREV_FREE 2U
+#define TLSF_FLAG_MASK (TLSF_ALIGN - 1)
+
+/* A free block holds its list links after the header and its size in
+   its last 4 bytes, where the next block finds it to merge backwards */
+typedef struct tlsf_block tlsf_block_t;
+
+typedef struct tlsf_links {
+    tlsf_block_t *next_free;
+    tlsf_block_t *prev_free;
+} tlsf_links_t;
+
+#define TLSF_ALIGN_UP(s) (((s) + TLSF_ALIGN - 1) & ~(uintptr_t)(TLSF_ALIGN - 1))
+#define TLSF_BLOCK_MIN \
+    TLSF_ALIGN_UP(TLSF_HEADER_SIZE + sizeof(tlsf_links_t) + 4)
+
+/* Entries of a size class list that malloc checks when the rounded-up
+   search finds nothing. Walking the whole list would make malloc O(n) in
+   a pool full of holes of one class; stopping early keeps it constant
+   time, but a block further down the list is then not found and malloc
+   fails as if the pool were full */
+#define TLSF_WALK_MAX 8
+
+/* Largest request whose block size can be computed without overflow */
+#define TLSF_MAX_REQUEST ((1U << TLSF_FL_MAX) - TLSF_SMALL_BLOCK)
+
+#define BLOCK_HEADER(b) (*(uint32 *)(b))
+#define BLOCK_SIZE(b) (BLOCK_HEADER(b) & ~TLSF_FLAG_MASK)
+#define BLOCK_IS_FREE(b) (BLOCK_HEADER(b) & TLSF_BLOCK_FREE)
+#define BLOCK_IS_PREV_FREE(b) (BLOCK_HEADER(b) & TLSF_PREV_FREE)
+#define BLOCK_TO_PTR(b) ((void *)((uint8 *)(b) + TLSF_HEADER_SIZE))
+#define PTR_TO_BLOCK(p) ((tlsf_block_t *)((uint8 *)(p)-TLSF_HEADER_SIZE))
+#define BLOCK_LINKS(b) ((tlsf_links_t *)BLOCK_TO_PTR(b))
+#define BLOCK_NEXT(b) ((tlsf_block_t *)((uint8 *)(b) + BLOCK_SIZE(b)))
+#define BLOCK_PREV(b) \
+    ((tlsf_block_t *)((uint8 *)(b) - *(uint32 *)((uint8 *)(b)-4)))
+
+struct tlsf_heap {
+    /* First block and the zero-size used block that ends the heap */
+    uint8 *base_addr;
+    uint8 *end_addr;
+
+    korp_mutex lock;
+
+    uint32 total_size;
+    uint32 total_free_size;
+    uint32 highmark_size;
+    bool is_heap_corrupted;
+
+    uint32 fl_bitmap;
+    uint32 sl_bitmap[TLSF_FL_COUNT];
+    tlsf_block_t *blocks[TLSF_FL_COUNT][TLSF_SL_COUNT];
+};
+
+static inline uint32
+tlsf_fls(uint32 word)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return 31 - (uint32)__builtin_clz(word);
+#else
+    uint32 bit = 31;
+
+    while (!(word & (1U << bit)))
+        bit--;
+    return bit;
+#endif
+}
+
+static inline uint32
+tlsf_ffs(uint32 word)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return (uint32)__builtin_ctz(word);
+#else
+    uint32 bit = 0;
+
+    while (!(word & (1U << bit)))
+        bit++;
+    return bit;
+#endif
+}
+
+static inline void
+mapping_insert(uint32 size, uint32 *fl, uint32 *sl)
+{
+    uint32 t;
+
+    if (size < TLSF_SMALL_BLOCK) {
+        *fl = 0;
+        *sl = size >> TLSF_ALIGN_LOG2;
+    }
+    else {
+        t = tlsf_fls(size);
+        *sl = (size >> (t - TLSF_SL_LOG2)) ^ TLSF_SL_COUNT;
+        *fl = t - TLSF_FL_SHIFT + 1;
+    }
+}
+
+static inline void
+block_set_size(tlsf_block_t *b, uint32 size)
+{
+    BLOCK_HEADER(b) = size | (BLOCK_HEADER(b) & TLSF_FLAG_MASK);
+}
+
+static void
+insert_free_block(tlsf_heap_t *heap, tlsf_block_t *b)
+{
+    uint32 size = BLOCK_SIZE(b), fl, sl;
+    tlsf_links_t *links = BLOCK_LINKS(b);
+    tlsf_block_t *head;
+
+    mapping_insert(size, &fl, &sl);
+    head = heap->blocks[fl][sl];
+    links->next_free = head;
+    links->prev_free = NULL;
+    if (head)
+        BLOCK_LINKS(head)->prev_free = b;
+    heap->blocks[fl][sl] = b;
+    heap->fl_bitmap |= 1U << fl;
+    heap->sl_bitmap[fl] |= 1U << sl;
+
+    /* The footer lets the next block find this one */
+    *(uint32 *)((uint8 *)b + size - 4) = size;
+    heap->total_free_size += size;
+}
+
+static void
+remove_free_block(tlsf_heap_t *heap, tlsf_block_t *b)
+{
+    tlsf_links_t *links = BLOCK_LINKS(b);
+    uint32 fl, sl;
+
+    mapping_insert(BLOCK_SIZE(b), &fl, &sl);
+    if (links->next_free)
+        BLOCK_LINKS(links->next_free)->prev_free = links->prev_free;
+    if (links->prev_free) {
+        BLOCK_LINKS(links->prev_free)->next_free = links->next_free;
+    }
+    else {
+        heap->blocks[fl][sl] = links->next_free;
+        if (!links->next_free) {
+            heap->sl_bitmap[fl] &= ~(1U << sl);
+            if (!heap->sl_bitmap[fl])
+                heap->fl_bitmap &= ~(1U << fl);
+        }
+    }
+    heap->total_free_size -= BLOCK_SIZE(b);
+}
+
+/* Set the flags of a block and of the next one for its new state */
+static inline void
+mark_free(tlsf_block_t *b)
+{
+    BLOCK_HEADER(b) |= TLSF_BLOCK_FREE;
+    BLOCK_HEADER(BLOCK_NEXT(b)) |= TLSF_PREV_FREE;
+}
+
+static inline void
+mark_used(tlsf_block_t *b)
+{
+    BLOCK_HEADER(b) &= ~TLSF_BLOCK_FREE;
+    BLOCK_HEADER(BLOCK_NEXT(b)) &= ~TLSF_PREV_FREE;
+}
+
+/* Split the tail off a used block if it is big enough to be a block,
+   merging it with the next block if that one is free */
+static void
+trim_used_block(tlsf_heap_t *heap, tlsf_block_t *b, uint32 size)
+{
+    uint32 rest = BLOCK_SIZE(b) - size;
+    tlsf_block_t *tail, *next;
+
+    if (rest < TLSF_BLOCK_MIN)
+        return;
+
+    block_set_size(b, size);
+    tail = BLOCK_NEXT(b);
+    BLOCK_HEADER(tail) = rest;
+    next = BLOCK_NEXT(tail);
+    if (BLOCK_IS_FREE(next)) {
+        remove_free_block(heap, next);
+        block_set_size(tail, rest + BLOCK_SIZE(next));
+    }
+    mark_free(tail);
+    insert_free_block(heap, tail);
+}
+
+static tlsf_block_t *
+find_free_block(tlsf_heap_t *heap, uint32 size)
+{
+    uint32 search = size, fl, sl, sl_map, fl_map, n;
+    tlsf_block_t *b;
+
+    /* Round up to the next list so that any block found is big enough,
+       this is what makes the search constant time */
+    if (size >= TLSF_SMALL_BLOCK)
+        search += (1U << (tlsf_fls(size) - TLSF_SL_LOG2)) - 1;
+    mapping_insert(search, &fl, &sl);
+
+    if (fl < TLSF_FL_COUNT) {
+        sl_map = heap->sl_bitmap[fl] & (~0U << sl);
+        if (!sl_map) {
+            fl_map = heap->fl_bitmap & (~0U << (fl + 1));
+            if (fl_map) {
+                fl = tlsf_ffs(fl_map);
+                sl_map = heap->sl_bitmap[fl];
+            }
+        }
+        if (sl_map) {
+            b = heap->blocks[fl][tlsf_ffs(sl_map)];
+            remove_free_block(heap, b);
+            return b;
+        }
+    }
+
+    /* Otherwise only the list of the size itself may hold a block that is
+       big enough, check the first few of it rather than fail */
+    mapping_insert(size, &fl, &sl);
+    for (b = heap->blocks[fl][sl], n = 0; b && n < TLSF_WALK_MAX;
+         b = BLOCK_LINKS(b)->next_free, n++) {
+        if (BLOCK_SIZE(b) >= size) {
+            remove_free_block(heap, b);
+            return b;
+        }
+    }
+    return NULL;
+}
+
+static void *
+malloc_locked(tlsf_heap_t *heap, uint32 size)
+{
+    tlsf_block_t *b;
+    uint32 block_size, used_size;
+
+    if (size > TLSF_MAX_REQUEST)
+        return NULL;
+
+    block_size = (uint32)TLSF_ALIGN_UP(size + TLSF_HEADER_SIZE);
+    if (block_size < TLSF_BLOCK_MIN)
+        block_size = TLSF_BLOCK_MIN;
+
+    if (!(b = find_free_block(heap, block_size)))
+        return NULL;
+
+    mark_used(b);
+    trim_used_block(heap, b, block_size);
+
+    used_size = heap->total_size - heap->total_free_size;
+    if (used_size > heap->highmark_size)
+        heap->highmark_size = used_size;
+    return BLOCK_TO_PTR(b);
+}
+
+/* Check that ptr is an allocated block of the heap, returns the block or
+   NULL */
+static tlsf_block_t *
+get_used_block(tlsf_heap_t *heap, void *ptr, bool *in_heap)
+{
+    tlsf_block_t *b = PTR_TO_BLOCK(ptr);
+    uint32 size;
+
+    *in_heap = (uint8 *)b >= heap->base_addr && (uint8 *)b < heap->end_addr;
+    if (!*in_heap)
+        return NULL;
+
+    if (((uintptr_t)ptr & (TLSF_ALIGN - 1)) || BLOCK_IS_FREE(b))
+        return NULL;
+
+    size = BLOCK_SIZE(b);
+    if (size < TLSF_BLOCK_MIN
+        || size > (uint32)(heap->end_addr - (uint8 *)b)) {
+        heap->is_heap_corrupted = true;
+        return NULL;
+    }
+    return b;
+}
+
+static int
+free_locked(tlsf_heap_t *heap, void *ptr)
+{
+    tlsf_block_t *b, *next, *prev;
+    bool in_heap;
+
+    if (!ptr)
+        return 0;
+
+    if (!(b = get_used_block(heap, ptr, &in_heap))) {
+        if (!in_heap)
+            return 0;
+        LOG_ERROR("[TLSF_ERROR]free %p failed: not an allocated block\n",
+                  ptr);
+        return -1;
+    }
+
+    if (BLOCK_IS_PREV_FREE(b)) {
+        prev = BLOCK_PREV(b);
+        remove_free_block(heap, prev);
+        block_set_size(prev, BLOCK_SIZE(prev) + BLOCK_SIZE(b));
+        b = prev;
+    }
+    next = BLOCK_NEXT(b);
+    if (BLOCK_IS_FREE(next)) {
+        remove_free_block(heap, next);
+        block_set_size(b, BLOCK_SIZE(b) + BLOCK_SIZE(next));
+    }
+    mark_free(b);
+    insert_free_block(heap, b);
+    return 0;
+}
+
+tlsf_heap_t *
+tlsf_create_with_pool(void *buf, uint32 buf_size)
+{
+    uintptr_t buf_end = (uintptr_t)buf + buf_size;
+    tlsf_heap_t *heap;
+    tlsf_block_t *b;
+    uint8 *base_addr, *end_addr;
+
+    heap = (tlsf_heap_t *)TLSF_ALIGN_UP((uintptr_t)buf);
+    /* Headers are 4 bytes before an 8-byte boundary so that user data is
+       8-byte aligned */
+    base_addr = (uint8 *)heap + TLSF_ALIGN_UP(sizeof(tlsf_heap_t))
+                + TLSF_ALIGN - TLSF_HEADER_SIZE;
+    end_addr = (uint8 *)((buf_end - TLSF_ALIGN) & ~(uintptr_t)(TLSF_ALIGN - 1))
+               + TLSF_ALIGN - TLSF_HEADER_SIZE;
+
+    if (buf_size < sizeof(tlsf_heap_t) + 2 * TLSF_ALIGN + TLSF_BLOCK_MIN
+        || end_addr < base_addr + TLSF_BLOCK_MIN) {
+        LOG_ERROR("[TLSF_ERROR]heap init buf size (%" PRIu32
+                  ") is too small\n",
+                  buf_size);
+        return NULL;
+    }
+    if ((uint32)(end_addr - base_addr) >= (1U << TLSF_FL_MAX)) {
+        LOG_ERROR("[TLSF_ERROR]heap init buf size (%" PRIu32
+                  ") is too large\n",
+                  buf_size);
+        return NULL;
+    }
+
+    memset(heap, 0, sizeof(tlsf_heap_t));
+    if (os_mutex_init(&heap->lock) != 0) {
+        LOG_ERROR("[TLSF_ERROR]failed to init lock\n");
+        return NULL;
+    }
+
+    heap->base_addr = base_addr;
+    heap->end_addr = end_addr;
+    heap->total_size = (uint32)(end_addr - base_addr);
+
+    /* One free block followed by the end marker, which is never free so
+       that merges stop there */
+    b = (tlsf_block_t *)base_addr;
+    BLOCK_HEADER(b) = heap->total_size;
+    BLOCK_HEADER(end_addr) = 0;
+    mark_free(b);
+    insert_free_block(heap, b);
+    return heap;
+}
+
+void
+tlsf_destroy(tlsf_heap_t *heap)
+{
+    os_mutex_destroy(&heap->lock);
+}
+
+void *
+tlsf_malloc(tlsf_heap_t *heap, uint32 size)
+{
+    void *ptr;
+
+    os_mutex_lock(&heap->lock);
+    ptr = malloc_locked(heap, size);
+    os_mutex_unlock(&heap->lock);
+    return ptr;
+}
+
+void *
+tlsf_realloc(tlsf_heap_t *heap, void *ptr, uint32 size)
+{
+    tlsf_block_t *b, *next;
+    uint32 block_size, old_size, used_size;
+    void *ptr_new = NULL;
+    bool in_heap;
+
+    if (!ptr)
+        return tlsf_malloc(heap, size);
+    if (size > TLSF_MAX_REQUEST)
+        return NULL;
+
+    block_size = (uint32)TLSF_ALIGN_UP(size + TLSF_HEADER_SIZE);
+    if (block_size < TLSF_BLOCK_MIN)
+        block_size = TLSF_BLOCK_MIN;
+
+    os_mutex_lock(&heap->lock);
+
+    if (!(b = get_used_block(heap, ptr, &in_heap))) {
+        os_mutex_unlock(&heap->lock);
+        LOG_ERROR("[TLSF_ERROR]realloc %p failed: not an allocated block\n",
+                  ptr);
+        return NULL;
+    }
+
+    old_size = BLOCK_SIZE(b);
+    next = BLOCK_NEXT(b);
+    if (block_size > old_size && BLOCK_IS_FREE(next)
+        && old_size + BLOCK_SIZE(next) >= block_size) {
+        /* Grow into the next block */
+        remove_free_block(heap, next);
+        block_set_size(b, old_size + BLOCK_SIZE(next));
+        mark_used(b);
+    }
+
+    if (block_size <= BLOCK_SIZE(b)) {
+        trim_used_block(heap, b, block_size);
+        used_size = heap->total_size - heap->total_free_size;
+        if (used_size > heap->highmark_size)
+            heap->highmark_size = used_size;
+        os_mutex_unlock(&heap->lock);
+        return ptr;
+    }
+
+    if ((ptr_new = malloc_locked(heap, size))) {
+        bh_memcpy_s(ptr_new, size, ptr, old_size - TLSF_HEADER_SIZE);
+        free_locked(heap, ptr);
+    }
+    os_mutex_unlock(&heap->lock);
+    return ptr_new;
+}
+
+int
+tlsf_free(tlsf_heap_t *heap, void *ptr)
+{
+    int ret;
+
+    os_mutex_lock(&heap->lock);
+    ret = free_locked(heap, ptr);
+    os_mutex_unlock(&heap->lock);
+    return ret;
+}
+
+uint32
+tlsf_malloc_batch(tlsf_heap_t *heap, uint32 size, void **ptrs, uint32 count)
+{
+    uint32 i;
+
+    os_mutex_lock(&heap->lock);
+    for (i = 0; i < count; i++) {
+        if (!(ptrs[i] = malloc_locked(heap, size)))
+            break;
+    }
+    os_mutex_unlock(&heap->lock);
+    return i;
+}
+
+void
+tlsf_free_batch(tlsf_heap_t *heap, void **ptrs, uint32 count)
+{
+    uint32 i;
+
+    os_mutex_lock(&heap->lock);
+    for (i = 0; i < count; i++)
+        free_locked(heap, ptrs[i]);
+    os_mutex_unlock(&heap->lock);
+}
+
+uint32
+tlsf_get_usable_size(tlsf_heap_t *heap, void *ptr)
+{
+    tlsf_block_t *b;
+    bool in_heap;
+
+    if (!ptr || !(b = get_used_block(heap, ptr, &in_heap)))
+        return 0;
+    return BLOCK_SIZE(b) - TLSF_HEADER_SIZE;
+}
+
+bool
+tlsf_is_heap_corrupted(tlsf_heap_t *heap)
+{
+    return heap->is_heap_corrupted;
+}
+
+void
+tlsf_heap_stats(tlsf_heap_t *heap, uint32 *stats, int size)
+{
+    int i;
+
+    os_mutex_lock(&heap->lock);
+    for (i = 0; i < size; i++) {
+        switch (i) {
+            case 0:
+                stats[i] = heap->total_size;
+                break;
+            case 1:
+                stats[i] = heap->total_free_size;
+                break;
+            case 2:
+                stats[i] = heap->highmark_size;
+                break;
+            default:
+                stats[i] = 0;
+                break;
+        }
+    }
+    os_mutex_unlock(&heap->lock);
+}
+
+#endif /* end of WASM_ENABLE_TLSF_ALLOCATOR != 0 */
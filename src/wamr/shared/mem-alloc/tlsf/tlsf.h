@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2025 WAMR-ESP32-Arduino Contributors
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+/**
+ * Two-Level Segregated Fit allocator
+ *
+ * Free blocks are kept in lists indexed by a first level (power of two
+ * of the size) and a second level (TLSF_SL_COUNT linear steps within it),
+ * with a bitmap per level. malloc and free find, split and merge blocks
+ * with a fixed number of steps whatever the heap state, so their latency
+ * is bounded, unlike the EMS tree walk.
+ *
+ * Blocks have a 4-byte header and are 8-byte aligned, like EMS blocks.
+ */
+
+#ifndef _TLSF_H
+#define _TLSF_H
+
+#include "bh_platform.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct tlsf_heap tlsf_heap_t;
+
+/**
+ * Create a heap whose control structure and blocks are all in the pool
+ *
+ * @return the heap, or NULL if the pool is too small or too large
+ */
+tlsf_heap_t *
+tlsf_create_with_pool(void *buf, uint32 buf_size);
+
+void
+tlsf_destroy(tlsf_heap_t *heap);
+
+void *
+tlsf_malloc(tlsf_heap_t *heap, uint32 size);
+
+void *
+tlsf_realloc(tlsf_heap_t *heap, void *ptr, uint32 size);
+
+/**
+ * Free a block, pointers outside the heap are ignored
+ *
+ * @return 0 on success, -1 if ptr isn't an allocated block
+ */
+int
+tlsf_free(tlsf_heap_t *heap, void *ptr);
+
+/* Allocate up to count blocks of size under one lock, returns the number
+   of blocks stored in ptrs */
+uint32
+tlsf_malloc_batch(tlsf_heap_t *heap, uint32 size, void **ptrs, uint32 count);
+
+void
+tlsf_free_batch(tlsf_heap_t *heap, void **ptrs, uint32 count);
+
+/* Usable size of an allocated block, 0 if ptr isn't one */
+uint32
+tlsf_get_usable_size(tlsf_heap_t *heap, void *ptr);
+
+bool
+tlsf_is_heap_corrupted(tlsf_heap_t *heap);
+
+/* Fill stats with the total, free and high-mark sizes, in the order of
+   mem_alloc_info_t */
+void
+tlsf_heap_stats(tlsf_heap_t *heap, uint32 *stats, int size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* end of _TLSF_H */
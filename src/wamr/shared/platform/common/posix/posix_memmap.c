@@ -264,6 +264,62 @@ os_mremap(void *old_addr, size_t old_size, size_t new_size)
 }
 #endif
 
+#ifdef OS_ENABLE_COW_MAPPING
+os_file_handle
+os_create_cow_file(const void *data, size_t data_size, size_t file_size)
+{
+    const uint8 *p = data;
+    size_t done = 0;
+    ssize_t n;
+    int fd;
+
+    if ((fd = memfd_create("wamr-cow", MFD_CLOEXEC)) < 0)
+        return os_get_invalid_handle();
+
+    if (ftruncate(fd, (off_t)file_size) != 0)
+        goto fail;
+
+    while (done < data_size) {
+        n = pwrite(fd, p + done, data_size - done, (off_t)done);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            goto fail;
+        done += (size_t)n;
+    }
+    return fd;
+
+fail:
+    close(fd);
+    return os_get_invalid_handle();
+}
+
+void *
+os_mmap_cow(void *hint, size_t size, int prot, int flags, os_file_handle file)
+{
+    int map_prot = PROT_NONE, map_flags = MAP_PRIVATE;
+    void *addr;
+
+    if (prot & MMAP_PROT_READ)
+        map_prot |= PROT_READ;
+
+    if (prot & MMAP_PROT_WRITE)
+        map_prot |= PROT_WRITE;
+
+    if (flags & MMAP_MAP_FIXED)
+        map_flags |= MAP_FIXED;
+
+    addr = mmap(hint, size, map_prot, map_flags, file, 0);
+    return addr != MAP_FAILED ? addr : NULL;
+}
+
+void
+os_close_cow_file(os_file_handle file)
+{
+    close(file);
+}
+#endif /* end of OS_ENABLE_COW_MAPPING */
+
 int
 os_mprotect(void *addr, size_t size, int prot)
 {
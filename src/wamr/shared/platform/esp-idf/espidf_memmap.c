@@ -43,10 +43,12 @@ os_mmap(void *hint, size_t size, int prot, int flags, os_file_handle file)
         uintptr_t *addr_field = buf_fixed - sizeof(uintptr_t);
         *addr_field = (uintptr_t)buf_origin;
 #if (WASM_MEM_DUAL_BUS_MIRROR != 0)
-        memset(buf_fixed + MEM_DUAL_BUS_OFFSET, 0, size);
+        if (!(flags & MMAP_MAP_NOZERO))
+            memset(buf_fixed + MEM_DUAL_BUS_OFFSET, 0, size);
         return buf_fixed + MEM_DUAL_BUS_OFFSET;
 #else
-        memset(buf_fixed, 0, size);
+        if (!(flags & MMAP_MAP_NOZERO))
+            memset(buf_fixed, 0, size);
         return buf_fixed;
 #endif
     }
@@ -73,7 +75,11 @@ os_mmap(void *hint, size_t size, int prot, int flags, os_file_handle file)
         uintptr_t *addr_field = buf_fixed - sizeof(uintptr_t);
         *addr_field = (uintptr_t)buf_origin;
 
-        memset(buf_fixed, 0, size);
+        /* heap_caps_malloc() doesn't zero, unlike a fresh mmap elsewhere,
+           and each pass over PSRAM is slow, so skip it when the caller
+           fills the buffer anyway */
+        if (!(flags & MMAP_MAP_NOZERO))
+            memset(buf_fixed, 0, size);
         return buf_fixed;
     }
 }
@@ -81,7 +87,20 @@ os_mmap(void *hint, size_t size, int prot, int flags, os_file_handle file)
 void *
 os_mremap(void *old_addr, size_t old_size, size_t new_size)
 {
-    return os_mremap_slow(old_addr, old_size, new_size);
+    /* As os_mremap_slow(), but only the bytes past the copy are zeroed */
+    size_t copy_size = new_size < old_size ? new_size : old_size;
+    void *new_memory =
+        os_mmap(NULL, new_size, MMAP_PROT_WRITE | MMAP_PROT_READ,
+                MMAP_MAP_NOZERO, os_get_invalid_handle());
+
+    if (!new_memory) {
+        return NULL;
+    }
+    memcpy(new_memory, old_addr, copy_size);
+    memset((char *)new_memory + copy_size, 0, new_size - copy_size);
+    os_munmap(old_addr, old_size);
+
+    return new_memory;
 }
 
 void
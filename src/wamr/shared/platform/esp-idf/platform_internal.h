@@ -44,6 +44,9 @@ typedef unsigned int korp_sem;
 
 #define OS_THREAD_MUTEX_INITIALIZER PTHREAD_MUTEX_INITIALIZER
 
+/* The toolchain supports __thread, the TLS area is part of each task */
+#define os_thread_local_attribute __thread
+
 #define BH_APPLET_PRESERVED_STACK_SIZE (2 * BH_KB)
 
 /* Default thread priority */
@@ -133,6 +133,10 @@ enum {
     /* Don't interpret addr as a hint: place the mapping at exactly
        that address. */
     MMAP_MAP_FIXED = 2,
+    /* The caller writes or zeroes every byte itself, so the mapping may
+       be left uninitialized. Platforms whose fresh mappings are always
+       zero ignore it. */
+    MMAP_MAP_NOZERO = 4,
 };
 
 void *
@@ -165,6 +169,29 @@ os_mremap_slow(void *old_addr, size_t old_size, size_t new_size)
 void *
 os_mremap(void *old_addr, size_t old_size, size_t new_size);
 
+#ifdef OS_ENABLE_COW_MAPPING
+/**
+ * Create an anonymous file of file_size bytes that starts with a copy of
+ * data_size bytes of data, for os_mmap_cow(). The bytes after them read
+ * as zero. Returns os_get_invalid_handle() on failure.
+ */
+os_file_handle
+os_create_cow_file(const void *data, size_t data_size, size_t file_size);
+
+/**
+ * Map the first size bytes of a file of os_create_cow_file() privately:
+ * writes go to copies of the pages, the file and other mappings of it are
+ * left unchanged. With MMAP_MAP_FIXED, replaces the pages at hint. Unmap
+ * with os_munmap().
+ */
+void *
+os_mmap_cow(void *hint, size_t size, int prot, int flags,
+            os_file_handle file);
+
+void
+os_close_cow_file(os_file_handle file);
+#endif
+
 #if (WASM_MEM_DUAL_BUS_MIRROR != 0)
 void *
 os_get_dbus_mirror(void *ibus);
@@ -0,0 +1,212 @@
+/*
+ * Copyright (C) 2025 WAMR-ESP32-Arduino Contributors
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "bh_arena.h"
+
+#define ARENA_ALIGN 8
+#define ARENA_ALIGN_UP(size) (((size) + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1))
+
+struct bh_arena_chunk {
+    bh_arena_chunk *next;
+    uint32 serial;
+    /* Bytes for blocks after the header */
+    uint32 size;
+    /* Bytes carved */
+    uint32 offset;
+    /* Offset of the last block carved, equal to offset if it has been
+       freed or resized */
+    uint32 last;
+};
+
+#define CHUNK_HEADER_SIZE ARENA_ALIGN_UP((uint32)sizeof(bh_arena_chunk))
+#define CHUNK_DATA(chunk) ((uint8 *)(chunk) + CHUNK_HEADER_SIZE)
+
+/* Largest block, so that a chunk holding it fits in uint32 */
+#define ARENA_MAX_BLOCK (UINT32_MAX - CHUNK_HEADER_SIZE - ARENA_ALIGN)
+
+void
+bh_arena_init(bh_arena *arena, uint32 first_chunk_size, uint32 chunk_size)
+{
+    bh_assert(first_chunk_size > 0 && first_chunk_size <= ARENA_MAX_BLOCK);
+    bh_assert(chunk_size > 0 && chunk_size <= ARENA_MAX_BLOCK);
+    memset(arena, 0, sizeof(bh_arena));
+    arena->chunk_size = ARENA_ALIGN_UP(chunk_size);
+    arena->next_chunk_size = ARENA_ALIGN_UP(first_chunk_size);
+}
+
+static void
+free_chunks_since(bh_arena *arena, uint32 serial)
+{
+    bh_arena_chunk **p_chunk = &arena->chunks, *chunk;
+
+    while ((chunk = *p_chunk)) {
+        if (chunk->serial >= serial) {
+            *p_chunk = chunk->next;
+            arena->total_size -= CHUNK_HEADER_SIZE + chunk->size;
+            BH_FREE(chunk);
+        }
+        else {
+            p_chunk = &chunk->next;
+        }
+    }
+}
+
+void
+bh_arena_destroy(bh_arena *arena)
+{
+    free_chunks_since(arena, 0);
+    memset(arena, 0, sizeof(bh_arena));
+}
+
+static bh_arena_chunk *
+create_chunk(bh_arena *arena, uint32 size)
+{
+    bh_arena_chunk *chunk;
+
+    if (!(chunk = BH_MALLOC(CHUNK_HEADER_SIZE + size)))
+        return NULL;
+
+    chunk->serial = arena->chunk_serial++;
+    chunk->size = size;
+    chunk->offset = chunk->last = 0;
+    arena->total_size += CHUNK_HEADER_SIZE + size;
+    return chunk;
+}
+
+static void *
+carve(bh_arena_chunk *chunk, uint32 size)
+{
+    chunk->last = chunk->offset;
+    chunk->offset += size;
+    return CHUNK_DATA(chunk) + chunk->last;
+}
+
+void *
+bh_arena_alloc(bh_arena *arena, uint32 size)
+{
+    bh_arena_chunk *chunk = arena->chunks;
+    uint32 chunk_size;
+
+    bh_assert(bh_arena_is_inited(arena));
+
+    if (size > ARENA_MAX_BLOCK)
+        return NULL;
+    size = size ? ARENA_ALIGN_UP(size) : ARENA_ALIGN;
+
+    if (chunk && chunk->size - chunk->offset >= size)
+        return carve(chunk, size);
+
+    if (size > arena->next_chunk_size / 2) {
+        if (!(chunk = create_chunk(arena, size)))
+            return NULL;
+        /* Keep carving the small blocks from the current chunk */
+        if (arena->chunks) {
+            chunk->next = arena->chunks->next;
+            arena->chunks->next = chunk;
+        }
+        else {
+            chunk->next = NULL;
+            arena->chunks = chunk;
+        }
+        return carve(chunk, size);
+    }
+
+    /* Try smaller chunks when the heap has no room for a whole one, down
+       to a chunk of just the block */
+    chunk_size = arena->next_chunk_size;
+    while (!(chunk = create_chunk(arena, chunk_size))) {
+        if (chunk_size == size)
+            return NULL;
+        chunk_size = ARENA_ALIGN_UP(chunk_size / 2);
+        if (chunk_size < size)
+            chunk_size = size;
+    }
+    arena->next_chunk_size = arena->chunk_size;
+    chunk->next = arena->chunks;
+    arena->chunks = chunk;
+    return carve(chunk, size);
+}
+
+static bh_arena_chunk *
+find_chunk(const bh_arena *arena, const void *ptr)
+{
+    bh_arena_chunk *chunk;
+
+    for (chunk = arena->chunks; chunk; chunk = chunk->next) {
+        if ((const uint8 *)ptr >= CHUNK_DATA(chunk)
+            && (const uint8 *)ptr < CHUNK_DATA(chunk) + chunk->size)
+            return chunk;
+    }
+    return NULL;
+}
+
+static bool
+is_last_block(const bh_arena_chunk *chunk, const void *ptr)
+{
+    return chunk->last < chunk->offset
+           && (const uint8 *)ptr == CHUNK_DATA(chunk) + chunk->last;
+}
+
+void *
+bh_arena_realloc(bh_arena *arena, void *ptr, uint32 size_old,
+                 uint32 size_new)
+{
+    bh_arena_chunk *chunk = find_chunk(arena, ptr);
+    void *ptr_new;
+
+    bh_assert(chunk);
+
+    if (chunk && is_last_block(chunk, ptr) && size_new <= ARENA_MAX_BLOCK
+        && chunk->size - chunk->last >= ARENA_ALIGN_UP(size_new)) {
+        chunk->offset = chunk->last + ARENA_ALIGN_UP(size_new);
+        return ptr;
+    }
+
+    if (!(ptr_new = bh_arena_alloc(arena, size_new)))
+        return NULL;
+    bh_memcpy_s(ptr_new, size_new, ptr,
+                size_old < size_new ? size_old : size_new);
+    bh_arena_free(arena, ptr);
+    return ptr_new;
+}
+
+bool
+bh_arena_contains(const bh_arena *arena, const void *ptr)
+{
+    return find_chunk(arena, ptr) != NULL;
+}
+
+bool
+bh_arena_free(bh_arena *arena, void *ptr)
+{
+    bh_arena_chunk *chunk = find_chunk(arena, ptr);
+
+    if (!chunk)
+        return false;
+
+    if (is_last_block(chunk, ptr))
+        chunk->offset = chunk->last;
+    return true;
+}
+
+void
+bh_arena_get_mark(const bh_arena *arena, bh_arena_mark *mark)
+{
+    mark->chunk = arena->chunks;
+    mark->offset = arena->chunks ? arena->chunks->offset : 0;
+    mark->chunk_serial = arena->chunk_serial;
+}
+
+void
+bh_arena_release(bh_arena *arena, const bh_arena_mark *mark)
+{
+    free_chunks_since(arena, mark->chunk_serial);
+
+    /* The chunks added since the mark were all put before or right after
+       the chunk carved from then, so it is the first one again */
+    bh_assert(arena->chunks == mark->chunk);
+    if (mark->chunk)
+        mark->chunk->offset = mark->chunk->last = mark->offset;
+}
@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2025 WAMR-ESP32-Arduino Contributors
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+/**
+ * Region allocator
+ *
+ * Blocks are carved from a few large chunks of the runtime heap and all go
+ * at once with bh_arena_destroy(), instead of each being a heap block with
+ * its own header and free. Only the last block carved from a chunk can be
+ * freed or grown in place, freeing any other block just leaves it unused
+ * until the arena goes or is released to an earlier mark.
+ *
+ * Blocks are 8-byte aligned and not zeroed. An arena isn't thread-safe.
+ */
+
+#ifndef _BH_ARENA_H
+#define _BH_ARENA_H
+
+#include "bh_platform.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct bh_arena_chunk bh_arena_chunk;
+
+typedef struct bh_arena {
+    /* Blocks are carved from the first chunk, the other ones are full or
+       hold a single large block */
+    bh_arena_chunk *chunks;
+    /* Size of the chunks after the first one */
+    uint32 chunk_size;
+    /* Size of the next chunk, smaller after the heap failed to give one */
+    uint32 next_chunk_size;
+    /* Serial number of the next chunk */
+    uint32 chunk_serial;
+    /* Bytes taken from the heap, chunk headers included */
+    uint32 total_size;
+} bh_arena;
+
+/* Position to release an arena back to, see bh_arena_release() */
+typedef struct bh_arena_mark {
+    bh_arena_chunk *chunk;
+    uint32 offset;
+    uint32 chunk_serial;
+} bh_arena_mark;
+
+/**
+ * Initialize an arena, no memory is taken until the first block
+ *
+ * @param first_chunk_size size of the first chunk, e.g. an estimate of
+ *        all the data to hold, to have one chunk in the common case
+ * @param chunk_size size of the next chunks, blocks larger than half
+ *        of it get a chunk of their own
+ */
+void
+bh_arena_init(bh_arena *arena, uint32 first_chunk_size, uint32 chunk_size);
+
+void
+bh_arena_destroy(bh_arena *arena);
+
+/* An arena that has been initialized and not destroyed */
+static inline bool
+bh_arena_is_inited(const bh_arena *arena)
+{
+    return arena->chunk_size != 0;
+}
+
+void *
+bh_arena_alloc(bh_arena *arena, uint32 size);
+
+/**
+ * Resize a block of the arena, in place if it is the last block of its
+ * chunk and the chunk has room, otherwise by copying it to a new block
+ *
+ * @return the block, or NULL if out of memory, the old block is kept then
+ */
+void *
+bh_arena_realloc(bh_arena *arena, void *ptr, uint32 size_old,
+                 uint32 size_new);
+
+bool
+bh_arena_contains(const bh_arena *arena, const void *ptr);
+
+/**
+ * Free a block, which only reclaims the space of the last block carved
+ * from a chunk
+ *
+ * @return true if ptr is in the arena, false otherwise and ptr is untouched
+ */
+bool
+bh_arena_free(bh_arena *arena, void *ptr);
+
+void
+bh_arena_get_mark(const bh_arena *arena, bh_arena_mark *mark);
+
+/* Free every block allocated since the mark was taken, the chunks added
+   since then go back to the heap */
+void
+bh_arena_release(bh_arena *arena, const bh_arena_mark *mark);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* end of _BH_ARENA_H */
@@ -0,0 +1,345 @@
+/*
+ * Host benchmark: runtime heap allocator under alloc/free traces
+ *
+ * Copyright (C) 2025 WAMR-ESP32-Arduino Contributors
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Drives wasm_runtime_malloc()/wasm_runtime_free() on a pool initialized
+ * the way WamrRuntime::begin() does it, so changes to the EMS allocator
+ * can be measured on the host. The traces are generated from a fixed seed
+ * and are identical between runs and builds:
+ *
+ *   random_small  random alloc/free of 8..240 byte blocks (the normal
+ *                 free lists), 4096 live slots
+ *   random_mixed  same with 8..4096 byte blocks (normal lists and tree)
+ *   fragmented    the pool is filled with small live blocks separated by
+ *                 free 0.5-2KB holes, then small blocks are allocated and freed
+ *                 in turn: every free list is empty and every free merges
+ *                 back into a hole, the worst case of the small-size path
+ *   loader_like   bursts of allocations freed in reverse order, the
+ *                 pattern of module load/unload and exec_env creation
+ *   threaded      random_small on 4 threads at once, each with its own
+ *                 slots; total_us is the wall time of the slowest thread
+ *
+ * The statistics of the per-thread allocation caches are printed to
+ * stderr after the traces.
+ * Every block is stamped on allocation and checked before it is freed,
+ * so the exit status is non-zero if the allocator hands out overlapping
+ * blocks.
+ *
+ * Usage:
+ *   alloc_bench [--scale=N] [--allocator=ems|tlsf]
+ *
+ * Output is CSV: trace,ops,total_us,per_op_ns,check
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "wasm_export.h"
+
+#define BENCH_POOL_SIZE (8 * 1024 * 1024)
+#define BENCH_SLOTS 4096
+#define BENCH_HOLE_MIN 512
+#define BENCH_HOLE_MAX 2048
+#define BENCH_BURST 64
+#define BENCH_THREADS 4
+#define BENCH_THREAD_SLOTS 1024
+
+struct Slot {
+  uint32_t *ptr;
+  uint32_t size;
+};
+
+static Slot slots[BENCH_SLOTS];
+static uint32_t rng_state;
+static uint32_t scale = 1;
+static pool_allocator_type_t allocator = Pool_Allocator_EMS;
+
+static double now_us() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+static uint32_t next_rand_state(uint32_t *state) {
+  // xorshift32
+  *state ^= *state << 13;
+  *state ^= *state >> 17;
+  *state ^= *state << 5;
+  return *state;
+}
+
+static uint32_t next_rand() { return next_rand_state(&rng_state); }
+
+// Stamp the first and last word of a block with its slot, cheap enough
+// not to dominate the timing but catches overlapping blocks
+static uint32_t *alloc_block(uint32_t index, uint32_t size) {
+  uint32_t *p = (uint32_t *)wasm_runtime_malloc(size);
+  if (p) {
+    p[0] = index;
+    p[size / 4 - 1] = ~index;
+  }
+  return p;
+}
+
+static bool free_block(uint32_t index, uint32_t *p, uint32_t size) {
+  bool ok = p[0] == index && p[size / 4 - 1] == ~index;
+  wasm_runtime_free(p);
+  return ok;
+}
+
+static bool free_all_slots() {
+  bool ok = true;
+  for (uint32_t i = 0; i < BENCH_SLOTS; i++) {
+    if (slots[i].ptr) {
+      ok &= free_block(i, slots[i].ptr, slots[i].size);
+      slots[i].ptr = nullptr;
+    }
+  }
+  return ok;
+}
+
+static void report(const char *trace, uint32_t ops, double total_us,
+                   bool ok) {
+  printf("%s,%u,%.1f,%.1f,%s\n", trace, ops, total_us,
+         ops ? total_us * 1e3 / ops : 0, ok ? "ok" : "FAIL");
+}
+
+// Each op frees a random slot if it is live and allocates it otherwise
+static bool run_random(const char *trace, uint32_t max_size) {
+  uint32_t ops = 400000 * scale;
+  bool ok = true;
+
+  rng_state = 0x9e3779b9;
+  double start = now_us();
+  for (uint32_t n = 0; n < ops && ok; n++) {
+    uint32_t r = next_rand();
+    Slot *s = &slots[r % BENCH_SLOTS];
+    if (s->ptr) {
+      ok = free_block((uint32_t)(s - slots), s->ptr, s->size);
+      s->ptr = nullptr;
+    } else {
+      // Half of the blocks are at most 64 bytes, like most of the runtime's
+      // own allocations
+      uint32_t range = (r >> 28) & 1 ? max_size : 64;
+      uint32_t size = 8 + (r >> 12) % (range / 4 - 1) * 4;
+      s->size = size;
+      s->ptr = alloc_block((uint32_t)(s - slots), size);
+      ok = s->ptr != nullptr;
+    }
+  }
+  double total_us = now_us() - start;
+  ok &= free_all_slots();
+  report(trace, ops, total_us, ok);
+  return ok;
+}
+
+static bool run_fragmented() {
+  uint32_t ops = 400000 * scale;
+  uint32_t *holes[BENCH_SLOTS];
+  bool ok = true;
+
+  // Small live blocks separated by larger blocks, which are then freed.
+  // The hole sizes vary so the free tree stays balanced (equal sizes
+  // would degrade it to a list). The rest of the pool is taken so
+  // allocations can only come from the holes.
+  rng_state = 0x2545f491;
+  for (uint32_t i = 0; i < BENCH_SLOTS && ok; i++) {
+    uint32_t hole_size =
+        BENCH_HOLE_MIN + next_rand() % (BENCH_HOLE_MAX - BENCH_HOLE_MIN);
+    slots[i].size = 16;
+    slots[i].ptr = alloc_block(i, 16);
+    holes[i] = (uint32_t *)wasm_runtime_malloc(hole_size);
+    ok = slots[i].ptr && holes[i];
+  }
+  void *rest[64];
+  uint32_t rest_count = 0;
+  for (uint32_t size = 1024 * 1024; size >= BENCH_HOLE_MAX && ok;) {
+    void *p = rest_count < 64 ? wasm_runtime_malloc(size) : nullptr;
+    if (p) {
+      rest[rest_count++] = p;
+    } else {
+      size /= 2;
+    }
+  }
+  for (uint32_t i = 0; i < BENCH_SLOTS; i++) {
+    wasm_runtime_free(holes[i]);
+  }
+
+  double start = now_us();
+  for (uint32_t n = 0; n < ops && ok; n++) {
+    uint32_t size = 8 + (next_rand() % 58) * 4;
+    uint32_t *p = alloc_block(n, size);
+    ok = p && free_block(n, p, size);
+  }
+  double total_us = now_us() - start;
+
+  for (uint32_t i = 0; i < rest_count; i++) {
+    wasm_runtime_free(rest[i]);
+  }
+  ok &= free_all_slots();
+  report("fragmented", ops, total_us, ok);
+  return ok;
+}
+
+static bool run_loader_like() {
+  uint32_t rounds = 20000 * scale;
+  uint32_t ops = 0;
+  bool ok = true;
+
+  rng_state = 0x6a09e667;
+  double start = now_us();
+  for (uint32_t n = 0; n < rounds && ok; n++) {
+    uint32_t count = 1 + next_rand() % BENCH_BURST;
+    ops += 2 * count;
+    for (uint32_t i = 0; i < count && ok; i++) {
+      // Mostly small structures, one in eight a larger buffer
+      uint32_t r = next_rand();
+      slots[i].size = (r & 7) ? 16 + (r >> 8) % 128 * 4
+                              : (2048 + (r >> 8) % 4096) & ~3u;
+      slots[i].ptr = alloc_block(i, slots[i].size);
+      ok = slots[i].ptr != nullptr;
+    }
+    while (count-- > 0 && ok) {
+      ok = free_block(count, slots[count].ptr, slots[count].size);
+      slots[count].ptr = nullptr;
+    }
+  }
+  double total_us = now_us() - start;
+  ok &= free_all_slots();
+  report("loader_like", ops, total_us, ok);
+  return ok;
+}
+
+struct ThreadTrace {
+  Slot slots[BENCH_THREAD_SLOTS];
+  uint32_t rng_state;
+  uint32_t ops;
+  double total_us;
+  bool ok;
+};
+
+static void *thread_trace_main(void *arg) {
+  ThreadTrace *t = (ThreadTrace *)arg;
+  uint32_t base = (uint32_t)(t->rng_state << 16);
+  bool ok = wasm_runtime_init_thread_env();
+
+  double start = now_us();
+  for (uint32_t n = 0; n < t->ops && ok; n++) {
+    uint32_t r = next_rand_state(&t->rng_state);
+    uint32_t index = r % BENCH_THREAD_SLOTS;
+    Slot *s = &t->slots[index];
+    if (s->ptr) {
+      ok = free_block(base + index, s->ptr, s->size);
+      s->ptr = nullptr;
+    } else {
+      uint32_t range = (r >> 28) & 1 ? 240 : 64;
+      s->size = 8 + (r >> 12) % (range / 4 - 1) * 4;
+      s->ptr = alloc_block(base + index, s->size);
+      ok = s->ptr != nullptr;
+    }
+  }
+  t->total_us = now_us() - start;
+
+  for (uint32_t i = 0; i < BENCH_THREAD_SLOTS; i++) {
+    if (t->slots[i].ptr) {
+      ok &= free_block(base + i, t->slots[i].ptr, t->slots[i].size);
+    }
+  }
+  // Returns the thread's cached blocks to the pool
+  wasm_runtime_destroy_thread_env();
+  t->ok = ok;
+  return nullptr;
+}
+
+static bool run_threaded() {
+  static ThreadTrace traces[BENCH_THREADS];
+  pthread_t threads[BENCH_THREADS];
+  uint32_t started = 0;
+  double total_us = 0;
+  bool ok = true;
+
+  for (uint32_t i = 0; i < BENCH_THREADS; i++) {
+    memset(&traces[i], 0, sizeof(traces[i]));
+    traces[i].rng_state = 0x3c6ef372 + i;
+    traces[i].ops = 200000 * scale;
+    if (pthread_create(&threads[i], nullptr, thread_trace_main, &traces[i])
+        != 0) {
+      ok = false;
+      break;
+    }
+    started++;
+  }
+  for (uint32_t i = 0; i < started; i++) {
+    pthread_join(threads[i], nullptr);
+    ok &= traces[i].ok;
+    if (traces[i].total_us > total_us) {
+      total_us = traces[i].total_us;
+    }
+  }
+  report("threaded", started * 200000 * scale, total_us, ok);
+  return ok;
+}
+
+static void print_cache_stats() {
+  mem_alloc_cache_stats_t stats;
+  if (!wasm_runtime_get_alloc_cache_stats(&stats)) {
+    fprintf(stderr, "alloc cache: disabled\n");
+    return;
+  }
+  uint64_t total = stats.hit_count + stats.miss_count;
+  fprintf(stderr,
+          "alloc cache: %llu hits, %llu misses (%.1f%% hit), "
+          "%u bytes held\n",
+          (unsigned long long)stats.hit_count,
+          (unsigned long long)stats.miss_count,
+          total ? stats.hit_count * 100.0 / total : 0.0, stats.bytes_held);
+}
+
+int main(int argc, char **argv) {
+  for (int i = 1; i < argc; i++) {
+    if (strncmp(argv[i], "--scale=", 8) == 0) {
+      scale = (uint32_t)atoi(argv[i] + 8);
+      if (scale == 0) {
+        scale = 1;
+      }
+    } else if (strcmp(argv[i], "--allocator=ems") == 0) {
+      allocator = Pool_Allocator_EMS;
+    } else if (strcmp(argv[i], "--allocator=tlsf") == 0) {
+      allocator = Pool_Allocator_TLSF;
+    } else {
+      fprintf(stderr, "usage: %s [--scale=N] [--allocator=ems|tlsf]\n",
+              argv[0]);
+      return 2;
+    }
+  }
+
+  char *pool = (char *)malloc(BENCH_POOL_SIZE);
+  RuntimeInitArgs init_args;
+  memset(&init_args, 0, sizeof(init_args));
+  init_args.mem_alloc_type = Alloc_With_Pool;
+  init_args.mem_alloc_option.pool.heap_buf = pool;
+  init_args.mem_alloc_option.pool.heap_size = BENCH_POOL_SIZE;
+  init_args.mem_alloc_option.pool.allocator_type = allocator;
+  if (!pool || !wasm_runtime_full_init(&init_args)) {
+    fprintf(stderr, "wasm_runtime_full_init failed\n");
+    free(pool);
+    return 1;
+  }
+
+  printf("trace,ops,total_us,per_op_ns,check\n");
+  bool ok = run_random("random_small", 240);
+  ok &= run_random("random_mixed", 4096);
+  ok &= run_fragmented();
+  ok &= run_loader_like();
+  ok &= run_threaded();
+  print_cache_stats();
+
+  wasm_runtime_destroy();
+  free(pool);
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,516 @@
+/*
+ * Host benchmark: EMS vs TLSF on recorded runtime allocation traces
+ *
+ * Copyright (C) 2025 WAMR-ESP32-Arduino Contributors
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Records every wasm_runtime_malloc()/realloc()/free() the runtime makes
+ * while it loads, instantiates, calls and unloads modules (the runtime
+ * runs on a recording allocator), then replays each trace on a pool
+ * managed by each allocator through the mem_allocator API. The traces:
+ *
+ *   math      the math module of the examples (add, fibonacci)
+ *   kernels   the kernels module with 2 pages of memory (fill, crc32,
+ *             matmul)
+ *   combined  both, plus any extra modules, loaded at the same time
+ *   <file>    each extra .wasm file, load and instantiate only
+ *   one_class a synthetic trace that leaves many holes of one size class
+ *             in a nearly full pool, then allocates the largest size of
+ *             that class over and over. It is timed in each allocator's
+ *             min_pool, where TLSF's rounded-up search finds nothing and
+ *             only a bounded walk of the class list can find the block
+ *
+ * Columns:
+ *   p50_ns..max_ns  latency of a single malloc/realloc/free over --scale x
+ *                   200 replays, minus the timer overhead
+ *   worst_op_ns     the slowest op of the trace, each op taken at its
+ *                   fastest replay, so the max without scheduler noise
+ *   peak_live       most bytes live at once in the trace
+ *   min_pool        smallest pool (1KB steps) the trace replays in without
+ *                   a failed allocation, so it includes the allocator's
+ *                   overhead and fragmentation
+ *   frag_pct        100 * (1 - largest free block / free bytes) at the
+ *                   peak of the trace, in a pool of the same size for both
+ *                   allocators
+ *
+ * Usage:
+ *   alloc_trace_bench [--scale=N] [module.wasm ...]
+ *
+ * Output is CSV:
+ *   trace,allocator,ops,p50_ns,p99_ns,p999_ns,max_ns,worst_op_ns,
+ *   peak_live,min_pool,frag_pct
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "wasm_export.h"
+#include "mem_alloc.h"
+
+#include "bench_modules.h"
+
+#define BENCH_REPLAYS 200
+#define BENCH_STACK_SIZE (16 * 1024)  // WamrModule defaults
+#define BENCH_HEAP_SIZE (64 * 1024)
+#define BENCH_POOL_STEP 1024
+
+enum TraceOpKind { OP_MALLOC, OP_REALLOC, OP_FREE };
+
+struct TraceOp {
+  TraceOpKind kind;
+  uint32_t id;
+  uint32_t size;
+};
+
+struct Trace {
+  std::string name;
+  std::vector<TraceOp> ops;
+  uint32_t block_count;
+  uint32_t peak_live;
+  size_t peak_index;  // First op after which peak_live bytes are live
+  bool tight;         // Timed in min_pool instead of a roomier pool
+};
+
+struct ModuleSource {
+  std::string name;
+  std::vector<uint8_t> bytes;
+  bool run;  // Call the built-in kernels after instantiating
+};
+
+struct Allocator {
+  const char *name;
+  int kind;
+};
+
+static const Allocator allocators[] = {
+    {"ems", MEM_ALLOCATOR_EMS},
+    {"tlsf", MEM_ALLOCATOR_TLSF},
+};
+
+static uint32_t scale = 1;
+
+// Recording state, the runtime only allocates from the calling thread here
+static Trace *recording;
+static std::unordered_map<void *, uint32_t> live_ids;
+static std::vector<uint32_t> live_sizes;
+static uint32_t live_bytes;
+
+static uint64_t now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static void record_op(TraceOpKind kind, uint32_t id, uint32_t size) {
+  recording->ops.push_back({kind, id, size});
+  if (live_bytes > recording->peak_live) {
+    recording->peak_live = live_bytes;
+    recording->peak_index = recording->ops.size();
+  }
+}
+
+static void *record_malloc(unsigned int size) {
+  void *ptr = malloc(size ? size : 1);
+  if (ptr && recording) {
+    uint32_t id = recording->block_count++;
+    live_ids[ptr] = id;
+    live_sizes.push_back(size);
+    live_bytes += size;
+    record_op(OP_MALLOC, id, size);
+  }
+  return ptr;
+}
+
+static void *record_realloc(void *ptr, unsigned int size) {
+  if (!ptr) {
+    return record_malloc(size);
+  }
+  void *ptr_new = realloc(ptr, size ? size : 1);
+  if (ptr_new && recording) {
+    auto it = live_ids.find(ptr);
+    if (it != live_ids.end()) {
+      uint32_t id = it->second;
+      live_ids.erase(it);
+      live_ids[ptr_new] = id;
+      live_bytes += size - live_sizes[id];
+      live_sizes[id] = size;
+      record_op(OP_REALLOC, id, size);
+    }
+  }
+  return ptr_new;
+}
+
+static void record_free(void *ptr) {
+  if (ptr && recording) {
+    auto it = live_ids.find(ptr);
+    if (it != live_ids.end()) {
+      uint32_t id = it->second;
+      live_ids.erase(it);
+      live_bytes -= live_sizes[id];
+      record_op(OP_FREE, id, 0);
+    }
+  }
+  free(ptr);
+}
+
+static void call(wasm_module_inst_t inst, wasm_exec_env_t exec_env,
+                 const char *name, uint32_t argc, uint32_t *argv) {
+  wasm_function_inst_t func = wasm_runtime_lookup_function(inst, name);
+  if (func) {
+    wasm_runtime_call_wasm(exec_env, func, argc, argv);
+  }
+}
+
+// Load all modules, instantiate them, run the built-in ones and unload
+// everything in reverse order, as an application using them together does
+static void record_session(Trace *trace,
+                           const std::vector<const ModuleSource *> &modules) {
+  std::vector<wasm_module_t> loaded;
+  std::vector<wasm_module_inst_t> insts;
+  std::vector<wasm_exec_env_t> exec_envs;
+  char error_buf[128];
+
+  // Read-only load as done by WamrModule::load()
+  LoadArgs load_args;
+  memset(&load_args, 0, sizeof(load_args));
+  load_args.name = const_cast<char *>("");
+  load_args.wasm_binary_readonly = true;
+
+  trace->block_count = 0;
+  trace->peak_live = 0;
+  trace->peak_index = 0;
+  trace->tight = false;
+  live_ids.clear();
+  live_sizes.clear();
+  live_bytes = 0;
+  recording = trace;
+
+  for (const ModuleSource *src : modules) {
+    wasm_module_t module = wasm_runtime_load_ex(
+        const_cast<uint8_t *>(src->bytes.data()), (uint32_t)src->bytes.size(),
+        &load_args, error_buf, sizeof(error_buf));
+    wasm_module_inst_t inst =
+        module ? wasm_runtime_instantiate(module, BENCH_STACK_SIZE,
+                                          BENCH_HEAP_SIZE, error_buf,
+                                          sizeof(error_buf))
+               : nullptr;
+    wasm_exec_env_t exec_env =
+        inst ? wasm_runtime_create_exec_env(inst, BENCH_STACK_SIZE) : nullptr;
+    if (!exec_env) {
+      fprintf(stderr, "%s: %s\n", src->name.c_str(), error_buf);
+    }
+    loaded.push_back(module);
+    insts.push_back(inst);
+    exec_envs.push_back(exec_env);
+  }
+
+  for (size_t i = 0; i < modules.size(); i++) {
+    if (!exec_envs[i] || !modules[i]->run) {
+      continue;
+    }
+    uint32_t argv[3];
+    argv[0] = 2;
+    argv[1] = 3;
+    call(insts[i], exec_envs[i], "add", 2, argv);
+    argv[0] = 10;
+    call(insts[i], exec_envs[i], "fibonacci", 1, argv);
+    argv[0] = 0;
+    argv[1] = 1024;
+    argv[2] = 7;
+    call(insts[i], exec_envs[i], "fill", 3, argv);
+    argv[0] = 0;
+    argv[1] = 1024;
+    call(insts[i], exec_envs[i], "crc32", 2, argv);
+    argv[0] = 8;
+    call(insts[i], exec_envs[i], "matmul", 1, argv);
+  }
+
+  for (size_t i = modules.size(); i-- > 0;) {
+    if (exec_envs[i]) {
+      wasm_runtime_destroy_exec_env(exec_envs[i]);
+    }
+    if (insts[i]) {
+      wasm_runtime_deinstantiate(insts[i]);
+    }
+    if (loaded[i]) {
+      wasm_runtime_unload(loaded[i]);
+    }
+  }
+  recording = nullptr;
+}
+
+// Holes of 1028 bytes between live 16-byte blocks, freed after a few of
+// 1076 bytes, so with TLSF's 4-byte headers the blocks that fit sit last
+// in the list of [1024, 1088). Requests of 1076 bytes then round up past
+// the list, and past the rest of a nearly full pool
+static void make_one_class_trace(Trace *trace) {
+  const uint32_t holes = 256, fits = 64;
+  const uint32_t fit_size = 1076, hole_size = 1028;
+  uint32_t id = 0, live = 0;
+
+  trace->name = "one_class";
+  trace->ops.clear();
+  trace->tight = true;
+  for (uint32_t i = 0; i < fits + holes; i++) {
+    uint32_t size = i < fits ? fit_size : hole_size;
+    trace->ops.push_back({OP_MALLOC, id++, size});
+    trace->ops.push_back({OP_MALLOC, id++, 16});
+    live += size + 16;
+  }
+  trace->peak_live = live;
+  trace->peak_index = trace->ops.size();
+  for (uint32_t i = 0; i < fits + holes; i++) {
+    trace->ops.push_back({OP_FREE, i * 2, 0});
+  }
+  for (uint32_t i = 0; i < fits; i++) {
+    trace->ops.push_back({OP_MALLOC, id++, fit_size});
+  }
+  trace->block_count = id;
+}
+
+// Replay a trace on a fresh allocator. With latencies, every op is timed;
+// with largest_free, the largest block that can be allocated and the free
+// bytes are measured at the peak. Returns false if an allocation fails.
+static bool replay(const Trace &trace, int kind, uint8_t *pool,
+                   uint32_t pool_size, std::vector<uint32_t> *latencies,
+                   uint64_t timer_ns, uint32_t *largest_free,
+                   uint32_t *free_size) {
+  mem_allocator_t allocator =
+      mem_allocator_create_with_kind(pool, pool_size, kind);
+  if (!allocator) {
+    return false;
+  }
+
+  std::vector<void *> ptrs(trace.block_count, nullptr);
+  bool ok = true;
+  for (size_t i = 0; i < trace.ops.size() && ok; i++) {
+    const TraceOp &op = trace.ops[i];
+    void *ptr = nullptr;
+    uint64_t start = latencies ? now_ns() : 0;
+    switch (op.kind) {
+      case OP_MALLOC:
+        ptr = mem_allocator_malloc(allocator, op.size);
+        break;
+      case OP_REALLOC:
+        ptr = mem_allocator_realloc(allocator, ptrs[op.id], op.size);
+        break;
+      case OP_FREE:
+        mem_allocator_free(allocator, ptrs[op.id]);
+        break;
+    }
+    if (latencies) {
+      uint64_t ns = now_ns() - start;
+      latencies->push_back(ns > timer_ns ? (uint32_t)(ns - timer_ns) : 0);
+    }
+    if (op.kind != OP_FREE) {
+      ok = ptr != nullptr;
+      ptrs[op.id] = ptr;
+    } else {
+      ptrs[op.id] = nullptr;
+    }
+
+    if (largest_free && i + 1 == trace.peak_index) {
+      mem_alloc_info_t info;
+      mem_allocator_get_alloc_info(allocator, &info);
+      *free_size = info.total_free_size;
+      uint32_t lo = 0, hi = info.total_free_size;
+      while (lo < hi) {
+        uint32_t mid = lo + (hi - lo + 1) / 2;
+        void *p = mem_allocator_malloc(allocator, mid);
+        if (p) {
+          mem_allocator_free(allocator, p);
+          lo = mid;
+        } else {
+          hi = mid - 1;
+        }
+      }
+      *largest_free = lo;
+    }
+  }
+
+  for (void *ptr : ptrs) {
+    if (ptr) {
+      mem_allocator_free(allocator, ptr);
+    }
+  }
+  mem_allocator_destroy(allocator);
+  return ok;
+}
+
+static uint32_t find_min_pool(const Trace &trace, int kind, uint8_t *pool,
+                              uint32_t max_pool) {
+  uint32_t lo = 1, hi = max_pool / BENCH_POOL_STEP;
+  if (!replay(trace, kind, pool, hi * BENCH_POOL_STEP, nullptr, 0, nullptr,
+              nullptr)) {
+    return 0;
+  }
+  while (lo < hi) {
+    uint32_t mid = lo + (hi - lo) / 2;
+    if (replay(trace, kind, pool, mid * BENCH_POOL_STEP, nullptr, 0, nullptr,
+               nullptr)) {
+      hi = mid;
+    } else {
+      lo = mid + 1;
+    }
+  }
+  return hi * BENCH_POOL_STEP;
+}
+
+static uint64_t measure_timer_ns() {
+  uint64_t best = ~0ull;
+  for (int i = 0; i < 1000; i++) {
+    uint64_t start = now_ns();
+    uint64_t ns = now_ns() - start;
+    if (ns < best) {
+      best = ns;
+    }
+  }
+  return best;
+}
+
+static void run_trace(const Trace &trace, uint64_t timer_ns) {
+  uint32_t max_pool = trace.peak_live * 4 + 256 * 1024;
+  uint8_t *pool = (uint8_t *)malloc(max_pool);
+  uint32_t min_pool[2];
+  uint32_t frag_pool = 0;
+
+  // Touch the pool so page faults don't show up as latency
+  memset(pool, 0, max_pool);
+
+  for (int a = 0; a < 2; a++) {
+    min_pool[a] = find_min_pool(trace, allocators[a].kind, pool, max_pool);
+    frag_pool = std::max(frag_pool, min_pool[a]);
+  }
+  frag_pool = std::max(frag_pool, trace.peak_live * 2);
+
+  for (int a = 0; a < 2; a++) {
+    std::vector<uint32_t> latencies;
+    uint32_t largest_free = 0, free_size = 0;
+    uint32_t replays = BENCH_REPLAYS * scale;
+    uint32_t pool_size = trace.tight ? min_pool[a] : frag_pool;
+
+    latencies.reserve(trace.ops.size() * replays);
+    replay(trace, allocators[a].kind, pool, pool_size, nullptr, 0,
+           &largest_free, &free_size);
+    for (uint32_t r = 0; r < replays; r++) {
+      replay(trace, allocators[a].kind, pool, pool_size, &latencies,
+             timer_ns, nullptr, nullptr);
+    }
+
+    // A replay stops at a failed allocation, then ops don't line up
+    uint32_t worst_op = 0;
+    if (latencies.size() == trace.ops.size() * replays) {
+      for (size_t i = 0; i < trace.ops.size(); i++) {
+        uint32_t best = ~0u;
+        for (uint32_t r = 0; r < replays; r++) {
+          best = std::min(best, latencies[r * trace.ops.size() + i]);
+        }
+        worst_op = std::max(worst_op, best);
+      }
+    }
+    std::sort(latencies.begin(), latencies.end());
+
+    size_t n = latencies.size();
+    printf("%s,%s,%zu,%u,%u,%u,%u,%u,%u,%u,%.1f\n", trace.name.c_str(),
+           allocators[a].name, trace.ops.size(), n ? latencies[n / 2] : 0,
+           n ? latencies[n * 99 / 100] : 0, n ? latencies[n * 999 / 1000] : 0,
+           n ? latencies[n - 1] : 0, worst_op, trace.peak_live, min_pool[a],
+           free_size ? 100.0 * (1.0 - (double)largest_free / free_size) : 0);
+  }
+  free(pool);
+}
+
+static bool read_file(const char *path, std::vector<uint8_t> *bytes) {
+  FILE *f = fopen(path, "rb");
+  if (!f) {
+    return false;
+  }
+  fseek(f, 0, SEEK_END);
+  long size = ftell(f);
+  fseek(f, 0, SEEK_SET);
+  bytes->resize(size > 0 ? size : 0);
+  bool ok = size > 0 && fread(bytes->data(), 1, size, f) == (size_t)size;
+  fclose(f);
+  return ok;
+}
+
+int main(int argc, char **argv) {
+  std::vector<ModuleSource> sources;
+  sources.push_back({"math",
+                     std::vector<uint8_t>(math_wasm, math_wasm + math_wasm_len),
+                     true});
+  sources.push_back(
+      {"kernels",
+       std::vector<uint8_t>(kernels_wasm, kernels_wasm + kernels_wasm_len),
+       true});
+
+  for (int i = 1; i < argc; i++) {
+    if (strncmp(argv[i], "--scale=", 8) == 0) {
+      scale = (uint32_t)atoi(argv[i] + 8);
+      if (scale == 0) {
+        scale = 1;
+      }
+    } else if (argv[i][0] == '-') {
+      fprintf(stderr, "usage: %s [--scale=N] [module.wasm ...]\n", argv[0]);
+      return 2;
+    } else {
+      ModuleSource src;
+      const char *base = strrchr(argv[i], '/');
+      src.name = base ? base + 1 : argv[i];
+      src.run = false;
+      if (!read_file(argv[i], &src.bytes)) {
+        fprintf(stderr, "cannot read %s\n", argv[i]);
+        return 1;
+      }
+      sources.push_back(src);
+    }
+  }
+
+  RuntimeInitArgs init_args;
+  memset(&init_args, 0, sizeof(init_args));
+  init_args.mem_alloc_type = Alloc_With_Allocator;
+  init_args.mem_alloc_option.allocator.malloc_func = (void *)record_malloc;
+  init_args.mem_alloc_option.allocator.realloc_func = (void *)record_realloc;
+  init_args.mem_alloc_option.allocator.free_func = (void *)record_free;
+  if (!wasm_runtime_full_init(&init_args)) {
+    fprintf(stderr, "wasm_runtime_full_init failed\n");
+    return 1;
+  }
+
+  std::vector<Trace> traces;
+  std::vector<const ModuleSource *> all;
+  for (const ModuleSource &src : sources) {
+    Trace trace;
+    trace.name = src.name;
+    record_session(&trace, {&src});
+    traces.push_back(trace);
+    all.push_back(&src);
+  }
+  Trace combined;
+  combined.name = "combined";
+  record_session(&combined, all);
+  traces.insert(traces.begin() + 2, combined);
+  Trace one_class;
+  make_one_class_trace(&one_class);
+  traces.insert(traces.begin() + 3, one_class);
+
+  wasm_runtime_destroy();
+
+  // Pools too small to create are expected while searching for min_pool
+  wasm_runtime_set_log_level(WASM_LOG_LEVEL_FATAL);
+
+  uint64_t timer_ns = measure_timer_ns();
+  printf("trace,allocator,ops,p50_ns,p99_ns,p999_ns,max_ns,worst_op_ns,"
+         "peak_live,min_pool,frag_pct\n");
+  for (const Trace &trace : traces) {
+    run_trace(trace, timer_ns);
+  }
+  return 0;
+}
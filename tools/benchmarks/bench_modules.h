@@ -0,0 +1,74 @@
+/*
+ * Embedded WASM modules for the host benchmark suite
+ *
+ * Copyright (C) 2025 WAMR-ESP32-Arduino Contributors
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Generated from tools/wasm_examples/math.wat and kernels.wat:
+ *   wat2wasm math.wat -o math.wasm && xxd -i math.wasm
+ *   wat2wasm kernels.wat -o kernels.wasm && xxd -i kernels.wasm
+ */
+
+#ifndef _WAMR_BENCH_MODULES_H
+#define _WAMR_BENCH_MODULES_H
+
+// add, subtract, multiply, divide, fibonacci
+static const unsigned char math_wasm[] = {
+  0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x0c, 0x02, 0x60,
+  0x02, 0x7f, 0x7f, 0x01, 0x7f, 0x60, 0x01, 0x7f, 0x01, 0x7f, 0x03, 0x06,
+  0x05, 0x00, 0x00, 0x00, 0x00, 0x01, 0x07, 0x32, 0x05, 0x03, 0x61, 0x64,
+  0x64, 0x00, 0x00, 0x08, 0x73, 0x75, 0x62, 0x74, 0x72, 0x61, 0x63, 0x74,
+  0x00, 0x01, 0x08, 0x6d, 0x75, 0x6c, 0x74, 0x69, 0x70, 0x6c, 0x79, 0x00,
+  0x02, 0x06, 0x64, 0x69, 0x76, 0x69, 0x64, 0x65, 0x00, 0x03, 0x09, 0x66,
+  0x69, 0x62, 0x6f, 0x6e, 0x61, 0x63, 0x63, 0x69, 0x00, 0x04, 0x0a, 0x47,
+  0x05, 0x07, 0x00, 0x20, 0x00, 0x20, 0x01, 0x6a, 0x0b, 0x07, 0x00, 0x20,
+  0x00, 0x20, 0x01, 0x6b, 0x0b, 0x07, 0x00, 0x20, 0x00, 0x20, 0x01, 0x6c,
+  0x0b, 0x10, 0x00, 0x20, 0x01, 0x45, 0x04, 0x7f, 0x41, 0x00, 0x05, 0x20,
+  0x00, 0x20, 0x01, 0x6d, 0x0b, 0x0b, 0x1c, 0x00, 0x20, 0x00, 0x41, 0x01,
+  0x4c, 0x04, 0x7f, 0x20, 0x00, 0x05, 0x20, 0x00, 0x41, 0x01, 0x6b, 0x10,
+  0x04, 0x20, 0x00, 0x41, 0x02, 0x6b, 0x10, 0x04, 0x6a, 0x0b, 0x0b
+};
+static unsigned int math_wasm_len = 155;
+
+// memory (2 pages), fill, memcpy_loop, crc32, matmul
+static const unsigned char kernels_wasm[] = {
+  0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x12, 0x03, 0x60,
+  0x03, 0x7f, 0x7f, 0x7f, 0x00, 0x60, 0x02, 0x7f, 0x7f, 0x01, 0x7f, 0x60,
+  0x01, 0x7f, 0x01, 0x7f, 0x03, 0x05, 0x04, 0x00, 0x00, 0x01, 0x02, 0x05,
+  0x03, 0x01, 0x00, 0x02, 0x07, 0x30, 0x05, 0x06, 0x6d, 0x65, 0x6d, 0x6f,
+  0x72, 0x79, 0x02, 0x00, 0x04, 0x66, 0x69, 0x6c, 0x6c, 0x00, 0x00, 0x0b,
+  0x6d, 0x65, 0x6d, 0x63, 0x70, 0x79, 0x5f, 0x6c, 0x6f, 0x6f, 0x70, 0x00,
+  0x01, 0x05, 0x63, 0x72, 0x63, 0x33, 0x32, 0x00, 0x02, 0x06, 0x6d, 0x61,
+  0x74, 0x6d, 0x75, 0x6c, 0x00, 0x03, 0x0a, 0xd1, 0x02, 0x04, 0x2a, 0x01,
+  0x01, 0x7f, 0x02, 0x40, 0x03, 0x40, 0x20, 0x03, 0x20, 0x01, 0x4f, 0x0d,
+  0x01, 0x20, 0x00, 0x20, 0x03, 0x6a, 0x20, 0x03, 0x41, 0x1f, 0x6c, 0x20,
+  0x02, 0x6a, 0x3a, 0x00, 0x00, 0x20, 0x03, 0x41, 0x01, 0x6a, 0x21, 0x03,
+  0x0c, 0x00, 0x0b, 0x0b, 0x0b, 0x2a, 0x01, 0x01, 0x7f, 0x02, 0x40, 0x03,
+  0x40, 0x20, 0x03, 0x20, 0x02, 0x4f, 0x0d, 0x01, 0x20, 0x00, 0x20, 0x03,
+  0x6a, 0x20, 0x01, 0x20, 0x03, 0x6a, 0x2d, 0x00, 0x00, 0x3a, 0x00, 0x00,
+  0x20, 0x03, 0x41, 0x01, 0x6a, 0x21, 0x03, 0x0c, 0x00, 0x0b, 0x0b, 0x0b,
+  0x57, 0x01, 0x03, 0x7f, 0x41, 0x7f, 0x21, 0x02, 0x02, 0x40, 0x03, 0x40,
+  0x20, 0x03, 0x20, 0x01, 0x4f, 0x0d, 0x01, 0x20, 0x02, 0x20, 0x00, 0x20,
+  0x03, 0x6a, 0x2d, 0x00, 0x00, 0x73, 0x21, 0x02, 0x41, 0x08, 0x21, 0x04,
+  0x03, 0x40, 0x20, 0x02, 0x41, 0x01, 0x76, 0x41, 0xa0, 0x86, 0xe2, 0xed,
+  0x7e, 0x41, 0x00, 0x20, 0x02, 0x41, 0x01, 0x71, 0x6b, 0x71, 0x73, 0x21,
+  0x02, 0x20, 0x04, 0x41, 0x01, 0x6b, 0x22, 0x04, 0x0d, 0x00, 0x0b, 0x20,
+  0x03, 0x41, 0x01, 0x6a, 0x21, 0x03, 0x0c, 0x00, 0x0b, 0x0b, 0x20, 0x02,
+  0x41, 0x7f, 0x73, 0x0b, 0xa0, 0x01, 0x01, 0x06, 0x7f, 0x20, 0x00, 0x20,
+  0x00, 0x6c, 0x41, 0x02, 0x74, 0x21, 0x05, 0x02, 0x40, 0x03, 0x40, 0x20,
+  0x01, 0x20, 0x00, 0x4f, 0x0d, 0x01, 0x41, 0x00, 0x21, 0x02, 0x02, 0x40,
+  0x03, 0x40, 0x20, 0x02, 0x20, 0x00, 0x4f, 0x0d, 0x01, 0x41, 0x00, 0x21,
+  0x04, 0x41, 0x00, 0x21, 0x03, 0x02, 0x40, 0x03, 0x40, 0x20, 0x03, 0x20,
+  0x00, 0x4f, 0x0d, 0x01, 0x20, 0x04, 0x20, 0x01, 0x20, 0x00, 0x6c, 0x20,
+  0x03, 0x6a, 0x41, 0x02, 0x74, 0x28, 0x02, 0x00, 0x20, 0x03, 0x20, 0x00,
+  0x6c, 0x20, 0x02, 0x6a, 0x41, 0x02, 0x74, 0x20, 0x05, 0x6a, 0x28, 0x02,
+  0x00, 0x6c, 0x6a, 0x21, 0x04, 0x20, 0x03, 0x41, 0x01, 0x6a, 0x21, 0x03,
+  0x0c, 0x00, 0x0b, 0x0b, 0x20, 0x01, 0x20, 0x00, 0x6c, 0x20, 0x02, 0x6a,
+  0x41, 0x02, 0x74, 0x20, 0x05, 0x41, 0x01, 0x74, 0x6a, 0x20, 0x04, 0x36,
+  0x02, 0x00, 0x20, 0x06, 0x20, 0x04, 0x6a, 0x21, 0x06, 0x20, 0x02, 0x41,
+  0x01, 0x6a, 0x21, 0x02, 0x0c, 0x00, 0x0b, 0x0b, 0x20, 0x01, 0x41, 0x01,
+  0x6a, 0x21, 0x01, 0x0c, 0x00, 0x0b, 0x0b, 0x20, 0x06, 0x0b
+};
+static unsigned int kernels_wasm_len = 430;
+
+#endif /* _WAMR_BENCH_MODULES_H */
@@ -0,0 +1,122 @@
+/*
+ * Host benchmark: per-call pthread spawn vs. worker pool dispatch
+ *
+ * Copyright (C) 2025 WAMR-ESP32-Arduino Contributors
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Measures the latency that WamrModule::callFunction() adds on top of the
+ * actual WASM call. The "call" here is a trivial add so the numbers are
+ * pure dispatch overhead.
+ *
+ * Output is CSV: mode,iterations,total_us,per_call_us
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "../../src/WamrWorkerPool.h"
+
+#define THREAD_STACK (32 * 1024)
+
+struct AddJob {
+  uint32_t argv[2];
+};
+
+static void add_job(void *arg) {
+  AddJob *job = (AddJob *)arg;
+  job->argv[0] = job->argv[0] + job->argv[1];
+}
+
+// A job that tries to stop its own pool, e.g. a native function calling
+// WamrRuntime::setWorkerCount()
+static void stop_job(void *arg) {
+  WamrWorkerPool *pool = (WamrWorkerPool *)arg;
+  if (pool->stop()) {
+    fprintf(stderr, "stop() from a worker didn't refuse\n");
+    exit(1);
+  }
+}
+
+static void *add_thread(void *arg) {
+  add_job(arg);
+  return nullptr;
+}
+
+static double now_us() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+// Previous callFunction() behaviour: create + join a pthread per call
+static bool spawn_call(AddJob *job) {
+  pthread_t thread;
+  pthread_attr_t attr;
+  pthread_attr_init(&attr);
+  pthread_attr_setstacksize(&attr, THREAD_STACK);
+  if (pthread_create(&thread, &attr, add_thread, job) != 0) {
+    pthread_attr_destroy(&attr);
+    return false;
+  }
+  pthread_join(thread, nullptr);
+  pthread_attr_destroy(&attr);
+  return true;
+}
+
+static void report(const char *mode, uint32_t iterations, double total_us) {
+  printf("%s,%u,%.1f,%.3f\n", mode, iterations, total_us,
+         total_us / iterations);
+}
+
+int main(int argc, char **argv) {
+  uint32_t iterations = argc > 1 ? (uint32_t)atoi(argv[1]) : 20000;
+  uint32_t checksum = 0;
+
+  printf("mode,iterations,total_us,per_call_us\n");
+
+  double start = now_us();
+  for (uint32_t i = 0; i < iterations; i++) {
+    AddJob job = {{i, 1}};
+    if (!spawn_call(&job)) {
+      fprintf(stderr, "pthread_create failed\n");
+      return 1;
+    }
+    checksum += job.argv[0];
+  }
+  report("spawn", iterations, now_us() - start);
+
+  WamrWorkerPool pool;
+  if (!pool.start(1, THREAD_STACK)) {
+    fprintf(stderr, "Failed to start worker pool\n");
+    return 1;
+  }
+  start = now_us();
+  for (uint32_t i = 0; i < iterations; i++) {
+    AddJob job = {{i, 1}};
+    pool.run(add_job, &job);
+    checksum -= job.argv[0];
+  }
+  report("pool", iterations, now_us() - start);
+
+  AddJob job = {{1, 2}};
+  if (!pool.run(stop_job, &pool) || !pool.isRunning() ||
+      !pool.run(add_job, &job) || job.argv[0] != 3) {
+    fprintf(stderr, "Worker pool broken by stop() from a worker\n");
+    return 1;
+  }
+  pool.stop();
+
+  volatile uint32_t sink = 0;
+  start = now_us();
+  for (uint32_t i = 0; i < iterations; i++) {
+    AddJob job = {{i, 1}};
+    add_job(&job);
+    sink = job.argv[0];
+  }
+  report("direct", iterations, now_us() - start);
+  (void)sink;
+
+  return checksum == 0 ? 0 : 1;
+}
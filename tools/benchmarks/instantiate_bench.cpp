@@ -0,0 +1,324 @@
+/*
+ * Host benchmark: instantiate and exec_env creation time against memory size
+ *
+ * Copyright (C) 2025 WAMR-ESP32-Arduino Contributors
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Instantiates generated modules with 1 to 16 pages of linear memory, and
+ * creates exec_envs with 16 KB and 64 KB wasm stacks, which is where the
+ * runtime zeroes memory: the linear memory, the app heap in it, and the
+ * exec_env with its stack. Each runs twice, with linear memories mapped
+ * from the system heap ("mmap") and with them placed in the runtime pools
+ * ("pool", see WamrRuntime::setMemoryPlacement()), where a block may be
+ * reused dirty from the previous instance.
+ *
+ * Every instance checks that its memory reads as zero outside the data
+ * segment, then dirties all of it, and that memory.grow adds zeroed pages.
+ *
+ * On Linux a fresh mapping is zeroed by the kernel, so the mmap rows leave
+ * out the pass os_mmap makes over PSRAM on the ESP32.
+ *
+ * Usage:
+ *   instantiate_bench [--scale=N]
+ *
+ * Output is CSV:
+ *   placement,pages,stack_kb,instantiate_us,exec_env_us,check
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <vector>
+
+#include "wasm_export.h"
+
+#define BENCH_POOL_SIZE (8 * 1024 * 1024)
+#define BENCH_FAST_POOL_SIZE (2 * 1024 * 1024)
+#define BENCH_HEAP_SIZE (16 * 1024)
+#define BENCH_ITERATIONS 100
+#define WASM_PAGE_SIZE 65536
+
+#define DATA_OFFSET 16
+
+static uint8_t pool[BENCH_POOL_SIZE];
+static uint8_t fast_pool[BENCH_FAST_POOL_SIZE];
+static uint32_t scale = 1;
+
+static const uint8_t data_seg[] = "each byte zeroed at most once";
+
+static double now_us() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+// ============================================================================
+// Generated module
+// ============================================================================
+
+static void put_u32(std::vector<uint8_t> *out, uint32_t value) {
+  do {
+    uint8_t byte = value & 0x7f;
+    value >>= 7;
+    out->push_back(value ? byte | 0x80 : byte);
+  } while (value);
+}
+
+static void put_section(std::vector<uint8_t> *out, uint8_t id,
+                        const std::vector<uint8_t> &body) {
+  out->push_back(id);
+  put_u32(out, (uint32_t)body.size());
+  out->insert(out->end(), body.begin(), body.end());
+}
+
+static void put_export(std::vector<uint8_t> *out, const char *name,
+                       uint32_t func_index) {
+  put_u32(out, (uint32_t)strlen(name));
+  out->insert(out->end(), name, name + strlen(name));
+  out->push_back(0x00);
+  put_u32(out, func_index);
+}
+
+// (memory pages 256) with one data segment, exporting
+//   sum(from, to) -> i32   sum of the i32 words in [from, to)
+//   fill(from, to, value)  store value in each word of [from, to)
+//   grow(n) -> i32         memory.grow
+static std::vector<uint8_t> build_module(uint32_t pages) {
+  std::vector<uint8_t> m = {0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00};
+  std::vector<uint8_t> s;
+
+  const uint8_t types[] = {
+      0x03,                                      // 3 types
+      0x60, 0x02, 0x7f, 0x7f, 0x01, 0x7f,        // (i32, i32) -> i32
+      0x60, 0x03, 0x7f, 0x7f, 0x7f, 0x00,        // (i32, i32, i32) -> ()
+      0x60, 0x01, 0x7f, 0x01, 0x7f,              // (i32) -> i32
+  };
+  s.assign(types, types + sizeof(types));
+  put_section(&m, 1, s);
+
+  const uint8_t funcs[] = {0x03, 0x00, 0x01, 0x02};
+  s.assign(funcs, funcs + sizeof(funcs));
+  put_section(&m, 3, s);
+
+  s.assign({0x01, 0x01});  // 1 memory with a maximum
+  put_u32(&s, pages);
+  put_u32(&s, 256);
+  put_section(&m, 5, s);
+
+  s.clear();
+  put_u32(&s, 3);
+  put_export(&s, "sum", 0);
+  put_export(&s, "fill", 1);
+  put_export(&s, "grow", 2);
+  put_section(&m, 7, s);
+
+  const uint8_t sum[] = {
+      0x01, 0x01, 0x7f,                          // local acc: i32
+      0x02, 0x40, 0x03, 0x40,                    // block loop
+      0x20, 0x00, 0x20, 0x01, 0x4f, 0x0d, 0x01,  // br_if 1 (from >= to)
+      0x20, 0x02, 0x20, 0x00, 0x28, 0x02, 0x00,  // acc += i32.load from
+      0x6a, 0x21, 0x02,
+      0x20, 0x00, 0x41, 0x04, 0x6a, 0x21, 0x00,  // from += 4
+      0x0c, 0x00, 0x0b, 0x0b,                    // br 0, end, end
+      0x20, 0x02, 0x0b,                          // acc
+  };
+  const uint8_t fill[] = {
+      0x00,
+      0x02, 0x40, 0x03, 0x40,                    // block loop
+      0x20, 0x00, 0x20, 0x01, 0x4f, 0x0d, 0x01,  // br_if 1 (from >= to)
+      0x20, 0x00, 0x20, 0x02, 0x36, 0x02, 0x00,  // i32.store from value
+      0x20, 0x00, 0x41, 0x04, 0x6a, 0x21, 0x00,  // from += 4
+      0x0c, 0x00, 0x0b, 0x0b, 0x0b,              // br 0, end, end, end
+  };
+  const uint8_t grow[] = {0x00, 0x20, 0x00, 0x40, 0x00, 0x0b};
+  s.clear();
+  put_u32(&s, 3);
+  put_u32(&s, sizeof(sum));
+  s.insert(s.end(), sum, sum + sizeof(sum));
+  put_u32(&s, sizeof(fill));
+  s.insert(s.end(), fill, fill + sizeof(fill));
+  put_u32(&s, sizeof(grow));
+  s.insert(s.end(), grow, grow + sizeof(grow));
+  put_section(&m, 10, s);
+
+  s.assign({0x01, 0x00, 0x41, DATA_OFFSET, 0x0b});
+  put_u32(&s, sizeof(data_seg));
+  s.insert(s.end(), data_seg, data_seg + sizeof(data_seg));
+  put_section(&m, 11, s);
+  return m;
+}
+
+// What sum() returns over a memory holding only the data segment
+static uint32_t data_seg_sum() {
+  uint8_t mem[DATA_OFFSET + sizeof(data_seg) + 4] = {0};
+  uint32_t sum = 0;
+
+  memcpy(mem + DATA_OFFSET, data_seg, sizeof(data_seg));
+  for (uint32_t i = 0; i + 4 <= sizeof(mem); i += 4) {
+    uint32_t word;
+    memcpy(&word, mem + i, 4);
+    sum += word;
+  }
+  return sum;
+}
+
+// ============================================================================
+// Measurement
+// ============================================================================
+
+static bool init_runtime(bool placed) {
+  RuntimeInitArgs init_args;
+  memset(&init_args, 0, sizeof(init_args));
+  init_args.mem_alloc_type = Alloc_With_Pool;
+  init_args.mem_alloc_option.pool.heap_buf = pool;
+  init_args.mem_alloc_option.pool.heap_size = sizeof(pool);
+  if (placed) {
+    init_args.mem_alloc_option.pool.fast_heap_buf = fast_pool;
+    init_args.mem_alloc_option.pool.fast_heap_size = sizeof(fast_pool);
+    init_args.mem_alloc_option.pool.fast_mem_classes =
+        MEM_CLASS_BIT(Mem_Class_LinearMemory) | MEM_CLASS_BIT(Mem_Class_Stack);
+  }
+  return wasm_runtime_full_init(&init_args);
+}
+
+static bool call(wasm_exec_env_t exec_env, wasm_module_inst_t inst,
+                 const char *name, uint32_t argc, uint32_t *argv) {
+  wasm_function_inst_t func = wasm_runtime_lookup_function(inst, name);
+  return func && wasm_runtime_call_wasm(exec_env, func, argc, argv);
+}
+
+// The instance's memory is zero but for the data segment, a grown page is
+// zero, and all of it is dirtied for the next instance to get
+static bool check_instance(wasm_module_inst_t inst, wasm_exec_env_t exec_env,
+                           uint32_t pages) {
+  uint32_t size = pages * WASM_PAGE_SIZE, argv[3];
+  static const uint32_t expected = data_seg_sum();
+
+  argv[0] = 0;
+  argv[1] = size;
+  if (!call(exec_env, inst, "sum", 2, argv) || argv[0] != expected) {
+    return false;
+  }
+  argv[0] = 0;
+  argv[1] = size;
+  argv[2] = 0xdeadbeef;
+  if (!call(exec_env, inst, "fill", 3, argv)) {
+    return false;
+  }
+
+  // The app heap may have been appended to the memory, so the grown page
+  // is the last one whatever the size was
+  argv[0] = 1;
+  if (!call(exec_env, inst, "grow", 1, argv) || argv[0] == 0xffffffffu) {
+    return false;
+  }
+  wasm_memory_inst_t memory = wasm_runtime_get_default_memory(inst);
+  uint64_t end = wasm_memory_get_cur_page_count(memory) *
+                 wasm_memory_get_bytes_per_page(memory);
+  argv[0] = (uint32_t)(end - WASM_PAGE_SIZE);
+  argv[1] = (uint32_t)end;
+  if (!call(exec_env, inst, "sum", 2, argv) || argv[0] != 0) {
+    return false;
+  }
+  argv[0] = (uint32_t)(end - WASM_PAGE_SIZE);
+  argv[1] = (uint32_t)end;
+  argv[2] = 0xdeadbeef;
+  return call(exec_env, inst, "fill", 3, argv);
+}
+
+static bool measure(bool placed, uint32_t pages, uint32_t stack_size) {
+  char error_buf[128];
+  std::vector<uint8_t> bytes = build_module(pages);
+  double instantiate_us = 0, exec_env_us = 0;
+  uint32_t iterations = BENCH_ITERATIONS * scale;
+  bool ok = true;
+
+  if (!init_runtime(placed)) {
+    fprintf(stderr, "wasm_runtime_full_init failed\n");
+    return false;
+  }
+  wasm_runtime_set_log_level(WASM_LOG_LEVEL_ERROR);
+
+  wasm_module_t module = wasm_runtime_load(
+      bytes.data(), (uint32_t)bytes.size(), error_buf, sizeof(error_buf));
+  if (!module) {
+    fprintf(stderr, "load %u pages: %s\n", pages, error_buf);
+    wasm_runtime_destroy();
+    return false;
+  }
+
+  for (uint32_t i = 0; i < iterations && ok; i++) {
+    double start = now_us();
+    wasm_module_inst_t inst = wasm_runtime_instantiate(
+        module, stack_size, BENCH_HEAP_SIZE, error_buf, sizeof(error_buf));
+    double instantiated = now_us();
+    if (!inst) {
+      fprintf(stderr, "instantiate %u pages: %s\n", pages, error_buf);
+      ok = false;
+      break;
+    }
+    wasm_exec_env_t exec_env = wasm_runtime_create_exec_env(inst, stack_size);
+    instantiate_us += instantiated - start;
+    exec_env_us += now_us() - instantiated;
+
+    // Check the first and the last instances, the ones between only get
+    // their memory dirtied
+    if (exec_env && (i == 0 || i == iterations - 1)) {
+      ok = check_instance(inst, exec_env, pages);
+    } else if (exec_env) {
+      uint32_t argv[3] = {0, pages * WASM_PAGE_SIZE, i};
+      ok = call(exec_env, inst, "fill", 3, argv);
+    } else {
+      ok = false;
+    }
+    if (!ok) {
+      fprintf(stderr, "%s, %u pages: check failed: %s\n",
+              placed ? "pool" : "mmap", pages,
+              wasm_runtime_get_exception(inst) ? wasm_runtime_get_exception(
+                                                     inst)
+                                               : "wrong result");
+    }
+    if (exec_env) {
+      wasm_runtime_destroy_exec_env(exec_env);
+    }
+    wasm_runtime_deinstantiate(inst);
+  }
+
+  wasm_runtime_unload(module);
+  wasm_runtime_destroy();
+
+  printf("%s,%u,%u,%.2f,%.2f,%s\n", placed ? "pool" : "mmap", pages,
+         stack_size / 1024, instantiate_us / iterations,
+         exec_env_us / iterations, ok ? "ok" : "FAIL");
+  return ok;
+}
+
+int main(int argc, char **argv) {
+  static const uint32_t page_counts[] = {1, 2, 4, 8, 16};
+  static const uint32_t stack_sizes[] = {16 * 1024, 64 * 1024};
+
+  for (int i = 1; i < argc; i++) {
+    if (strncmp(argv[i], "--scale=", 8) == 0) {
+      scale = (uint32_t)atoi(argv[i] + 8);
+      if (scale == 0) {
+        scale = 1;
+      }
+    } else {
+      fprintf(stderr, "usage: %s [--scale=N]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  bool all_ok = true;
+  printf("placement,pages,stack_kb,instantiate_us,exec_env_us,check\n");
+  for (int placed = 0; placed < 2; placed++) {
+    for (uint32_t pages : page_counts) {
+      for (uint32_t stack_size : stack_sizes) {
+        all_ok = measure(placed != 0, pages, stack_size) && all_ok;
+      }
+    }
+  }
+  return all_ok ? 0 : 1;
+}
@@ -0,0 +1,709 @@
+/*
+ * Host benchmark: fast-interpreter superinstructions
+ *
+ * Copyright (C) 2025 WAMR-ESP32-Arduino Contributors
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Runs the math and kernels modules loaded twice, once with the loader's
+ * superinstructions (WASM_ENABLE_SUPERINSTRUCTIONS) and once with
+ * LoadArgs.no_superinstructions, and checks that both give the same
+ * results. The fused sequences are
+ *   i32 comparison + br_if   loop exits and conditional branches
+ *   i32.add + i32 load       base + index addressing
+ * and i32 arithmetic with a constant operand runs as a single handler
+ * taking the constant as an immediate. A generated module also runs each
+ * of these opcodes over edge cases (signed and unsigned comparisons, a
+ * branch carrying a value, addresses wrapping around 2^32, an out of
+ * bounds load, the constant on either side, shift counts of 32 and more)
+ * against results computed here. A code cache built in one mode must be
+ * used when loading in that mode and ignored in the other.
+ *
+ * interp_bench_counted is the same program linked against a runtime built
+ * with WASM_ENABLE_OPCODE_COUNTER: it also reports how many handlers were
+ * dispatched, which is what the superinstructions save, and its timings
+ * include the counting.
+ *
+ * Usage:
+ *   interp_bench [--scale=N]
+ *   interp_bench_counted [--scale=N] [--top=N]
+ *
+ * Output is CSV:
+ *   workload,mode,iterations,us_per_iteration,dispatches,check
+ * where dispatches is per iteration and 0 unless counted. The counted
+ * build adds the handlers that ran most often in each workload, in either
+ * mode:
+ *   workload,opcode,plain_count,fused_count
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "wasm_export.h"
+
+#include "bench_modules.h"
+
+#define BENCH_POOL_SIZE (4 * 1024 * 1024)
+#define BENCH_STACK_SIZE (64 * 1024)
+#define WASM_PAGE_SIZE 65536
+#define OPCODE_NUM 256
+
+#define FIB_N 20
+#define FIB_EXPECTED 6765
+#define KERNEL_BYTES (32 * 1024)
+#define MATMUL_N 24
+
+// Offset immediate of the loads in the generated module
+#define LOAD_OFFSET 3
+
+static uint8_t pool[BENCH_POOL_SIZE];
+static uint32_t scale = 1;
+static uint32_t top = 8;
+
+enum Mode { Mode_Plain, Mode_Fused, Mode_Num };
+
+static const char *mode_names[Mode_Num] = {"plain", "fused"};
+
+static double now_us() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+// ============================================================================
+// Generated module
+// ============================================================================
+
+static void put_u32(std::vector<uint8_t> *out, uint32_t value) {
+  do {
+    uint8_t byte = value & 0x7f;
+    value >>= 7;
+    out->push_back(value ? byte | 0x80 : byte);
+  } while (value);
+}
+
+static void put_s32(std::vector<uint8_t> *out, int32_t value) {
+  bool more;
+  do {
+    uint8_t byte = value & 0x7f;
+    value >>= 7;
+    more = !((value == 0 && !(byte & 0x40)) || (value == -1 && (byte & 0x40)));
+    out->push_back(more ? byte | 0x80 : byte);
+  } while (more);
+}
+
+static void put_section(std::vector<uint8_t> *out, uint8_t id,
+                        const std::vector<uint8_t> &body) {
+  out->push_back(id);
+  put_u32(out, (uint32_t)body.size());
+  out->insert(out->end(), body.begin(), body.end());
+}
+
+static void put_export(std::vector<uint8_t> *out, const char *name,
+                       uint32_t func_index) {
+  put_u32(out, (uint32_t)strlen(name));
+  out->insert(out->end(), name, name + strlen(name));
+  out->push_back(0x00);
+  put_u32(out, func_index);
+}
+
+static void put_body(std::vector<uint8_t> *out,
+                     const std::vector<uint8_t> &body) {
+  put_u32(out, (uint32_t)body.size());
+  out->insert(out->end(), body.begin(), body.end());
+}
+
+struct CmpFunc {
+  const char *name;
+  uint8_t opcode;
+};
+
+static const CmpFunc cmp_funcs[] = {
+    {"eqz", 0x45},  {"eq", 0x46},   {"ne", 0x47},   {"lt_s", 0x48},
+    {"lt_u", 0x49}, {"gt_s", 0x4a}, {"gt_u", 0x4b}, {"le_s", 0x4c},
+    {"le_u", 0x4d}, {"ge_s", 0x4e}, {"ge_u", 0x4f},
+};
+
+#define CMP_FUNC_COUNT (sizeof(cmp_funcs) / sizeof(cmp_funcs[0]))
+
+struct LoadFunc {
+  const char *name;
+  uint8_t opcode;
+};
+
+static const LoadFunc load_funcs[] = {
+    {"load", 0x28},     {"load8_s", 0x2c},  {"load8_u", 0x2d},
+    {"load16_s", 0x2e}, {"load16_u", 0x2f},
+};
+
+#define LOAD_FUNC_COUNT (sizeof(load_funcs) / sizeof(load_funcs[0]))
+
+struct ImmFunc {
+  const char *name;
+  uint8_t opcode;
+  int32_t imm;
+};
+
+static const ImmFunc imm_funcs[] = {
+    {"add_imm", 0x6a, 0x7fffffff},      {"sub_imm", 0x6b, 5},
+    {"mul_imm", 0x6c, -3},              {"and_imm", 0x71, (int32_t)0xedb88320},
+    {"or_imm", 0x72, (int32_t)0x80000001}, {"xor_imm", 0x73, -1},
+    {"shl_imm", 0x74, 33},              {"shr_s_imm", 0x75, 35},
+    {"shr_u_imm", 0x76, -1},
+};
+
+#define IMM_FUNC_COUNT (sizeof(imm_funcs) / sizeof(imm_funcs[0]))
+
+// (memory 1), every function (i32, i32) -> i32:
+//   <cmp>(a, b)       block (result i32) 1, a <cmp> b, br_if 0, drop 0 end
+//   <load>(base, i)   <load> offset=LOAD_OFFSET (base + i)
+//   <op>_imm(a, _)    a <op> imm
+//   <op>_imm_lhs(a, _) imm <op> a
+static std::vector<uint8_t> build_patterns_module() {
+  std::vector<uint8_t> m = {0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00};
+  std::vector<uint8_t> s;
+  uint32_t func_count = CMP_FUNC_COUNT + LOAD_FUNC_COUNT + IMM_FUNC_COUNT * 2;
+  uint32_t index = 0;
+  char name[32];
+
+  s.assign({0x01, 0x60, 0x02, 0x7f, 0x7f, 0x01, 0x7f});
+  put_section(&m, 1, s);
+
+  s.clear();
+  put_u32(&s, func_count);
+  s.insert(s.end(), func_count, 0x00);
+  put_section(&m, 3, s);
+
+  s.assign({0x01, 0x00, 0x01});
+  put_section(&m, 5, s);
+
+  s.clear();
+  put_u32(&s, func_count);
+  for (const CmpFunc &f : cmp_funcs) {
+    put_export(&s, f.name, index++);
+  }
+  for (const LoadFunc &f : load_funcs) {
+    put_export(&s, f.name, index++);
+  }
+  for (const ImmFunc &f : imm_funcs) {
+    put_export(&s, f.name, index++);
+    snprintf(name, sizeof(name), "%s_lhs", f.name);
+    put_export(&s, name, index++);
+  }
+  put_section(&m, 7, s);
+
+  s.clear();
+  put_u32(&s, func_count);
+  for (const CmpFunc &f : cmp_funcs) {
+    std::vector<uint8_t> body = {0x00, 0x02, 0x7f, 0x41, 0x01, 0x20, 0x00};
+    if (f.opcode != 0x45) {
+      body.insert(body.end(), {0x20, 0x01});
+    }
+    body.insert(body.end(), {f.opcode, 0x0d, 0x00, 0x1a, 0x41, 0x00, 0x0b,
+                             0x0b});
+    put_body(&s, body);
+  }
+  for (const LoadFunc &f : load_funcs) {
+    put_body(&s, {0x00, 0x20, 0x00, 0x20, 0x01, 0x6a, f.opcode, 0x00,
+                  LOAD_OFFSET, 0x0b});
+  }
+  for (const ImmFunc &f : imm_funcs) {
+    std::vector<uint8_t> body = {0x00, 0x20, 0x00, 0x41};
+    put_s32(&body, f.imm);
+    body.insert(body.end(), {f.opcode, 0x0b});
+    put_body(&s, body);
+
+    body.assign({0x00, 0x41});
+    put_s32(&body, f.imm);
+    body.insert(body.end(), {0x20, 0x00, f.opcode, 0x0b});
+    put_body(&s, body);
+  }
+  put_section(&m, 10, s);
+  return m;
+}
+
+// ============================================================================
+// Instances
+// ============================================================================
+
+struct Instance {
+  wasm_module_t module;
+  wasm_module_inst_t inst;
+  wasm_exec_env_t exec_env;
+};
+
+static void release(Instance *in) {
+  if (in->exec_env) {
+    wasm_runtime_destroy_exec_env(in->exec_env);
+  }
+  if (in->inst) {
+    wasm_runtime_deinstantiate(in->inst);
+  }
+  if (in->module) {
+    wasm_runtime_unload(in->module);
+  }
+  memset(in, 0, sizeof(*in));
+}
+
+static bool instantiate(const uint8_t *bytes, uint32_t size, Mode mode,
+                        Instance *in) {
+  char error_buf[128];
+  LoadArgs load_args;
+
+  memset(in, 0, sizeof(*in));
+  memset(&load_args, 0, sizeof(load_args));
+  load_args.name = const_cast<char *>("");
+  load_args.wasm_binary_readonly = true;
+  load_args.no_superinstructions = mode == Mode_Plain;
+  in->module = wasm_runtime_load_ex(const_cast<uint8_t *>(bytes), size,
+                                    &load_args, error_buf, sizeof(error_buf));
+  if (in->module) {
+    // No app heap, so that the memory ends where the module says
+    in->inst = wasm_runtime_instantiate(in->module, BENCH_STACK_SIZE, 0,
+                                        error_buf, sizeof(error_buf));
+  }
+  if (in->inst && !(in->exec_env = wasm_runtime_create_exec_env(
+                        in->inst, BENCH_STACK_SIZE))) {
+    snprintf(error_buf, sizeof(error_buf), "create exec_env failed");
+  }
+  if (!in->exec_env) {
+    fprintf(stderr, "%s: %s\n", mode_names[mode], error_buf);
+    release(in);
+    return false;
+  }
+  return true;
+}
+
+static bool call(const Instance &in, const char *name, uint32_t argc,
+                 uint32_t *argv) {
+  wasm_function_inst_t func = wasm_runtime_lookup_function(in.inst, name);
+  return func && wasm_runtime_call_wasm(in.exec_env, func, argc, argv);
+}
+
+static uint8_t *memory_base(const Instance &in) {
+  return (uint8_t *)wasm_runtime_addr_app_to_native(in.inst, 0);
+}
+
+// ============================================================================
+// Pattern checks
+// ============================================================================
+
+static uint32_t cmp_expected(uint8_t opcode, uint32_t a, uint32_t b) {
+  int32_t sa = (int32_t)a, sb = (int32_t)b;
+
+  switch (opcode) {
+    case 0x45: return a == 0;
+    case 0x46: return a == b;
+    case 0x47: return a != b;
+    case 0x48: return sa < sb;
+    case 0x49: return a < b;
+    case 0x4a: return sa > sb;
+    case 0x4b: return a > b;
+    case 0x4c: return sa <= sb;
+    case 0x4d: return a <= b;
+    case 0x4e: return sa >= sb;
+    default: return a >= b;
+  }
+}
+
+static uint32_t imm_expected(uint8_t opcode, uint32_t a, uint32_t b) {
+  switch (opcode) {
+    case 0x6a: return a + b;
+    case 0x6b: return a - b;
+    case 0x6c: return a * b;
+    case 0x71: return a & b;
+    case 0x72: return a | b;
+    case 0x73: return a ^ b;
+    case 0x74: return a << (b % 32);
+    case 0x75: return (uint32_t)((int32_t)a >> (b % 32));
+    default: return a >> (b % 32);
+  }
+}
+
+static uint32_t load_expected(const uint8_t *mem, uint8_t opcode,
+                              uint32_t addr) {
+  uint32_t u32;
+  uint16_t u16;
+
+  switch (opcode) {
+    case 0x28:
+      memcpy(&u32, mem + addr, 4);
+      return u32;
+    case 0x2c: return (uint32_t)(int32_t)(int8_t)mem[addr];
+    case 0x2d: return mem[addr];
+    case 0x2e:
+      memcpy(&u16, mem + addr, 2);
+      return (uint32_t)(int32_t)(int16_t)u16;
+    default:
+      memcpy(&u16, mem + addr, 2);
+      return u16;
+  }
+}
+
+static uint32_t load_size(uint8_t opcode) {
+  return opcode == 0x28 ? 4 : opcode == 0x2c || opcode == 0x2d ? 1 : 2;
+}
+
+static bool fail_pattern(const char *mode, const char *name, uint32_t a,
+                         uint32_t b) {
+  fprintf(stderr, "%s: %s(0x%x, 0x%x) gave a wrong result\n", mode, name, a,
+          b);
+  return false;
+}
+
+static bool check_patterns(const Instance &in, Mode mode) {
+  static const uint32_t pairs[][2] = {
+      {0, 0},          {1, 2},          {2, 1},
+      {0xffffffff, 1}, {1, 0xffffffff}, {0x80000000, 0x7fffffff},
+      {0x7fffffff, 0x80000000}, {0xffffffff, 0xffffffff}, {5, 5},
+  };
+  const char *m = mode_names[mode];
+  uint8_t *mem = memory_base(in);
+  uint32_t argv[2];
+
+  for (const CmpFunc &f : cmp_funcs) {
+    for (const auto &pair : pairs) {
+      argv[0] = pair[0];
+      argv[1] = pair[1];
+      if (!call(in, f.name, 2, argv) ||
+          argv[0] != cmp_expected(f.opcode, pair[0], pair[1])) {
+        return fail_pattern(m, f.name, pair[0], pair[1]);
+      }
+    }
+  }
+
+  for (uint32_t i = 0; i < WASM_PAGE_SIZE; i++) {
+    mem[i] = (uint8_t)(i * 131 + 7);
+  }
+  for (const LoadFunc &f : load_funcs) {
+    uint32_t last = WASM_PAGE_SIZE - LOAD_OFFSET - load_size(f.opcode);
+    // The sum wraps around 2^32 before the offset is added
+    const uint32_t loads[][2] = {
+        {0, 0}, {100, 23}, {last, 0}, {0xfffffff0, 0x20}, {7, 0xfffffffe},
+    };
+    for (const auto &load : loads) {
+      uint32_t addr = load[0] + load[1] + LOAD_OFFSET;
+      argv[0] = load[0];
+      argv[1] = load[1];
+      if (!call(in, f.name, 2, argv) ||
+          argv[0] != load_expected(mem, f.opcode, addr)) {
+        return fail_pattern(m, f.name, load[0], load[1]);
+      }
+    }
+
+    // One byte past the end of the memory
+    argv[0] = last;
+    argv[1] = 1;
+    const char *exception;
+    if (call(in, f.name, 2, argv) ||
+        !(exception = wasm_runtime_get_exception(in.inst)) ||
+        !strstr(exception, "out of bounds memory access")) {
+      fprintf(stderr, "%s: %s past the end didn't trap\n", m, f.name);
+      return false;
+    }
+    wasm_runtime_clear_exception(in.inst);
+  }
+
+  for (const ImmFunc &f : imm_funcs) {
+    char lhs_name[32];
+    uint32_t imm = (uint32_t)f.imm;
+
+    snprintf(lhs_name, sizeof(lhs_name), "%s_lhs", f.name);
+    for (const auto &pair : pairs) {
+      argv[0] = pair[0];
+      argv[1] = pair[1];
+      if (!call(in, f.name, 2, argv) ||
+          argv[0] != imm_expected(f.opcode, pair[0], imm)) {
+        return fail_pattern(m, f.name, pair[0], imm);
+      }
+      argv[0] = pair[0];
+      argv[1] = pair[1];
+      if (!call(in, lhs_name, 2, argv) ||
+          argv[0] != imm_expected(f.opcode, imm, pair[0])) {
+        return fail_pattern(m, lhs_name, imm, pair[0]);
+      }
+    }
+  }
+
+  return true;
+}
+
+// ============================================================================
+// Workloads
+// ============================================================================
+
+struct Workload {
+  const char *name;
+  bool kernels;
+  const char *func;
+  uint32_t argc;
+  uint32_t args[3];
+  bool has_result;
+  uint32_t iterations;
+};
+
+// Run in this order on the same instances: matmul multiplies what fill
+// and memcpy_loop left in the memory
+static const Workload workloads[] = {
+    {"fibonacci", false, "fibonacci", 1, {FIB_N}, true, 20},
+    {"fill", true, "fill", 3, {0, KERNEL_BYTES, 7}, false, 20},
+    {"memcpy_loop", true, "memcpy_loop", 3,
+     {KERNEL_BYTES, 0, KERNEL_BYTES}, false, 20},
+    {"crc32", true, "crc32", 2, {0, KERNEL_BYTES}, true, 4},
+    {"matmul", true, "matmul", 1, {MATMUL_N}, true, 20},
+};
+
+#define WORKLOAD_COUNT (sizeof(workloads) / sizeof(workloads[0]))
+#define PATTERNS WORKLOAD_COUNT
+
+struct Result {
+  double us_per_iteration;
+  uint64_t dispatches;
+  uint32_t value;
+  bool ok;
+};
+
+// Rows: the workloads, then the pattern checks
+static Result results[WORKLOAD_COUNT + 1][Mode_Num];
+static uint64_t opcode_counts[WORKLOAD_COUNT + 1][Mode_Num][OPCODE_NUM];
+
+// Counts of the last run, 0 when the runtime doesn't count
+static uint64_t read_opcode_counts(uint64_t *counts) {
+  uint64_t total = 0;
+  const char *name;
+
+  for (uint32_t i = 0; i < OPCODE_NUM; i++) {
+    counts[i] = wasm_runtime_get_opcode_count(i, &name);
+    total += counts[i];
+  }
+  return total;
+}
+
+// FNV-1a over the kernels' working area, for the workloads that only
+// write memory
+static uint32_t memory_hash(const Instance &in) {
+  const uint8_t *mem = memory_base(in);
+  uint32_t hash = 2166136261u;
+
+  for (uint32_t i = 0; i < 2 * KERNEL_BYTES; i++) {
+    hash = (hash ^ mem[i]) * 16777619u;
+  }
+  return hash;
+}
+
+static bool run_workload(uint32_t w, const Instance &math,
+                         const Instance &kernels, Mode mode) {
+  const Workload &wl = workloads[w];
+  const Instance &in = wl.kernels ? kernels : math;
+  Result *r = &results[w][mode];
+  uint32_t iterations = wl.iterations * scale, argv[3];
+
+  wasm_runtime_reset_opcode_counts();
+  r->ok = true;
+  double start = now_us();
+  for (uint32_t i = 0; i < iterations && r->ok; i++) {
+    memcpy(argv, wl.args, sizeof(argv));
+    r->ok = call(in, wl.func, wl.argc, argv);
+  }
+  r->us_per_iteration = (now_us() - start) / iterations;
+  r->dispatches = read_opcode_counts(opcode_counts[w][mode]) / iterations;
+
+  if (!r->ok) {
+    const char *exception = wasm_runtime_get_exception(in.inst);
+    fprintf(stderr, "%s %s: %s\n", mode_names[mode], wl.name,
+            exception ? exception : "call failed");
+    return false;
+  }
+  r->value = wl.has_result ? argv[0] : memory_hash(in);
+  if (w == 0 && r->value != FIB_EXPECTED) {
+    fprintf(stderr, "%s fibonacci: got %u\n", mode_names[mode], r->value);
+    r->ok = false;
+  }
+  return r->ok;
+}
+
+static bool run_mode(Mode mode, const std::vector<uint8_t> &patterns) {
+  Instance math, kernels, checks;
+  bool ok = true;
+
+  if (!instantiate(math_wasm, math_wasm_len, mode, &math)) {
+    return false;
+  }
+  if (!instantiate(kernels_wasm, kernels_wasm_len, mode, &kernels)) {
+    release(&math);
+    return false;
+  }
+  for (uint32_t w = 0; w < WORKLOAD_COUNT; w++) {
+    ok = run_workload(w, math, kernels, mode) && ok;
+  }
+  release(&kernels);
+  release(&math);
+
+  Result *r = &results[PATTERNS][mode];
+  if (instantiate(patterns.data(), (uint32_t)patterns.size(), mode,
+                  &checks)) {
+    wasm_runtime_reset_opcode_counts();
+    double start = now_us();
+    r->ok = check_patterns(checks, mode);
+    r->us_per_iteration = now_us() - start;
+    r->dispatches = read_opcode_counts(opcode_counts[PATTERNS][mode]);
+    release(&checks);
+  }
+  return r->ok && ok;
+}
+
+// Whether the math module loads from a code cache built in another mode
+static bool load_with_cache(Mode built, Mode loaded, bool *used) {
+  char error_buf[128];
+  LoadArgs load_args;
+  uint8_t *cache = nullptr;
+  uint32_t cache_size = 0;
+
+  memset(&load_args, 0, sizeof(load_args));
+  load_args.name = const_cast<char *>("");
+  load_args.wasm_binary_readonly = true;
+  load_args.no_superinstructions = built == Mode_Plain;
+  load_args.code_cache_record = true;
+  wasm_module_t module =
+      wasm_runtime_load_ex(const_cast<uint8_t *>(math_wasm), math_wasm_len,
+                           &load_args, error_buf, sizeof(error_buf));
+  if (module) {
+    cache_size = wasm_runtime_save_code_cache(module, nullptr, 0);
+    cache = cache_size ? (uint8_t *)malloc(cache_size) : nullptr;
+    if (cache &&
+        wasm_runtime_save_code_cache(module, cache, cache_size) != cache_size) {
+      free(cache);
+      cache = nullptr;
+    }
+    wasm_runtime_unload(module);
+  }
+  if (!cache) {
+    fprintf(stderr, "%s: build code cache failed\n", mode_names[built]);
+    return false;
+  }
+
+  load_args.no_superinstructions = loaded == Mode_Plain;
+  load_args.code_cache_record = false;
+  load_args.code_cache = cache;
+  load_args.code_cache_size = cache_size;
+  module = wasm_runtime_load_ex(const_cast<uint8_t *>(math_wasm),
+                                math_wasm_len, &load_args, error_buf,
+                                sizeof(error_buf));
+  if (module) {
+    *used = wasm_runtime_is_code_cache_used(module);
+    wasm_runtime_unload(module);
+  } else {
+    fprintf(stderr, "%s: %s\n", mode_names[loaded], error_buf);
+  }
+  free(cache);
+  return module != nullptr;
+}
+
+static bool check_code_cache(Mode mode) {
+  Mode other = mode == Mode_Plain ? Mode_Fused : Mode_Plain;
+  bool same_used = false, other_used = true;
+
+  return load_with_cache(mode, mode, &same_used) &&
+         load_with_cache(mode, other, &other_used) && same_used &&
+         !other_used;
+}
+
+#if WASM_ENABLE_OPCODE_COUNTER != 0
+static void print_top_opcodes(uint32_t w, const char *name) {
+  const uint64_t(*counts)[OPCODE_NUM] = opcode_counts[w];
+  std::vector<uint32_t> order;
+  const char *opcode_name;
+
+  for (uint32_t i = 0; i < OPCODE_NUM; i++) {
+    if (counts[Mode_Plain][i] || counts[Mode_Fused][i]) {
+      order.push_back(i);
+    }
+  }
+  std::sort(order.begin(), order.end(), [counts](uint32_t a, uint32_t b) {
+    return std::max(counts[Mode_Plain][a], counts[Mode_Fused][a]) >
+           std::max(counts[Mode_Plain][b], counts[Mode_Fused][b]);
+  });
+  if (order.size() > top) {
+    order.resize(top);
+  }
+  for (uint32_t i : order) {
+    wasm_runtime_get_opcode_count(i, &opcode_name);
+    printf("%s,%s,%llu,%llu\n", name, opcode_name ? opcode_name : "?",
+           (unsigned long long)counts[Mode_Plain][i],
+           (unsigned long long)counts[Mode_Fused][i]);
+  }
+}
+#endif
+
+int main(int argc, char **argv) {
+  for (int i = 1; i < argc; i++) {
+    if (strncmp(argv[i], "--scale=", 8) == 0) {
+      scale = (uint32_t)atoi(argv[i] + 8);
+      if (scale == 0) {
+        scale = 1;
+      }
+    } else if (strncmp(argv[i], "--top=", 6) == 0) {
+      top = (uint32_t)atoi(argv[i] + 6);
+    } else {
+      fprintf(stderr, "usage: %s [--scale=N] [--top=N]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  RuntimeInitArgs init_args;
+  memset(&init_args, 0, sizeof(init_args));
+  init_args.mem_alloc_type = Alloc_With_Pool;
+  init_args.mem_alloc_option.pool.heap_buf = pool;
+  init_args.mem_alloc_option.pool.heap_size = sizeof(pool);
+  if (!wasm_runtime_full_init(&init_args)) {
+    fprintf(stderr, "wasm_runtime_full_init failed\n");
+    return 1;
+  }
+  wasm_runtime_set_log_level(WASM_LOG_LEVEL_ERROR);
+
+  std::vector<uint8_t> patterns = build_patterns_module();
+  bool all_ok = true, cache_ok[Mode_Num];
+  for (int mode = 0; mode < Mode_Num; mode++) {
+    all_ok = run_mode((Mode)mode, patterns) && all_ok;
+  }
+  for (int mode = 0; mode < Mode_Num; mode++) {
+    cache_ok[mode] = check_code_cache((Mode)mode);
+  }
+  wasm_runtime_destroy();
+
+  // Both modes must agree, and superinstructions must not add dispatches
+  printf("workload,mode,iterations,us_per_iteration,dispatches,check\n");
+  for (uint32_t w = 0; w <= WORKLOAD_COUNT; w++) {
+    const char *name = w < WORKLOAD_COUNT ? workloads[w].name : "patterns";
+    uint32_t iterations = w < WORKLOAD_COUNT ? workloads[w].iterations * scale
+                                             : 1;
+    Result *r = results[w];
+    bool same = r[Mode_Plain].value == r[Mode_Fused].value &&
+                r[Mode_Fused].dispatches <= r[Mode_Plain].dispatches;
+    for (int mode = 0; mode < Mode_Num; mode++) {
+      bool ok = r[mode].ok && same;
+      printf("%s,%s,%u,%.1f,%llu,%s\n", name, mode_names[mode], iterations,
+             r[mode].us_per_iteration,
+             (unsigned long long)r[mode].dispatches, ok ? "ok" : "FAIL");
+      all_ok = all_ok && ok;
+    }
+  }
+  for (int mode = 0; mode < Mode_Num; mode++) {
+    printf("code_cache,%s,1,0.0,0,%s\n", mode_names[mode],
+           cache_ok[mode] ? "ok" : "FAIL");
+    all_ok = all_ok && cache_ok[mode];
+  }
+
+#if WASM_ENABLE_OPCODE_COUNTER != 0
+  printf("\nworkload,opcode,plain_count,fused_count\n");
+  for (uint32_t w = 0; w <= WORKLOAD_COUNT; w++) {
+    print_top_opcodes(w, w < WORKLOAD_COUNT ? workloads[w].name : "patterns");
+  }
+#endif
+
+  return all_ok ? 0 : 1;
+}
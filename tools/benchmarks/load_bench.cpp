@@ -0,0 +1,427 @@
+/*
+ * Host benchmark: module load footprint and time, heap vs load arena
+ *
+ * Copyright (C) 2025 WAMR-ESP32-Arduino Contributors
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Loads each module read-only, as WamrModule::load() does, once with every
+ * loader allocation a heap block and once with LoadArgs.load_arena, in a
+ * fresh runtime pool each time. The modules are the math and kernels
+ * modules of the examples, generated modules with 16, 48 and 160 functions,
+ * exports and globals, like small applications, and any extra .wasm files.
+ *
+ * Columns:
+ *   wasm_bytes  size of the binary
+ *   pool_bytes  pool bytes the loaded module holds, allocator headers and
+ *               the arena's unused chunk space included
+ *   peak_bytes  most pool bytes in use while loading
+ *   load_us     average time of a load, unload_us of an unload
+ *   check       the module instantiates and an exported function returns
+ *               the same value in both modes
+ *
+ * With --lazy, both modes load with LoadArgs.lazy_lowering, and the check
+ * covers lowering on the first call.
+ *
+ * Usage:
+ *   load_bench [--lazy] [--scale=N] [module.wasm ...]
+ *
+ * Output is CSV:
+ *   module,wasm_bytes,mode,pool_bytes,peak_bytes,load_us,unload_us,check
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <string>
+#include <vector>
+
+#include "wasm_export.h"
+
+#include "bench_modules.h"
+
+#define BENCH_POOL_SIZE (2 * 1024 * 1024)
+#define BENCH_LOADS 200
+#define BENCH_STACK_SIZE (64 * 1024)  // The generated module recurses
+#define BENCH_HEAP_SIZE (64 * 1024)
+
+#define SYNTH_GLOBALS 24
+#define SYNTH_DATA_SEGS 8
+
+static uint8_t pool[BENCH_POOL_SIZE];
+static uint32_t scale = 1;
+static bool lazy = false;
+
+struct ModuleSource {
+  std::string name;
+  std::vector<uint8_t> bytes;
+  const char *func;  // Exported (i32, i32) -> i32 function to check, if any
+};
+
+struct LoadResult {
+  uint32_t pool_bytes;
+  uint32_t peak_bytes;
+  double load_us;
+  double unload_us;
+  bool ok;
+  uint32_t ret;
+};
+
+static double now_us() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+// ============================================================================
+// Generated module
+// ============================================================================
+
+static void put_u32(std::vector<uint8_t> *out, uint32_t value) {
+  do {
+    uint8_t byte = value & 0x7f;
+    value >>= 7;
+    out->push_back(value ? byte | 0x80 : byte);
+  } while (value);
+}
+
+static void put_i32(std::vector<uint8_t> *out, int32_t value) {
+  bool more = true;
+  while (more) {
+    uint8_t byte = value & 0x7f;
+    value >>= 7;
+    more = !((value == 0 && !(byte & 0x40)) || (value == -1 && (byte & 0x40)));
+    out->push_back(more ? byte | 0x80 : byte);
+  }
+}
+
+static void put_name(std::vector<uint8_t> *out, const std::string &name) {
+  put_u32(out, (uint32_t)name.size());
+  out->insert(out->end(), name.begin(), name.end());
+}
+
+static void put_section(std::vector<uint8_t> *out, uint8_t id,
+                        const std::vector<uint8_t> &body) {
+  out->push_back(id);
+  put_u32(out, (uint32_t)body.size());
+  out->insert(out->end(), body.begin(), body.end());
+}
+
+// Function i: (a, b) -> i32 looping a + b times over a few locals, globals
+// and memory loads, then adding the result of function i - 1 called on
+// the loop value, so each body has blocks, branches, calls and constants
+static std::vector<uint8_t> synth_body(uint32_t i) {
+  std::vector<uint8_t> b;
+  b.push_back(1);  // 1 local entry: 3 x i32
+  put_u32(&b, 3);
+  b.push_back(0x7f);
+
+  const uint8_t head[] = {
+      0x20, 0x00, 0x20, 0x01, 0x6a, 0x21, 0x02,  // l2 = a + b
+      0x02, 0x40, 0x03, 0x40,                    // block loop
+      0x20, 0x02, 0x45, 0x0d, 0x01,              // br_if 1 (l2 == 0)
+      0x20, 0x03, 0x20, 0x02, 0x73,              // l3 ^ l2
+  };
+  b.insert(b.end(), head, head + sizeof(head));
+  b.push_back(0x41);  // * const
+  put_i32(&b, (int32_t)(i * 2654435761u) | 1);
+  b.push_back(0x6c);
+  b.push_back(0x23);  // + global
+  put_u32(&b, i % SYNTH_GLOBALS);
+  b.push_back(0x6a);
+  b.push_back(0x21);  // -> l3
+  b.push_back(0x03);
+  const uint8_t tail[] = {
+      0x20, 0x02, 0x41, 0x01, 0x6b, 0x21, 0x02,  // l2 -= 1
+      0x0c, 0x00, 0x0b, 0x0b,                    // br 0, end, end
+      0x20, 0x03,                                // l3
+      0x41, 0x00,                                // + i32.load offset
+      0x28, 0x02,
+  };
+  b.insert(b.end(), tail, tail + sizeof(tail));
+  put_u32(&b, (i * 4) % 1024);
+  b.push_back(0x6a);
+  if (i > 0) {
+    const uint8_t call[] = {0x20, 0x03, 0x41, 0x07, 0x71, 0x41, 0x00};
+    b.insert(b.end(), call, call + sizeof(call));  // f(l3 & 7, 0)
+    b.push_back(0x10);
+    put_u32(&b, i - 1);
+    b.push_back(0x6a);
+  }
+  b.push_back(0x0b);
+
+  std::vector<uint8_t> out;
+  put_u32(&out, (uint32_t)b.size());
+  out.insert(out.end(), b.begin(), b.end());
+  return out;
+}
+
+static std::vector<uint8_t> build_synth_module(uint32_t func_count) {
+  std::vector<uint8_t> m = {0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00};
+  std::vector<uint8_t> s;
+
+  // Types: the one used and a few others, as a toolchain emits them
+  const uint8_t types[] = {
+      0x60, 0x02, 0x7f, 0x7f, 0x01, 0x7f,  // (i32, i32) -> i32
+      0x60, 0x00, 0x00,                    // () -> ()
+      0x60, 0x01, 0x7f, 0x00,              // (i32) -> ()
+      0x60, 0x01, 0x7e, 0x01, 0x7e,        // (i64) -> i64
+      0x60, 0x03, 0x7f, 0x7f, 0x7f, 0x01, 0x7f,
+  };
+  put_u32(&s, 5);
+  s.insert(s.end(), types, types + sizeof(types));
+  put_section(&m, 1, s);
+
+  s.clear();
+  put_u32(&s, func_count);
+  for (uint32_t i = 0; i < func_count; i++) {
+    s.push_back(0);
+  }
+  put_section(&m, 3, s);
+
+  s.clear();  // Table for call_indirect, filled by the element segment
+  const uint8_t table[] = {0x01, 0x70, 0x00};
+  s.insert(s.end(), table, table + sizeof(table));
+  put_u32(&s, func_count);
+  put_section(&m, 4, s);
+
+  s.clear();
+  const uint8_t memory[] = {0x01, 0x00, 0x01};  // 1 page
+  s.insert(s.end(), memory, memory + sizeof(memory));
+  put_section(&m, 5, s);
+
+  s.clear();
+  put_u32(&s, SYNTH_GLOBALS);
+  for (uint32_t i = 0; i < SYNTH_GLOBALS; i++) {
+    s.push_back(0x7f);
+    s.push_back(0x01);
+    s.push_back(0x41);
+    put_i32(&s, (int32_t)i * 17);
+    s.push_back(0x0b);
+  }
+  put_section(&m, 6, s);
+
+  s.clear();  // Half of the functions and the memory
+  put_u32(&s, func_count / 2 + 1);
+  for (uint32_t i = 0; i < func_count; i += 2) {
+    put_name(&s, "synth_func_" + std::to_string(i));
+    s.push_back(0x00);
+    put_u32(&s, i);
+  }
+  put_name(&s, "memory");
+  s.push_back(0x02);
+  put_u32(&s, 0);
+  put_section(&m, 7, s);
+
+  s.clear();
+  const uint8_t elem[] = {0x01, 0x00, 0x41, 0x00, 0x0b};
+  s.insert(s.end(), elem, elem + sizeof(elem));
+  put_u32(&s, func_count);
+  for (uint32_t i = 0; i < func_count; i++) {
+    put_u32(&s, i);
+  }
+  put_section(&m, 9, s);
+
+  s.clear();
+  put_u32(&s, func_count);
+  for (uint32_t i = 0; i < func_count; i++) {
+    std::vector<uint8_t> body = synth_body(i);
+    s.insert(s.end(), body.begin(), body.end());
+  }
+  put_section(&m, 10, s);
+
+  s.clear();
+  put_u32(&s, SYNTH_DATA_SEGS);
+  for (uint32_t i = 0; i < SYNTH_DATA_SEGS; i++) {
+    s.push_back(0x00);
+    s.push_back(0x41);
+    put_i32(&s, (int32_t)i * 64);
+    s.push_back(0x0b);
+    put_u32(&s, 32);
+    for (uint32_t j = 0; j < 32; j++) {
+      s.push_back((uint8_t)(i * 32 + j));
+    }
+  }
+  put_section(&m, 11, s);
+  return m;
+}
+
+// ============================================================================
+// Measurement
+// ============================================================================
+
+static bool init_runtime() {
+  RuntimeInitArgs init_args;
+  memset(&init_args, 0, sizeof(init_args));
+  init_args.mem_alloc_type = Alloc_With_Pool;
+  init_args.mem_alloc_option.pool.heap_buf = pool;
+  init_args.mem_alloc_option.pool.heap_size = sizeof(pool);
+  return wasm_runtime_full_init(&init_args);
+}
+
+static uint32_t pool_used(uint32_t *highmark) {
+  mem_alloc_info_t info;
+  // Blocks freed by the loader may sit in this thread's cache
+  wasm_runtime_flush_thread_alloc_cache();
+  wasm_runtime_get_mem_alloc_info(&info);
+  if (highmark) {
+    *highmark = info.highmark_size;
+  }
+  return info.total_size - info.total_free_size;
+}
+
+static wasm_module_t load(const ModuleSource &src, bool arena,
+                          char *error_buf, uint32_t error_buf_size) {
+  LoadArgs load_args;
+  memset(&load_args, 0, sizeof(load_args));
+  load_args.name = const_cast<char *>("");
+  load_args.wasm_binary_readonly = true;
+  load_args.lazy_lowering = lazy;
+  load_args.load_arena = arena;
+  return wasm_runtime_load_ex(const_cast<uint8_t *>(src.bytes.data()),
+                              (uint32_t)src.bytes.size(), &load_args,
+                              error_buf, error_buf_size);
+}
+
+static bool check_module(const ModuleSource &src, wasm_module_t module,
+                         uint32_t *ret) {
+  char error_buf[128];
+  wasm_module_inst_t inst =
+      wasm_runtime_instantiate(module, BENCH_STACK_SIZE, BENCH_HEAP_SIZE,
+                               error_buf, sizeof(error_buf));
+  if (!inst) {
+    fprintf(stderr, "%s: %s\n", src.name.c_str(), error_buf);
+    return false;
+  }
+  bool ok = true;
+  *ret = 0;
+  if (src.func) {
+    wasm_function_inst_t func = wasm_runtime_lookup_function(inst, src.func);
+    wasm_exec_env_t exec_env =
+        wasm_runtime_create_exec_env(inst, BENCH_STACK_SIZE);
+    uint32_t argv[2] = {5, 7};
+    ok = func && exec_env && wasm_runtime_call_wasm(exec_env, func, 2, argv);
+    *ret = argv[0];
+    if (exec_env) {
+      wasm_runtime_destroy_exec_env(exec_env);
+    }
+  }
+  wasm_runtime_deinstantiate(inst);
+  return ok;
+}
+
+static LoadResult measure(const ModuleSource &src, bool arena) {
+  LoadResult r;
+  char error_buf[128];
+  uint32_t highmark;
+
+  memset(&r, 0, sizeof(r));
+  if (!init_runtime()) {
+    fprintf(stderr, "wasm_runtime_full_init failed\n");
+    return r;
+  }
+  wasm_runtime_set_log_level(WASM_LOG_LEVEL_ERROR);
+
+  uint32_t used_before = pool_used(nullptr);
+  wasm_module_t module = load(src, arena, error_buf, sizeof(error_buf));
+  if (!module) {
+    fprintf(stderr, "%s: %s\n", src.name.c_str(), error_buf);
+    wasm_runtime_destroy();
+    return r;
+  }
+  r.pool_bytes = pool_used(&highmark) - used_before;
+  r.peak_bytes = highmark - used_before;
+  r.ok = check_module(src, module, &r.ret);
+  wasm_runtime_unload(module);
+
+  uint32_t loads = BENCH_LOADS * scale;
+  for (uint32_t i = 0; i < loads && r.ok; i++) {
+    double start = now_us();
+    module = load(src, arena, error_buf, sizeof(error_buf));
+    double loaded = now_us();
+    if (!module) {
+      r.ok = false;
+      break;
+    }
+    wasm_runtime_unload(module);
+    r.load_us += loaded - start;
+    r.unload_us += now_us() - loaded;
+  }
+  r.load_us /= loads;
+  r.unload_us /= loads;
+
+  wasm_runtime_destroy();
+  return r;
+}
+
+static bool read_file(const char *path, std::vector<uint8_t> *bytes) {
+  FILE *f = fopen(path, "rb");
+  if (!f) {
+    return false;
+  }
+  fseek(f, 0, SEEK_END);
+  long size = ftell(f);
+  fseek(f, 0, SEEK_SET);
+  bytes->resize(size > 0 ? size : 0);
+  bool ok = size > 0 && fread(bytes->data(), 1, size, f) == (size_t)size;
+  fclose(f);
+  return ok;
+}
+
+int main(int argc, char **argv) {
+  std::vector<ModuleSource> sources;
+  sources.push_back(
+      {"math", std::vector<uint8_t>(math_wasm, math_wasm + math_wasm_len),
+       "add"});
+  sources.push_back(
+      {"kernels",
+       std::vector<uint8_t>(kernels_wasm, kernels_wasm + kernels_wasm_len),
+       nullptr});
+  sources.push_back({"synth16", build_synth_module(16), "synth_func_14"});
+  sources.push_back({"synth48", build_synth_module(48), "synth_func_46"});
+  sources.push_back({"synth160", build_synth_module(160), "synth_func_158"});
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--lazy") == 0) {
+      lazy = true;
+    } else if (strncmp(argv[i], "--scale=", 8) == 0) {
+      scale = (uint32_t)atoi(argv[i] + 8);
+      if (scale == 0) {
+        scale = 1;
+      }
+    } else if (argv[i][0] == '-') {
+      fprintf(stderr, "usage: %s [--lazy] [--scale=N] [module.wasm ...]\n",
+              argv[0]);
+      return 2;
+    } else {
+      ModuleSource src;
+      const char *base = strrchr(argv[i], '/');
+      src.name = base ? base + 1 : argv[i];
+      src.func = nullptr;
+      if (!read_file(argv[i], &src.bytes)) {
+        fprintf(stderr, "cannot read %s\n", argv[i]);
+        return 1;
+      }
+      sources.push_back(src);
+    }
+  }
+
+  bool all_ok = true;
+  printf("module,wasm_bytes,mode,pool_bytes,peak_bytes,load_us,unload_us,"
+         "check\n");
+  for (const ModuleSource &src : sources) {
+    LoadResult heap = measure(src, false);
+    LoadResult arena = measure(src, true);
+    bool ok = heap.ok && arena.ok && heap.ret == arena.ret;
+    const LoadResult *rows[2] = {&heap, &arena};
+    for (int i = 0; i < 2; i++) {
+      printf("%s,%zu,%s,%u,%u,%.2f,%.2f,%s\n", src.name.c_str(),
+             src.bytes.size(), i ? "arena" : "heap", rows[i]->pool_bytes,
+             rows[i]->peak_bytes, rows[i]->load_us, rows[i]->unload_us,
+             ok ? "ok" : "FAIL");
+    }
+    all_ok &= ok;
+  }
+  return all_ok ? 0 : 1;
+}
@@ -0,0 +1,449 @@
+/*
+ * Host tool: memory taken by the runtime's structures for a module
+ *
+ * Copyright (C) 2025 WAMR-ESP32-Arduino Contributors
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Loads and instantiates each module the way WamrModule does (read-only
+ * binary, fast interpreter), then walks the loaded WASMModule and its
+ * WASMModuleInstance and reports what each kind of structure takes:
+ *   WASMModule, types, imports, function_ptrs, WASMFunction,
+ *   function_locals (local types and local offsets), compiled_code,
+ *   consts, tables, memories, globals, exports, table_segments,
+ *   data_segments, const_strings   loaded module
+ *   WASMModuleInstance (with its memory, table and global data),
+ *   import_func_ptrs, WASMFunctionInstance, global_instances,
+ *   export_functions                instance
+ * followed by the total of the rows and the pool used by the load, which
+ * adds the allocator's header of each block.
+ *
+ * metadata_report_compact is the same program linked against a runtime
+ * built with WASM_ENABLE_COMPACT_METADATA. Sizes are the host's: on a
+ * 32-bit target each pointer takes 4 bytes instead of 8.
+ *
+ * Usage:
+ *   metadata_report [--functions=N] [file.wasm ...]
+ *   metadata_report_compact [--functions=N] [file.wasm ...]
+ * Without files it reports math, kernels and a generated module of N
+ * functions (default 2000) with three params, two locals and two consts
+ * each, all exported.
+ *
+ * Output is CSV:
+ *   module,layout,structure,count,bytes_each,bytes,blocks
+ * where bytes_each is the struct size, or the average for data of varying
+ * size, and blocks the heap blocks the structure takes.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include "wasm_export.h"
+#include "wasm.h"
+#include "wasm_runtime.h"
+
+#include "bench_modules.h"
+
+#define BENCH_POOL_SIZE (16 * 1024 * 1024)
+#define BENCH_STACK_SIZE (16 * 1024)
+
+static uint8_t pool[BENCH_POOL_SIZE];
+static uint32_t function_count = 2000;
+
+static const char *layout_name =
+    WASM_ENABLE_COMPACT_METADATA ? "compact" : "full";
+
+// ============================================================================
+// Generated module
+// ============================================================================
+
+static void put_u32(std::vector<uint8_t> *out, uint32_t value) {
+  do {
+    uint8_t byte = value & 0x7f;
+    value >>= 7;
+    out->push_back(value ? byte | 0x80 : byte);
+  } while (value);
+}
+
+static void put_s32(std::vector<uint8_t> *out, int32_t value) {
+  bool more;
+  do {
+    uint8_t byte = value & 0x7f;
+    value >>= 7;
+    more = !((value == 0 && !(byte & 0x40)) || (value == -1 && (byte & 0x40)));
+    out->push_back(more ? byte | 0x80 : byte);
+  } while (more);
+}
+
+static void put_section(std::vector<uint8_t> *out, uint8_t id,
+                        const std::vector<uint8_t> &body) {
+  out->push_back(id);
+  put_u32(out, (uint32_t)body.size());
+  out->insert(out->end(), body.begin(), body.end());
+}
+
+// Function k is (i32 a, i64 b, f64 c) -> i32 with locals (i32 x, i64 y):
+//   x = a + k; y = b + 1000; return x + (i32)y
+// exported as "f<k>"
+static std::vector<uint8_t> build_module(uint32_t count) {
+  std::vector<uint8_t> out = {0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00};
+  std::vector<uint8_t> sec, body;
+  char name[16];
+
+  put_section(&out, 1, {1, 0x60, 3, 0x7f, 0x7e, 0x7c, 1, 0x7f});
+
+  put_u32(&sec, count);
+  for (uint32_t k = 0; k < count; k++) {
+    sec.push_back(0);
+  }
+  put_section(&out, 3, sec);
+
+  sec.clear();
+  put_u32(&sec, count);
+  for (uint32_t k = 0; k < count; k++) {
+    snprintf(name, sizeof(name), "f%u", k);
+    put_u32(&sec, (uint32_t)strlen(name));
+    sec.insert(sec.end(), name, name + strlen(name));
+    sec.push_back(0x00);
+    put_u32(&sec, k);
+  }
+  put_section(&out, 7, sec);
+
+  sec.clear();
+  put_u32(&sec, count);
+  for (uint32_t k = 0; k < count; k++) {
+    body = {2, 1, 0x7f, 1, 0x7e, 0x20, 0x00, 0x41};
+    put_s32(&body, (int32_t)k);
+    body.insert(body.end(), {0x6a, 0x21, 0x03, 0x20, 0x01, 0x42});
+    put_s32(&body, 1000);
+    body.insert(body.end(), {0x7c, 0x21, 0x04, 0x20, 0x03, 0x20, 0x04, 0xa7,
+                             0x6a, 0x0b});
+    put_u32(&sec, (uint32_t)body.size());
+    sec.insert(sec.end(), body.begin(), body.end());
+  }
+  put_section(&out, 10, sec);
+  return out;
+}
+
+// ============================================================================
+// Report
+// ============================================================================
+
+struct Row {
+  const char *structure;
+  uint64_t count;
+  uint64_t bytes_each;
+  uint64_t bytes;
+  uint64_t blocks;
+};
+
+static void add_row(std::vector<Row> *rows, const char *structure,
+                    uint64_t count, uint64_t bytes_each, uint64_t bytes,
+                    uint64_t blocks) {
+  rows->push_back({structure, count, bytes_each, bytes, blocks});
+}
+
+// bytes_each is the average of data of varying size
+static void add_data_row(std::vector<Row> *rows, const char *structure,
+                         uint64_t count, uint64_t bytes, uint64_t blocks) {
+  add_row(rows, structure, count, count ? bytes / count : 0, bytes, blocks);
+}
+
+static void report_module(const WASMModule *module, std::vector<Row> *rows) {
+  uint64_t bytes, blocks;
+  uint32_t i;
+
+  add_row(rows, "WASMModule", 1, sizeof(WASMModule), sizeof(WASMModule), 1);
+
+  bytes = sizeof(WASMType *) * (uint64_t)module->type_count;
+  for (i = 0; i < module->type_count; i++) {
+    const WASMFuncType *type = (const WASMFuncType *)module->types[i];
+    bytes += offsetof(WASMFuncType, types) + type->param_count +
+             type->result_count;
+  }
+  add_data_row(rows, "types", module->type_count, bytes,
+               module->type_count ? module->type_count + 1 : 0);
+
+  add_row(rows, "imports", module->import_count, sizeof(WASMImport),
+          sizeof(WASMImport) * (uint64_t)module->import_count,
+          module->import_count ? 1 : 0);
+
+  add_row(rows, "function_ptrs", module->function_count,
+          sizeof(WASMFunction *),
+          sizeof(WASMFunction *) * (uint64_t)module->function_count,
+          module->function_count ? 1 : 0);
+
+  add_row(rows, "WASMFunction", module->function_count, sizeof(WASMFunction),
+          sizeof(WASMFunction) * (uint64_t)module->function_count,
+          module->function_count);
+
+  // Local types trail each function; the local offsets are allocated with
+  // it in the compact layout and on their own otherwise
+  bytes = blocks = 0;
+  for (i = 0; i < module->function_count; i++) {
+    const WASMFunction *func = module->functions[i];
+    uint64_t local_num = func->func_type->param_count + func->local_count;
+    bytes += func->local_count + sizeof(uint16) * local_num;
+    if (!WASM_ENABLE_COMPACT_METADATA && local_num > 0) {
+      blocks++;
+    }
+  }
+  add_data_row(rows, "function_locals", module->function_count, bytes,
+               blocks);
+
+  bytes = blocks = 0;
+  for (i = 0; i < module->function_count; i++) {
+    if (module->functions[i]->code_compiled) {
+      bytes += module->functions[i]->code_compiled_size;
+      blocks++;
+    }
+  }
+  add_data_row(rows, "compiled_code", module->function_count, bytes, blocks);
+
+  bytes = blocks = 0;
+  for (i = 0; i < module->function_count; i++) {
+    if (module->functions[i]->consts) {
+      bytes += sizeof(uint32) * module->functions[i]->const_cell_num;
+      blocks++;
+    }
+  }
+  add_data_row(rows, "consts", module->function_count, bytes, blocks);
+
+  add_row(rows, "tables", module->table_count, sizeof(WASMTable),
+          sizeof(WASMTable) * (uint64_t)module->table_count,
+          module->table_count ? 1 : 0);
+  add_row(rows, "memories", module->memory_count, sizeof(WASMMemory),
+          sizeof(WASMMemory) * (uint64_t)module->memory_count,
+          module->memory_count ? 1 : 0);
+  add_row(rows, "globals", module->global_count, sizeof(WASMGlobal),
+          sizeof(WASMGlobal) * (uint64_t)module->global_count,
+          module->global_count ? 1 : 0);
+  add_row(rows, "exports", module->export_count, sizeof(WASMExport),
+          sizeof(WASMExport) * (uint64_t)module->export_count,
+          module->export_count ? 1 : 0);
+
+  bytes = sizeof(WASMTableSeg) * (uint64_t)module->table_seg_count;
+  blocks = module->table_seg_count ? 1 : 0;
+  for (i = 0; i < module->table_seg_count; i++) {
+    const WASMTableSeg *seg = &module->table_segments[i];
+    if (seg->init_values) {
+      bytes += sizeof(InitializerExpression) * (uint64_t)seg->value_count;
+      blocks++;
+    }
+  }
+  add_data_row(rows, "table_segments", module->table_seg_count, bytes,
+               blocks);
+
+  bytes = sizeof(WASMDataSeg *) * (uint64_t)module->data_seg_count;
+  blocks = module->data_seg_count ? module->data_seg_count + 1 : 0;
+  for (i = 0; i < module->data_seg_count; i++) {
+    const WASMDataSeg *seg = module->data_segments[i];
+    bytes += sizeof(WASMDataSeg);
+    if (seg->is_data_cloned) {
+      bytes += seg->data_length;
+      blocks++;
+    }
+  }
+  add_data_row(rows, "data_segments", module->data_seg_count, bytes, blocks);
+
+  bytes = blocks = 0;
+  for (const StringNode *node = module->const_str_list; node;
+       node = node->next) {
+    bytes += sizeof(StringNode) + strlen(node->str) + 1;
+    blocks++;
+  }
+  add_data_row(rows, "const_strings", blocks, bytes, blocks);
+}
+
+static void report_instance(const WASMModuleInstance *inst,
+                            std::vector<Row> *rows) {
+  const WASMModuleInstanceExtra *e = inst->e;
+  uint64_t bytes;
+
+  bytes = (uint64_t)((const uint8 *)e - (const uint8 *)inst) +
+          sizeof(WASMModuleInstanceExtra);
+  add_row(rows, "WASMModuleInstance", 1, bytes, bytes, 1);
+
+  add_row(rows, "import_func_ptrs", inst->module->import_function_count,
+          sizeof(void *),
+          sizeof(void *) * (uint64_t)inst->module->import_function_count,
+          inst->module->import_function_count ? 1 : 0);
+  add_row(rows, "WASMFunctionInstance", e->function_count,
+          sizeof(WASMFunctionInstance),
+          sizeof(WASMFunctionInstance) * (uint64_t)e->function_count,
+          e->function_count ? 1 : 0);
+  add_row(rows, "global_instances", e->global_count,
+          sizeof(WASMGlobalInstance),
+          sizeof(WASMGlobalInstance) * (uint64_t)e->global_count,
+          e->global_count ? 1 : 0);
+  add_row(rows, "export_functions", inst->export_func_count,
+          sizeof(WASMExportFuncInstance),
+          sizeof(WASMExportFuncInstance) * (uint64_t)inst->export_func_count,
+          inst->export_func_count ? 1 : 0);
+}
+
+static uint32_t pool_used() {
+  mem_alloc_info_t info;
+
+  // Freed blocks held by this thread's cache would count as used
+  wasm_runtime_flush_thread_alloc_cache();
+  wasm_runtime_get_mem_alloc_info(&info);
+  return info.total_size - info.total_free_size;
+}
+
+// Calls f<k>(7, 5, 0.0) of the generated module, which returns 1012 + k
+static bool check_generated(wasm_module_inst_t inst, uint32_t count) {
+  wasm_exec_env_t exec_env =
+      wasm_runtime_create_exec_env(inst, BENCH_STACK_SIZE);
+  uint32_t samples[] = {0, count / 2, count - 1};
+  bool ok = exec_env != NULL;
+  char name[16];
+
+  for (uint32_t k : samples) {
+    uint32_t argv[5] = {7, 5, 0, 0, 0};
+    snprintf(name, sizeof(name), "f%u", k);
+    wasm_function_inst_t func = wasm_runtime_lookup_function(inst, name);
+    if (!ok || !func ||
+        !wasm_runtime_call_wasm(exec_env, func, 5, argv) ||
+        argv[0] != 1012 + k) {
+      const char *exception = wasm_runtime_get_exception(inst);
+      fprintf(stderr, "%s: %s\n", name,
+              exception ? exception : "wrong result");
+      ok = false;
+      break;
+    }
+  }
+  if (exec_env) {
+    wasm_runtime_destroy_exec_env(exec_env);
+  }
+  return ok;
+}
+
+static bool report(const char *name, const uint8_t *bytes, uint32_t size,
+                   bool generated) {
+  char error_buf[128];
+  LoadArgs load_args;
+  std::vector<Row> rows;
+  uint32_t used_before = pool_used();
+  bool ok = true;
+
+  memset(&load_args, 0, sizeof(load_args));
+  load_args.name = const_cast<char *>("");
+  load_args.wasm_binary_readonly = true;
+  wasm_module_t module =
+      wasm_runtime_load_ex(const_cast<uint8_t *>(bytes), size, &load_args,
+                           error_buf, sizeof(error_buf));
+  if (!module) {
+    fprintf(stderr, "%s: load: %s\n", name, error_buf);
+    return false;
+  }
+  if (wasm_runtime_get_module_package_type(module) != Wasm_Module_Bytecode) {
+    fprintf(stderr, "%s: not a wasm bytecode module\n", name);
+    wasm_runtime_unload(module);
+    return false;
+  }
+  uint32_t load_used = pool_used() - used_before;
+
+  wasm_module_inst_t inst = wasm_runtime_instantiate(
+      module, BENCH_STACK_SIZE, 0, error_buf, sizeof(error_buf));
+  if (!inst) {
+    fprintf(stderr, "%s: instantiate: %s\n", name, error_buf);
+    wasm_runtime_unload(module);
+    return false;
+  }
+
+  report_module((const WASMModule *)module, &rows);
+  report_instance((const WASMModuleInstance *)inst, &rows);
+  if (generated) {
+    ok = check_generated(inst, function_count);
+  }
+
+  Row total = {"total", 0, 0, 0, 0};
+  for (const Row &row : rows) {
+    total.bytes += row.bytes;
+    total.blocks += row.blocks;
+  }
+  rows.push_back(total);
+  add_row(&rows, "pool_load", 1, load_used, load_used, 0);
+
+  for (const Row &row : rows) {
+    printf("%s,%s,%s,%llu,%llu,%llu,%llu\n", name, layout_name,
+           row.structure, (unsigned long long)row.count,
+           (unsigned long long)row.bytes_each, (unsigned long long)row.bytes,
+           (unsigned long long)row.blocks);
+  }
+
+  wasm_runtime_deinstantiate(inst);
+  wasm_runtime_unload(module);
+  return ok;
+}
+
+static bool read_file(const char *path, std::vector<uint8_t> *out) {
+  FILE *file = fopen(path, "rb");
+  uint8_t buf[4096];
+  size_t n;
+
+  if (!file) {
+    fprintf(stderr, "%s: cannot open\n", path);
+    return false;
+  }
+  while ((n = fread(buf, 1, sizeof(buf), file)) > 0) {
+    out->insert(out->end(), buf, buf + n);
+  }
+  fclose(file);
+  return true;
+}
+
+int main(int argc, char **argv) {
+  std::vector<const char *> files;
+
+  for (int i = 1; i < argc; i++) {
+    if (strncmp(argv[i], "--functions=", 12) == 0) {
+      function_count = (uint32_t)atoi(argv[i] + 12);
+      if (function_count == 0 || function_count > 100000) {
+        function_count = 2000;
+      }
+    } else if (argv[i][0] == '-') {
+      fprintf(stderr, "usage: %s [--functions=N] [file.wasm ...]\n",
+              argv[0]);
+      return 2;
+    } else {
+      files.push_back(argv[i]);
+    }
+  }
+
+  RuntimeInitArgs init_args;
+  memset(&init_args, 0, sizeof(init_args));
+  init_args.mem_alloc_type = Alloc_With_Pool;
+  init_args.mem_alloc_option.pool.heap_buf = pool;
+  init_args.mem_alloc_option.pool.heap_size = sizeof(pool);
+  if (!wasm_runtime_full_init(&init_args)) {
+    fprintf(stderr, "wasm_runtime_full_init failed\n");
+    return 1;
+  }
+  wasm_runtime_set_log_level(WASM_LOG_LEVEL_FATAL);
+
+  bool all_ok = true;
+  printf("module,layout,structure,count,bytes_each,bytes,blocks\n");
+  if (files.empty()) {
+    std::vector<uint8_t> generated = build_module(function_count);
+    all_ok = report("math", math_wasm, math_wasm_len, false);
+    all_ok = report("kernels", kernels_wasm, kernels_wasm_len, false) &&
+             all_ok;
+    all_ok = report("generated", generated.data(),
+                    (uint32_t)generated.size(), true) &&
+             all_ok;
+  }
+  for (const char *path : files) {
+    std::vector<uint8_t> bytes;
+    all_ok = read_file(path, &bytes) &&
+             report(path, bytes.data(), (uint32_t)bytes.size(), false) &&
+             all_ok;
+  }
+
+  wasm_runtime_destroy();
+  return all_ok ? 0 : 1;
+}
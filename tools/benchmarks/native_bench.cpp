@@ -0,0 +1,765 @@
+/*
+ * Host benchmark: round trips from wasm into natives
+ *
+ * Copyright (C) 2025 WAMR-ESP32-Arduino Contributors
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * A generated module imports one native of each signature shape that has
+ * a direct trampoline (WASM_ENABLE_NATIVE_TRAMPOLINES), plus "(iii)i"
+ * which has none, and exports a loop calling each of them. The module is
+ * loaded twice, once with the trampolines and once with
+ * LoadArgs.no_native_trampolines, which sends every call through
+ * wasm_runtime_invoke_native(). Each loop's result and the state the
+ * natives left are checked against values computed here, and a few single
+ * calls check what the trampolines must keep doing: the attachment, an
+ * exception raised by the native, and "(*~)" buffers out of bounds.
+ *
+ * The module also imports fast natives (WASM_ENABLE_FAST_NATIVES), which
+ * take the wasm cells of their params: leaf ones, called without a frame,
+ * and framed ones, one of which calls back into wasm. The modes don't
+ * change how fast natives are called.
+ *
+ * "loop" runs the same loop without a call, for the cost of the loop
+ * itself.
+ *
+ * Usage:
+ *   native_bench [--scale=N]
+ *
+ * Output is CSV:
+ *   native,kind,signature,mode,calls,ns_per_call,check
+ * where kind is plain, fast_leaf or fast_framed.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <vector>
+
+#include "wasm_export.h"
+
+#define BENCH_POOL_SIZE (1024 * 1024)
+#define BENCH_STACK_SIZE (16 * 1024)
+#define WASM_PAGE_SIZE 65536
+
+#define CALLS 200000
+#define REPEATS 3
+#define BUFFER_LEN 16
+
+static uint8_t pool[BENCH_POOL_SIZE];
+static uint32_t scale = 1;
+
+enum Mode { Mode_Generic, Mode_Trampoline, Mode_Num };
+
+static const char *mode_names[Mode_Num] = {"generic", "trampoline"};
+
+static double now_us() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+// ============================================================================
+// Natives
+// ============================================================================
+
+// What the natives without a result leave behind
+static uint32_t native_state;
+static uint32_t tick_counter;
+
+static void native_nop(wasm_exec_env_t exec_env) { native_state++; }
+
+static int32_t native_tick(wasm_exec_env_t exec_env) {
+  uint32_t *counter = (uint32_t *)wasm_runtime_get_function_attachment(
+      exec_env);
+  return (int32_t)(*counter)++;
+}
+
+static void native_sink(wasm_exec_env_t exec_env, int32_t a) {
+  native_state = native_state * 31 + (uint32_t)a;
+}
+
+static int32_t native_twice(wasm_exec_env_t exec_env, int32_t a) {
+  if (a == -1) {
+    wasm_runtime_set_exception(wasm_runtime_get_module_inst(exec_env),
+                               "twice of -1");
+    return 0;
+  }
+  return 2 * a + 1;
+}
+
+static void native_pair(wasm_exec_env_t exec_env, int32_t a, int32_t b) {
+  native_state = native_state * 31 + (uint32_t)a + (uint32_t)b * 1000;
+}
+
+static int32_t native_mix(wasm_exec_env_t exec_env, int32_t a, int32_t b) {
+  return (int32_t)(((uint32_t)a * 31) ^ (uint32_t)b);
+}
+
+static void native_checksum(wasm_exec_env_t exec_env, const uint8_t *buf,
+                            uint32_t len) {
+  for (uint32_t i = 0; i < len; i++) {
+    native_state += buf[i];
+  }
+}
+
+static float native_scale(wasm_exec_env_t exec_env, float x) {
+  return x * 0.5f + 1.0f;
+}
+
+static int32_t native_mix3(wasm_exec_env_t exec_env, int32_t a, int32_t b,
+                           int32_t c) {
+  return (int32_t)((uint32_t)a * 31 + (uint32_t)b * 7 + (uint32_t)c);
+}
+
+// Fast natives: params and result in the wasm cells
+
+static void fast_nop(wasm_exec_env_t exec_env, uint32_t *cells) {
+  native_state++;
+}
+
+static void fast_twice(wasm_exec_env_t exec_env, uint32_t *cells) {
+  if ((int32_t)cells[0] == -1) {
+    wasm_runtime_set_exception(wasm_runtime_get_module_inst(exec_env),
+                               "twice of -1");
+    return;
+  }
+  cells[0] = 2 * cells[0] + 1;
+}
+
+static void fast_mix(wasm_exec_env_t exec_env, uint32_t *cells) {
+  cells[0] = (cells[0] * 31) ^ cells[1];
+}
+
+static void fast_mix3(wasm_exec_env_t exec_env, uint32_t *cells) {
+  cells[0] = cells[0] * 31 + cells[1] * 7 + cells[2];
+}
+
+// An i64 takes two cells
+static void fast_wide(wasm_exec_env_t exec_env, uint32_t *cells) {
+  uint64_t x;
+  memcpy(&x, cells, sizeof(x));
+  x = x * 3 + 1;
+  memcpy(cells, &x, sizeof(x));
+}
+
+// Set once instantiated, for fast_callback
+static wasm_function_inst_t add1_func;
+
+// Calls back into wasm for x + 1, then adds x read from its cells again,
+// which the callback must not have overwritten
+static void fast_callback(wasm_exec_env_t exec_env, uint32_t *cells) {
+  uint32_t argv[1] = {cells[0]};
+  if (wasm_runtime_call_wasm(exec_env, add1_func, 1, argv)) {
+    cells[0] += argv[0];
+  }
+}
+
+// Sorted by the runtime when registered, so not const
+static NativeSymbol natives[] = {
+    {"nop", (void *)native_nop, "()", NULL},
+    {"tick", (void *)native_tick, "()i", &tick_counter},
+    {"sink", (void *)native_sink, "(i)", NULL},
+    {"twice", (void *)native_twice, "(i)i", NULL},
+    {"pair", (void *)native_pair, "(ii)", NULL},
+    {"mix", (void *)native_mix, "(ii)i", NULL},
+    {"checksum", (void *)native_checksum, "(*~)", NULL},
+    {"scale", (void *)native_scale, "(f)f", NULL},
+    {"mix3", (void *)native_mix3, "(iii)i", NULL},
+};
+
+static NativeSymbol fast_leaf_natives[] = {
+    {"fast_nop", (void *)fast_nop, "()", NULL},
+    {"fast_twice", (void *)fast_twice, "(i)i", NULL},
+    {"fast_mix", (void *)fast_mix, "(ii)i", NULL},
+    {"fast_mix3", (void *)fast_mix3, "(iii)i", NULL},
+    {"fast_wide", (void *)fast_wide, "(I)I", NULL},
+};
+
+static NativeSymbol fast_framed_natives[] = {
+    {"framed_mix3", (void *)fast_mix3, "(iii)i", NULL},
+    {"fast_callback", (void *)fast_callback, "(i)i", NULL},
+};
+
+#define NATIVE_COUNT (sizeof(natives) / sizeof(natives[0]))
+#define FAST_LEAF_COUNT \
+  (sizeof(fast_leaf_natives) / sizeof(fast_leaf_natives[0]))
+#define FAST_FRAMED_COUNT \
+  (sizeof(fast_framed_natives) / sizeof(fast_framed_natives[0]))
+
+// ============================================================================
+// Generated module
+// ============================================================================
+
+static void put_u32(std::vector<uint8_t> *out, uint32_t value) {
+  do {
+    uint8_t byte = value & 0x7f;
+    value >>= 7;
+    out->push_back(value ? byte | 0x80 : byte);
+  } while (value);
+}
+
+static void put_name(std::vector<uint8_t> *out, const char *name) {
+  put_u32(out, (uint32_t)strlen(name));
+  out->insert(out->end(), name, name + strlen(name));
+}
+
+static void put_section(std::vector<uint8_t> *out, uint8_t id,
+                        const std::vector<uint8_t> &body) {
+  out->push_back(id);
+  put_u32(out, (uint32_t)body.size());
+  out->insert(out->end(), body.begin(), body.end());
+}
+
+static void put_body(std::vector<uint8_t> *out,
+                     const std::vector<uint8_t> &body) {
+  put_u32(out, (uint32_t)body.size());
+  out->insert(out->end(), body.begin(), body.end());
+}
+
+// Types of the module, in the order of the type section
+enum Type {
+  Type_Void,     // ()
+  Type_RetI,     // ()i
+  Type_I,        // (i)
+  Type_IRetI,    // (i)i, also the loops: (calls) -> result
+  Type_II,       // (ii)
+  Type_IIRetI,   // (ii)i
+  Type_FRetF,    // (f)f
+  Type_IIIRetI,  // (iii)i
+  Type_LRetL,    // (I)I
+};
+
+// Operands the loops pass, with i the loop counter and acc the result so
+// far
+enum Arg {
+  Arg_I,
+  Arg_Acc,
+  Arg_Seven,
+  Arg_Offset,
+  Arg_Len,
+  Arg_FloatI,
+  Arg_WideI,
+};
+
+// How a loop folds the native's result into acc
+enum Fold { Fold_None, Fold_Add, Fold_Set, Fold_AddBits, Fold_AddWide };
+
+// What a native computes, for the expected results
+enum Calc {
+  Calc_Count,
+  Calc_Tick,
+  Calc_Sink,
+  Calc_Twice,
+  Calc_Pair,
+  Calc_Mix,
+  Calc_Checksum,
+  Calc_Scale,
+  Calc_Mix3,
+  Calc_Wide,
+};
+
+enum Kind { Kind_Plain, Kind_FastLeaf, Kind_FastFramed };
+
+static const char *kind_names[] = {"plain", "fast_leaf", "fast_framed"};
+
+struct Import {
+  const char *name;
+  Kind kind;
+  Type type;
+  uint32_t argc;
+  Arg args[3];
+  Fold fold;
+  Calc calc;
+};
+
+// Same order as the function indices of the imports
+static const Import imports[] = {
+    {"nop", Kind_Plain, Type_Void, 0, {}, Fold_None, Calc_Count},
+    {"tick", Kind_Plain, Type_RetI, 0, {}, Fold_Add, Calc_Tick},
+    {"sink", Kind_Plain, Type_I, 1, {Arg_I}, Fold_None, Calc_Sink},
+    {"twice", Kind_Plain, Type_IRetI, 1, {Arg_I}, Fold_Add, Calc_Twice},
+    {"pair", Kind_Plain, Type_II, 2, {Arg_I, Arg_Seven}, Fold_None,
+     Calc_Pair},
+    {"mix", Kind_Plain, Type_IIRetI, 2, {Arg_I, Arg_Acc}, Fold_Set,
+     Calc_Mix},
+    {"checksum", Kind_Plain, Type_II, 2, {Arg_Offset, Arg_Len}, Fold_None,
+     Calc_Checksum},
+    {"scale", Kind_Plain, Type_FRetF, 1, {Arg_FloatI}, Fold_AddBits,
+     Calc_Scale},
+    {"mix3", Kind_Plain, Type_IIIRetI, 3, {Arg_I, Arg_Acc, Arg_Seven},
+     Fold_Set, Calc_Mix3},
+    {"fast_nop", Kind_FastLeaf, Type_Void, 0, {}, Fold_None, Calc_Count},
+    {"fast_twice", Kind_FastLeaf, Type_IRetI, 1, {Arg_I}, Fold_Add,
+     Calc_Twice},
+    {"fast_mix", Kind_FastLeaf, Type_IIRetI, 2, {Arg_I, Arg_Acc}, Fold_Set,
+     Calc_Mix},
+    {"fast_mix3", Kind_FastLeaf, Type_IIIRetI, 3, {Arg_I, Arg_Acc, Arg_Seven},
+     Fold_Set, Calc_Mix3},
+    {"fast_wide", Kind_FastLeaf, Type_LRetL, 1, {Arg_WideI}, Fold_AddWide,
+     Calc_Wide},
+    {"framed_mix3", Kind_FastFramed, Type_IIIRetI, 3,
+     {Arg_I, Arg_Acc, Arg_Seven}, Fold_Set, Calc_Mix3},
+    {"fast_callback", Kind_FastFramed, Type_IRetI, 1, {Arg_I}, Fold_Add,
+     Calc_Twice},
+};
+
+#define IMPORT_COUNT (sizeof(imports) / sizeof(imports[0]))
+
+static uint32_t import_index(const char *name) {
+  for (uint32_t i = 0; i < IMPORT_COUNT; i++) {
+    if (strcmp(imports[i].name, name) == 0) {
+      return i;
+    }
+  }
+  return 0;
+}
+
+static void put_arg(std::vector<uint8_t> *body, Arg arg) {
+  switch (arg) {
+    case Arg_I:
+      body->insert(body->end(), {0x20, 1});
+      break;
+    case Arg_Acc:
+      body->insert(body->end(), {0x20, 2});
+      break;
+    case Arg_Seven:
+      body->insert(body->end(), {0x41, 7});
+      break;
+    case Arg_Offset:
+      // i & 255
+      body->insert(body->end(), {0x20, 1, 0x41, 0xff, 0x01, 0x71});
+      break;
+    case Arg_Len:
+      body->insert(body->end(), {0x41, BUFFER_LEN});
+      break;
+    case Arg_FloatI:
+      // f32.convert_i32_s
+      body->insert(body->end(), {0x20, 1, 0xb2});
+      break;
+    case Arg_WideI:
+      // i64.extend_i32_u
+      body->insert(body->end(), {0x20, 1, 0xad});
+      break;
+  }
+}
+
+// (calls) -> acc, calling import `func` once per iteration, or nothing
+// for a negative `func`. Locals: 1 is i, 2 is acc
+static std::vector<uint8_t> loop_body(int func) {
+  std::vector<uint8_t> body = {0x01, 0x02, 0x7f, 0x03, 0x40};
+
+  if (func >= 0) {
+    const Import &im = imports[func];
+    for (uint32_t a = 0; a < im.argc; a++) {
+      put_arg(&body, im.args[a]);
+    }
+    body.push_back(0x10);
+    put_u32(&body, (uint32_t)func);
+    switch (im.fold) {
+      case Fold_None:
+        break;
+      case Fold_Add:
+        body.insert(body.end(), {0x20, 2, 0x6a, 0x21, 2});
+        break;
+      case Fold_Set:
+        body.insert(body.end(), {0x21, 2});
+        break;
+      case Fold_AddBits:
+        // i32.reinterpret_f32
+        body.insert(body.end(), {0xbc, 0x20, 2, 0x6a, 0x21, 2});
+        break;
+      case Fold_AddWide:
+        // i32.wrap_i64
+        body.insert(body.end(), {0xa7, 0x20, 2, 0x6a, 0x21, 2});
+        break;
+    }
+  }
+  // i = i + 1; br_if (i < calls)
+  body.insert(body.end(), {0x20, 1, 0x41, 1, 0x6a, 0x22, 1, 0x20, 0, 0x49,
+                           0x0d, 0x00, 0x0b, 0x20, 2, 0x0b});
+  return body;
+}
+
+// Exports a loop per import, then "loop", then the single calls
+// "twice_once" (x), "fast_twice_once" (x) and "checksum_once" (offset,
+// len), and "add1" for fast_callback
+static std::vector<uint8_t> build_module() {
+  std::vector<uint8_t> out = {0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00};
+  std::vector<uint8_t> sec;
+
+  sec = {9,
+         0x60, 0, 0,
+         0x60, 0, 1, 0x7f,
+         0x60, 1, 0x7f, 0,
+         0x60, 1, 0x7f, 1, 0x7f,
+         0x60, 2, 0x7f, 0x7f, 0,
+         0x60, 2, 0x7f, 0x7f, 1, 0x7f,
+         0x60, 1, 0x7d, 1, 0x7d,
+         0x60, 3, 0x7f, 0x7f, 0x7f, 1, 0x7f,
+         0x60, 1, 0x7e, 1, 0x7e};
+  put_section(&out, 1, sec);
+
+  sec.clear();
+  put_u32(&sec, IMPORT_COUNT);
+  for (uint32_t i = 0; i < IMPORT_COUNT; i++) {
+    put_name(&sec, "env");
+    put_name(&sec, imports[i].name);
+    sec.push_back(0x00);
+    put_u32(&sec, imports[i].type);
+  }
+  put_section(&out, 2, sec);
+
+  const char *single_names[] = {"loop", "twice_once", "fast_twice_once",
+                                "checksum_once", "add1"};
+  uint32_t func_count = IMPORT_COUNT + 5;
+  sec.clear();
+  put_u32(&sec, func_count);
+  for (uint32_t i = 0; i < IMPORT_COUNT + 3; i++) {
+    sec.push_back(Type_IRetI);
+  }
+  sec.push_back(Type_II);
+  sec.push_back(Type_IRetI);
+  put_section(&out, 3, sec);
+
+  // One page, no maximum
+  put_section(&out, 5, {1, 0x00, 1});
+
+  sec.clear();
+  put_u32(&sec, func_count + 1);
+  char name[32];
+  for (uint32_t i = 0; i < func_count; i++) {
+    if (i < IMPORT_COUNT) {
+      snprintf(name, sizeof(name), "run_%s", imports[i].name);
+    } else {
+      snprintf(name, sizeof(name), "%s", single_names[i - IMPORT_COUNT]);
+    }
+    put_name(&sec, name);
+    sec.push_back(0x00);
+    put_u32(&sec, IMPORT_COUNT + i);
+  }
+  put_name(&sec, "memory");
+  sec.insert(sec.end(), {0x02, 0});
+  put_section(&out, 7, sec);
+
+  sec.clear();
+  put_u32(&sec, func_count);
+  for (uint32_t i = 0; i < IMPORT_COUNT; i++) {
+    put_body(&sec, loop_body((int)i));
+  }
+  put_body(&sec, loop_body(-1));
+  put_body(&sec, {0x00, 0x20, 0, 0x10, (uint8_t)import_index("twice"), 0x0b});
+  put_body(&sec,
+           {0x00, 0x20, 0, 0x10, (uint8_t)import_index("fast_twice"), 0x0b});
+  put_body(&sec, {0x00, 0x20, 0, 0x20, 1, 0x10,
+                  (uint8_t)import_index("checksum"), 0x0b});
+  // local.get 0; i32.const 1; i32.add
+  put_body(&sec, {0x00, 0x20, 0, 0x41, 1, 0x6a, 0x0b});
+  put_section(&out, 10, sec);
+  return out;
+}
+
+// ============================================================================
+// Expected results
+// ============================================================================
+
+static uint8_t memory_byte(uint32_t offset) {
+  return (uint8_t)(offset * 7 + 3);
+}
+
+struct Expected {
+  uint32_t acc;
+  uint32_t state;
+};
+
+// What a loop of import `func` (IMPORT_COUNT for "loop") returns and
+// leaves in native_state, starting from 0
+static Expected expected(uint32_t func, uint32_t calls) {
+  Expected e = {0, 0};
+
+  if (func >= IMPORT_COUNT) {
+    return e;
+  }
+  for (uint32_t i = 0; i < calls; i++) {
+    switch (imports[func].calc) {
+      case Calc_Count:
+        e.state++;
+        break;
+      case Calc_Tick:
+        e.acc += i;
+        break;
+      case Calc_Sink:
+        e.state = e.state * 31 + i;
+        break;
+      case Calc_Twice:
+        e.acc += 2 * i + 1;
+        break;
+      case Calc_Pair:
+        e.state = e.state * 31 + i + 7 * 1000;
+        break;
+      case Calc_Mix:
+        e.acc = (i * 31) ^ e.acc;
+        break;
+      case Calc_Checksum:
+        for (uint32_t b = 0; b < BUFFER_LEN; b++) {
+          e.state += memory_byte((i & 255) + b);
+        }
+        break;
+      case Calc_Scale: {
+        float r = (float)(int32_t)i * 0.5f + 1.0f;
+        uint32_t bits;
+        memcpy(&bits, &r, sizeof(bits));
+        e.acc += bits;
+        break;
+      }
+      case Calc_Mix3:
+        e.acc = i * 31 + e.acc * 7 + 7;
+        break;
+      case Calc_Wide:
+        e.acc += (uint32_t)((uint64_t)i * 3 + 1);
+        break;
+    }
+  }
+  return e;
+}
+
+// ============================================================================
+// Runs
+// ============================================================================
+
+struct Instance {
+  wasm_module_t module;
+  wasm_module_inst_t inst;
+  wasm_exec_env_t exec_env;
+};
+
+static void release(Instance *in) {
+  if (in->exec_env) {
+    wasm_runtime_destroy_exec_env(in->exec_env);
+  }
+  if (in->inst) {
+    wasm_runtime_deinstantiate(in->inst);
+  }
+  if (in->module) {
+    wasm_runtime_unload(in->module);
+  }
+  memset(in, 0, sizeof(*in));
+}
+
+static bool instantiate(const std::vector<uint8_t> &bytes, Mode mode,
+                        Instance *in) {
+  char error_buf[128];
+  LoadArgs load_args;
+
+  memset(in, 0, sizeof(*in));
+  memset(&load_args, 0, sizeof(load_args));
+  load_args.name = const_cast<char *>("");
+  load_args.wasm_binary_readonly = true;
+  load_args.no_native_trampolines = mode == Mode_Generic;
+  in->module = wasm_runtime_load_ex(const_cast<uint8_t *>(bytes.data()),
+                                    (uint32_t)bytes.size(), &load_args,
+                                    error_buf, sizeof(error_buf));
+  if (in->module) {
+    in->inst = wasm_runtime_instantiate(in->module, BENCH_STACK_SIZE, 0,
+                                        error_buf, sizeof(error_buf));
+  }
+  if (in->inst && !(in->exec_env = wasm_runtime_create_exec_env(
+                        in->inst, BENCH_STACK_SIZE))) {
+    snprintf(error_buf, sizeof(error_buf), "create exec_env failed");
+  }
+  if (!in->exec_env) {
+    fprintf(stderr, "%s: %s\n", mode_names[mode], error_buf);
+    release(in);
+    return false;
+  }
+  add1_func = wasm_runtime_lookup_function(in->inst, "add1");
+  uint8_t *mem = (uint8_t *)wasm_runtime_addr_app_to_native(in->inst, 0);
+  for (uint32_t i = 0; i < WASM_PAGE_SIZE; i++) {
+    mem[i] = memory_byte(i);
+  }
+  return true;
+}
+
+static bool call(const Instance &in, const char *name, uint32_t argc,
+                 uint32_t *argv) {
+  wasm_function_inst_t func = wasm_runtime_lookup_function(in.inst, name);
+  return func && wasm_runtime_call_wasm(in.exec_env, func, argc, argv);
+}
+
+struct Result {
+  double ns_per_call;
+  bool ok;
+};
+
+// Rows: the imports, then "loop"
+static Result results[IMPORT_COUNT + 1][Mode_Num];
+
+static bool run_loop(const Instance &in, uint32_t func, Mode mode) {
+  const char *name = func < IMPORT_COUNT ? imports[func].name : "loop";
+  uint32_t calls = CALLS * scale;
+  Expected e = expected(func, calls);
+  Result *r = &results[func][mode];
+  char export_name[32];
+
+  snprintf(export_name, sizeof(export_name),
+           func < IMPORT_COUNT ? "run_%s" : "%s", name);
+  r->ok = true;
+  r->ns_per_call = 0;
+  for (uint32_t rep = 0; rep < REPEATS && r->ok; rep++) {
+    uint32_t argv[1] = {calls};
+    native_state = 0;
+    tick_counter = 0;
+    double start = now_us();
+    r->ok = call(in, export_name, 1, argv);
+    double ns = (now_us() - start) * 1e3 / calls;
+    if (rep == 0 || ns < r->ns_per_call) {
+      r->ns_per_call = ns;
+    }
+    if (!r->ok) {
+      const char *exception = wasm_runtime_get_exception(in.inst);
+      fprintf(stderr, "%s %s: %s\n", mode_names[mode], name,
+              exception ? exception : "call failed");
+    } else if (argv[0] != e.acc || native_state != e.state) {
+      fprintf(stderr, "%s %s: got %u/%u, expected %u/%u\n", mode_names[mode],
+              name, argv[0], native_state, e.acc, e.state);
+      r->ok = false;
+    }
+  }
+  return r->ok;
+}
+
+// A single call that must fail with `exception`
+static bool expect_trap(const Instance &in, Mode mode, const char *name,
+                        uint32_t argc, uint32_t *argv, const char *exception) {
+  bool ok = !call(in, name, argc, argv);
+  const char *got = wasm_runtime_get_exception(in.inst);
+
+  ok = ok && got && strstr(got, exception);
+  if (!ok) {
+    fprintf(stderr, "%s %s: expected \"%s\", got \"%s\"\n", mode_names[mode],
+            name, exception, got ? got : "no exception");
+  }
+  wasm_runtime_clear_exception(in.inst);
+  return ok;
+}
+
+static bool run_checks(const Instance &in, Mode mode) {
+  uint32_t argv[2];
+  bool ok = true;
+
+  argv[0] = (uint32_t)-1;
+  ok = expect_trap(in, mode, "twice_once", 1, argv, "twice of -1") && ok;
+  argv[0] = 5;
+  ok = call(in, "twice_once", 1, argv) && argv[0] == 11 && ok;
+  argv[0] = (uint32_t)-1;
+  ok = expect_trap(in, mode, "fast_twice_once", 1, argv, "twice of -1") && ok;
+  argv[0] = 5;
+  ok = call(in, "fast_twice_once", 1, argv) && argv[0] == 11 && ok;
+
+  // Straddling the end of the memory, and wrapping around 2^32
+  argv[0] = WASM_PAGE_SIZE - BUFFER_LEN / 2;
+  argv[1] = BUFFER_LEN;
+  ok = expect_trap(in, mode, "checksum_once", 2, argv,
+                   "out of bounds memory access") && ok;
+  argv[0] = 0xfffffff0;
+  argv[1] = 0x20;
+  ok = expect_trap(in, mode, "checksum_once", 2, argv,
+                   "out of bounds memory access") && ok;
+
+  // The last bytes of the memory
+  native_state = 0;
+  argv[0] = WASM_PAGE_SIZE - BUFFER_LEN;
+  argv[1] = BUFFER_LEN;
+  uint32_t sum = 0;
+  for (uint32_t b = 0; b < BUFFER_LEN; b++) {
+    sum += memory_byte(WASM_PAGE_SIZE - BUFFER_LEN + b);
+  }
+  ok = call(in, "checksum_once", 2, argv) && native_state == sum && ok;
+
+  if (!ok) {
+    fprintf(stderr, "%s: single call checks failed\n", mode_names[mode]);
+  }
+  return ok;
+}
+
+static bool run_mode(Mode mode, const std::vector<uint8_t> &bytes) {
+  Instance in;
+  bool ok = true;
+
+  if (!instantiate(bytes, mode, &in)) {
+    return false;
+  }
+  for (uint32_t func = 0; func <= IMPORT_COUNT; func++) {
+    ok = run_loop(in, func, mode) && ok;
+  }
+  ok = run_checks(in, mode) && ok;
+  release(&in);
+  return ok;
+}
+
+int main(int argc, char **argv) {
+  for (int i = 1; i < argc; i++) {
+    if (strncmp(argv[i], "--scale=", 8) == 0) {
+      scale = (uint32_t)atoi(argv[i] + 8);
+      if (scale == 0) {
+        scale = 1;
+      }
+    } else {
+      fprintf(stderr, "usage: %s [--scale=N]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  RuntimeInitArgs init_args;
+  memset(&init_args, 0, sizeof(init_args));
+  init_args.mem_alloc_type = Alloc_With_Pool;
+  init_args.mem_alloc_option.pool.heap_buf = pool;
+  init_args.mem_alloc_option.pool.heap_size = sizeof(pool);
+  init_args.native_module_name = "env";
+  init_args.native_symbols = natives;
+  init_args.n_native_symbols = NATIVE_COUNT;
+  if (!wasm_runtime_full_init(&init_args)) {
+    fprintf(stderr, "wasm_runtime_full_init failed\n");
+    return 1;
+  }
+  if (!wasm_runtime_register_natives_fast("env", fast_leaf_natives,
+                                          FAST_LEAF_COUNT, true) ||
+      !wasm_runtime_register_natives_fast("env", fast_framed_natives,
+                                          FAST_FRAMED_COUNT, false)) {
+    fprintf(stderr, "wasm_runtime_register_natives_fast failed\n");
+    wasm_runtime_destroy();
+    return 1;
+  }
+  wasm_runtime_set_log_level(WASM_LOG_LEVEL_ERROR);
+
+  std::vector<uint8_t> bytes = build_module();
+  bool all_ok = true;
+  for (int mode = 0; mode < Mode_Num; mode++) {
+    all_ok = run_mode((Mode)mode, bytes) && all_ok;
+  }
+  wasm_runtime_destroy();
+
+  printf("native,kind,signature,mode,calls,ns_per_call,check\n");
+  for (uint32_t func = 0; func <= IMPORT_COUNT; func++) {
+    const char *name = func < IMPORT_COUNT ? imports[func].name : "loop";
+    Kind kind = func < IMPORT_COUNT ? imports[func].kind : Kind_Plain;
+    const char *signature = "";
+    const NativeSymbol *lists[] = {natives, fast_leaf_natives,
+                                   fast_framed_natives};
+    const uint32_t counts[] = {NATIVE_COUNT, FAST_LEAF_COUNT,
+                               FAST_FRAMED_COUNT};
+    for (uint32_t n = 0; n < counts[kind] && func < IMPORT_COUNT; n++) {
+      if (strcmp(lists[kind][n].symbol, name) == 0) {
+        signature = lists[kind][n].signature;
+      }
+    }
+    for (int mode = 0; mode < Mode_Num; mode++) {
+      Result *r = &results[func][mode];
+      printf("%s,%s,%s,%s,%u,%.1f,%s\n", name, kind_names[kind], signature,
+             mode_names[mode], CALLS * scale, r->ns_per_call,
+             r->ok ? "ok" : "FAIL");
+    }
+  }
+  return all_ok ? 0 : 1;
+}
@@ -0,0 +1,259 @@
+/*
+ * Host benchmark: placement of runtime objects in a fast memory pool
+ *
+ * Copyright (C) 2025 WAMR-ESP32-Arduino Contributors
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * On the ESP32 the fast pool is internal SRAM and the main pool can be
+ * PSRAM; on Linux both are plain heap memory, so the timings mostly show
+ * the cost of the placement itself. What the run does check is where each
+ * object class ends up: the math and kernels modules are loaded and run
+ * through WamrRuntime::setMemoryPlacement() with
+ *   off      no fast pool
+ *   default  a 64 KB fast pool, WAMR_DEFAULT_FAST_CLASSES
+ *   all      a 1 MB fast pool, every class including linear memory
+ *   tiny     a 4 KB fast pool, default classes, so most blocks fall back
+ *            to the main pool
+ * and each configuration must give the same kernel results and leave both
+ * pools as they were once the modules are unloaded.
+ *
+ * Usage:
+ *   placement_bench [--scale=N]
+ *
+ * Output is two CSV tables:
+ *   config,fast_pool_bytes,main_used,fast_used,kernels_us,check
+ *   config,class,fast_count,fast_bytes,main_count,main_bytes,fallback_count
+ * where main_used and fast_used are the pool bytes in use with both
+ * modules loaded.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <WAMR.h>
+
+#include "bench_modules.h"
+
+#define BENCH_HEAP_POOL (4 * 1024 * 1024)
+#define BENCH_STACK_SIZE (64 * 1024)
+#define BENCH_MODULE_HEAP (64 * 1024)
+
+#define FIB_N 20
+#define FIB_EXPECTED 6765
+#define KERNEL_BYTES (64 * 1024)
+#define MATMUL_N 32
+
+struct PlacementConfig {
+  const char *name;
+  uint32_t fast_pool_size;
+  uint32_t fast_classes;
+};
+
+static const PlacementConfig configs[] = {
+    {"off", 0, 0},
+    {"default", 64 * 1024, WAMR_DEFAULT_FAST_CLASSES},
+    {"all", 1024 * 1024, MEM_CLASS_BIT(Mem_Class_Num) - 1},
+    {"tiny", 4 * 1024, WAMR_DEFAULT_FAST_CLASSES},
+};
+
+#define CONFIG_COUNT (sizeof(configs) / sizeof(configs[0]))
+
+static const char *class_names[Mem_Class_Num] = {
+    "metadata", "stack", "linear_memory", "code", "consts", "instance",
+};
+
+struct ConfigResult {
+  uint32_t main_used;
+  uint32_t fast_used;
+  double kernels_us;
+  uint32_t kernel_sum;
+  bool ok;
+  mem_class_stats_t stats[Mem_Class_Num];
+};
+
+static ConfigResult results[CONFIG_COUNT];
+static uint32_t scale = 1;
+
+static double now_us() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+static bool pools_in_use(uint32_t *main_used, uint32_t *fast_used) {
+  mem_alloc_info_t main_info, fast_info;
+
+  // Blocks held by the thread caches would count as in use. Restarting
+  // the workers makes them release theirs.
+  WamrRuntime::setWorkerCount(1);
+  WamrRuntime::releaseThreadCache();
+  if (!WamrRuntime::getPoolInfo(&main_info, &fast_info)) {
+    return false;
+  }
+  *main_used = main_info.total_size - main_info.total_free_size;
+  *fast_used = fast_info.total_size - fast_info.total_free_size;
+  return true;
+}
+
+// Runs the kernels once per iteration, returns a checksum of the results
+// that must be the same in every configuration
+static bool run_kernels(WamrModule &math, WamrModule &kernels,
+                        uint32_t *sum) {
+  uint32_t argv[3];
+
+  *sum = 0;
+  for (uint32_t i = 0; i < 4 * scale; i++) {
+    argv[0] = FIB_N;
+    if (!math.callFunction("fibonacci", 1, argv) || argv[0] != FIB_EXPECTED) {
+      return false;
+    }
+
+    argv[0] = 0;
+    argv[1] = KERNEL_BYTES;
+    argv[2] = i;
+    if (!kernels.callFunction("fill", 3, argv)) {
+      return false;
+    }
+    argv[0] = KERNEL_BYTES;
+    argv[1] = 0;
+    argv[2] = KERNEL_BYTES;
+    if (!kernels.callFunction("memcpy_loop", 3, argv)) {
+      return false;
+    }
+    argv[0] = KERNEL_BYTES;
+    argv[1] = KERNEL_BYTES;
+    if (!kernels.callFunction("crc32", 2, argv)) {
+      return false;
+    }
+    *sum += argv[0];
+    argv[0] = MATMUL_N;
+    if (!kernels.callFunction("matmul", 1, argv)) {
+      return false;
+    }
+    *sum += argv[0];
+  }
+  return true;
+}
+
+static bool run_config(const PlacementConfig &config, ConfigResult *r) {
+  uint32_t main_base, fast_base, main_after, fast_after;
+
+  memset(r, 0, sizeof(*r));
+  WamrRuntime::setMemoryPlacement(config.fast_pool_size, config.fast_classes);
+  if (!WamrRuntime::begin(BENCH_HEAP_POOL)) {
+    fprintf(stderr, "%s: runtime init failed\n", config.name);
+    return false;
+  }
+
+  bool ok = pools_in_use(&main_base, &fast_base);
+  {
+    WamrModule math;
+    WamrModule kernels;
+    if (!math.load(math_wasm, math_wasm_len, BENCH_STACK_SIZE,
+                   BENCH_MODULE_HEAP) ||
+        !kernels.load(kernels_wasm, kernels_wasm_len, BENCH_STACK_SIZE,
+                      BENCH_MODULE_HEAP)) {
+      fprintf(stderr, "%s: module load failed\n", config.name);
+      ok = false;
+    }
+
+    if (ok) {
+      double start = now_us();
+      ok = run_kernels(math, kernels, &r->kernel_sum);
+      r->kernels_us = now_us() - start;
+      if (!ok) {
+        fprintf(stderr, "%s: kernel call failed\n", config.name);
+      }
+    }
+
+    ok = pools_in_use(&r->main_used, &r->fast_used) && ok;
+    r->main_used -= main_base;
+    r->fast_used -= fast_base;
+    for (int c = 0; c < Mem_Class_Num; c++) {
+      wasm_runtime_get_mem_class_stats((mem_class_t)c, &r->stats[c]);
+    }
+  }
+
+  if (!pools_in_use(&main_after, &fast_after) || main_after != main_base ||
+      fast_after != fast_base) {
+    fprintf(stderr, "%s: pools not back to baseline (main %u -> %u, fast "
+            "%u -> %u)\n", config.name, main_base, main_after, fast_base,
+            fast_after);
+    ok = false;
+  }
+
+  WamrRuntime::end();
+  return ok;
+}
+
+static bool check_placement(const PlacementConfig &config,
+                            const ConfigResult &r) {
+  for (int c = Mem_Class_Stack; c < Mem_Class_Num; c++) {
+    const mem_class_stats_t &s = r.stats[c];
+    bool placed = config.fast_pool_size > 0 &&
+                  (config.fast_classes & MEM_CLASS_BIT(c));
+
+    // Nothing goes to the fast pool unless its class is placed there, and
+    // each block is counted once, in one pool
+    if ((!placed && (s.fast_count || s.fallback_count)) ||
+        s.fallback_count > s.main_count) {
+      fprintf(stderr, "%s: bad stats for %s\n", config.name, class_names[c]);
+      return false;
+    }
+  }
+  // The stack and the instances are never carved from the load arena, so
+  // they are counted whatever the placement
+  if (config.fast_pool_size > 0 &&
+      (r.stats[Mem_Class_Stack].fast_count +
+           r.stats[Mem_Class_Stack].main_count ==
+       0)) {
+    fprintf(stderr, "%s: no stack allocation counted\n", config.name);
+    return false;
+  }
+  return true;
+}
+
+int main(int argc, char **argv) {
+  for (int i = 1; i < argc; i++) {
+    if (strncmp(argv[i], "--scale=", 8) == 0) {
+      scale = (uint32_t)atoi(argv[i] + 8);
+      if (scale == 0) {
+        scale = 1;
+      }
+    } else {
+      fprintf(stderr, "usage: %s [--scale=N]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  bool all_ok = true;
+  for (uint32_t i = 0; i < CONFIG_COUNT; i++) {
+    ConfigResult *r = &results[i];
+    r->ok = run_config(configs[i], r) && check_placement(configs[i], *r) &&
+            r->kernel_sum == results[0].kernel_sum;
+    all_ok = all_ok && r->ok;
+  }
+
+  printf("config,fast_pool_bytes,main_used,fast_used,kernels_us,check\n");
+  for (uint32_t i = 0; i < CONFIG_COUNT; i++) {
+    const ConfigResult &r = results[i];
+    printf("%s,%u,%u,%u,%.1f,%s\n", configs[i].name,
+           configs[i].fast_pool_size, r.main_used, r.fast_used, r.kernels_us,
+           r.ok ? "ok" : "FAIL");
+  }
+
+  printf("\nconfig,class,fast_count,fast_bytes,main_count,main_bytes,"
+         "fallback_count\n");
+  for (uint32_t i = 0; i < CONFIG_COUNT; i++) {
+    for (int c = Mem_Class_Stack; c < Mem_Class_Num; c++) {
+      const mem_class_stats_t &s = results[i].stats[c];
+      printf("%s,%s,%u,%llu,%u,%llu,%u\n", configs[i].name, class_names[c],
+             s.fast_count, (unsigned long long)s.fast_bytes, s.main_count,
+             (unsigned long long)s.main_bytes, s.fallback_count);
+    }
+  }
+
+  return all_ok ? 0 : 1;
+}
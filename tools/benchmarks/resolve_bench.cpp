@@ -0,0 +1,501 @@
+/*
+ * Host benchmark: native registration and import resolution at load
+ *
+ * Copyright (C) 2025 WAMR-ESP32-Arduino Contributors
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Registers tables of natives the way a board support layer would (gpio,
+ * i2c, spi, display and sensor, on top of libc-builtin), then loads a
+ * module importing all of them in a shuffled order. Each native returns
+ * an id taken from its attachment, so a call through every import checks
+ * that each one resolved to its own native.
+ *
+ * Rows:
+ *   register_shuffled  the tables registered with
+ *                      wasm_runtime_register_natives(), which sorts them
+ *   register_sorted    the same tables, sorted beforehand, registered with
+ *                      wasm_runtime_register_natives_sorted()
+ *   resolve            wasm_runtime_is_import_func_linked() over every
+ *                      import
+ *   load               wasm_runtime_load() of the module, which resolves
+ *                      the imports
+ * The check of each row also covers: a later registration hiding a
+ * symbol until it is unregistered, an import named "_name" resolving to
+ * "name", and wasm_runtime_register_natives_sorted() refusing an unsorted
+ * table.
+ *
+ * resolve_bench_list is the same program linked against a runtime built
+ * without WASM_ENABLE_NATIVE_INDEX, which resolves imports with a walk
+ * over the registrations and a bsearch in each.
+ *
+ * Usage:
+ *   resolve_bench [--scale=N] [--natives=N]
+ *   resolve_bench_list [--scale=N] [--natives=N]
+ *
+ * Output is CSV:
+ *   phase,index,tables,natives,us,check
+ * where natives is per table and us is per registration of all the tables,
+ * per resolution of all the imports, or per load.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "wasm_export.h"
+
+#define BENCH_POOL_SIZE (4 * 1024 * 1024)
+#define BENCH_STACK_SIZE (16 * 1024)
+
+#define REGISTER_ROUNDS 50
+#define RESOLVE_ROUNDS 200
+#define LOAD_ROUNDS 100
+
+static uint8_t pool[BENCH_POOL_SIZE];
+static uint32_t scale = 1;
+static uint32_t natives_per_table = 80;
+
+static const char *table_modules[] = {"gpio", "i2c", "spi", "display",
+                                      "sensor"};
+
+#define TABLE_COUNT (sizeof(table_modules) / sizeof(table_modules[0]))
+
+// Attachment of the native hiding "gpio_op000"
+#define OVERRIDE_ID 100000
+
+static double now_us() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+// ============================================================================
+// Natives
+// ============================================================================
+
+// Every native: its id plus the argument
+static int32_t native_id(wasm_exec_env_t exec_env, int32_t x) {
+  return (int32_t)(uintptr_t)wasm_runtime_get_function_attachment(exec_env) +
+         x;
+}
+
+struct Table {
+  const char *module;
+  std::vector<std::string> names;
+  std::vector<NativeSymbol> shuffled;
+  std::vector<NativeSymbol> sorted;
+};
+
+static Table tables[TABLE_COUNT];
+static std::mt19937 rng(12345);
+
+static void build_tables() {
+  char name[48];
+
+  for (uint32_t t = 0; t < TABLE_COUNT; t++) {
+    Table &table = tables[t];
+    table.module = table_modules[t];
+    for (uint32_t i = 0; i < natives_per_table; i++) {
+      snprintf(name, sizeof(name), "%s_op%03u", table.module, i);
+      table.names.push_back(name);
+    }
+    // Names are stable from here on
+    for (uint32_t i = 0; i < natives_per_table; i++) {
+      NativeSymbol symbol = {table.names[i].c_str(), (void *)native_id,
+                             "(i)i", (void *)(uintptr_t)(t * 1000 + i)};
+      table.sorted.push_back(symbol);
+    }
+    std::sort(table.sorted.begin(), table.sorted.end(),
+              [](const NativeSymbol &a, const NativeSymbol &b) {
+                return strcmp(a.symbol, b.symbol) < 0;
+              });
+    table.shuffled = table.sorted;
+  }
+}
+
+// ============================================================================
+// Generated module
+// ============================================================================
+
+static void put_u32(std::vector<uint8_t> *out, uint32_t value) {
+  do {
+    uint8_t byte = value & 0x7f;
+    value >>= 7;
+    out->push_back(value ? byte | 0x80 : byte);
+  } while (value);
+}
+
+static void put_name(std::vector<uint8_t> *out, const char *name) {
+  put_u32(out, (uint32_t)strlen(name));
+  out->insert(out->end(), name, name + strlen(name));
+}
+
+static void put_section(std::vector<uint8_t> *out, uint8_t id,
+                        const std::vector<uint8_t> &body) {
+  out->push_back(id);
+  put_u32(out, (uint32_t)body.size());
+  out->insert(out->end(), body.begin(), body.end());
+}
+
+static void put_body(std::vector<uint8_t> *out,
+                     const std::vector<uint8_t> &body) {
+  put_u32(out, (uint32_t)body.size());
+  out->insert(out->end(), body.begin(), body.end());
+}
+
+struct ImportName {
+  const char *module;
+  std::string field;
+  uint32_t id;
+};
+
+static std::vector<ImportName> import_names;
+static uint32_t gpio0_import, underscore_import;
+static uint32_t expected_sum;
+
+// Imports every native in a shuffled order, then "_spi_op001". Exports
+// "sum_all" (the sum of every import called with 1), "call_gpio0" and
+// "call_underscore" (the import called with 0)
+static std::vector<uint8_t> build_module() {
+  std::vector<uint8_t> out = {0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00};
+  std::vector<uint8_t> sec, body;
+
+  import_names.clear();
+  expected_sum = 0;
+  for (uint32_t t = 0; t < TABLE_COUNT; t++) {
+    for (uint32_t i = 0; i < natives_per_table; i++) {
+      import_names.push_back({tables[t].module, tables[t].names[i],
+                              t * 1000 + i});
+    }
+  }
+  std::shuffle(import_names.begin(), import_names.end(), rng);
+  for (uint32_t k = 0; k < import_names.size(); k++) {
+    expected_sum += import_names[k].id + 1;
+    if (import_names[k].field == "gpio_op000") {
+      gpio0_import = k;
+    }
+  }
+  underscore_import = (uint32_t)import_names.size();
+  import_names.push_back({"spi", "_spi_op001", 2 * 1000 + 1});
+  uint32_t import_count = (uint32_t)import_names.size();
+
+  // (i32) -> i32 for the imports, () -> i32 for the exports
+  put_section(&out, 1, {2, 0x60, 1, 0x7f, 1, 0x7f, 0x60, 0, 1, 0x7f});
+
+  put_u32(&sec, import_count);
+  for (const ImportName &im : import_names) {
+    put_name(&sec, im.module);
+    put_name(&sec, im.field.c_str());
+    sec.insert(sec.end(), {0x00, 0x00});
+  }
+  put_section(&out, 2, sec);
+
+  put_section(&out, 3, {3, 1, 1, 1});
+
+  sec.clear();
+  put_u32(&sec, 3);
+  const char *exports[] = {"sum_all", "call_gpio0", "call_underscore"};
+  for (uint32_t i = 0; i < 3; i++) {
+    put_name(&sec, exports[i]);
+    sec.push_back(0x00);
+    put_u32(&sec, import_count + i);
+  }
+  put_section(&out, 7, sec);
+
+  sec.clear();
+  put_u32(&sec, 3);
+  // i32.const 0, then i32.const 1; call k; i32.add for each import
+  body = {0x00, 0x41, 0x00};
+  for (uint32_t k = 0; k < underscore_import; k++) {
+    body.insert(body.end(), {0x41, 0x01, 0x10});
+    put_u32(&body, k);
+    body.push_back(0x6a);
+  }
+  body.push_back(0x0b);
+  put_body(&sec, body);
+  for (uint32_t k : {gpio0_import, underscore_import}) {
+    body = {0x00, 0x41, 0x00, 0x10};
+    put_u32(&body, k);
+    body.push_back(0x0b);
+    put_body(&sec, body);
+  }
+  put_section(&out, 10, sec);
+  return out;
+}
+
+// ============================================================================
+// Runs
+// ============================================================================
+
+enum Phase {
+  Phase_RegisterShuffled,
+  Phase_RegisterSorted,
+  Phase_Resolve,
+  Phase_Load,
+  Phase_Num
+};
+
+static const char *phase_names[Phase_Num] = {
+    "register_shuffled", "register_sorted", "resolve", "load"};
+
+struct Result {
+  double us;
+  bool ok;
+};
+
+static Result results[Phase_Num];
+
+static bool init_runtime() {
+  RuntimeInitArgs init_args;
+  memset(&init_args, 0, sizeof(init_args));
+  init_args.mem_alloc_type = Alloc_With_Pool;
+  init_args.mem_alloc_option.pool.heap_buf = pool;
+  init_args.mem_alloc_option.pool.heap_size = sizeof(pool);
+  if (!wasm_runtime_full_init(&init_args)) {
+    fprintf(stderr, "wasm_runtime_full_init failed\n");
+    return false;
+  }
+  wasm_runtime_set_log_level(WASM_LOG_LEVEL_FATAL);
+  return true;
+}
+
+static bool register_tables(bool sorted) {
+  for (uint32_t t = 0; t < TABLE_COUNT; t++) {
+    Table &table = tables[t];
+    bool ok = sorted
+                  ? wasm_runtime_register_natives_sorted(
+                        table.module, table.sorted.data(), natives_per_table)
+                  : wasm_runtime_register_natives(
+                        table.module, table.shuffled.data(), natives_per_table);
+    if (!ok) {
+      fprintf(stderr, "registering %s failed\n", table.module);
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool time_registration(bool sorted) {
+  Result *r = &results[sorted ? Phase_RegisterSorted : Phase_RegisterShuffled];
+  uint32_t rounds = REGISTER_ROUNDS * scale;
+  double total = 0;
+
+  r->ok = true;
+  for (uint32_t round = 0; round < rounds && r->ok; round++) {
+    for (Table &table : tables) {
+      std::shuffle(table.shuffled.begin(), table.shuffled.end(), rng);
+    }
+    if (!init_runtime()) {
+      r->ok = false;
+      break;
+    }
+    double start = now_us();
+    r->ok = register_tables(sorted);
+    total += now_us() - start;
+    wasm_runtime_destroy();
+  }
+  r->us = total / rounds;
+  return r->ok;
+}
+
+struct Instance {
+  wasm_module_t module;
+  wasm_module_inst_t inst;
+  wasm_exec_env_t exec_env;
+};
+
+static void release(Instance *in) {
+  if (in->exec_env) {
+    wasm_runtime_destroy_exec_env(in->exec_env);
+  }
+  if (in->inst) {
+    wasm_runtime_deinstantiate(in->inst);
+  }
+  if (in->module) {
+    wasm_runtime_unload(in->module);
+  }
+  memset(in, 0, sizeof(*in));
+}
+
+static wasm_module_t load(const std::vector<uint8_t> &bytes) {
+  char error_buf[128];
+  LoadArgs load_args;
+
+  memset(&load_args, 0, sizeof(load_args));
+  load_args.name = const_cast<char *>("");
+  load_args.wasm_binary_readonly = true;
+  wasm_module_t module = wasm_runtime_load_ex(
+      const_cast<uint8_t *>(bytes.data()), (uint32_t)bytes.size(), &load_args,
+      error_buf, sizeof(error_buf));
+  if (!module) {
+    fprintf(stderr, "load: %s\n", error_buf);
+  }
+  return module;
+}
+
+static bool instantiate(const std::vector<uint8_t> &bytes, Instance *in) {
+  char error_buf[128];
+
+  memset(in, 0, sizeof(*in));
+  if (!(in->module = load(bytes))) {
+    return false;
+  }
+  in->inst = wasm_runtime_instantiate(in->module, BENCH_STACK_SIZE, 0,
+                                      error_buf, sizeof(error_buf));
+  if (in->inst) {
+    in->exec_env = wasm_runtime_create_exec_env(in->inst, BENCH_STACK_SIZE);
+  }
+  if (!in->exec_env) {
+    fprintf(stderr, "instantiate: %s\n",
+            in->inst ? "create exec_env failed" : error_buf);
+    release(in);
+    return false;
+  }
+  return true;
+}
+
+static bool call(const Instance &in, const char *name, uint32_t expected) {
+  wasm_function_inst_t func = wasm_runtime_lookup_function(in.inst, name);
+  uint32_t argv[1] = {0};
+
+  if (!func || !wasm_runtime_call_wasm(in.exec_env, func, 0, argv)) {
+    const char *exception = wasm_runtime_get_exception(in.inst);
+    fprintf(stderr, "%s: %s\n", name, exception ? exception : "not found");
+    return false;
+  }
+  if (argv[0] != expected) {
+    fprintf(stderr, "%s: got %u, expected %u\n", name, argv[0], expected);
+    return false;
+  }
+  return true;
+}
+
+// Every import calls its own native, "_spi_op001" calls spi_op001, and a
+// later registration hides gpio_op000 until it is unregistered
+static bool check_resolution(const std::vector<uint8_t> &bytes) {
+  static NativeSymbol override_symbols[] = {
+      {"gpio_op000", (void *)native_id, "(i)i", (void *)OVERRIDE_ID},
+  };
+  Instance in;
+  bool ok;
+
+  if (!instantiate(bytes, &in)) {
+    return false;
+  }
+  ok = call(in, "sum_all", expected_sum) && call(in, "call_gpio0", 0) &&
+       call(in, "call_underscore", 2 * 1000 + 1);
+  release(&in);
+
+  ok = ok && wasm_runtime_register_natives("gpio", override_symbols, 1) &&
+       instantiate(bytes, &in);
+  if (in.inst) {
+    ok = call(in, "call_gpio0", OVERRIDE_ID) && ok;
+    release(&in);
+  }
+  ok = ok && wasm_runtime_unregister_natives("gpio", override_symbols) &&
+       instantiate(bytes, &in);
+  if (in.inst) {
+    ok = call(in, "call_gpio0", 0) && ok;
+    release(&in);
+  }
+  return ok;
+}
+
+// wasm_runtime_register_natives_sorted() must refuse an unsorted table
+static bool check_unsorted_refused() {
+  NativeSymbol unsorted[] = {
+      {"zz_last", (void *)native_id, "(i)i", NULL},
+      {"aa_first", (void *)native_id, "(i)i", NULL},
+  };
+
+  if (wasm_runtime_register_natives_sorted("unsorted", unsorted, 2)) {
+    fprintf(stderr, "unsorted table registered\n");
+    wasm_runtime_unregister_natives("unsorted", unsorted);
+    return false;
+  }
+  return true;
+}
+
+static bool run_loads(const std::vector<uint8_t> &bytes) {
+  uint32_t rounds;
+  double start;
+  bool checks;
+
+  if (!init_runtime()) {
+    return false;
+  }
+  if (!register_tables(true)) {
+    wasm_runtime_destroy();
+    return false;
+  }
+  checks = check_resolution(bytes) && check_unsorted_refused();
+
+  Result *r = &results[Phase_Resolve];
+  rounds = RESOLVE_ROUNDS * scale;
+  r->ok = checks;
+  start = now_us();
+  for (uint32_t round = 0; round < rounds; round++) {
+    for (const ImportName &im : import_names) {
+      r->ok = wasm_runtime_is_import_func_linked(im.module,
+                                                 im.field.c_str()) &&
+              r->ok;
+    }
+  }
+  r->us = (now_us() - start) / rounds;
+
+  r = &results[Phase_Load];
+  rounds = LOAD_ROUNDS * scale;
+  r->ok = checks;
+  start = now_us();
+  for (uint32_t round = 0; round < rounds && r->ok; round++) {
+    wasm_module_t module = load(bytes);
+    r->ok = module != NULL;
+    if (module) {
+      wasm_runtime_unload(module);
+    }
+  }
+  r->us = (now_us() - start) / rounds;
+
+  wasm_runtime_destroy();
+  return results[Phase_Resolve].ok && r->ok;
+}
+
+int main(int argc, char **argv) {
+  for (int i = 1; i < argc; i++) {
+    if (strncmp(argv[i], "--scale=", 8) == 0) {
+      scale = (uint32_t)atoi(argv[i] + 8);
+      if (scale == 0) {
+        scale = 1;
+      }
+    } else if (strncmp(argv[i], "--natives=", 10) == 0) {
+      natives_per_table = (uint32_t)atoi(argv[i] + 10);
+      if (natives_per_table < 2 || natives_per_table > 999) {
+        natives_per_table = 80;
+      }
+    } else {
+      fprintf(stderr, "usage: %s [--scale=N] [--natives=N]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  build_tables();
+  std::vector<uint8_t> bytes = build_module();
+  bool all_ok = time_registration(false);
+  all_ok = time_registration(true) && all_ok;
+  all_ok = run_loads(bytes) && all_ok;
+
+  printf("phase,index,tables,natives,us,check\n");
+  for (int phase = 0; phase < Phase_Num; phase++) {
+    printf("%s,%s,%u,%u,%.1f,%s\n", phase_names[phase],
+           WASM_ENABLE_NATIVE_INDEX ? "hash" : "list",
+           (unsigned)TABLE_COUNT, natives_per_table, results[phase].us,
+           results[phase].ok ? "ok" : "FAIL");
+  }
+  return all_ok ? 0 : 1;
+}
@@ -0,0 +1,447 @@
+/*
+ * Host benchmark: instance snapshots and reset against reloading
+ *
+ * Copyright (C) 2025 WAMR-ESP32-Arduino Contributors
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * A generated module builds a table in its linear memory with an init
+ * export, the kind of setup a script runs once before serving calls. The
+ * benchmark compares four ways to get an initialized instance:
+ *   reload   unload(), load() and call init again
+ *   reset    WamrModule::reset() and call init again, after the previous
+ *            round dirtied memory, bumped a global, grew the memory and
+ *            trapped
+ *   restore  WamrModule::restoreSnapshot() on the same instance, after the
+ *            same round
+ *   clone    WamrModule::cloneFrom() a module holding the snapshot
+ *
+ * Every instance must give the checksum of a freshly initialized one, have
+ * its initial page count, and hand out the same app heap block the source
+ * got after its snapshot. Clones must keep working once the source is
+ * unloaded.
+ *
+ * Usage:
+ *   snapshot_bench [--scale=N]
+ *
+ * Output is CSV:
+ *   method,iterations,us_per_op,snapshot_bytes,check
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <vector>
+
+#include <WAMR.h>
+
+#define BENCH_HEAP_POOL (4 * 1024 * 1024)
+#define BENCH_STACK_SIZE (16 * 1024)
+#define BENCH_MODULE_HEAP (16 * 1024)
+#define BENCH_ITERATIONS 50
+#define INIT_ROUNDS 20000
+
+#define DATA_OFFSET 16
+#define TABLE_BASE 1024
+#define TABLE_WORDS 256
+#define CHECKSUM_END 2048
+#define MALLOC_SIZE 64
+
+static uint32_t scale = 1;
+static std::vector<uint8_t> wasm;
+
+static const uint8_t data_seg[] = "restored, not re-run";
+
+static double now_us() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+// ============================================================================
+// Generated module
+// ============================================================================
+
+static void put_u32(std::vector<uint8_t> *out, uint32_t value) {
+  do {
+    uint8_t byte = value & 0x7f;
+    value >>= 7;
+    out->push_back(value ? byte | 0x80 : byte);
+  } while (value);
+}
+
+static void put_section(std::vector<uint8_t> *out, uint8_t id,
+                        const std::vector<uint8_t> &body) {
+  out->push_back(id);
+  put_u32(out, (uint32_t)body.size());
+  out->insert(out->end(), body.begin(), body.end());
+}
+
+static void put_export(std::vector<uint8_t> *out, const char *name,
+                       uint32_t func_index) {
+  put_u32(out, (uint32_t)strlen(name));
+  out->insert(out->end(), name, name + strlen(name));
+  out->push_back(0x00);
+  put_u32(out, func_index);
+}
+
+static void put_body(std::vector<uint8_t> *out, const uint8_t *body,
+                     uint32_t size) {
+  put_u32(out, size);
+  out->insert(out->end(), body, body + size);
+}
+
+// (memory 1 16) with one data segment and a mutable global, exporting
+//   init(n)          n rounds of word[i % 256] = word[i % 256] * 31 + i
+//                    over the table at TABLE_BASE, then global = 1
+//   checksum() -> i32  sum of the words below CHECKSUM_END plus the global
+//   bump()           dirties the table, increments the global and grows
+//                    the memory by a page
+//   trap()           unreachable
+static std::vector<uint8_t> build_module() {
+  std::vector<uint8_t> m = {0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00};
+  std::vector<uint8_t> s;
+
+  const uint8_t types[] = {
+      0x03,                                      // 3 types
+      0x60, 0x01, 0x7f, 0x00,                    // (i32) -> ()
+      0x60, 0x00, 0x01, 0x7f,                    // () -> i32
+      0x60, 0x00, 0x00,                          // () -> ()
+  };
+  s.assign(types, types + sizeof(types));
+  put_section(&m, 1, s);
+
+  const uint8_t funcs[] = {0x04, 0x00, 0x01, 0x02, 0x02};
+  s.assign(funcs, funcs + sizeof(funcs));
+  put_section(&m, 3, s);
+
+  s.assign({0x01, 0x01, 0x01, 0x10});  // 1 memory, 1 to 16 pages
+  put_section(&m, 5, s);
+
+  s.assign({0x01, 0x7f, 0x01, 0x41, 0x00, 0x0b});  // (mut i32) = 0
+  put_section(&m, 6, s);
+
+  s.clear();
+  put_u32(&s, 4);
+  put_export(&s, "init", 0);
+  put_export(&s, "checksum", 1);
+  put_export(&s, "bump", 2);
+  put_export(&s, "trap", 3);
+  put_section(&m, 7, s);
+
+  const uint8_t init[] = {
+      0x01, 0x02, 0x7f,                          // locals i, addr: i32
+      0x02, 0x40, 0x03, 0x40,                    // block loop
+      0x20, 0x01, 0x20, 0x00, 0x4f, 0x0d, 0x01,  // br_if 1 (i >= n)
+      0x20, 0x01, 0x41, 0xff, 0x01, 0x71,        // addr = (i & 255) << 2
+      0x41, 0x02, 0x74,                          //        + TABLE_BASE
+      0x41, 0x80, 0x08, 0x6a, 0x22, 0x02,
+      0x20, 0x02, 0x28, 0x02, 0x00,              // i32.store addr
+      0x41, 0x1f, 0x6c, 0x20, 0x01, 0x6a,        //   (load addr * 31 + i)
+      0x36, 0x02, 0x00,
+      0x20, 0x01, 0x41, 0x01, 0x6a, 0x21, 0x01,  // i += 1
+      0x0c, 0x00, 0x0b, 0x0b,                    // br 0, end, end
+      0x41, 0x01, 0x24, 0x00,                    // global = 1
+      0x0b,
+  };
+  const uint8_t checksum[] = {
+      0x01, 0x02, 0x7f,                          // locals addr, acc: i32
+      0x02, 0x40, 0x03, 0x40,                    // block loop
+      0x20, 0x00, 0x41, 0x80, 0x10, 0x4f,        // br_if 1
+      0x0d, 0x01,                                //   (addr >= CHECKSUM_END)
+      0x20, 0x01, 0x20, 0x00, 0x28, 0x02, 0x00,  // acc += i32.load addr
+      0x6a, 0x21, 0x01,
+      0x20, 0x00, 0x41, 0x04, 0x6a, 0x21, 0x00,  // addr += 4
+      0x0c, 0x00, 0x0b, 0x0b,                    // br 0, end, end
+      0x20, 0x01, 0x23, 0x00, 0x6a,              // acc + global
+      0x0b,
+  };
+  const uint8_t bump[] = {
+      0x00,
+      0x41, 0x80, 0x08, 0x41, 0x7f, 0x36, 0x02,  // i32.store TABLE_BASE -1
+      0x00,
+      0x23, 0x00, 0x41, 0x01, 0x6a, 0x24, 0x00,  // global += 1
+      0x41, 0x01, 0x40, 0x00, 0x1a,              // drop memory.grow 1
+      0x0b,
+  };
+  const uint8_t trap[] = {0x00, 0x00, 0x0b};
+  s.clear();
+  put_u32(&s, 4);
+  put_body(&s, init, sizeof(init));
+  put_body(&s, checksum, sizeof(checksum));
+  put_body(&s, bump, sizeof(bump));
+  put_body(&s, trap, sizeof(trap));
+  put_section(&m, 10, s);
+
+  s.assign({0x01, 0x00, 0x41, DATA_OFFSET, 0x0b});
+  put_u32(&s, sizeof(data_seg));
+  s.insert(s.end(), data_seg, data_seg + sizeof(data_seg));
+  put_section(&m, 11, s);
+  return m;
+}
+
+// What checksum() returns once init(INIT_ROUNDS) ran on a fresh instance
+static uint32_t expected_checksum() {
+  static uint32_t words[CHECKSUM_END / 4];
+  uint32_t sum = 1;
+
+  memset(words, 0, sizeof(words));
+  memcpy((uint8_t *)words + DATA_OFFSET, data_seg, sizeof(data_seg));
+  for (uint32_t i = 0; i < INIT_ROUNDS; i++) {
+    uint32_t *word = &words[TABLE_BASE / 4 + (i & (TABLE_WORDS - 1))];
+    *word = *word * 31 + i;
+  }
+  for (uint32_t i = 0; i < CHECKSUM_END / 4; i++) {
+    sum += words[i];
+  }
+  return sum;
+}
+
+// ============================================================================
+// Checks
+// ============================================================================
+
+static uint32_t initial_pages;
+static uint64_t heap_block;
+
+static uint32_t page_count(WamrModule &module) {
+  wasm_memory_inst_t memory =
+      wasm_runtime_get_default_memory(module.getInstance());
+  return memory ? (uint32_t)wasm_memory_get_cur_page_count(memory) : 0;
+}
+
+// Allocates and frees an app heap block, returning its offset
+static uint64_t probe_heap(WamrModule &module) {
+  uint64_t offset = wasm_runtime_module_malloc(module.getInstance(),
+                                               MALLOC_SIZE, NULL);
+  if (offset) {
+    wasm_runtime_module_free(module.getInstance(), offset);
+  }
+  return offset;
+}
+
+// Checks that the module is in the state of a freshly initialized instance
+static bool check_initialized(const char *what, WamrModule &module,
+                              uint32_t expected) {
+  uint32_t argv[1] = {0};
+
+  if (!module.callFunction("checksum", 0, argv)) {
+    fprintf(stderr, "%s: checksum failed: %s\n", what, module.getError());
+    return false;
+  }
+  if (argv[0] != expected) {
+    fprintf(stderr, "%s: checksum 0x%08x, expected 0x%08x\n", what, argv[0],
+            expected);
+    return false;
+  }
+  if (page_count(module) != initial_pages) {
+    fprintf(stderr, "%s: %u pages, expected %u\n", what, page_count(module),
+            initial_pages);
+    return false;
+  }
+  if (heap_block && probe_heap(module) != heap_block) {
+    fprintf(stderr, "%s: app heap not in its snapshot state\n", what);
+    return false;
+  }
+  return true;
+}
+
+// Dirties memory and globals, grows the memory and traps
+static bool dirty(WamrModule &module) {
+  if (!module.callFunction("bump") || page_count(module) != initial_pages + 1) {
+    fprintf(stderr, "bump failed: %s\n", module.getError());
+    return false;
+  }
+  if (module.callFunction("trap")) {
+    fprintf(stderr, "trap did not trap\n");
+    return false;
+  }
+  return true;
+}
+
+static bool load_initialized(WamrModule &module) {
+  uint32_t argv[1] = {INIT_ROUNDS};
+
+  if (!module.load(wasm.data(), (uint32_t)wasm.size(), BENCH_STACK_SIZE,
+                   BENCH_MODULE_HEAP)) {
+    fprintf(stderr, "load failed: %s\n", module.getError());
+    return false;
+  }
+  if (!module.callFunction("init", 1, argv)) {
+    fprintf(stderr, "init failed: %s\n", module.getError());
+    return false;
+  }
+  return true;
+}
+
+// ============================================================================
+// Methods
+// ============================================================================
+
+struct MethodResult {
+  const char *name;
+  double us_per_op;
+  uint32_t snapshot_bytes;
+  bool ok;
+};
+
+static MethodResult bench_reload(uint32_t iterations, uint32_t expected) {
+  MethodResult r = {"reload", 0, 0, true};
+  WamrModule module;
+  double total = 0;
+
+  for (uint32_t i = 0; i < iterations && r.ok; i++) {
+    double start = now_us();
+    module.unload();
+    r.ok = load_initialized(module);
+    total += now_us() - start;
+    r.ok = r.ok && check_initialized("reload", module, expected);
+  }
+  r.us_per_op = total / iterations;
+  return r;
+}
+
+static MethodResult bench_reset(uint32_t iterations, uint32_t expected) {
+  MethodResult r = {"reset", 0, 0, true};
+  uint32_t argv[1];
+  WamrModule module;
+  double total = 0;
+
+  r.ok = load_initialized(module);
+  for (uint32_t i = 0; i < iterations && r.ok; i++) {
+    r.ok = dirty(module);
+    if (!r.ok) {
+      break;
+    }
+    double start = now_us();
+    r.ok = module.reset();
+    argv[0] = INIT_ROUNDS;
+    r.ok = r.ok && module.callFunction("init", 1, argv);
+    total += now_us() - start;
+    if (!r.ok) {
+      fprintf(stderr, "reset failed: %s\n", module.getError());
+      break;
+    }
+    r.ok = check_initialized("reset", module, expected);
+  }
+  r.us_per_op = total / iterations;
+  return r;
+}
+
+static MethodResult bench_restore(WamrModule &source, uint32_t iterations,
+                                  uint32_t expected) {
+  MethodResult r = {"restore", 0, source.getSnapshotSize(), true};
+  double total = 0;
+
+  for (uint32_t i = 0; i < iterations && r.ok; i++) {
+    r.ok = dirty(source);
+    if (!r.ok) {
+      break;
+    }
+    double start = now_us();
+    r.ok = source.restoreSnapshot();
+    total += now_us() - start;
+    if (!r.ok) {
+      fprintf(stderr, "restore failed: %s\n", source.getError());
+      break;
+    }
+    r.ok = check_initialized("restore", source, expected);
+  }
+  r.us_per_op = total / iterations;
+  return r;
+}
+
+static MethodResult bench_clone(WamrModule &source, uint32_t iterations,
+                                uint32_t expected) {
+  MethodResult r = {"clone", 0, source.getSnapshotSize(), true};
+  double total = 0;
+
+  for (uint32_t i = 0; i < iterations && r.ok; i++) {
+    WamrModule clone;
+    double start = now_us();
+    r.ok = clone.cloneFrom(source);
+    total += now_us() - start;
+    if (!r.ok) {
+      fprintf(stderr, "clone failed: %s\n", clone.getError());
+      break;
+    }
+    r.ok = check_initialized("clone", clone, expected) && dirty(clone) &&
+           clone.restoreSnapshot() &&
+           check_initialized("clone restore", clone, expected);
+  }
+  r.us_per_op = total / iterations;
+  return r;
+}
+
+// The source goes first, its clones keep the shared module and snapshot
+static bool check_clone_outlives_source(uint32_t expected) {
+  WamrModule source;
+  WamrModule clone;
+
+  if (!load_initialized(source) || !source.takeSnapshot() ||
+      !clone.cloneFrom(source)) {
+    fprintf(stderr, "clone setup failed\n");
+    return false;
+  }
+  if (source.takeSnapshot()) {
+    fprintf(stderr, "snapshot replaced while a clone shares it\n");
+    return false;
+  }
+  source.unload();
+  return dirty(clone) && clone.restoreSnapshot() &&
+         check_initialized("orphan clone", clone, expected);
+}
+
+int main(int argc, char **argv) {
+  for (int i = 1; i < argc; i++) {
+    if (strncmp(argv[i], "--scale=", 8) == 0) {
+      scale = (uint32_t)atoi(argv[i] + 8);
+      if (scale == 0) {
+        scale = 1;
+      }
+    } else {
+      fprintf(stderr, "usage: %s [--scale=N]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  if (!WamrRuntime::begin(BENCH_HEAP_POOL)) {
+    fprintf(stderr, "runtime init failed\n");
+    return 1;
+  }
+
+  wasm = build_module();
+  uint32_t expected = expected_checksum();
+  uint32_t iterations = BENCH_ITERATIONS * scale;
+  MethodResult results[4];
+  bool ok = true;
+  {
+    WamrModule source;
+    ok = load_initialized(source);
+    initial_pages = ok ? page_count(source) : 0;
+    ok = ok && check_initialized("init", source, expected) &&
+         source.takeSnapshot();
+    heap_block = ok ? probe_heap(source) : 0;
+    if (ok && !heap_block) {
+      fprintf(stderr, "app heap allocation failed\n");
+      ok = false;
+    }
+
+    results[0] = bench_reload(iterations, expected);
+    results[1] = bench_reset(iterations, expected);
+    results[2] = bench_restore(source, iterations, expected);
+    results[3] = bench_clone(source, iterations, expected);
+  }
+  ok = check_clone_outlives_source(expected) && ok;
+
+  printf("method,iterations,us_per_op,snapshot_bytes,check\n");
+  for (const MethodResult &r : results) {
+    printf("%s,%u,%.1f,%u,%s\n", r.name, iterations, r.us_per_op,
+           r.snapshot_bytes, ok && r.ok ? "ok" : "FAIL");
+    ok = ok && r.ok;
+  }
+
+  WamrRuntime::end();
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,756 @@
+/*
+ * Host benchmark suite: load, instantiate, call overhead and kernels
+ *
+ * Copyright (C) 2025 WAMR-ESP32-Arduino Contributors
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Runs the vendored WAMR runtime and the Arduino wrapper on Linux (see the
+ * top-level CMakeLists.txt) so runtime and wrapper changes can be measured
+ * without flashing a board. Absolute numbers are host numbers; compare runs
+ * of the same binary on the same machine, not against ESP32 timings.
+ *
+ * Every benchmark also checks its result, so a run doubles as a smoke test
+ * of the wrapper and interpreter. The exit status is non-zero if any check
+ * fails.
+ *
+ * Usage:
+ *   wamr_bench [--format=csv|json] [--scale=N] [module.wasm ...]
+ *
+ * Extra .wasm files are measured for load and instantiate time only.
+ *
+ * Output columns: group,name,iterations,total_us,per_iter_us,check
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <WAMR.h>
+
+#include "bench_modules.h"
+
+#define BENCH_HEAP_POOL (8 * 1024 * 1024)
+#define BENCH_STACK_SIZE (64 * 1024)
+#define BENCH_MODULE_HEAP (64 * 1024)
+#define BENCH_MAX_RESULTS 64
+#define BENCH_BATCH_ROWS 256
+
+#define FIB_N 24
+#define FIB_EXPECTED 46368
+#define KERNEL_BYTES (64 * 1024)
+#define MATMUL_N 48
+
+struct BenchResult {
+  const char *group;
+  char name[48];
+  uint32_t iterations;
+  double total_us;
+  bool ok;
+};
+
+static BenchResult results[BENCH_MAX_RESULTS];
+static uint32_t result_count = 0;
+static uint32_t scale = 1;
+
+static double now_us() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+static void record(const char *group, const char *name, uint32_t iterations,
+                   double total_us, bool ok) {
+  if (result_count == BENCH_MAX_RESULTS) {
+    return;
+  }
+  BenchResult *r = &results[result_count++];
+  r->group = group;
+  snprintf(r->name, sizeof(r->name), "%s", name);
+  r->iterations = iterations;
+  r->total_us = total_us;
+  r->ok = ok;
+}
+
+// ============================================================================
+// Load / instantiate
+// ============================================================================
+
+static void bench_load(const char *name, const uint8_t *bytes, uint32_t size) {
+  char error_buf[128];
+  uint32_t iterations = 200 * scale;
+  bool ok = true;
+  double total_us = 0;
+
+  uint8_t *copy = (uint8_t *)malloc(size);
+  if (!copy) {
+    record("load", name, 0, 0, false);
+    return;
+  }
+
+  for (uint32_t i = 0; i < iterations && ok; i++) {
+    memcpy(copy, bytes, size);
+    double start = now_us();
+    wasm_module_t module =
+        wasm_runtime_load(copy, size, error_buf, sizeof(error_buf));
+    if (!module) {
+      fprintf(stderr, "load %s: %s\n", name, error_buf);
+      ok = false;
+      break;
+    }
+    wasm_runtime_unload(module);
+    total_us += now_us() - start;
+  }
+  record("load", name, iterations, total_us, ok);
+  if (!ok) {
+    free(copy);
+    return;
+  }
+
+  // Read-only load as done by WamrModule::load(): no copy, strings cloned
+  LoadArgs load_args;
+  memset(&load_args, 0, sizeof(load_args));
+  load_args.name = const_cast<char *>("");
+  load_args.wasm_binary_readonly = true;
+  total_us = 0;
+  for (uint32_t i = 0; i < iterations && ok; i++) {
+    double start = now_us();
+    wasm_module_t module =
+        wasm_runtime_load_ex(const_cast<uint8_t *>(bytes), size, &load_args,
+                             error_buf, sizeof(error_buf));
+    if (!module) {
+      fprintf(stderr, "load_readonly %s: %s\n", name, error_buf);
+      ok = false;
+      break;
+    }
+    wasm_runtime_unload(module);
+    total_us += now_us() - start;
+  }
+  record("load_readonly", name, iterations, total_us, ok);
+
+  // Read-only load restoring the functions from a code cache, as done by
+  // WamrModule::loadCached()
+  uint32_t cache_size = 0;
+  uint8_t *cache = WamrModule::buildCodeCache(bytes, size, &cache_size);
+  load_args.code_cache = cache;
+  load_args.code_cache_size = cache_size;
+  ok = cache != nullptr;
+  total_us = 0;
+  for (uint32_t i = 0; i < iterations && ok; i++) {
+    double start = now_us();
+    wasm_module_t module =
+        wasm_runtime_load_ex(const_cast<uint8_t *>(bytes), size, &load_args,
+                             error_buf, sizeof(error_buf));
+    if (!module) {
+      fprintf(stderr, "load_cached %s: %s\n", name, error_buf);
+      ok = false;
+      break;
+    }
+    ok = wasm_runtime_is_code_cache_used(module);
+    wasm_runtime_unload(module);
+    total_us += now_us() - start;
+  }
+  record("load_cached", name, iterations, total_us, ok);
+  free(cache);
+
+  // Read-only load deferring function lowering to the first call, as done
+  // by WamrModule::loadLazy()
+  load_args.code_cache = nullptr;
+  load_args.code_cache_size = 0;
+  load_args.lazy_lowering = true;
+  ok = true;
+  total_us = 0;
+  for (uint32_t i = 0; i < iterations && ok; i++) {
+    double start = now_us();
+    wasm_module_t module =
+        wasm_runtime_load_ex(const_cast<uint8_t *>(bytes), size, &load_args,
+                             error_buf, sizeof(error_buf));
+    if (!module) {
+      fprintf(stderr, "load_lazy %s: %s\n", name, error_buf);
+      ok = false;
+      break;
+    }
+    wasm_runtime_unload(module);
+    total_us += now_us() - start;
+  }
+  record("load_lazy", name, iterations, total_us, ok);
+  ok = true;
+
+  memcpy(copy, bytes, size);
+  wasm_module_t module =
+      wasm_runtime_load(copy, size, error_buf, sizeof(error_buf));
+  double start = now_us();
+  for (uint32_t i = 0; i < iterations; i++) {
+    wasm_module_inst_t inst =
+        wasm_runtime_instantiate(module, BENCH_STACK_SIZE, BENCH_MODULE_HEAP,
+                                 error_buf, sizeof(error_buf));
+    if (!inst) {
+      fprintf(stderr, "instantiate %s: %s\n", name, error_buf);
+      ok = false;
+      break;
+    }
+    wasm_runtime_deinstantiate(inst);
+  }
+  record("instantiate", name, iterations, now_us() - start, ok);
+  wasm_runtime_unload(module);
+  free(copy);
+}
+
+static bool read_file(const char *path, uint8_t **bytes, uint32_t *size) {
+  FILE *f = fopen(path, "rb");
+  if (!f) {
+    return false;
+  }
+  fseek(f, 0, SEEK_END);
+  long len = ftell(f);
+  fseek(f, 0, SEEK_SET);
+  *bytes = (uint8_t *)malloc(len > 0 ? len : 1);
+  bool ok = *bytes && len > 0 && fread(*bytes, 1, len, f) == (size_t)len;
+  fclose(f);
+  if (!ok) {
+    free(*bytes);
+    return false;
+  }
+  *size = (uint32_t)len;
+  return true;
+}
+
+// ============================================================================
+// Call overhead (math module, "add")
+// ============================================================================
+
+// (module (global (export "ticks") (mut i32) (i32.const 0))
+//   (func (export "tick")
+//     (global.set 0 (i32.add (global.get 0) (i32.const 1)))))
+static const unsigned char tick_wasm[] = {
+  0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x04, 0x01, 0x60,
+  0x00, 0x00, 0x03, 0x02, 0x01, 0x00, 0x06, 0x06, 0x01, 0x7f, 0x01, 0x41,
+  0x00, 0x0b, 0x07, 0x10, 0x02, 0x04, 0x74, 0x69, 0x63, 0x6b, 0x00, 0x00,
+  0x05, 0x74, 0x69, 0x63, 0x6b, 0x73, 0x03, 0x00, 0x0a, 0x0b, 0x01, 0x09,
+  0x00, 0x23, 0x00, 0x41, 0x01, 0x6a, 0x24, 0x00, 0x0b
+};
+
+static void bench_calls(WamrModule &module) {
+  uint32_t iterations = 20000 * scale;
+  uint32_t argv[2];
+  bool ok;
+  double start;
+
+  // Direct runtime call: the floor every wrapper path is compared against
+  wasm_module_inst_t inst = module.getInstance();
+  wasm_function_inst_t add = wasm_runtime_lookup_function(inst, "add");
+  wasm_exec_env_t env = wasm_runtime_create_exec_env(inst, BENCH_STACK_SIZE);
+  ok = add && env;
+  start = now_us();
+  for (uint32_t i = 0; i < iterations && ok; i++) {
+    argv[0] = i;
+    argv[1] = 1;
+    ok = wasm_runtime_call_wasm(env, add, 2, argv) && argv[0] == i + 1;
+  }
+  record("call", "runtime_call_wasm", iterations, now_us() - start, ok);
+  if (env) {
+    wasm_runtime_destroy_exec_env(env);
+  }
+
+  ok = true;
+  start = now_us();
+  for (uint32_t i = 0; i < iterations && ok; i++) {
+    argv[0] = i;
+    argv[1] = 1;
+    ok = module.callFunctionRaw("add", 2, argv) && argv[0] == i + 1;
+  }
+  record("call", "callFunctionRaw", iterations, now_us() - start, ok);
+
+  ok = true;
+  start = now_us();
+  for (uint32_t i = 0; i < iterations && ok; i++) {
+    argv[0] = i;
+    argv[1] = 1;
+    ok = module.callFunction("add", 2, argv) && argv[0] == i + 1;
+  }
+  record("call", "callFunction", iterations, now_us() - start, ok);
+
+  // Name hashed at compile time, looked up in the table built at load
+  ok = true;
+  start = now_us();
+  for (uint32_t i = 0; i < iterations && ok; i++) {
+    argv[0] = i;
+    argv[1] = 1;
+    ok = module.callFunctionRaw(WAMR_EXPORT("add"), 2, argv) &&
+         argv[0] == i + 1;
+  }
+  record("call", "callFunctionRaw_hashed", iterations, now_us() - start, ok);
+
+  ok = true;
+  start = now_us();
+  for (uint32_t i = 0; i < iterations && ok; i++) {
+    argv[0] = i;
+    argv[1] = 1;
+    ok = module.callFunction(WAMR_EXPORT("add"), 2, argv) && argv[0] == i + 1;
+  }
+  record("call", "callFunction_hashed", iterations, now_us() - start, ok);
+
+  argv[0] = 10;
+  argv[1] = 3;
+  ok = module.callFunctionRaw(WAMR_EXPORT("subtract"), 2, argv) &&
+       argv[0] == 7 && !module.callFunctionRaw(WAMR_EXPORT("missing"), 2, argv);
+  record("check", "hashed_names", 1, 0, ok);
+
+  // A name colliding with "add" in hash and length must not call it
+  WamrExportName collision = {"sub", wamrHashName("add"), 3};
+  ok = !module.callFunctionRaw(collision, 2, argv);
+  record("check", "hashed_name_collision", 1, 0, ok);
+
+  WamrFunction handle = module.getFunction("add");
+  ok = handle.isValid();
+  start = now_us();
+  for (uint32_t i = 0; i < iterations && ok; i++) {
+    argv[0] = i;
+    argv[1] = 1;
+    ok = handle.callRaw(2, argv) && argv[0] == i + 1;
+  }
+  record("call", "handle_raw", iterations, now_us() - start, ok);
+
+  ok = handle.isValid();
+  start = now_us();
+  for (uint32_t i = 0; i < iterations && ok; i++) {
+    argv[0] = i;
+    argv[1] = 1;
+    ok = handle.call(2, argv) && argv[0] == i + 1;
+  }
+  record("call", "handle", iterations, now_us() - start, ok);
+
+  auto typed = module.getFunction<int32_t(int32_t, int32_t)>("add");
+  ok = typed.isValid();
+  start = now_us();
+  for (uint32_t i = 0; i < iterations && ok; i++) {
+    int32_t result = 0;
+    ok = typed.callRaw(result, (int32_t)i, 1) && result == (int32_t)i + 1;
+  }
+  record("call", "typed_raw", iterations, now_us() - start, ok);
+
+  // One row per call; per_iter_us is per row
+  static uint32_t matrix[BENCH_BATCH_ROWS * 2];
+  uint32_t batches = iterations / BENCH_BATCH_ROWS;
+  ok = true;
+  start = now_us();
+  for (uint32_t b = 0; b < batches && ok; b++) {
+    for (uint32_t r = 0; r < BENCH_BATCH_ROWS; r++) {
+      matrix[r * 2] = r;
+      matrix[r * 2 + 1] = b;
+    }
+    ok = module.callBatch("add", 2, matrix, BENCH_BATCH_ROWS);
+    for (uint32_t r = 0; r < BENCH_BATCH_ROWS && ok; r++) {
+      ok = matrix[r * 2] == r + b;
+    }
+  }
+  record("call", "callBatch", batches * BENCH_BATCH_ROWS, now_us() - start,
+         ok);
+
+  // Trapping row: INT_MIN / -1 at index 3 must stop the batch there
+  uint32_t trap[4 * 2] = {8, 2, 9, 3, 10, 5, 0x80000000u, 0xffffffffu};
+  uint32_t failed = 0;
+  ok = !module.callBatch("divide", 2, trap, 4, &failed) && failed == 3 &&
+       trap[0] == 4 && trap[4] == 2;
+  record("check", "callBatch_trap_index", 1, 0, ok);
+
+  // Traps stay set on the instance until cleared
+  wasm_runtime_clear_exception(module.getInstance());
+
+  // A () -> () export batched with no matrix at all
+  WamrModule ticker;
+  wasm_global_inst_t ticks;
+  ok = ticker.load(tick_wasm, sizeof(tick_wasm), BENCH_STACK_SIZE, 0) &&
+       ticker.callBatch("tick", 0, nullptr, 5) &&
+       wasm_runtime_get_export_global_inst(ticker.getInstance(), "ticks",
+                                           &ticks) &&
+       *(int32_t *)ticks.global_data == 5 && ticker.getResult() == 0;
+  record("check", "callBatch_no_cells", 1, 0, ok);
+}
+
+// ============================================================================
+// Export lookups (math and kernels modules)
+// ============================================================================
+
+// (module (global (export "counter") (mut i32) (i32.const 7)))
+static const unsigned char global_wasm[] = {
+  0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x06, 0x06, 0x01, 0x7f,
+  0x01, 0x41, 0x07, 0x0b, 0x07, 0x0b, 0x01, 0x07, 0x63, 0x6f, 0x75, 0x6e,
+  0x74, 0x65, 0x72, 0x03, 0x00
+};
+
+static uint32_t pool_free() {
+  mem_alloc_info_t main_info, fast_info;
+  WamrRuntime::getPoolInfo(&main_info, &fast_info);
+  return main_info.total_free_size;
+}
+
+static void *call_add_thread(void *arg) {
+  WamrModule *module = (WamrModule *)arg;
+  uint32_t argv[2] = {1, 2};
+  bool ok = module->callFunctionRaw("add", 2, argv) && argv[0] == 3;
+  return ok ? arg : nullptr;
+}
+
+// The exec_env (and WASM stack) of a thread is freed when it exits: a user
+// thread, and a pool worker replaced by setWorkerCount()
+static void check_thread_exit(WamrModule &module) {
+  uint32_t free_before = pool_free();
+  pthread_t thread;
+  void *ret = nullptr;
+  bool ok = pthread_create(&thread, nullptr, call_add_thread, &module) == 0 &&
+            pthread_join(thread, &ret) == 0 && ret == &module;
+  ok = ok && pool_free() + 1024 > free_before;
+  record("check", "thread_exit_frees_exec_env", 1, 0, ok);
+
+  // Stopping the workers frees the stack before the next call makes one
+  uint32_t argv[2] = {1, 2};
+  ok = module.callFunction("add", 2, argv);
+  free_before = pool_free();
+  WamrRuntime::setWorkerCount(1);
+  ok = ok && pool_free() >= free_before + BENCH_STACK_SIZE;
+  argv[0] = 1;
+  ok = ok && module.callFunction("add", 2, argv) && argv[0] == 3;
+  record("check", "worker_restart_frees_exec_env", 1, 0, ok);
+}
+
+// Bytecode loads from any address; an AOT buffer must be word aligned and
+// an unaligned one is rejected before the loader reads it
+static void check_unaligned_load() {
+  uint8_t *buf = (uint8_t *)malloc(math_wasm_len + 1);
+  if (!buf) {
+    record("check", "unaligned_wasm_load", 1, 0, false);
+    return;
+  }
+  memcpy(buf + 1, math_wasm, math_wasm_len);
+  WamrModule module;
+  uint32_t argv[2] = {1, 2};
+  bool ok = module.load(buf + 1, math_wasm_len, BENCH_STACK_SIZE,
+                        BENCH_MODULE_HEAP) &&
+            module.callFunctionRaw("add", 2, argv) && argv[0] == 3;
+  module.unload();
+  record("check", "unaligned_wasm_load", 1, 0, ok);
+
+  static const uint8_t aot_header[] = {0x00, 'a', 'o', 't', 3, 0, 0, 0};
+  memcpy(buf + 1, aot_header, sizeof(aot_header));
+  ok = !module.load(buf + 1, sizeof(aot_header)) &&
+       !WamrModule::isXipBinary(buf + 1, sizeof(aot_header));
+#if WASM_ENABLE_AOT != 0
+  ok = ok && strstr(module.getError(), "aligned") != nullptr;
+#endif
+  record("check", "unaligned_aot_rejected", 1, 0, ok);
+  free(buf);
+}
+
+static void bench_exports(WamrModule &math, WamrModule &kernels) {
+  uint32_t iterations = 100000 * scale;
+  wasm_module_inst_t inst = math.getInstance();
+  wasm_module_t module = wasm_runtime_get_module(inst);
+  char error_buf[128];
+  bool ok;
+  double start;
+
+  ok = true;
+  start = now_us();
+  for (uint32_t i = 0; i < iterations && ok; i++) {
+    ok = wasm_runtime_lookup_function(inst, "fibonacci") != nullptr;
+  }
+  record("lookup", "lookup_function", iterations, now_us() - start, ok);
+
+  int32_t fib = wasm_runtime_get_export_index(module, "fibonacci",
+                                              WASM_IMPORT_EXPORT_KIND_FUNC);
+  ok = fib >= 0;
+  start = now_us();
+  for (uint32_t i = 0; i < iterations && ok; i++) {
+    ok = wasm_runtime_get_export_function_by_index(inst, fib) != nullptr;
+  }
+  record("lookup", "export_index", iterations, now_us() - start, ok);
+
+  // The index resolves the same export in another instance of the module
+  wasm_module_inst_t other =
+      wasm_runtime_instantiate(module, BENCH_STACK_SIZE, BENCH_MODULE_HEAP,
+                               error_buf, sizeof(error_buf));
+  ok = other &&
+       wasm_runtime_get_export_function_by_index(other, fib) ==
+           wasm_runtime_lookup_function(other, "fibonacci") &&
+       wasm_runtime_get_export_function_by_index(other, fib) !=
+           wasm_runtime_get_export_function_by_index(inst, fib);
+  if (other) {
+    wasm_runtime_deinstantiate(other);
+  }
+  // Wrong kind, unknown name, out of range
+  ok = ok &&
+       !wasm_runtime_get_export_memory_by_index(inst, fib) &&
+       wasm_runtime_get_export_index(module, "fibonacci",
+                                     WASM_IMPORT_EXPORT_KIND_GLOBAL) < 0 &&
+       wasm_runtime_get_export_index(module, "missing",
+                                     WASM_IMPORT_EXPORT_KIND_FUNC) < 0 &&
+       !wasm_runtime_get_export_function_by_index(inst, -1) &&
+       !wasm_runtime_get_export_function_by_index(
+           inst, wasm_runtime_get_export_count(module));
+  record("check", "export_index_functions", 1, 0, ok);
+
+  inst = kernels.getInstance();
+  module = wasm_runtime_get_module(inst);
+  int32_t memory = wasm_runtime_get_export_index(
+      module, "memory", WASM_IMPORT_EXPORT_KIND_MEMORY);
+  ok = memory >= 0 &&
+       wasm_runtime_get_export_memory_by_index(inst, memory) ==
+           wasm_runtime_lookup_memory(inst, "memory");
+  record("check", "export_index_memory", 1, 0, ok);
+
+  WamrModule globals;
+  wasm_global_inst_t by_name, by_index;
+  ok = globals.load(global_wasm, sizeof(global_wasm), BENCH_STACK_SIZE, 0);
+  if (ok) {
+    inst = globals.getInstance();
+    int32_t counter =
+        wasm_runtime_get_export_index(wasm_runtime_get_module(inst), "counter",
+                                      WASM_IMPORT_EXPORT_KIND_GLOBAL);
+    ok = wasm_runtime_get_export_global_inst(inst, "counter", &by_name) &&
+         wasm_runtime_get_export_global_inst_by_index(inst, counter,
+                                                      &by_index) &&
+         by_index.global_data == by_name.global_data &&
+         by_index.kind == WASM_I32 && by_index.is_mutable &&
+         *(int32_t *)by_index.global_data == 7;
+  }
+  record("check", "export_index_global", 1, 0, ok);
+}
+
+// ============================================================================
+// Kernels (kernels module)
+// ============================================================================
+
+static uint32_t host_crc32(const uint8_t *p, uint32_t len) {
+  uint32_t crc = 0xffffffffu;
+  for (uint32_t i = 0; i < len; i++) {
+    crc ^= p[i];
+    for (int k = 0; k < 8; k++) {
+      crc = (crc >> 1) ^ (0xedb88320u & (0u - (crc & 1)));
+    }
+  }
+  return ~crc;
+}
+
+static uint32_t host_matmul(const uint8_t *mem, uint32_t n) {
+  const int32_t *a = (const int32_t *)mem;
+  const int32_t *b = a + n * n;
+  uint32_t sum = 0;
+  for (uint32_t i = 0; i < n; i++) {
+    for (uint32_t j = 0; j < n; j++) {
+      uint32_t c = 0;
+      for (uint32_t k = 0; k < n; k++) {
+        c += (uint32_t)a[i * n + k] * (uint32_t)b[k * n + j];
+      }
+      sum += c;
+    }
+  }
+  return sum;
+}
+
+static void bench_kernels(WamrModule &math, WamrModule &kernels) {
+  uint32_t argv[3];
+  bool ok;
+  double start;
+
+  uint32_t iterations = 5 * scale;
+  ok = true;
+  start = now_us();
+  for (uint32_t i = 0; i < iterations && ok; i++) {
+    argv[0] = FIB_N;
+    ok = math.callFunction("fibonacci", 1, argv) && argv[0] == FIB_EXPECTED;
+  }
+  record("kernel", "fibonacci_24", iterations, now_us() - start, ok);
+
+  uint8_t *mem = (uint8_t *)wasm_runtime_addr_app_to_native(
+      kernels.getInstance(), 0);
+  if (!mem) {
+    record("kernel", "memory", 0, 0, false);
+    return;
+  }
+
+  iterations = 10 * scale;
+  ok = true;
+  start = now_us();
+  for (uint32_t i = 0; i < iterations && ok; i++) {
+    argv[0] = 0;
+    argv[1] = KERNEL_BYTES;
+    argv[2] = i;
+    ok = kernels.callFunction("fill", 3, argv) &&
+         mem[KERNEL_BYTES - 1] == (uint8_t)((KERNEL_BYTES - 1) * 31 + i);
+  }
+  record("kernel", "fill_64k", iterations, now_us() - start, ok);
+
+  ok = true;
+  start = now_us();
+  for (uint32_t i = 0; i < iterations && ok; i++) {
+    argv[0] = KERNEL_BYTES;
+    argv[1] = 0;
+    argv[2] = KERNEL_BYTES;
+    ok = kernels.callFunction("memcpy_loop", 3, argv) &&
+         memcmp(mem, mem + KERNEL_BYTES, KERNEL_BYTES) == 0;
+  }
+  record("kernel", "memcpy_64k", iterations, now_us() - start, ok);
+
+  uint32_t expected = host_crc32(mem, KERNEL_BYTES);
+  ok = true;
+  start = now_us();
+  for (uint32_t i = 0; i < iterations && ok; i++) {
+    argv[0] = 0;
+    argv[1] = KERNEL_BYTES;
+    ok = kernels.callFunction("crc32", 2, argv) && argv[0] == expected;
+  }
+  record("kernel", "crc32_64k", iterations, now_us() - start, ok);
+
+  argv[0] = 0;
+  argv[1] = MATMUL_N * MATMUL_N * 4 * 2;
+  argv[2] = 7;
+  kernels.callFunction("fill", 3, argv);
+  expected = host_matmul(mem, MATMUL_N);
+  iterations = 2 * scale;
+  ok = true;
+  start = now_us();
+  for (uint32_t i = 0; i < iterations && ok; i++) {
+    argv[0] = MATMUL_N;
+    ok = kernels.callFunction("matmul", 1, argv) && argv[0] == expected;
+  }
+  record("kernel", "matmul_48", iterations, now_us() - start, ok);
+}
+
+// ============================================================================
+// Output
+// ============================================================================
+
+static void print_csv() {
+  printf("group,name,iterations,total_us,per_iter_us,check\n");
+  for (uint32_t i = 0; i < result_count; i++) {
+    const BenchResult *r = &results[i];
+    printf("%s,%s,%u,%.1f,%.4f,%s\n", r->group, r->name, r->iterations,
+           r->total_us, r->iterations ? r->total_us / r->iterations : 0.0,
+           r->ok ? "ok" : "FAIL");
+  }
+}
+
+static void print_json() {
+  printf("{\n  \"results\": [\n");
+  for (uint32_t i = 0; i < result_count; i++) {
+    const BenchResult *r = &results[i];
+    printf("    {\"group\": \"%s\", \"name\": \"%s\", \"iterations\": %u, "
+           "\"total_us\": %.1f, \"per_iter_us\": %.4f, \"ok\": %s}%s\n",
+           r->group, r->name, r->iterations, r->total_us,
+           r->iterations ? r->total_us / r->iterations : 0.0,
+           r->ok ? "true" : "false", i + 1 < result_count ? "," : "");
+  }
+  printf("  ]\n}\n");
+}
+
+int main(int argc, char **argv) {
+  bool json = false;
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--format=json") == 0) {
+      json = true;
+    } else if (strcmp(argv[i], "--format=csv") == 0) {
+      json = false;
+    } else if (strncmp(argv[i], "--scale=", 8) == 0) {
+      scale = (uint32_t)atoi(argv[i] + 8);
+      if (scale == 0) {
+        scale = 1;
+      }
+    } else if (argv[i][0] == '-') {
+      fprintf(stderr,
+              "usage: %s [--format=csv|json] [--scale=N] [module.wasm ...]\n",
+              argv[0]);
+      return 2;
+    }
+  }
+
+  if (!WamrRuntime::begin(BENCH_HEAP_POOL)) {
+    fprintf(stderr, "WamrRuntime::begin failed: %s\n",
+            WamrRuntime::getError());
+    return 1;
+  }
+
+  bench_load("math", math_wasm, math_wasm_len);
+  bench_load("kernels", kernels_wasm, kernels_wasm_len);
+  for (int i = 1; i < argc; i++) {
+    uint8_t *bytes;
+    uint32_t size;
+    if (argv[i][0] == '-') {
+      continue;
+    }
+    if (!read_file(argv[i], &bytes, &size)) {
+      fprintf(stderr, "cannot read %s\n", argv[i]);
+      record("load", argv[i], 0, 0, false);
+      continue;
+    }
+    const char *base = strrchr(argv[i], '/');
+    bench_load(base ? base + 1 : argv[i], bytes, size);
+    free(bytes);
+  }
+  check_unaligned_load();
+
+  // WamrModule::load() never writes to the buffer, so the const module
+  // arrays (in .rodata) are loaded directly. The kernels module runs code
+  // restored from its code cache, so the kernel checks cover the cache, and
+  // the math module is lowered lazily, so the call checks cover that.
+  {
+    WamrModule math;
+    WamrModule kernels;
+    uint32_t cache_size = 0;
+    uint8_t *cache =
+        WamrModule::buildCodeCache(kernels_wasm, kernels_wasm_len, &cache_size);
+    if (!math.loadLazy(math_wasm, math_wasm_len, BENCH_STACK_SIZE,
+                       BENCH_MODULE_HEAP) ||
+        !kernels.loadCached(kernels_wasm, kernels_wasm_len, cache, cache_size,
+                            BENCH_STACK_SIZE, BENCH_MODULE_HEAP)) {
+      fprintf(stderr, "module load failed\n");
+      free(cache);
+      return 1;
+    }
+    record("check", "code_cache_used", 1, 0, kernels.isCodeCacheUsed());
+
+    // A flipped bit anywhere in the cache makes the load lower the
+    // functions instead of restoring them
+    bool ok = true;
+    double start = now_us();
+    for (uint32_t i = 0; i < cache_size && ok; i++) {
+      WamrModule corrupted;
+      cache[i] ^= 1;
+      ok = corrupted.loadCached(kernels_wasm, kernels_wasm_len, cache,
+                                cache_size, BENCH_STACK_SIZE,
+                                BENCH_MODULE_HEAP) &&
+           !corrupted.isCodeCacheUsed();
+      cache[i] ^= 1;
+    }
+    record("check", "code_cache_corrupted", cache_size, now_us() - start, ok);
+    free(cache);
+    bench_calls(math);
+    check_thread_exit(math);
+    bench_exports(math, kernels);
+    bench_kernels(math, kernels);
+
+    // Cost of lowering the math functions on their first call, which the
+    // load_lazy rows leave out
+    uint32_t lowered_count = 0;
+    uint64_t lowering_us = 0;
+    bool lazy = math.getLazyLoweringStats(&lowered_count, &lowering_us);
+    record("lazy_lowering", "math", lowered_count, (double)lowering_us,
+           lazy && lowered_count > 0);
+  }
+
+  WamrRuntime::end();
+
+  if (json) {
+    print_json();
+  } else {
+    print_csv();
+  }
+
+  for (uint32_t i = 0; i < result_count; i++) {
+    if (!results[i].ok) {
+      return 1;
+    }
+  }
+  return 0;
+}
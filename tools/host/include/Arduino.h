@@ -0,0 +1,57 @@
+/*
+ * WAMR Arduino Wrapper Library - Host Build Arduino Shim
+ *
+ * Copyright (C) 2025 WAMR-ESP32-Arduino Contributors
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Minimal stand-ins for the Arduino-ESP32 globals used by src/WAMR.cpp so
+ * the wrapper can be compiled and benchmarked on Linux (see CMakeLists.txt).
+ * Only what the wrapper touches is provided. Serial output goes to stderr
+ * so benchmark results on stdout stay machine-readable.
+ */
+
+#ifndef _WAMR_HOST_ARDUINO_H
+#define _WAMR_HOST_ARDUINO_H
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+class HostSerial {
+public:
+  int printf(const char *format, ...) __attribute__((format(printf, 2, 3))) {
+    va_list ap;
+    va_start(ap, format);
+    int ret = vfprintf(stderr, format, ap);
+    va_end(ap);
+    return ret;
+  }
+
+  void println(const char *s = "") {
+    fputs(s, stderr);
+    fputc('\n', stderr);
+  }
+};
+
+class HostEsp {
+public:
+  // No meaningful equivalent on the host; heap statistics report zero
+  uint32_t getFreeHeap() { return 0; }
+  uint32_t getFreePsram() { return 0; }
+};
+
+static HostSerial Serial;
+static HostEsp ESP;
+
+static inline unsigned long micros() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (unsigned long)(ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000);
+}
+
+static inline unsigned long millis() { return micros() / 1000; }
+
+#endif /* _WAMR_HOST_ARDUINO_H */
@@ -0,0 +1,39 @@
+/*
+ * WAMR Arduino Wrapper Library - Host Build heap_caps Shim
+ *
+ * Copyright (C) 2025 WAMR-ESP32-Arduino Contributors
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * The host has a single heap; capability flags are accepted and ignored.
+ */
+
+#ifndef _WAMR_HOST_ESP_HEAP_CAPS_H
+#define _WAMR_HOST_ESP_HEAP_CAPS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define MALLOC_CAP_8BIT (1 << 2)
+#define MALLOC_CAP_INTERNAL (1 << 11)
+#define MALLOC_CAP_SPIRAM (1 << 10)
+#define MALLOC_CAP_DEFAULT (1 << 12)
+
+static inline void *heap_caps_malloc(size_t size, uint32_t caps) {
+  (void)caps;
+  return malloc(size);
+}
+
+static inline void heap_caps_free(void *ptr) { free(ptr); }
+
+static inline size_t heap_caps_get_largest_free_block(uint32_t caps) {
+  (void)caps;
+  return 0;
+}
+
+static inline size_t heap_caps_get_free_size(uint32_t caps) {
+  (void)caps;
+  return 0;
+}
+
+#endif /* _WAMR_HOST_ESP_HEAP_CAPS_H */
@@ -0,0 +1,63 @@
+/*
+ * Benchmark kernels example
+ *
+ * Opcode-heavy loops used by the host benchmark suite (tools/benchmarks).
+ * kernels.wat is a hand-written WebAssembly text equivalent that is
+ * embedded in the benchmark, so the host build needs no wasm32 toolchain.
+ *
+ * Compile:
+ *   clang --target=wasm32 -nostdlib -Wl,--no-entry \
+ *         -Wl,--export=fill -Wl,--export=memcpy_loop \
+ *         -Wl,--export=crc32 -Wl,--export=matmul \
+ *         -Wl,--export=memory -O3 -o kernels.wasm kernels.c
+ */
+
+typedef unsigned char uint8_t;
+typedef unsigned int uint32_t;
+
+// Fill a buffer with a deterministic byte pattern
+void fill(uint8_t *ptr, uint32_t len, uint32_t seed) {
+    for (uint32_t i = 0; i < len; i++) {
+        ptr[i] = (uint8_t)(i * 31 + seed);
+    }
+}
+
+// Byte-by-byte copy loop
+void memcpy_loop(uint8_t *dst, const uint8_t *src, uint32_t len) {
+    for (uint32_t i = 0; i < len; i++) {
+        dst[i] = src[i];
+    }
+}
+
+// Bitwise CRC-32 (IEEE 802.3)
+uint32_t crc32(const uint8_t *ptr, uint32_t len) {
+    uint32_t crc = 0xFFFFFFFF;
+    for (uint32_t i = 0; i < len; i++) {
+        crc ^= ptr[i];
+        for (int k = 0; k < 8; k++) {
+            crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+        }
+    }
+    return ~crc;
+}
+
+// n x n integer matrix multiply C = A * B with A at address 0,
+// B right after A and C right after B. Returns the sum of C.
+uint32_t matmul(uint32_t n) {
+    uint32_t *a = (uint32_t *)0;
+    uint32_t *b = a + n * n;
+    uint32_t *c = b + n * n;
+    uint32_t checksum = 0;
+
+    for (uint32_t i = 0; i < n; i++) {
+        for (uint32_t j = 0; j < n; j++) {
+            uint32_t sum = 0;
+            for (uint32_t k = 0; k < n; k++) {
+                sum += a[i * n + k] * b[k * n + j];
+            }
+            c[i * n + j] = sum;
+            checksum += sum;
+        }
+    }
+    return checksum;
+}
@@ -0,0 +1,203 @@
+;; Benchmark kernels (WebAssembly text equivalent of kernels.c)
+;;
+;; Embedded in the host benchmark suite. Compile:
+;;   wat2wasm kernels.wat -o kernels.wasm
+
+(module
+  (memory (export "memory") 2)
+
+  ;; fill(ptr, len, seed): ptr[i] = i * 31 + seed
+  (func (export "fill") (param i32 i32 i32) (local i32)
+    block
+      loop
+        local.get 3
+        local.get 1
+        i32.ge_u
+        br_if 1
+        local.get 0
+        local.get 3
+        i32.add
+        local.get 3
+        i32.const 31
+        i32.mul
+        local.get 2
+        i32.add
+        i32.store8
+        local.get 3
+        i32.const 1
+        i32.add
+        local.set 3
+        br 0
+      end
+    end)
+
+  ;; memcpy_loop(dst, src, len): byte-by-byte copy
+  (func (export "memcpy_loop") (param i32 i32 i32) (local i32)
+    block
+      loop
+        local.get 3
+        local.get 2
+        i32.ge_u
+        br_if 1
+        local.get 0
+        local.get 3
+        i32.add
+        local.get 1
+        local.get 3
+        i32.add
+        i32.load8_u
+        i32.store8
+        local.get 3
+        i32.const 1
+        i32.add
+        local.set 3
+        br 0
+      end
+    end)
+
+  ;; crc32(ptr, len): bitwise CRC-32 (IEEE 802.3)
+  ;; locals: 2 crc, 3 i, 4 bit counter
+  (func (export "crc32") (param i32 i32) (result i32) (local i32 i32 i32)
+    i32.const -1
+    local.set 2
+    block
+      loop
+        local.get 3
+        local.get 1
+        i32.ge_u
+        br_if 1
+        local.get 2
+        local.get 0
+        local.get 3
+        i32.add
+        i32.load8_u
+        i32.xor
+        local.set 2
+        i32.const 8
+        local.set 4
+        loop
+          local.get 2
+          i32.const 1
+          i32.shr_u
+          i32.const 0xEDB88320
+          i32.const 0
+          local.get 2
+          i32.const 1
+          i32.and
+          i32.sub
+          i32.and
+          i32.xor
+          local.set 2
+          local.get 4
+          i32.const 1
+          i32.sub
+          local.tee 4
+          br_if 0
+        end
+        local.get 3
+        i32.const 1
+        i32.add
+        local.set 3
+        br 0
+      end
+    end
+    local.get 2
+    i32.const -1
+    i32.xor)
+
+  ;; matmul(n): C = A * B for n x n i32 matrices, returns sum of C
+  ;; A at 0, B at n*n*4, C at 2*n*n*4
+  ;; locals: 1 i, 2 j, 3 k, 4 sum, 5 matrix bytes, 6 checksum
+  (func (export "matmul") (param i32) (result i32) (local i32 i32 i32 i32 i32 i32)
+    local.get 0
+    local.get 0
+    i32.mul
+    i32.const 2
+    i32.shl
+    local.set 5
+    block
+      loop
+        local.get 1
+        local.get 0
+        i32.ge_u
+        br_if 1
+        i32.const 0
+        local.set 2
+        block
+          loop
+            local.get 2
+            local.get 0
+            i32.ge_u
+            br_if 1
+            i32.const 0
+            local.set 4
+            i32.const 0
+            local.set 3
+            block
+              loop
+                local.get 3
+                local.get 0
+                i32.ge_u
+                br_if 1
+                local.get 4
+                local.get 1
+                local.get 0
+                i32.mul
+                local.get 3
+                i32.add
+                i32.const 2
+                i32.shl
+                i32.load
+                local.get 3
+                local.get 0
+                i32.mul
+                local.get 2
+                i32.add
+                i32.const 2
+                i32.shl
+                local.get 5
+                i32.add
+                i32.load
+                i32.mul
+                i32.add
+                local.set 4
+                local.get 3
+                i32.const 1
+                i32.add
+                local.set 3
+                br 0
+              end
+            end
+            local.get 1
+            local.get 0
+            i32.mul
+            local.get 2
+            i32.add
+            i32.const 2
+            i32.shl
+            local.get 5
+            i32.const 1
+            i32.shl
+            i32.add
+            local.get 4
+            i32.store
+            local.get 6
+            local.get 4
+            i32.add
+            local.set 6
+            local.get 2
+            i32.const 1
+            i32.add
+            local.set 2
+            br 0
+          end
+        end
+        local.get 1
+        i32.const 1
+        i32.add
+        local.set 1
+        br 0
+      end
+    end
+    local.get 6)
+)
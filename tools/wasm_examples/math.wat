@@ -0,0 +1,48 @@
+;; Math functions example (WebAssembly text equivalent of math.c)
+;;
+;; Used for the embedded benchmark modules so the host build does not
+;; need a wasm32 C toolchain. Compile:
+;;   wat2wasm math.wat -o math.wasm
+
+(module
+  (func (export "add") (param i32 i32) (result i32)
+    local.get 0
+    local.get 1
+    i32.add)
+  (func (export "subtract") (param i32 i32) (result i32)
+    local.get 0
+    local.get 1
+    i32.sub)
+  (func (export "multiply") (param i32 i32) (result i32)
+    local.get 0
+    local.get 1
+    i32.mul)
+  (func (export "divide") (param i32 i32) (result i32)
+    local.get 1
+    i32.eqz
+    if (result i32)
+      i32.const 0
+    else
+      local.get 0
+      local.get 1
+      i32.div_s
+    end)
+  ;; Recursive fibonacci
+  (func (export "fibonacci") (param i32) (result i32)
+    local.get 0
+    i32.const 1
+    i32.le_s
+    if (result i32)
+      local.get 0
+    else
+      local.get 0
+      i32.const 1
+      i32.sub
+      call 4
+      local.get 0
+      i32.const 2
+      i32.sub
+      call 4
+      i32.add
+    end)
+)